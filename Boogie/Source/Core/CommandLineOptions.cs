@@ -411,6 +411,8 @@ namespace Microsoft.Boogie {
     public string ICEHoudini = null;
     public string LearnerExecutable = null;
     public bool MLHoudiniUseBounds = true;
+    public bool MLHoudiniBinarySample = false;
+    public bool MLHoudiniServer = true;
     public string LearnerOptions = null;
     public string MLHoudiniSymb = null;
     public bool UseUnsatCoreForContractInfer = false;
@@ -984,6 +986,22 @@ namespace Microsoft.Boogie {
                 }
                 return true;
             }
+        case "mlHoudiniBinarySample":
+            {
+                if (ps.ConfirmArgumentCount(1))
+                {
+                    MLHoudiniBinarySample = Convert.ToBoolean(args[ps.i]);
+                }
+                return true;
+            }
+        case "mlHoudiniServer":
+            {
+                if (ps.ConfirmArgumentCount(1))
+                {
+                    MLHoudiniServer = Convert.ToBoolean(args[ps.i]);
+                }
+                return true;
+            }
         case "learnerOptions":
             {
                 if (ps.ConfirmArgumentCount(1))
@@ -1325,7 +1325,7 @@ namespace Microsoft.Boogie
         CommandLineOptions.Clo.TypeEncodingMethod = CommandLineOptions.TypeEncoding.Monomorphic;
 
         // Run Abstract Houdini
-        var mlice = new Houdini.MLHoudini(program, CommandLineOptions.Clo.LearnerExecutable, filename, CommandLineOptions.Clo.LearnerOptions, CommandLineOptions.Clo.MLHoudiniUseBounds);
+        var mlice = new Houdini.MLHoudini(program, CommandLineOptions.Clo.LearnerExecutable, filename, CommandLineOptions.Clo.LearnerOptions, CommandLineOptions.Clo.MLHoudiniUseBounds, CommandLineOptions.Clo.MLHoudiniBinarySample, CommandLineOptions.Clo.MLHoudiniServer);
         var mliceout = mlice.ComputeSummaries();
         ProcessOutcome(mliceout.outcome, mliceout.errors, "", stats, Console.Out, CommandLineOptions.Clo.ProverKillTime, er);
         ProcessErrors(mliceout.errors, mliceout.outcome, Console.Out, er);
@@ -293,6 +293,23 @@ namespace Microsoft.Boogie.Houdini {
         /// </summary>
         List<int> bounds4cex;
 
+        /// <summary>
+        /// Indicates whether to pass the sample to the learner in the binary sample format (see binary_sample.h of hice-dt)
+        /// instead of the textual data and Horn files.
+        /// </summary>
+        bool useBinarySample;
+
+        /// <summary>
+        /// Indicates whether to run the learner once as a server (hice-dt --server) that keeps the sample in memory across
+        /// rounds instead of starting it once per round. The server is passed the sample in the binary sample format.
+        /// </summary>
+        bool useServer;
+
+        /// <summary>
+        /// The learner running as a server (null if it has not been started yet or has been stopped).
+        /// </summary>
+        Process learnerServer;
+
         #endregion
 
         // Stats
@@ -371,6 +388,17 @@ namespace Microsoft.Boogie.Houdini {
         /// </summary>
         List<Tuple<List<int>, int?>> hornClauses;
 
+        /// <summary>
+        /// Labels of the data points written to the binary data file so far (in the order of their index); null if
+        /// the binary sample files have not been created yet.
+        /// </summary>
+        List<int> binaryLabels;
+
+        /// <summary>
+        /// Number of Horn clauses written to the binary Horn file so far.
+        /// </summary>
+        int binaryHornClausesWritten;
+
         #endregion
 
 
@@ -379,7 +407,7 @@ namespace Microsoft.Boogie.Houdini {
         //bool realErrorEncountered;
         //bool newSamplesAdded;   // tracks whether new ICE samples added in a round or not?
 
-        public MLHoudini(Program program, string learnerExecutable, string filename, string learnerOptions, bool useBounds)
+        public MLHoudini(Program program, string learnerExecutable, string filename, string learnerOptions, bool useBounds, bool useBinarySample, bool useServer)
         {
             this.program = program;
             this.impl2VC = new Dictionary<string, VCExpr>();
@@ -412,6 +440,8 @@ namespace Microsoft.Boogie.Houdini {
             this.learnerExecutable = learnerExecutable;
             this.learnerOptions = learnerOptions;
             this.useBounds = useBounds;
+            this.useBinarySample = useBinarySample || useServer;
+            this.useServer = useServer;
 
             // config = alg1, alg2, alg3, alg4, smallcex_alg1, smallcex_alg2, ...
 
@@ -1169,7 +1199,14 @@ namespace Microsoft.Boogie.Houdini {
 
             var start = DateTime.Now;
 
-            overallOutcome = LearnInv(impl2Priority);
+            try
+            {
+                overallOutcome = LearnInv(impl2Priority);
+            }
+            finally
+            {
+                StopLearnerServer();
+            }
 
             var elapsed = DateTime.Now;
             this.totaltime = elapsed - start;
@@ -1592,17 +1629,19 @@ namespace Microsoft.Boogie.Houdini {
 
 
         /// <summary>
-        /// Generates a string representation of a given data point in the Horn learner syntax.
-        /// Attributes that correspond to paramaters not in the scope of the function to which the
+        /// Computes the values of the attributes of a given data point in the Horn learner syntax, i.e., the category of
+        /// the function to which the data point belongs and the values of all integer attributes (in the order of the
+        /// attributes file). Attributes that correspond to paramaters not in the scope of the function to which the
         /// data point belongs are set to a default value.
         /// </summary>
         /// <param name="dp">A data point</param>
-        /// <returns>a string representation of a given data point in the Horn learner syntax</returns>
-        private string Datapoint2String(dataPoint dp)
+        /// <param name="category">The category of the function to which the data point belongs</param>
+        /// <returns>the values of the integer attributes of the data point</returns>
+        private List<int> Datapoint2Values(dataPoint dp, out int category)
         {
 
-            StringBuilder builder = new StringBuilder();
-            int category = -1;
+            List<int> values = new List<int>();
+            category = -1;
 
             // Iterate over all existential functions
             for (int i = 0; i < category2FunctionName.Count; ++i)
@@ -1616,10 +1655,7 @@ namespace Microsoft.Boogie.Houdini {
                     category = i;
 
                     // Output program values
-                    foreach (var value in dp.value)
-                    {
-                        builder.Append(",").Append(value);
-                    }
+                    values.AddRange(dp.value);
 
                     // Output octagonal constraints
                     for (int k = 0; k < dp.value.Count; ++k)
@@ -1630,8 +1666,8 @@ namespace Microsoft.Boogie.Houdini {
                             {
                                 if (existentialFunctions[category2FunctionName[i]].InParams[l].TypedIdent.Type.IsInt)
                                 {
-                                    builder.Append(",").Append(dp.value[k] + dp.value[l]);
-                                    builder.Append(",").Append(dp.value[k] - dp.value[l]);
+                                    values.Add(dp.value[k] + dp.value[l]);
+                                    values.Add(dp.value[k] - dp.value[l]);
                                 }
                             }
                         }
@@ -1644,7 +1680,7 @@ namespace Microsoft.Boogie.Houdini {
                 {
                     for (int j = 0; j < existentialFunctions[category2FunctionName[i]].InParams.Count; ++j)
                     {
-                        builder.Append(",0");
+                        values.Add(0);
                     }
                     for (int k = 0; k < existentialFunctions[category2FunctionName[i]].InParams.Count; ++k)
                     {
@@ -1654,7 +1690,8 @@ namespace Microsoft.Boogie.Houdini {
                             {
                                 if (existentialFunctions[category2FunctionName[i]].InParams[l].TypedIdent.Type.IsInt)
                                 {
-                                    builder.Append(",0,0");
+                                    values.Add(0);
+                                    values.Add(0);
                                 }
                             }
                         }
@@ -1665,7 +1702,32 @@ namespace Microsoft.Boogie.Houdini {
 
             Debug.Assert(category >= 0);
 
-            return category + builder.ToString();
+            return values;
+
+        }
+
+
+        /// <summary>
+        /// Generates a string representation of a given data point in the Horn learner syntax.
+        /// Attributes that correspond to paramaters not in the scope of the function to which the
+        /// data point belongs are set to a default value.
+        /// </summary>
+        /// <param name="dp">A data point</param>
+        /// <returns>a string representation of a given data point in the Horn learner syntax</returns>
+        private string Datapoint2String(dataPoint dp)
+        {
+
+            int category;
+            var values = Datapoint2Values(dp, out category);
+
+            StringBuilder builder = new StringBuilder();
+            builder.Append(category);
+            foreach (var value in values)
+            {
+                builder.Append(",").Append(value);
+            }
+
+            return builder.ToString();
 
         }
 
@@ -1756,6 +1818,121 @@ namespace Microsoft.Boogie.Houdini {
 
         }
 
+        /// <summary>
+        /// Writes the data points and Horn clauses to the binary sample files (see binary_sample.h of hice-dt). The
+        /// files are created (and stale files of a previous run are overwritten) when this method is first called.
+        /// Afterwards, only the data points and Horn clauses added since the previous call are appended, and the labels
+        /// of data points that have changed since then are overwritten in place.
+        /// </summary>
+        void GenerateBinarySampleFiles()
+        {
+
+            // The binary sample format: 32 bit little-endian integers (as written by BinaryWriter)
+            const uint noHead = 0xFFFFFFFF;
+            const int dataHeaderSize = 16;
+
+            bool create = binaryLabels == null;
+
+
+            //
+            // Data points (one categorical attribute, the function, and the integer attributes)
+            //
+            using (var writer = new System.IO.BinaryWriter(System.IO.File.Open(filename + ".data.bin", create ? System.IO.FileMode.Create : System.IO.FileMode.Open, System.IO.FileAccess.Write)))
+            {
+
+                int numberOfIntAttributes = 0;
+                foreach (var functionName in category2FunctionName)
+                {
+                    var parameters = existentialFunctions[functionName].InParams;
+                    var numberOfInts = parameters.Count(p => p.TypedIdent.Type.IsInt);
+                    numberOfIntAttributes += parameters.Count + numberOfInts * (numberOfInts - 1);
+                }
+
+                if (create)
+                {
+                    writer.Write(Encoding.ASCII.GetBytes("HICEDAT1"));
+                    writer.Write((uint)1);
+                    writer.Write((uint)numberOfIntAttributes);
+                    binaryLabels = new List<int>();
+                    binaryHornClausesWritten = 0;
+                }
+
+                int recordSize = 4 * (2 + numberOfIntAttributes);
+                int pos = 0;
+                foreach (var kvPair in c5samplePointToClassAttr)
+                {
+
+                    if (c5samplePointToIndex[kvPair.Key] != pos)
+                    {
+                        throw new MLHoudiniInternalError("Detected incorrect order of data points in binary data file");
+                    }
+
+                    // Overwrite the label of a data point written before if it has changed
+                    if (pos < binaryLabels.Count)
+                    {
+                        if (binaryLabels[pos] != kvPair.Value)
+                        {
+                            writer.BaseStream.Seek(dataHeaderSize + (long)pos * recordSize, System.IO.SeekOrigin.Begin);
+                            writer.Write((uint)kvPair.Value);
+                            binaryLabels[pos] = kvPair.Value;
+                        }
+                    }
+
+                    // Append a new data point
+                    else
+                    {
+
+                        int category;
+                        var values = Datapoint2Values(kvPair.Key, out category);
+                        Debug.Assert(values.Count == numberOfIntAttributes);
+
+                        writer.BaseStream.Seek(0, System.IO.SeekOrigin.End);
+                        writer.Write((uint)kvPair.Value);
+                        writer.Write((uint)category);
+                        foreach (var value in values)
+                        {
+                            writer.Write(value);
+                        }
+
+                        binaryLabels.Add(kvPair.Value);
+
+                    }
+
+                    ++pos;
+
+                }
+
+            }
+
+
+            //
+            // Horn clauses added since the previous call
+            //
+            using (var writer = new System.IO.BinaryWriter(System.IO.File.Open(filename + ".horn.bin", create ? System.IO.FileMode.Create : System.IO.FileMode.Append, System.IO.FileAccess.Write)))
+            {
+
+                if (create)
+                {
+                    writer.Write(Encoding.ASCII.GetBytes("HICEHRN1"));
+                }
+
+                for (; binaryHornClausesWritten < hornClauses.Count; ++binaryHornClausesWritten)
+                {
+
+                    var clause = hornClauses[binaryHornClausesWritten];
+                    writer.Write(clause.Item2 == null ? noHead : (uint)clause.Item2);
+                    writer.Write((uint)clause.Item1.Count);
+                    foreach (var index in clause.Item1)
+                    {
+                        writer.Write((uint)index);
+                    }
+
+                }
+
+            }
+
+        }
+
         /// <summary>
         /// Writes status information to file, allowing the teacher to communicate (optional) information
         /// to the learner. As of now, the teacher only communicates the current number of learner
@@ -1896,6 +2073,104 @@ namespace Microsoft.Boogie.Houdini {
 
         #region Horn
 
+        /// <summary>
+        /// Sends a message to the learner running as server and returns its answer (see run_server in hice-dt.cpp).
+        /// </summary>
+        /// <param name="message">The message</param>
+        /// <returns>the answer of the learner</returns>
+        string SendToLearnerServer(string message)
+        {
+
+            learnerServer.StandardInput.WriteLine(message);
+            var answer = learnerServer.StandardOutput.ReadLine();
+
+            if (answer == null || answer.StartsWith("error"))
+            {
+                Console.WriteLine("The learner seems to have run into an error!");
+                throw new MLHoudiniInternalError("The learner seems to have run into an error!" + (answer == null ? "" : " (" + answer + ")"));
+            }
+
+            return answer;
+
+        }
+
+
+        /// <summary>
+        /// Runs a round of the learner running as server (which is started in the first round): the server reads the
+        /// data points and Horn clauses appended to the binary sample files since the previous round and answers with the
+        /// learned decision tree.
+        /// </summary>
+        /// <returns>the JSON serialization of the learned decision tree</returns>
+        string RunLearnerServer()
+        {
+
+            var start = DateTime.Now;
+
+            // Start the server (after the attributes and intervals files have been written)
+            if (learnerServer == null)
+            {
+
+                ProcessStartInfo learnerStartInfo = new ProcessStartInfo();
+                learnerStartInfo.FileName = learnerExecutable;
+                learnerStartInfo.Arguments = (learnerOptions == null ? "" : learnerOptions + " ") + "--server " + filename;
+                learnerStartInfo.WindowStyle = ProcessWindowStyle.Hidden;
+                learnerStartInfo.CreateNoWindow = true;
+                learnerStartInfo.UseShellExecute = false;
+                learnerStartInfo.RedirectStandardInput = true;
+                learnerStartInfo.RedirectStandardOutput = true;
+                if (CommandLineOptions.Clo.Trace)
+                {
+                    Console.WriteLine("Starting " + learnerStartInfo.FileName + " " + learnerStartInfo.Arguments);
+                }
+
+                learnerServer = Process.Start(learnerStartInfo);
+                learnerServer.StandardInput.AutoFlush = true;
+
+            }
+
+            // Read new samples and learn
+            SendToLearnerServer("binary");
+            var JSONString = SendToLearnerServer("learn");
+
+            var time = DateTime.Now - start;
+            if (CommandLineOptions.Clo.Trace)
+            {
+                Console.WriteLine("Total learner time was " + time.ToString());
+            }
+            c5LearnerTime += time;
+
+            return JSONString;
+
+        }
+
+
+        /// <summary>
+        /// Stops the learner running as server (if it has been started).
+        /// </summary>
+        void StopLearnerServer()
+        {
+
+            if (learnerServer == null)
+            {
+                return;
+            }
+
+            // The server may have terminated already (e.g., after an error)
+            try
+            {
+                learnerServer.StandardInput.WriteLine("quit");
+            }
+            catch (System.IO.IOException)
+            {
+            }
+            learnerServer.WaitForExit();
+
+            learnerServer.Dispose();
+            learnerServer = null;
+
+        }
+
+
         public bool learn(out HashSet<string> funcsChanged)
         {
 
@@ -1909,55 +2184,76 @@ namespace Microsoft.Boogie.Houdini {
             //
             // Generate files for Horn DT learner
             //
-            GenerateDataFile();
-            GenerateHornFile();
+            if (useBinarySample)
+            {
+                GenerateBinarySampleFiles();
+            }
+            else
+            {
+                GenerateDataFile();
+                GenerateHornFile();
+            }
             GenerateStatusFile();
 
 
             //
             // Run learner
             //
-
-            // Create startup info
-            ProcessStartInfo learnerStartInfo = new ProcessStartInfo();
-            learnerStartInfo.FileName = learnerExecutable;
-            learnerStartInfo.Arguments = learnerOptions == null ? filename : learnerOptions + " " + filename;
-            learnerStartInfo.WindowStyle = ProcessWindowStyle.Hidden;
-            learnerStartInfo.CreateNoWindow = true;
-            learnerStartInfo.UseShellExecute = false;
-            //process.RedirectStandardOutput = true;
-            if (CommandLineOptions.Clo.Trace)
+            string JSONString;
+            if (useServer)
             {
-                Console.WriteLine("Calling " + learnerStartInfo.FileName + " " + learnerStartInfo.Arguments);
+                JSONString = RunLearnerServer();
             }
+            else
+            {
 
-            // Run the external process & wait for it to finish
-            Process learnerProcess = Process.Start(learnerStartInfo);
-            learnerProcess.WaitForExit();
+                // Create startup info
+                ProcessStartInfo learnerStartInfo = new ProcessStartInfo();
+                learnerStartInfo.FileName = learnerExecutable;
+                learnerStartInfo.Arguments = (learnerOptions == null ? "" : learnerOptions + " ") + (useBinarySample ? "--binary " : "") + filename;
+                learnerStartInfo.WindowStyle = ProcessWindowStyle.Hidden;
+                learnerStartInfo.CreateNoWindow = true;
+                learnerStartInfo.UseShellExecute = false;
+                //process.RedirectStandardOutput = true;
+                if (CommandLineOptions.Clo.Trace)
+                {
+                    Console.WriteLine("Calling " + learnerStartInfo.FileName + " " + learnerStartInfo.Arguments);
+                }
 
+                // Run the external process & wait for it to finish
+                Process learnerProcess = Process.Start(learnerStartInfo);
+                learnerProcess.WaitForExit();
+
+
+                //
+                // Check exit code of learner
+                //
+                var learnerExitCode = learnerProcess.ExitCode;
+                if (learnerExitCode != 0)
+                {
+                    Console.WriteLine("The learner seems to have run into an error!");
+                    throw new MLHoudiniInternalError("The learner seems to have run into an error!");
+                }
+                if (CommandLineOptions.Clo.Trace)
+                {
+                    Console.WriteLine("Total learner time was " + (learnerProcess.ExitTime - learnerProcess.StartTime).ToString());
+                }
+                c5LearnerTime += (learnerProcess.ExitTime - learnerProcess.StartTime);
+
+                JSONString = null;
 
-            //
-            // Check exit code of learner
-            //
-            var learnerExitCode = learnerProcess.ExitCode;
-            if (learnerExitCode != 0)
-            {
-                Console.WriteLine("The learner seems to have run into an error!");
-                throw new MLHoudiniInternalError("The learner seems to have run into an error!");
-            }
-            if (CommandLineOptions.Clo.Trace)
-            {
-                Console.WriteLine("Total learner time was " + (learnerProcess.ExitTime - learnerProcess.StartTime).ToString());
             }
-            c5LearnerTime += (learnerProcess.ExitTime - learnerProcess.StartTime);
 
 
             var start = DateTime.Now;
 
             //
-            // Read JSON tree from file
+            // Read JSON tree from file (unless answered by the server)
             //
-            string JSONString = System.IO.File.ReadAllText(filename + ".json");
+            if (JSONString == null)
+            {
+                JSONString = System.IO.File.ReadAllText(filename + ".json");
+            }
             TreeNode root = JsonConvert.DeserializeObject<TreeNode>(JSONString);
             if (root == null)
             {
@@ -19,6 +19,7 @@
 #include "datapoint.h"
 #include "horn_counterexample.h"
 #include "seahorn_smtlib2_parser.h"
+#include "z3_helper.h"
 
 // Z3 includes
 #include "z3++.h"
@@ -172,6 +173,43 @@ namespace chc_teacher
 		
 		
 		static std::unique_ptr<horn_counterexample> check_chc(z3::context & ctx, const constrainted_horn_clause & chc, const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & conjectures)
+		{
+			
+			predicate_substitution substitution(ctx);
+			for (const auto & decl : chc.uninterpreted_predicates)
+			{
+				
+				// Get conjecture
+				auto & pred_conjecture = conjectures.at(decl);
+				
+				// Check that variable count matches
+				assert (pred_conjecture.variables.size() == decl.arity());
+				
+				substitution.add(decl, pred_conjecture.expr, pred_conjecture.variables);
+				
+			}
+			
+			auto counterexamples = check_chc(ctx, chc, substitution, chc.predicates_in_lhs, chc.predicates_in_rhs, 1);
+			return counterexamples.empty() ? std::unique_ptr<horn_counterexample>() : std::move(counterexamples.front());
+			
+		}
+
+
+		/**
+		 * Checks a CHC, extracting the data points of up to a given number of counterexamples for the
+		 * given predicates (in the given order).
+		 *
+		 * @param ctx The context of the CHC and the conjectures
+		 * @param chc The CHC
+		 * @param substitution The substitution of conjectures for (at least) the uninterpreted predicates of the CHC
+		 * @param predicates_in_lhs The predicates of the left-hand-side of the CHC
+		 * @param predicates_in_rhs The predicates of the right-hand-side of the CHC
+		 * @param number_of_counterexamples The maximal number of counterexamples to extract
+		 *
+		 * @return the counterexamples (empty if the CHC is satisfied)
+		 */
+		template <class Predicates>
+		static std::vector<std::unique_ptr<horn_counterexample>> check_chc(z3::context & ctx, const constrainted_horn_clause & chc, predicate_substitution & substitution, const Predicates & predicates_in_lhs, const Predicates & predicates_in_rhs, unsigned number_of_counterexamples)
 		{
 			
 			// // // std::cout << std::endl << "========== PERFORMING CHECK OF CHC ==========" << std::endl << std::endl;
@@ -180,28 +218,13 @@ namespace chc_teacher
 			//
 			// 1. Get CHC to check
 			//
-			z3::expr chc_expr = chc.expr;
-			// // // std::cout << "Original expression is " << std::endl << chc_expr << std::endl;
+			// // // std::cout << "Original expression is " << std::endl << chc.expr << std::endl;
 
 			
 			//
-			// 2. Substitute uninterpreted predicates in CHC with conjectures
+			// 2. Substitute uninterpreted predicates in CHC with conjectures (in a single pass)
 			//
-			for (const auto & decl : chc.uninterpreted_predicates)
-			{
-			
-				// Get conjecture
-				auto & pred_conjecture = conjectures.at(decl);
-				
-				// Check that variable count matches
-				assert (pred_conjecture.variables.size() == decl.arity());
-
-				// // // std::cout << "Substitutinng " << decl << " with " << pred_conjecture << std::endl;
-				
-				// Do substitution
-				chc_expr = z3_helper::substitute(ctx, chc_expr, decl, pred_conjecture.expr, pred_conjecture.variables);
-			
-			}
+			z3::expr chc_expr = substitution.apply(chc.expr);
 			// // // std::cout << "---------- CHC after substituting ----------" << std::endl;
 			// // // std::cout << chc_expr << std::endl;
 			
@@ -231,7 +254,7 @@ namespace chc_teacher
 			if (result == z3::check_result::unsat)
 			{
 				// // // std::cout << "UNSAT!!" << std::endl;
-				return std::unique_ptr<horn_counterexample>();
+				return std::vector<std::unique_ptr<horn_counterexample>>();
 			}
 			
 			// Unknown (i.e., error)
@@ -246,31 +269,133 @@ namespace chc_teacher
 				
 				// // // std::cout << "SAT!!" << std::endl;
 				
+				return extract_counterexamples(solver, z3::expr_vector(ctx), predicates_in_lhs, predicates_in_rhs, number_of_counterexamples);
+				
+			}
+			
+			
+		}
+
+
+		/**
+		 * Adds, for every argument of the given predicates, the disequality of the argument and its value
+		 * in the given data points.
+		 *
+		 * @param predicates The predicates
+		 * @param datapoints The data points of the predicates (in the same order)
+		 * @param disequalities The vector to which the disequalities are added
+		 */
+		template <class Predicates>
+		static void add_disequalities(const Predicates & predicates, const std::list<datapoint> & datapoints, z3::expr_vector & disequalities)
+		{
+			
+			auto dp_it = datapoints.cbegin();
+			for (const auto & pred : predicates)
+			{
+				
+				for (unsigned i = 0; i < pred.num_args(); ++i)
+				{
+					disequalities.push_back(pred.arg(i) != dp_it->values[i]);
+				}
+				++dp_it;
+				
+			}
+			
+		}
+
+
+		/**
+		 * Extracts counterexamples to a CHC from a solver whose last check of the negation of the CHC
+		 * was satisfiable.
+		 *
+		 * After extracting a counterexample from the model, a blocking clause is added to the solver,
+		 * which states that the arguments of the predicates do not all take the values of the
+		 * counterexample, and the solver is checked again. This is repeated until the negated CHC has
+		 * become unsatisfiable or the given number of counterexamples has been extracted. If the
+		 * check was done under assumptions, the blocking clauses are guarded by the assumptions (and,
+		 * hence, do not affect checks under other assumptions).
+		 *
+		 * @param solver The solver
+		 * @param assumptions The assumptions of the last check of the solver
+		 * @param predicates_in_lhs The predicates of the left-hand-side of the CHC
+		 * @param predicates_in_rhs The predicates of the right-hand-side of the CHC
+		 * @param number_of_counterexamples The maximal number of counterexamples to extract (at least one is extracted)
+		 *
+		 * @return the counterexamples
+		 */
+		template <class Predicates>
+		static std::vector<std::unique_ptr<horn_counterexample>> extract_counterexamples(z3::solver & solver, const z3::expr_vector & assumptions, const Predicates & predicates_in_lhs, const Predicates & predicates_in_rhs, unsigned number_of_counterexamples)
+		{
+			
+			std::vector<std::unique_ptr<horn_counterexample>> counterexamples;
+			auto & ctx = solver.ctx();
+			
+			while (true)
+			{
+				
 				// Get model
 				auto model = solver.get_model();
 				// // // std::cout << "---------- Model ----------" << std::endl << model << std::endl;
 				
-				
-				std::list<datapoint> lhs;
-				std::list<datapoint> rhs;
-				
-				// Extract data points of left-hand-side
-				for (const auto & pred : chc.predicates_in_lhs)
+				counterexamples.push_back(extract_counterexample(model, predicates_in_lhs, predicates_in_rhs));
+				if (counterexamples.size() >= number_of_counterexamples)
 				{
-					lhs.push_back(extract_datapoint(pred, model));
+					break;
 				}
 				
-				// Extract data points of right-hand-side
-				for (const auto & pred : chc.predicates_in_rhs)
+				
+				// Block the values of the predicate arguments
+				z3::expr_vector disequalities(ctx);
+				add_disequalities(predicates_in_lhs, counterexamples.back()->lhs, disequalities);
+				add_disequalities(predicates_in_rhs, counterexamples.back()->rhs, disequalities);
+				
+				auto blocking_clause = disequalities.empty() ? ctx.bool_val(false) : z3::mk_or(disequalities);
+				solver.add(assumptions.empty() ? blocking_clause : z3::implies(z3::mk_and(assumptions), blocking_clause));
+				
+				
+				// Check again (an unknown result simply ends the search, as a counterexample has already been found)
+				if ((assumptions.empty() ? solver.check() : solver.check(assumptions)) != z3::check_result::sat)
 				{
-					rhs.push_back(extract_datapoint(pred, model));
+					break;
 				}
 				
+			}
+			
+			return counterexamples;
+			
+		}
 
-				return std::make_unique<horn_counterexample>(std::move(lhs), std::move(rhs));
-				
+
+		/**
+		 * Extracts a counterexample to a CHC from a model of its negation.
+		 *
+		 * @param model The model
+		 * @param predicates_in_lhs The predicates of the left-hand-side of the CHC
+		 * @param predicates_in_rhs The predicates of the right-hand-side of the CHC
+		 *
+		 * @return the counterexample
+		 */
+		template <class Predicates>
+		static std::unique_ptr<horn_counterexample> extract_counterexample(const z3::model & model, const Predicates & predicates_in_lhs, const Predicates & predicates_in_rhs)
+		{
+			
+			std::list<datapoint> lhs;
+			std::list<datapoint> rhs;
+			
+			// Extract data points of left-hand-side
+			for (const auto & pred : predicates_in_lhs)
+			{
+				lhs.push_back(extract_datapoint(pred, model));
 			}
 			
+			// Extract data points of right-hand-side
+			for (const auto & pred : predicates_in_rhs)
+			{
+				rhs.push_back(extract_datapoint(pred, model));
+			}
+			
+
+			return std::make_unique<horn_counterexample>(std::move(lhs), std::move(rhs));
 			
 		}
 
@@ -7,6 +7,7 @@
 
 // C++ includes
 #include <ostream>
+#include <stdexcept>
 #include <vector>
 
 // Z3 includes
@@ -14,6 +15,7 @@
 
 // Project includes
 #include "../../hice-dt/include/datapoint.h"
+#include "relation_descriptor.h"
 
 
 namespace chc_teacher
@@ -26,7 +28,7 @@ namespace chc_teacher
 
 		z3::func_decl predicate;
 		
-		mutable std::vector<z3::expr> values;
+		std::vector<z3::expr> values;
 		
 		datapoint(const z3::func_decl & predicate, std::vector<z3::expr> && values)
 			: predicate(predicate), values(std::move(values))
@@ -74,60 +76,80 @@ namespace chc_teacher
 			return true;
 		}
 
-		std::vector<unsigned int> get_categorical_data(std::unordered_map<z3::func_decl, unsigned, ASTHasher, ASTComparer> relation2ID) const{
+		/**
+		 * Converts this data point into the attributes of a learner data point. The learner data point
+		 * gets the id of the relation of this data point as categorical attribute. Of its integer
+		 * attributes, only those of the relation (the values of this data point followed by the sums and
+		 * differences of all pairs of integer values and the linear attributes of the relation, starting
+		 * at the base of the relation) are set, all
+		 * other attributes are left untouched (and are expected to be 0). The learner relies on this when
+		 * it searches only the attributes of a relation for splits (see
+		 * horn_verification::simple_job_manager::set_attribute_intervals()).
+		 *
+		 * @param relation The descriptor of the relation of this data point
+		 * @param learner_datapoint The learner data point, whose integer attributes need to be allocated
+		 */
+		void to_learner_datapoint(const relation_descriptor & relation, horn_verification::datapoint<bool> & learner_datapoint) const {
 
-			std::vector<unsigned int> _categorical_data;
+			assert (relation.arity == values.size());
 
-			_categorical_data.push_back(relation2ID.find(predicate)->second);
+			learner_datapoint._categorical_data.assign(1, relation.id);
 
-			return _categorical_data;
-		}
+			auto & _int_data = learner_datapoint._int_data;
+
+			//
+			// Adding basic attributes
+			//
 
-		std::vector<int> get_int_data(std::unordered_map<z3::func_decl, unsigned, ASTHasher, ASTComparer> relation_to_base_value, unsigned number_of_int_attributes) const{
+			auto attribute = relation.base;
+
+			for (unsigned i = 0; i < relation.arity; ++i) {
+				assert (values[i].is_const());
+				int value;
+				if (relation.argument_sorts[i] == Z3_BOOL_SORT) {
+					value = values[i].bool_value(); // Bool value (should be casted to int as well), implicit conversion happens here
+				} else if (relation.argument_sorts[i] == Z3_INT_SORT) {
+					auto conversion_result = Z3_get_numeral_int(values[i].ctx(), values[i], &value); // Integer value
+					assert (conversion_result);
+				} else {
+					throw std::runtime_error("Unsupported value type"); // Unsupported type of value
+				}
+				_int_data.at(attribute++) = value;
+			}
 
 			//
 			// Adding derived attributes
 			//
 
-			auto size_of_basic_attributes = values.size();
+			for (unsigned first_index = 0; first_index < relation.arity; first_index++) {
 
-			for (unsigned first_index = 0; first_index < size_of_basic_attributes; first_index++) {
+				for (unsigned second_index = first_index + 1; second_index < relation.arity; second_index++) {
 
-				for (unsigned second_index = first_index + 1; second_index < size_of_basic_attributes; second_index++) {
+					if (relation.argument_sorts[first_index] == Z3_INT_SORT && relation.argument_sorts[second_index] == Z3_INT_SORT) {
 
-					if (values.at(first_index).get_sort().is_int() && values.at(second_index).get_sort().is_int()) {
+						const long long first_value = _int_data[relation.base + first_index];
+						const long long second_value = _int_data[relation.base + second_index];
 
-						values.push_back((values.at(first_index) + values.at(second_index)).simplify());
+						_int_data.at(attribute++) = static_cast<int>(first_value + second_value);
 
-						values.push_back((values.at(first_index) - values.at(second_index)).simplify());
+						_int_data.at(attribute++) = static_cast<int>(first_value - second_value);
 					}
 				}
 			}
 
-			std::vector<int> _int_data;
+			//
+			// Adding linear attributes
+			//
 
-			for (unsigned int_data_index = 0; int_data_index <= number_of_int_attributes; int_data_index++) {
+			for (const auto & form : relation.linear_forms) {
 
-				if ((int_data_index < relation_to_base_value.find(predicate)->second)||(int_data_index >= (relation_to_base_value.find(predicate)->second + values.size()))) {
-					_int_data.push_back(0);
-				} else {
-					for (const auto & expr : values) {
-						assert (expr.is_const());
-						int value;
-						if (expr.is_bool()) {
-							value = expr.bool_value(); // Bool value (should be casted to int as well), implicit conversion happens here
-						} else if (expr.is_int()) {
-							auto conversion_result = Z3_get_numeral_int(expr.ctx(), expr, &value); // Integer value
-							assert (conversion_result);
-						} else {
-							throw std::runtime_error("Unsupported value type"); // Unsupported type of value
-						}
-						_int_data.push_back(value);
-						int_data_index++;
-					}
+				long long value = 0;
+				for (unsigned i = 0; i < relation.arity; ++i) {
+					value += static_cast<long long>(form[i]) * _int_data[relation.base + i];
 				}
+
+				_int_data.at(attribute++) = static_cast<int>(value);
 			}
-			return _int_data;
 		}
 
 		
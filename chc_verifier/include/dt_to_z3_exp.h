@@ -6,9 +6,14 @@
 #define __CHCTEACHER_DT_TO_Z3_EXP_H__
 
 // C++ includes
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <list>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // C includes
 #include <cassert>
@@ -17,276 +22,364 @@
 #include "z3++.h"
 
 // Project includes
+#include "conjecture.h"
 #include "decision_tree.h"
+#include "visitor.h"
+#include "z3_helper.h"
 
 
 namespace chc_teacher
 {
 
-	class dt_to_z3_exp
+	/**
+	 * Translates the decision trees learned in successive rounds into conjectures.
+	 *
+	 * The translation is memoised across rounds: every subtree below the categorical node is
+	 * identified by a structural key (its attribute, its threshold and the identifiers of its two
+	 * children), which is mapped to a unique identifier and the z3 expression of the subtree. Hence,
+	 * a subtree that has been translated before (in any round and for any relation) is not translated
+	 * again. Moreover, the identifier of the subtree of each relation is compared to that of the
+	 * previous round, which yields a cheap bit per relation indicating whether its conjecture has
+	 * changed.
+	 *
+	 * @version 1.0
+	 */
+	class dt_to_z3_exp : public horn_verification::base_visitor
 	{
-		/// Variables used to construct conjecture expressions
-		std::vector<std::vector<z3::expr>> _set_of_variables;
 
-		std::unordered_map<unsigned, z3::func_decl> _ID2relation;
+		/**
+		 * The structural key of an integer node, consisting of its attribute, its threshold and the
+		 * identifiers of its children.
+		 */
+		struct subtree_key
+		{
 
-		std::unordered_map<unsigned, z3::expr> _integer_identifier_to_attribute;
+			std::size_t attribute;
 
-		z3::context & _ctx;
+			int threshold;
 
-		public:
+			unsigned left;
 
+			unsigned right;
 
-			dt_to_z3_exp(const std::vector<std::vector<z3::expr>> & variables, std::unordered_map<unsigned, z3::func_decl> & ID2relation, std::unordered_map<unsigned, z3::expr> & integer_identifier_to_attribute)
-				: _set_of_variables(variables), _ID2relation(ID2relation), _integer_identifier_to_attribute(integer_identifier_to_attribute), _ctx((_ID2relation.begin())->second.ctx())
-			{
-				//Nothing to do
+			bool operator==(const subtree_key & other) const {
+
+				return attribute == other.attribute && threshold == other.threshold && left == other.left && right == other.right;
 			}
 
-			std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> get_unordered_map(horn_verification::base_node *node) const {
-				
-				std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> map_z3_expr;
+		};
 
-				horn_verification::categorical_node* categorical_child = dynamic_cast<horn_verification::categorical_node*> (node);
+		struct subtree_key_Hasher
+		{
 
-				horn_verification::leaf_node* leaf_child = NULL;
+			std::size_t operator() (const subtree_key & key) const {
 
-				if (categorical_child != NULL) {
+				std::size_t hash = std::hash<std::size_t>()(key.attribute);
+				hash = hash * 31 + std::hash<int>()(key.threshold);
+				hash = hash * 31 + key.left;
+				hash = hash * 31 + key.right;
 
-					get_z3_exp_categorical(categorical_child, map_z3_expr);
+				return hash;
+			}
 
-				} else {
+		};
 
-					leaf_child = dynamic_cast<horn_verification::leaf_node*> (node);
-				}
+		/// Reserved subtree identifiers
+		enum : unsigned {
 
-				for (auto categorical_identifier : _ID2relation) {
+			/// Identifier of a leaf with output false
+			false_leaf = 0,
 
-					if (map_z3_expr.find(categorical_identifier.second) == map_z3_expr.end()) {
+			/// Identifier of a leaf with output true
+			true_leaf = 1,
 
-						z3::func_decl relation_signature = categorical_identifier.second;
+			/// Identifier of a relation that has not been translated yet
+			no_subtree = std::numeric_limits<unsigned>::max()
+		};
 
-						z3::expr_vector  variables(_ctx);
+		/// Number of cached subtrees after which the cache is cleared
+		static const std::size_t max_cached_subtrees = 1 << 16;
 
-						for (auto var : _set_of_variables.at(categorical_identifier.first)) {
+		/// Variables used to construct conjecture expressions
+		std::vector<std::vector<z3::expr>> _set_of_variables;
 
-							variables.push_back(var);
-						}
+		std::unordered_map<unsigned, z3::func_decl> _ID2relation;
 
-						bool random_boolean_value;
+		std::unordered_map<unsigned, z3::expr> _integer_identifier_to_attribute;
 
-						if (categorical_child == NULL && leaf_child != NULL) {
+		z3::context & _ctx;
 
-							random_boolean_value = leaf_child->output();
+		/// The identifiers of the subtrees translated so far
+		std::unordered_map<subtree_key, unsigned, subtree_key_Hasher> _subtree_ids;
 
-						} else if (rand()%2 == 0) {
+		/// The expressions of the subtrees translated so far (indexed by identifier)
+		std::vector<z3::expr> _subtree_expressions;
 
-							random_boolean_value = false;
+		/// The identifier of the subtree visited last
+		unsigned _last_subtree;
 
-						} else {
+		/// For every relation, the identifier of its subtree in the previous round
+		std::vector<unsigned> _previous_subtrees;
 
-							random_boolean_value = true;
-						}
+		/// For every relation, its conjecture in the previous round
+		std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> _previous_conjectures;
 
-						conjecture relation_conjecture(_ctx.bool_val(random_boolean_value), variables);
+		/// For every relation, whether its conjecture has changed in the last round
+		std::unordered_map<z3::func_decl, bool, ASTHasher, ASTComparer> _changed;
 
-						map_z3_expr.emplace(relation_signature, relation_conjecture);
-					}
-				}
 
-				return map_z3_expr;
+		/**
+		 * Returns the variables of a relation as expression vector.
+		 *
+		 * @param categorical_identifier The identifier of the relation
+		 *
+		 * @return the variables of the relation
+		 */
+		z3::expr_vector variables_of(unsigned categorical_identifier) const {
+
+			z3::expr_vector variables(_ctx);
+
+			for (const auto & var : _set_of_variables.at(categorical_identifier)) {
+
+				variables.push_back(var);
 			}
 
+			return variables;
+		}
 
-			void get_z3_exp_categorical(horn_verification::categorical_node *node, std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & map_z3_expr) const {
 
-				z3::expr expression = _ctx.bool_val(false);
+		/**
+		 * Returns the constraint an integer node imposes on its left or right subtree.
+		 *
+		 * @param node The node
+		 * @param left Whether to return the constraint of the left subtree
+		 *
+		 * @return the constraint
+		 */
+		z3::expr get_z3_exp_constraint(const horn_verification::int_node & node, bool left) const {
 
-				unsigned categorical_identifier = 0;
+			const auto & attribute = _integer_identifier_to_attribute.find(node.attribute())->second;
 
-				for (auto child : node->children()) {
+			if (attribute.is_bool()) {
 
-					horn_verification::int_node* int_child = dynamic_cast<horn_verification::int_node*> (child);
+				return attribute && ((node.threshold() == 1) == left);
 
-					horn_verification::leaf_node* leaf_child = dynamic_cast<horn_verification::leaf_node*> (child);
+			} else {
 
-					if(leaf_child != NULL) {
+				return left ? attribute <= node.threshold() : attribute > node.threshold();
+			}
+		}
 
-						expression = get_z3_exp_leaf(leaf_child, _set_of_variables.at(categorical_identifier));
 
-					} else if (int_child != NULL) {
+		/**
+		 * Records the outcome of a round for a relation.
+		 *
+		 * @param categorical_identifier The identifier of the relation
+		 * @param subtree The identifier of the subtree of the relation
+		 * @param expression The conjecture of the relation
+		 * @param map_z3_expr The map of conjectures to add the conjecture to
+		 */
+		void add_conjecture(unsigned categorical_identifier, unsigned subtree, const z3::expr & expression, std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & map_z3_expr) {
 
-						expression = get_z3_exp_int(int_child, _set_of_variables.at(categorical_identifier));
+			const auto & relation_signature = _ID2relation.find(categorical_identifier)->second;
 
-					}
+			auto previous_it = _previous_conjectures.find(relation_signature);
 
-					z3::func_decl relation_signature = (_ID2relation.find(categorical_identifier))->second;
+			bool has_changed = previous_it == _previous_conjectures.end() || (_previous_subtrees[categorical_identifier] != subtree && !z3::eq(previous_it->second.expr, expression));
 
-					z3::expr_vector  variables(_ctx);
+			_changed[relation_signature] = has_changed;
 
-					for (auto var : _set_of_variables.at(categorical_identifier)) {
+			_previous_subtrees[categorical_identifier] = subtree;
 
-						variables.push_back(var);
-					}
+			if (has_changed) {
 
-					conjecture relation_conjecture(expression, variables);
+				conjecture relation_conjecture(expression, variables_of(categorical_identifier));
 
-					map_z3_expr.emplace(relation_signature, relation_conjecture);
+				_previous_conjectures.erase(relation_signature);
 
-					//std::cout << std::endl  << "Relation: " << relation_signature << ", can be replace with expression:  " << expression << std::endl;
+				_previous_conjectures.emplace(relation_signature, relation_conjecture);
 
-					categorical_identifier++;
-				}
+				map_z3_expr.emplace(relation_signature, relation_conjecture);
+
+			} else {
+
+				map_z3_expr.emplace(relation_signature, previous_it->second);
 			}
+		}
 
 
-			z3::expr get_z3_exp_int(horn_verification::int_node *node, std::vector<z3::expr> _variables) const {
+		public:
 
-				auto children = node->children();
 
-				auto left_child = children[0];
+			dt_to_z3_exp(const std::vector<std::vector<z3::expr>> & variables, const std::unordered_map<unsigned, z3::func_decl> & ID2relation, const std::unordered_map<unsigned, z3::expr> & integer_identifier_to_attribute)
+				: _set_of_variables(variables), _ID2relation(ID2relation), _integer_identifier_to_attribute(integer_identifier_to_attribute), _ctx((_ID2relation.begin())->second.ctx()), _last_subtree(false_leaf), _previous_subtrees(variables.size(), no_subtree)
+			{
+				_subtree_expressions.push_back(_ctx.bool_val(false));
+				_subtree_expressions.push_back(_ctx.bool_val(true));
+			}
 
-				auto right_child = children[1];
+			/**
+			 * Translates a decision tree into conjectures.
+			 *
+			 * @param node The root of the decision tree
+			 *
+			 * @return a map that maps declarations of the uninterpreted predicates to their conjectures
+			 */
+			std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> get_unordered_map(horn_verification::base_node *node) {
 
-				horn_verification::int_node* left_int_child = dynamic_cast<horn_verification::int_node*> (left_child);
+				if (_subtree_expressions.size() > max_cached_subtrees) {
 
-				horn_verification::leaf_node* left_leaf_child = dynamic_cast<horn_verification::leaf_node*> (left_child);
+					_subtree_ids.clear();
 
-				horn_verification::int_node* right_int_child = dynamic_cast<horn_verification::int_node*> (right_child);
+					_subtree_expressions.resize(2, _ctx.bool_val(false));
 
-				horn_verification::leaf_node* right_leaf_child = dynamic_cast<horn_verification::leaf_node*> (right_child);
+					_previous_subtrees.assign(_previous_subtrees.size(), no_subtree);
+				}
 
-				z3::expr left_expression(_ctx), right_expression(_ctx);
+				std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> map_z3_expr;
 
-				bool no_left_child = false;
+				horn_verification::categorical_node* categorical_child = dynamic_cast<horn_verification::categorical_node*> (node);
 
-				bool no_right_child = false;
+				horn_verification::leaf_node* leaf_child = NULL;
 
-				if (left_int_child != NULL) {
+				if (categorical_child != NULL) {
 
-					if ((_integer_identifier_to_attribute.find(node->attribute())->second).is_bool()) {
+					get_z3_exp_categorical(categorical_child, map_z3_expr);
 
-						bool boolean_value;
+				} else {
 
-						if (node->threshold() == 1) {
+					leaf_child = dynamic_cast<horn_verification::leaf_node*> (node);
+				}
 
-							boolean_value = true;
+				for (auto categorical_identifier : _ID2relation) {
 
-						} else {
+					if (map_z3_expr.find(categorical_identifier.second) == map_z3_expr.end()) {
 
-							boolean_value = false;
-						}
+						bool random_boolean_value;
 
-						left_expression = get_z3_exp_int(left_int_child, _variables) && (_integer_identifier_to_attribute.find(node->attribute())->second && boolean_value);
+						if (categorical_child == NULL && leaf_child != NULL) {
 
-					} else {
+							random_boolean_value = leaf_child->output();
 
-						left_expression = get_z3_exp_int(left_int_child, _variables) && (_integer_identifier_to_attribute.find(node->attribute())->second <= node->threshold());
-					}
+						} else if (rand()%2 == 0) {
 
-				} else if (left_leaf_child != NULL) {
+							random_boolean_value = false;
 
-					if (left_leaf_child->output() == true) {
+						} else {
 
-						if ((_integer_identifier_to_attribute.find(node->attribute())->second).is_bool()) {
+							random_boolean_value = true;
+						}
 
-							bool boolean_value;
+						unsigned subtree = random_boolean_value ? true_leaf : false_leaf;
 
-							if (node->threshold() == 1) {
+						add_conjecture(categorical_identifier.first, subtree, _subtree_expressions[subtree], map_z3_expr);
+					}
+				}
 
-								boolean_value = true;
+				return map_z3_expr;
+			}
 
-							} else {
 
-								boolean_value = false;
-							}
+			void get_z3_exp_categorical(horn_verification::categorical_node *node, std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & map_z3_expr) {
 
-							left_expression = _integer_identifier_to_attribute.find(node->attribute())->second && boolean_value;
+				unsigned categorical_identifier = 0;
 
-						} else {
+				// A missing child keeps the subtree of the previous child (or false for the first child)
+				_last_subtree = false_leaf;
 
-							left_expression = _integer_identifier_to_attribute.find(node->attribute())->second <= node->threshold();
-						}
+				for (auto child : node->children()) {
 
-					} else {
+					if (child != NULL) {
 
-						no_left_child = true;
+						child->accept(*this);
 					}
-				}
 
-				if (right_int_child != NULL) {
+					add_conjecture(categorical_identifier, _last_subtree, _subtree_expressions[_last_subtree], map_z3_expr);
 
-					if ((_integer_identifier_to_attribute.find(node->attribute())->second).is_bool()) {
+					categorical_identifier++;
+				}
+			}
 
-						bool boolean_value;
 
-						if (node->threshold() == 1) {
+			/**
+			 * Returns, for every relation, whether its conjecture has changed in the last call of
+			 * get_unordered_map() (conjectures of the first call are considered changed).
+			 *
+			 * @return a map that maps declarations of the uninterpreted predicates to their change bit
+			 */
+			const std::unordered_map<z3::func_decl, bool, ASTHasher, ASTComparer> & changed() const {
 
-							boolean_value = false;
+				return _changed;
+			}
 
-						} else {
 
-							boolean_value = true;
-						}
+			void visit(horn_verification::categorical_node & node) override {
 
-						right_expression = get_z3_exp_int(right_int_child, _variables) && (_integer_identifier_to_attribute.find(node->attribute())->second && boolean_value);
+				throw std::runtime_error("Unexpected categorical node below the root of the decision tree");
+			}
 
-					} else {
 
-						right_expression = get_z3_exp_int(right_int_child, _variables) && (_integer_identifier_to_attribute.find(node->attribute())->second > node->threshold());
+			void visit(horn_verification::int_node & node) override {
 
-					}
+				node.children()[0]->accept(*this);
 
-				} else if (right_leaf_child != NULL) {
+				auto left = _last_subtree;
 
-					if (right_leaf_child->output() == true) {
+				node.children()[1]->accept(*this);
 
-						if ((_integer_identifier_to_attribute.find(node->attribute())->second).is_bool()) {
+				auto right = _last_subtree;
 
-							bool boolean_value;
+				subtree_key key { node.attribute(), node.threshold(), left, right };
 
-							if (node->threshold() == 1) {
+				auto it = _subtree_ids.find(key);
 
-								boolean_value = false;
+				if (it != _subtree_ids.end()) {
 
-							} else {
+					_last_subtree = it->second;
 
-								boolean_value = true;
-							}
+					return;
+				}
 
-							right_expression = _integer_identifier_to_attribute.find(node->attribute())->second && boolean_value;
 
-						} else {
+				// Translate subtree from the expressions of its children (a false leaf contributes nothing)
+				z3::expr left_expression(_ctx), right_expression(_ctx);
 
-							right_expression = _integer_identifier_to_attribute.find(node->attribute())->second > node->threshold();
-						}
+				if (left != false_leaf) {
+
+					left_expression = left == true_leaf ? get_z3_exp_constraint(node, true) : _subtree_expressions[left] && get_z3_exp_constraint(node, true);
+				}
 
-					} else {
+				if (right != false_leaf) {
 
-						no_right_child = true;
-					}
+					right_expression = right == true_leaf ? get_z3_exp_constraint(node, false) : _subtree_expressions[right] && get_z3_exp_constraint(node, false);
 				}
 
-				if (no_right_child == false && no_left_child == false) {
+				if (left != false_leaf && right != false_leaf) {
+
+					_subtree_expressions.push_back(left_expression || right_expression);
 
-					return left_expression || right_expression;
+				} else if (left != false_leaf) {
 
-				} else if (no_right_child == true && no_left_child == false) {
+					_subtree_expressions.push_back(left_expression);
 
-					return left_expression;
+				} else if (right != false_leaf) {
 
-				} else if (no_left_child == true && no_right_child == false) {
+					_subtree_expressions.push_back(right_expression);
 
-					return right_expression;
+				} else {
+
+					_subtree_expressions.push_back(_ctx.bool_val(false));
 				}
 
-				return _ctx.bool_val(false);
+				_last_subtree = _subtree_expressions.size() - 1;
 
+				_subtree_ids.emplace(key, _last_subtree);
 			}
 
-			z3::expr get_z3_exp_leaf(horn_verification::leaf_node *node, std::vector<z3::expr> _variables) const {
 
-				return _ctx.bool_val(node->output());
+			void visit(horn_verification::leaf_node & node) override {
+
+				_last_subtree = node.output() ? true_leaf : false_leaf;
 			}
 	};
 
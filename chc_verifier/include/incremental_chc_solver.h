@@ -0,0 +1,246 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __CHCTEACHER_INCREMENTAL_CHC_SOLVER_H__
+#define __CHCTEACHER_INCREMENTAL_CHC_SOLVER_H__
+
+// C++ includes
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// C includes
+#include <cassert>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "chc.h"
+#include "chc_verifier.h"
+#include "conjecture.h"
+#include "horn_counterexample.h"
+#include "z3_helper.h"
+
+
+namespace chc_teacher
+{
+
+	/**
+	 * This class checks one CHC against changing conjectures, keeping one z3 solver for all checks.
+	 *
+	 * The negation of the CHC is split into conjuncts. The conjuncts that do not contain an
+	 * uninterpreted predicate (i.e., the constraints of the body of the CHC) are asserted once.
+	 * Every check then introduces a fresh activation literal <em>a</em>, asserts <em>a => c</em> for
+	 * the remaining conjuncts <em>c</em> with the conjectures substituted for the uninterpreted
+	 * predicates and checks satisfiability under the assumption <em>a</em>. Afterwards, <em>a</em> is
+	 * retired by asserting its negation. Hence, the solver keeps the preprocessed body of the CHC and
+	 * what it has learned about it across checks. As the retired constraints still occupy the solver,
+	 * the solver is reset once a number of activation literals have been retired.
+	 *
+	 * @version 1.0
+	 */
+	class incremental_chc_solver
+	{
+
+		/// The context of the CHC
+		z3::context & _ctx;
+
+		/// The CHC
+		const constrainted_horn_clause & _chc;
+
+		/// The solver
+		z3::solver _solver;
+
+		/// The conjuncts of the negated CHC that do not contain uninterpreted predicates
+		std::vector<z3::expr> _body;
+
+		/// The conjuncts of the negated CHC that contain uninterpreted predicates
+		std::vector<z3::expr> _guarded;
+
+		/// The number of activation literals used (and retired) since the solver was last reset
+		unsigned _number_of_retired_literals;
+
+		/// The number of retired activation literals after which the solver is reset
+		static const unsigned max_retired_literals = 100;
+
+
+		/**
+		 * Returns whether an expression contains an application of an uninterpreted predicate of the CHC.
+		 *
+		 * @param e The expression
+		 *
+		 * @return whether the expression contains an uninterpreted predicate
+		 */
+		bool contains_predicate(const z3::expr & e) const
+		{
+
+			expr_set visited;
+			std::vector<z3::expr> worklist;
+			worklist.push_back(e);
+
+			while (!worklist.empty())
+			{
+
+				auto cur = worklist.back();
+				worklist.pop_back();
+
+				if (!cur.is_app() || !visited.insert(cur).second)
+				{
+					continue;
+				}
+
+				if (_chc.uninterpreted_predicates.count(cur.decl()) > 0)
+				{
+					return true;
+				}
+
+				for (unsigned i = 0; i < cur.num_args(); ++i)
+				{
+					worklist.push_back(cur.arg(i));
+				}
+
+			}
+
+			return false;
+
+		}
+
+
+		/**
+		 * Splits an expression into conjuncts, pushing negations over implications and disjunctions.
+		 *
+		 * @param e The expression
+		 * @param conjuncts The vector to which the conjuncts are added
+		 */
+		static void split_conjuncts(const z3::expr & e, std::vector<z3::expr> & conjuncts)
+		{
+
+			if (e.is_app() && e.decl().decl_kind() == Z3_OP_AND)
+			{
+				for (unsigned i = 0; i < e.num_args(); ++i)
+				{
+					split_conjuncts(e.arg(i), conjuncts);
+				}
+			}
+			else if (e.is_app() && e.decl().decl_kind() == Z3_OP_NOT && e.arg(0).is_app() && e.arg(0).decl().decl_kind() == Z3_OP_IMPLIES)
+			{
+				split_conjuncts(e.arg(0).arg(0), conjuncts);
+				split_conjuncts(!e.arg(0).arg(1), conjuncts);
+			}
+			else if (e.is_app() && e.decl().decl_kind() == Z3_OP_NOT && e.arg(0).is_app() && e.arg(0).decl().decl_kind() == Z3_OP_OR)
+			{
+				for (unsigned i = 0; i < e.arg(0).num_args(); ++i)
+				{
+					split_conjuncts(!e.arg(0).arg(i), conjuncts);
+				}
+			}
+			else
+			{
+				conjuncts.push_back(e);
+			}
+
+		}
+
+
+		/**
+		 * Asserts the body of the CHC in an empty solver.
+		 */
+		void reset()
+		{
+			_solver.reset();
+			for (const auto & conjunct : _body)
+			{
+				_solver.add(conjunct);
+			}
+			_number_of_retired_literals = 0;
+		}
+
+
+	public:
+
+		/**
+		 * Creates a new solver for a CHC.
+		 *
+		 * @param ctx The context of the CHC
+		 * @param chc The CHC (which needs to outlive the solver)
+		 */
+		incremental_chc_solver(z3::context & ctx, const constrainted_horn_clause & chc)
+			: _ctx(ctx), _chc(chc), _solver(ctx), _number_of_retired_literals(0)
+		{
+
+			std::vector<z3::expr> conjuncts;
+			split_conjuncts(!chc.expr, conjuncts);
+			for (const auto & conjunct : conjuncts)
+			{
+				(contains_predicate(conjunct) ? _guarded : _body).push_back(conjunct);
+			}
+
+			reset();
+
+		}
+
+
+		/**
+		 * Checks the CHC against conjectures.
+		 *
+		 * @param substitution The substitution of conjectures for (at least) the uninterpreted predicates of the CHC
+		 * @param predicates_in_lhs The predicates of the left-hand-side of the CHC
+		 * @param predicates_in_rhs The predicates of the right-hand-side of the CHC
+		 * @param number_of_counterexamples The maximal number of counterexamples to extract
+		 *
+		 * @return the counterexamples (empty if the CHC is satisfied)
+		 */
+		template <class Predicates>
+		std::vector<std::unique_ptr<horn_counterexample>> check(predicate_substitution & substitution, const Predicates & predicates_in_lhs, const Predicates & predicates_in_rhs, unsigned number_of_counterexamples)
+		{
+
+			if (_number_of_retired_literals >= max_retired_literals)
+			{
+				reset();
+			}
+
+
+			//
+			// Assert the conjectures under a fresh activation literal
+			//
+			auto literal = _ctx.bool_const(("chc#activation" + std::to_string(_number_of_retired_literals++)).c_str());
+
+			for (const auto & conjunct : _guarded)
+			{
+				_solver.add(z3::implies(literal, substitution.apply(conjunct)));
+			}
+
+
+			//
+			// Solve under the activation literal
+			//
+			z3::expr_vector assumptions(_ctx);
+			assumptions.push_back(literal);
+			auto result = _solver.check(assumptions);
+
+			std::vector<std::unique_ptr<horn_counterexample>> counterexamples;
+			if (result == z3::check_result::unknown)
+			{
+				throw std::runtime_error("Solver reported UNKNOWN");
+			}
+			else if (result == z3::check_result::sat)
+			{
+				counterexamples = chc_verifier::extract_counterexamples(_solver, assumptions, predicates_in_lhs, predicates_in_rhs, number_of_counterexamples);
+			}
+
+			// Retire activation literal (and, hence, the blocking clauses of the counterexamples)
+			_solver.add(!literal);
+
+			return counterexamples;
+
+		}
+
+	};
+
+}; // End namespace chc_teacher
+
+#endif
@@ -0,0 +1,537 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __CHCTEACHER_KARR_ANALYSIS_H__
+#define __CHCTEACHER_KARR_ANALYSIS_H__
+
+// C++ includes
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "chc_verifier.h"
+#include "conjecture.h"
+#include "horn_counterexample.h"
+#include "problem.h"
+#include "relation_descriptor.h"
+#include "z3_helper.h"
+
+
+namespace chc_teacher
+{
+
+	/**
+	 * This class computes the affine equalities that hold between the integer arguments of every
+	 * relation of a problem (Karr's analysis), computed symbolically with the CHC checks of the
+	 * teacher: the affine hull of every relation starts empty, and as long as a CHC is violated by the
+	 * current hulls, the counterexample is a point of the relation in the right-hand-side that lies
+	 * outside of its hull, which is therefore extended by this point. Since the dimension of a hull
+	 * grows with every point, the analysis performs at most (number of integer arguments + 1) checks
+	 * with counterexample per relation and CHC. The resulting equalities are an inductive invariant
+	 * of the CHCs without query.
+	 *
+	 * The linear forms of the equalities make good attributes for the learner, e.g., <em>x - 2y</em> for
+	 * the equality <em>x - 2y = 1</em>.
+	 *
+	 * Z3's own Karr transformer (<code>mk_karr_invariants</code>, available through muz_preprocessor)
+	 * is no substitute: it keeps its invariants to itself (they only show up in the strengthened rule
+	 * bodies and its model converter), so that they cannot be turned into attributes, and on the
+	 * sequential benchmarks it does not strengthen a single rule.
+	 *
+	 * @version 1.0
+	 */
+	class karr_analysis
+	{
+
+		/**
+		 * The state of the analysis of a relation.
+		 */
+		struct relation_state
+		{
+
+			/// The indices of the integer arguments of the relation
+			std::vector<unsigned> int_arguments;
+
+			/// The points (values of the integer arguments) spanning the affine hull
+			std::vector<std::vector<std::int64_t>> generators;
+
+			/// The equalities of the affine hull (coefficients of the integer arguments followed by the constant)
+			std::vector<std::vector<std::int64_t>> equalities;
+
+			/// Whether the analysis gave up on the relation (if a value or coefficient is too large), whose invariant is then true
+			bool is_top = false;
+
+		};
+
+
+		/// The Z3 context
+		z3::context & _ctx;
+
+		/// The state of every relation
+		std::unordered_map<z3::func_decl, relation_state, ASTHasher, ASTComparer> _states;
+
+		/// The invariant of every relation
+		std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> _invariants;
+
+		/// The number of CHC checks performed
+		unsigned _number_of_checks;
+
+
+		/**
+		 * Computes the equalities that every given point satisfies, i.e., a basis of the vectors
+		 * <em>(c, d)</em> with <em>c * g = d</em> for every generator <em>g</em>, with coprime coefficients.
+		 *
+		 * @param generators The points (of equal dimension)
+		 * @param dimension The dimension of the points
+		 * @param equalities The vector to which to add the equalities
+		 *
+		 * @return whether the computation succeeded without overflow
+		 */
+		static bool affine_equalities(const std::vector<std::vector<std::int64_t>> & generators, std::size_t dimension, std::vector<std::vector<std::int64_t>> & equalities)
+		{
+
+			typedef __int128 integer;
+			const integer limit = integer(1) << 62;
+
+			auto abs = [](integer x) { return x < 0 ? -x : x; };
+			auto gcd = [&abs](integer a, integer b) { a = abs(a); b = abs(b); while (b != 0) { auto t = a % b; a = b; b = t; } return a; };
+			auto normalize = [&gcd](std::vector<integer> & row) {
+				integer divisor = 0;
+				for (auto x : row) { divisor = gcd(divisor, x); }
+				if (divisor > 1) { for (auto & x : row) { x /= divisor; } }
+			};
+
+			// The matrix of the homogeneous system c * g - d = 0 (one row per generator)
+			std::vector<std::vector<integer>> rows;
+			rows.reserve(generators.size());
+			for (const auto & g : generators)
+			{
+				std::vector<integer> row(g.begin(), g.end());
+				row.push_back(-1);
+				rows.push_back(std::move(row));
+			}
+
+			// Fraction-free Gauss-Jordan elimination
+			std::vector<std::size_t> pivot_columns;
+			std::vector<bool> is_pivot_column(dimension + 1, false);
+			std::size_t rank = 0;
+			for (std::size_t column = 0; column <= dimension && rank < rows.size(); ++column)
+			{
+
+				std::size_t pivot = rank;
+				while (pivot < rows.size() && rows[pivot][column] == 0)
+				{
+					++pivot;
+				}
+				if (pivot == rows.size())
+				{
+					continue;
+				}
+				std::swap(rows[rank], rows[pivot]);
+
+				for (std::size_t i = 0; i < rows.size(); ++i)
+				{
+					if (i != rank && rows[i][column] != 0)
+					{
+						const auto factor = rows[i][column];
+						for (std::size_t j = 0; j <= dimension; ++j)
+						{
+							rows[i][j] = rows[i][j] * rows[rank][column] - rows[rank][j] * factor;
+							if (abs(rows[i][j]) >= limit)
+							{
+								return false;
+							}
+						}
+						normalize(rows[i]);
+					}
+				}
+
+				pivot_columns.push_back(column);
+				is_pivot_column[column] = true;
+				++rank;
+
+			}
+
+			// One equality per free column
+			integer common_multiple = 1;
+			for (std::size_t r = 0; r < rank; ++r)
+			{
+				const auto p = abs(rows[r][pivot_columns[r]]);
+				common_multiple = common_multiple / gcd(common_multiple, p) * p;
+				if (common_multiple >= limit)
+				{
+					return false;
+				}
+			}
+
+			for (std::size_t free_column = 0; free_column <= dimension; ++free_column)
+			{
+
+				if (is_pivot_column[free_column])
+				{
+					continue;
+				}
+
+				std::vector<integer> equality(dimension + 1, 0);
+				equality[free_column] = common_multiple;
+				for (std::size_t r = 0; r < rank; ++r)
+				{
+					equality[pivot_columns[r]] = -rows[r][free_column] * (common_multiple / rows[r][pivot_columns[r]]);
+					if (abs(equality[pivot_columns[r]]) >= limit)
+					{
+						return false;
+					}
+				}
+				normalize(equality);
+
+				// Skip the trivial equality 0 = 0 (only possible without generators)
+				bool is_trivial = true;
+				for (std::size_t j = 0; j < dimension; ++j)
+				{
+					is_trivial = is_trivial && equality[j] == 0;
+				}
+				if (!is_trivial)
+				{
+					equalities.push_back(std::vector<std::int64_t>(equality.begin(), equality.end()));
+				}
+
+			}
+
+			return true;
+
+		}
+
+
+		/**
+		 * Rebuilds the invariant of a relation from its state.
+		 *
+		 * @param decl The declaration of the relation
+		 * @param state The state of the relation
+		 */
+		void update_invariant(const z3::func_decl & decl, const relation_state & state)
+		{
+
+			z3::expr_vector variables(_ctx);
+			for (unsigned i = 0; i < decl.arity(); ++i)
+			{
+				variables.push_back(_ctx.constant((decl.name().str() + "#" + std::to_string(i)).c_str(), decl.domain(i)));
+			}
+
+			auto invariant = _ctx.bool_val(!state.generators.empty() || state.is_top);
+			if (!state.is_top)
+			{
+				for (const auto & equality : state.equalities)
+				{
+
+					auto lhs = _ctx.int_val(0);
+					for (std::size_t j = 0; j < state.int_arguments.size(); ++j)
+					{
+						if (equality[j] != 0)
+						{
+							lhs = lhs + _ctx.int_val(static_cast<int64_t>(equality[j])) * variables[state.int_arguments[j]];
+						}
+					}
+					invariant = invariant && lhs == _ctx.int_val(static_cast<int64_t>(equality.back()));
+
+				}
+			}
+
+			_invariants.erase(decl);
+			_invariants.emplace(decl, conjecture(invariant.simplify(), variables));
+
+		}
+
+
+		/**
+		 * Extends the affine hull of a relation by a point.
+		 *
+		 * @param decl The declaration of the relation
+		 * @param state The state of the relation
+		 * @param point The point (as data point of a counterexample)
+		 */
+		void add_point(const z3::func_decl & decl, relation_state & state, const datapoint & point)
+		{
+
+			std::vector<std::int64_t> generator;
+			for (auto i : state.int_arguments)
+			{
+				std::int64_t value;
+				if (!Z3_get_numeral_int64(_ctx, point.values[i], &value))
+				{
+					state.is_top = true;
+					break;
+				}
+				generator.push_back(value);
+			}
+
+			// The point has to lie outside of the hull (otherwise the invariant is not exact)
+			bool is_new = state.generators.empty();
+			for (const auto & equality : state.equalities)
+			{
+				__int128 sum = 0;
+				for (std::size_t j = 0; j < generator.size() && !state.is_top; ++j)
+				{
+					sum += __int128(equality[j]) * generator[j];
+				}
+				is_new = is_new || sum != equality.back();
+			}
+
+			if (!state.is_top && is_new)
+			{
+				state.generators.push_back(std::move(generator));
+				state.equalities.clear();
+				state.is_top = !affine_equalities(state.generators, state.int_arguments.size(), state.equalities);
+			}
+			else
+			{
+				state.is_top = true;
+			}
+
+			update_invariant(decl, state);
+
+		}
+
+
+	public:
+
+		/**
+		 * Runs Karr's analysis on a problem.
+		 *
+		 * @param ctx The Z3 context of the problem
+		 * @param p The problem
+		 */
+		karr_analysis(z3::context & ctx, const problem & p)
+			: _ctx(ctx), _number_of_checks(0)
+		{
+
+			for (const auto & decl : p.relations)
+			{
+
+				relation_state state;
+				for (unsigned i = 0; i < decl.arity(); ++i)
+				{
+					if (decl.domain(i).is_int())
+					{
+						state.int_arguments.push_back(i);
+					}
+				}
+
+				update_invariant(decl, state);
+				_states.emplace(decl, std::move(state));
+
+			}
+
+
+			// Extend the hulls until no CHC with right-hand-side is violated
+			bool is_changed = true;
+			while (is_changed)
+			{
+
+				is_changed = false;
+				for (const auto & chc : p.chcs)
+				{
+
+					if (chc.predicates_in_rhs.empty())
+					{
+						continue;
+					}
+
+					const auto decl = chc.predicates_in_rhs.begin()->decl();
+					auto & state = _states.at(decl);
+					while (!state.is_top)
+					{
+
+						++_number_of_checks;
+						auto counterexample = chc_verifier::check_chc(_ctx, chc, _invariants);
+						if (counterexample == nullptr)
+						{
+							break;
+						}
+
+						add_point(decl, state, counterexample->rhs.front());
+						is_changed = true;
+
+					}
+
+				}
+
+			}
+
+		}
+
+
+		/**
+		 * Returns the invariant of every relation (i.e., the conjunction of its affine equalities, false
+		 * if no CHC derives a point of the relation).
+		 *
+		 * @return the invariants
+		 */
+		const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & invariants() const
+		{
+			return _invariants;
+		}
+
+
+		/**
+		 * Returns the linear forms of the equalities of every relation that involve at least two integer
+		 * arguments (each given by one coefficient per argument, the first non-zero one positive), except
+		 * for <em>x + y</em> and <em>x - y</em>, which are attributes anyway.
+		 *
+		 * @return the linear forms of every relation that has any
+		 */
+		linear_form_map linear_forms() const
+		{
+
+			linear_form_map forms;
+			for (const auto & relation : _states)
+			{
+
+				const auto & state = relation.second;
+				if (state.is_top)
+				{
+					continue;
+				}
+
+				std::set<std::vector<int>> relation_forms;
+				for (const auto & equality : state.equalities)
+				{
+
+					std::vector<int> form(relation.first.arity(), 0);
+					unsigned number_of_arguments = 0;
+					bool is_pairwise = true;
+					bool is_representable = true;
+					int sign = 0;
+					for (std::size_t j = 0; j < state.int_arguments.size(); ++j)
+					{
+						if (equality[j] != 0)
+						{
+							sign = sign == 0 ? (equality[j] > 0 ? 1 : -1) : sign;
+							is_representable = is_representable && equality[j] >= -(1 << 15) && equality[j] <= (1 << 15);
+							is_pairwise = is_pairwise && (equality[j] == 1 || equality[j] == -1);
+							form[state.int_arguments[j]] = sign * static_cast<int>(equality[j]);
+							++number_of_arguments;
+						}
+					}
+
+					if (is_representable && number_of_arguments >= 2 && !(is_pairwise && number_of_arguments == 2))
+					{
+						relation_forms.insert(std::move(form));
+					}
+
+				}
+
+				if (!relation_forms.empty())
+				{
+					forms.emplace(relation.first, std::vector<std::vector<int>>(relation_forms.begin(), relation_forms.end()));
+				}
+
+			}
+
+			return forms;
+
+		}
+
+
+		/**
+		 * Returns a copy of a problem in which every CHC assumes the invariants of the relations in its
+		 * left-hand-side, which serves as initial conjecture: the teacher never returns a counterexample
+		 * that violates an invariant, and the learner only has to find what the equalities miss. A
+		 * solution of the returned problem becomes a solution of the original problem by conjoining the
+		 * invariants (see <code>conjoin</code>).
+		 *
+		 * @param p The problem the analysis ran on
+		 *
+		 * @return the strengthened problem
+		 */
+		problem strengthen(const problem & p) const
+		{
+
+			std::vector<constrainted_horn_clause> chcs;
+			chcs.reserve(p.chcs.size());
+			for (const auto & chc : p.chcs)
+			{
+
+				z3::expr_vector assumptions(_ctx);
+				for (const auto & predicate : chc.predicates_in_lhs)
+				{
+
+					const auto & invariant = _invariants.at(predicate.decl());
+					if (!invariant.expr.is_true())
+					{
+						z3::expr_vector arguments(_ctx);
+						for (unsigned i = 0; i < predicate.num_args(); ++i)
+						{
+							arguments.push_back(predicate.arg(i));
+						}
+						auto expr = invariant.expr;
+						assumptions.push_back(expr.substitute(invariant.variables, arguments));
+					}
+
+				}
+
+				auto expr = assumptions.empty() ? chc.expr : z3::implies(z3::mk_and(assumptions), chc.expr);
+				chcs.push_back(constrainted_horn_clause(expr, chc.uninterpreted_predicates, chc.predicates_in_lhs, chc.predicates_in_rhs));
+
+			}
+
+			return problem(decl_set(p.relations), std::move(chcs));
+
+		}
+
+
+		/**
+		 * Conjoins the invariant of every relation to its conjecture. Turns a solution of the problem
+		 * returned by <code>strengthen</code> into a solution of the original problem.
+		 *
+		 * @param conjectures The conjectures
+		 *
+		 * @return the conjectures conjoined with the invariants
+		 */
+		std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> conjoin(const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & conjectures) const
+		{
+
+			std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> result;
+			for (const auto & pair : conjectures)
+			{
+
+				const auto & c = pair.second;
+				auto it = _invariants.find(pair.first);
+				if (it == _invariants.end() || it->second.expr.is_true())
+				{
+					result.emplace(pair.first, c);
+					continue;
+				}
+
+				auto invariant = it->second.expr;
+				result.emplace(pair.first, conjecture((c.expr && invariant.substitute(it->second.variables, c.variables)).simplify(), c.variables));
+
+			}
+
+			return result;
+
+		}
+
+
+		/**
+		 * Returns the number of CHC checks the analysis performed.
+		 *
+		 * @return the number of CHC checks
+		 */
+		unsigned number_of_checks() const
+		{
+			return _number_of_checks;
+		}
+
+	};
+
+}; // End namespace chc_teacher
+
+#endif
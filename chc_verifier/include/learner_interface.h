@@ -7,6 +7,8 @@
 
 // C++ includes
 #include <list>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 #include <iostream>
@@ -25,6 +27,7 @@
 #include "z3_helper.h"
 #include "../../hice-dt/include/datapoint.h"
 #include "datapoint.h"
+#include "relation_descriptor.h"
 #include "api.h"
 #include "dt_to_z3_exp.h"
 #include "pretty_print_visitor.h" // DEBUG
@@ -60,14 +63,11 @@ namespace chc_teacher
 
 		};
 
-		/// ID of relations
-		std::unordered_map<z3::func_decl, unsigned, ASTHasher, ASTComparer> relation2ID;
+		/// ID, first attribute and argument sorts of relations
+		relation_table relation_descriptors;
 
 		std::unordered_map<unsigned, z3::func_decl> categorical_identifier_to_relation;
 
-		/// ID of attributes
-		std::unordered_map<z3::func_decl, unsigned, ASTHasher, ASTComparer> relation_to_base_value;
-
 		std::unordered_map<unsigned, z3::expr> integer_identifier_to_attribute;
 
 		mutable std::unordered_map<chc_teacher::datapoint, horn_verification::datapoint<bool>, datapoint_Hasher, datapoint_Comparer> teacher_datapoint_to_learner_datapoint;
@@ -75,6 +75,9 @@ namespace chc_teacher
 		/// Variables used to construct conjecture expressions
 		std::vector<std::vector<z3::expr>> variables;
 
+		/// Translation of decision trees into conjectures (memoised across rounds)
+		std::unique_ptr<dt_to_z3_exp> conjecture_translator;
+
 		horn_verification::api api_object;
 
 		unsigned categorical_identifier;
@@ -87,8 +90,12 @@ namespace chc_teacher
 		 * Creates a new learner interface (and potentially the learner within in).
 		 *
 		 * @param relations The uninterpreted predicates that need to be learned
+		 * @param do_horndini_prephase Whether to run the Horndini pre-phase
+		 * @param use_bounds Whether to bound the learner
+		 * @param incremental Whether to relearn the decision tree incrementally from the previous round
+		 * @param linear_forms Additional linear attributes of the relations (e.g., computed by karr_analysis)
 		 */
-		learner_interface(const decl_set & relations, bool do_horndini_prephase, bool use_bounds) {
+		learner_interface(const decl_set & relations, bool do_horndini_prephase, bool use_bounds, bool incremental = false, const linear_form_map & linear_forms = linear_form_map()) {
 
 			categorical_identifier = 0;
 
@@ -98,7 +105,7 @@ namespace chc_teacher
 
 			api_object.reserve_datapoint_ptrs(2000);
 
-			api_object.configure_learner(do_horndini_prephase, use_bounds);
+			api_object.configure_learner(do_horndini_prephase, use_bounds, incremental);
 
 			unsigned left;
 
@@ -120,15 +127,12 @@ namespace chc_teacher
 			for (const auto & decl : relations)
 			{
 				//
-				// Assign unique ID to relation
+				// Assign unique ID and first attribute to relation
 				//
-				relation2ID.emplace(decl, categorical_identifier);
+				auto linear_forms_it = linear_forms.find(decl);
+				const auto & descriptor = relation_descriptors.add(decl, integer_identifier, linear_forms_it == linear_forms.end() ? std::vector<std::vector<int>>() : linear_forms_it->second);
 
 				categorical_identifier_to_relation.emplace(categorical_identifier, decl);
-				
-				// TODO: Perhaps we also want to store the arity of each relation so as to easily compute the position of data in a DT data point object
-			
-				relation_to_base_value.emplace(decl, integer_identifier);
 
 				//
 				// Create variables / expression for each argument of the relation
@@ -180,40 +184,57 @@ namespace chc_teacher
 					}
 				}
 
+				//
+				// Adding linear attributes
+				//
+
+				for (const auto & form : descriptor.linear_forms) {
+
+					auto linear_attribute = decl.ctx().int_val(0);
+					for (unsigned i = 0; i < attributes.size(); ++i) {
+						if (form[i] != 0) {
+							linear_attribute = linear_attribute + decl.ctx().int_val(form[i]) * attributes.at(i);
+						}
+					}
+					linear_attribute = linear_attribute.simplify();
+
+					std::stringstream linearAttributeStream;
+					linearAttributeStream << linear_attribute;
+
+					integer_identifier_to_attribute.emplace(integer_identifier++, linear_attribute);
+
+					api_object.add_integer_attribute(linearAttributeStream.str());
+
+				}
+
 				variables.push_back(std::move(attributes));
 				categorical_identifier++;
 				api_object.add_intervals(left, (integer_identifier - 1));
 			}
 
 			api_object.add_categorical_attribute("$func", categorical_identifier);
+
+			conjecture_translator = std::unique_ptr<dt_to_z3_exp>(new dt_to_z3_exp(variables, categorical_identifier_to_relation, integer_identifier_to_attribute));
 		}
 
 	horn_verification::datapoint<bool>* get_unique_learner_datapoint(const chc_teacher::datapoint &teacher_datapoint) const {
 
-		if (teacher_datapoint_to_learner_datapoint.find(teacher_datapoint) == teacher_datapoint_to_learner_datapoint.end()) { 
+		auto it = teacher_datapoint_to_learner_datapoint.find(teacher_datapoint);
 
-			horn_verification::datapoint<bool> current_learner_datapoint(api_object.index_of_datapoint_ptrs());
-			
-			current_learner_datapoint._int_data = teacher_datapoint.get_int_data(relation_to_base_value, integer_identifier);
-				
-			current_learner_datapoint._categorical_data = teacher_datapoint.get_categorical_data(relation2ID);
-				
-			teacher_datapoint_to_learner_datapoint.emplace(teacher_datapoint, current_learner_datapoint);
+		if (it == teacher_datapoint_to_learner_datapoint.end()) {
 
-			//assert (teacher_datapoint_to_learner_datapoint.find(teacher_datapoint)->second._categorical_data.size() == 1);
+			horn_verification::datapoint<bool> current_learner_datapoint(api_object.index_of_datapoint_ptrs());
 
-			if (teacher_datapoint_to_learner_datapoint.find(teacher_datapoint)->second._identifier == api_object.index_of_datapoint_ptrs()) {
+			current_learner_datapoint._int_data.assign(integer_identifier, 0);
 
-			// This portion to re investigate why the teacher_datapoint is mapping to an existing learner_datapoint
-			// Hopefully there will be an unused datapoint
+			teacher_datapoint.to_learner_datapoint(relation_descriptors[teacher_datapoint.predicate], current_learner_datapoint);
 
-			// Some one can check whether teacher_datapoint_to_learner_datapoint can be a pair or vectors rather than a Map
+			it = teacher_datapoint_to_learner_datapoint.emplace(teacher_datapoint, std::move(current_learner_datapoint)).first;
 
-				api_object.add_datapoints(teacher_datapoint_to_learner_datapoint.find(teacher_datapoint)->second);
-			}
+			api_object.add_datapoints(it->second);
 		}
 
-		return &teacher_datapoint_to_learner_datapoint.find(teacher_datapoint)->second;
+		return &it->second;
 	}
 
 
@@ -325,9 +346,43 @@ namespace chc_teacher
 
 			//std::cout << "Hi" << std::endl;
 
-			dt_to_z3_exp map_dt_z3(variables, categorical_identifier_to_relation, integer_identifier_to_attribute);
+			return conjecture_translator->get_unordered_map(decision_tree.root());
+		}
+
+		/**
+		 * Returns, for every uninterpreted predicate, whether its conjecture has changed in the
+		 * most recent call of get_conjectures() compared to the call before.
+		 *
+		 * @return a map that maps declarations of the uninterpreted predicates to whether their
+		 *         conjecture has changed
+		 */
+		const std::unordered_map<z3::func_decl, bool, ASTHasher, ASTComparer> & changed_conjectures() const
+		{
+			return conjecture_translator->changed();
+		}
+		
+		/**
+		 * Returns the number of nodes the learner reused from the previous tree and the number
+		 * of nodes it built from scratch in the most recent call of get_conjectures().
+		 *
+		 * @return a pair (reused nodes, rebuilt nodes)
+		 */
+		std::pair<std::size_t, std::size_t> last_round_statistics() const
+		{
+			const auto & statistics = api_object.get_round_statistics();
+			return statistics.empty() ? std::make_pair<std::size_t, std::size_t>(0, 0) : statistics.back();
+		}
 
-			return map_dt_z3.get_unordered_map(decision_tree.root());
+		/**
+		 * Returns the bound (or 0 if no bound is used) and the time in seconds of every run of
+		 * the learner in the most recent call of get_conjectures().
+		 *
+		 * @return a vector of pairs (bound, time), one pair per run
+		 */
+		std::vector<std::pair<int, double>> last_round_bound_times() const
+		{
+			const auto & bound_times = api_object.get_round_bound_times();
+			return bound_times.empty() ? std::vector<std::pair<int, double>>() : bound_times.back();
 		}
 
 	};
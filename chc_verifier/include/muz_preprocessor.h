@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __CHCTEACHER_MUZ_PREPROCESSOR_H__
+#define __CHCTEACHER_MUZ_PREPROCESSOR_H__
+
+// C++ includes
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "conjecture.h"
+#include "z3_helper.h"
+
+
+namespace chc_teacher
+{
+
+	/**
+	 * This class simplifies the rules of a CHC problem with the rule transformers of Z3's datalog
+	 * engine (see <code>muz/transforms</code>) before the problem is passed to the learner and maps the
+	 * conjectures learned for the simplified problem back to the relations of the original problem.
+	 *
+	 * The preprocessor works on the rules and queries as read from the file (i.e., before 0-ary
+	 * relations are replaced by 1-ary relations, see <code>seahorn_smtlib2_parser</code>). Each transformer
+	 * registers a model converter with the datalog context, which rebuilds the interpretation of the
+	 * original relations from an interpretation of the simplified relations. The mapped conjectures
+	 * can contain quantifiers (e.g., the definition of an inlined relation).
+	 *
+	 * The implementation uses Z3's internal API and lives in <code>muz_preprocessor.cpp</code>.
+	 *
+	 * @version 1.0
+	 */
+	class muz_preprocessor
+	{
+
+	public:
+
+		/**
+		 * The transformers to run (Z3 orders them by their priority, which is coi, karr, inline, subsumption, slice).
+		 *
+		 * <code>mk_unfold</code> is not offered: it registers no model converter, and a conjecture that is
+		 * inductive for the unfolded rules need not be inductive for the original ones.
+		 */
+		struct options
+		{
+
+			/// Removes rules of relations that are not reachable from a fact or cannot reach a query (<code>mk_coi_filter</code>)
+			bool coi = false;
+
+			/// Inlines relations (<code>mk_rule_inliner</code>)
+			bool inline_rules = false;
+
+			/// Removes rules subsumed by other rules (<code>mk_subsumption_checker</code>)
+			bool subsumption = false;
+
+			/// Removes arguments of relations that do not influence the queries (<code>mk_slice</code>)
+			bool slice = false;
+
+			/// Strengthens the bodies of the rules with the invariants of Karr's analysis, which are conjoined to the mapped conjectures (<code>mk_karr_invariants</code>)
+			bool karr = false;
+
+
+			/**
+			 * Returns whether any transformer is to be run.
+			 *
+			 * @return whether any transformer is to be run
+			 */
+			bool any() const
+			{
+				return coi || inline_rules || subsumption || slice || karr;
+			}
+
+		};
+
+
+	private:
+
+		/// The internal state (datalog context and model converter)
+		class impl;
+
+		/// The internal state
+		std::unique_ptr<impl> _impl;
+
+
+	public:
+
+		/**
+		 * Creates a new preprocessor.
+		 *
+		 * @param ctx The Z3 context of the rules and queries
+		 * @param opts The transformers to run
+		 */
+		muz_preprocessor(z3::context & ctx, const options & opts);
+
+
+		~muz_preprocessor();
+
+
+		muz_preprocessor(const muz_preprocessor &) = delete;
+
+		muz_preprocessor & operator=(const muz_preprocessor &) = delete;
+
+
+		/**
+		 * Runs the transformers on the given rules and queries and replaces them with the resulting
+		 * rules and queries. Every query has to be an application of a relation. Can only be called once.
+		 *
+		 * @param rules The rules (as returned by <code>Z3_fixedpoint_get_rules</code>)
+		 * @param queries The queries
+		 */
+		void transform(z3::expr_vector & rules, z3::expr_vector & queries);
+
+
+		/**
+		 * Maps conjectures of the relations of the transformed problem to conjectures of the relations
+		 * of the original problem. Both are keyed by the relations as they appear in the respective
+		 * <code>problem</code> (i.e., with 0-ary relations replaced by 1-ary relations). Relations of the
+		 * original problem that the transformers do not define are conjectured to be true.
+		 *
+		 * @param conjectures The conjectures of the relations of the transformed problem
+		 * @param relations The relations of the original problem
+		 *
+		 * @return the conjectures of the relations of the original problem
+		 */
+		std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> map_back(const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & conjectures, const decl_set & relations) const;
+
+
+		/**
+		 * Returns the number of rules before and after the transformation.
+		 *
+		 * @return a pair consisting of the number of rules before and after the transformation
+		 */
+		std::pair<unsigned, unsigned> number_of_rules() const;
+
+	};
+
+}; // End namespace chc_teacher
+
+#endif
@@ -0,0 +1,408 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __CHCTEACHER_PARALLEL_CHC_VERIFIER_H__
+#define __CHCTEACHER_PARALLEL_CHC_VERIFIER_H__
+
+// C++ includes
+#include <exception>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "chc.h"
+#include "chc_verifier.h"
+#include "conjecture.h"
+#include "datapoint.h"
+#include "horn_counterexample.h"
+#include "incremental_chc_solver.h"
+#include "problem.h"
+#include "z3_helper.h"
+
+
+namespace chc_teacher
+{
+
+	/**
+	 * This class checks a number of CHCs of a problem against the same conjectures in parallel.
+	 *
+	 * Since a z3 context must not be used by more than one thread at a time, every worker thread has
+	 * a context of its own, into which the CHCs are translated once (when the verifier is created) and
+	 * the conjectures are translated before every check. Every CHC is bound to a fixed worker (the CHC
+	 * with index i in the problem to the worker i mod n), which checks the CHCs bound to it one after
+	 * another, while the workers run in parallel. Thus, every context is only used by one thread at a
+	 * time and the queries a context sees do not depend on the timing of the threads, which keeps the
+	 * counterexamples (z3 may return different models in different contexts) deterministic. The
+	 * counterexamples are translated back into the context of the problem and returned in the order of
+	 * the CHCs.
+	 *
+	 * With a single worker, the CHCs are checked in the context of the problem, one after another.
+	 *
+	 * Optionally, every CHC is checked with a solver that is kept for the whole run (see
+	 * incremental_chc_solver) instead of a new solver per check. A CHC has exactly one such solver,
+	 * which lives in the context the CHC is checked in (the context of the problem or the context of
+	 * the worker the CHC is bound to).
+	 *
+	 * Moreover, up to a given number of counterexamples can be extracted for every CHC that is not
+	 * satisfied (see chc_verifier::extract_counterexamples).
+	 *
+	 * @version 1.0
+	 */
+	class parallel_chc_verifier
+	{
+
+		/**
+		 * The state of a worker thread.
+		 */
+		struct worker
+		{
+
+			/// The context of the worker
+			std::unique_ptr<z3::context> ctx;
+
+			/// The CHCs of the problem translated into the context of the worker (in the order of the problem)
+			std::vector<constrainted_horn_clause> chcs;
+
+			/// For every CHC, the predicates of its left-hand-side (in the order of the CHC of the problem)
+			std::vector<std::vector<z3::expr>> predicates_in_lhs;
+
+			/// For every CHC, the predicates of its right-hand-side (in the order of the CHC of the problem)
+			std::vector<std::vector<z3::expr>> predicates_in_rhs;
+
+			/// The substitution of the conjectures of the current round (translated into the context of the worker)
+			std::unique_ptr<predicate_substitution> substitution;
+
+		};
+
+
+		/// The context of the problem
+		z3::context & _ctx;
+
+		/// The problem
+		const problem & _problem;
+
+		/// Whether to check CHCs with incremental solvers
+		bool _use_incremental_solvers;
+
+		/// The maximal number of counterexamples to extract per CHC
+		unsigned _number_of_counterexamples;
+
+		/// The substitution of the conjectures of the current round (if the CHCs are checked sequentially)
+		predicate_substitution _substitution;
+
+		/// The workers (empty if the CHCs are checked sequentially)
+		std::vector<worker> _workers;
+
+		/// For every CHC, its incremental solver in the context the CHC is checked in (if created yet; declared after the workers, so that the solvers are destroyed before the contexts of the workers)
+		std::vector<std::unique_ptr<incremental_chc_solver>> _solvers;
+
+
+		/**
+		 * Translates an expression into another context.
+		 *
+		 * @param e The expression
+		 * @param target The context to translate to
+		 *
+		 * @return the translated expression
+		 */
+		static z3::expr translate(const z3::expr & e, z3::context & target)
+		{
+			auto result = Z3_translate(e.ctx(), e, target);
+			target.check_error();
+			return z3::expr(target, result);
+		}
+
+
+		/**
+		 * Translates a declaration into another context.
+		 *
+		 * @param f The declaration
+		 * @param target The context to translate to
+		 *
+		 * @return the translated declaration
+		 */
+		static z3::func_decl translate(const z3::func_decl & f, z3::context & target)
+		{
+			auto result = Z3_translate(f.ctx(), f, target);
+			target.check_error();
+			return z3::func_decl(target, Z3_to_func_decl(target, result));
+		}
+
+
+		/**
+		 * Translates a set of predicates into another context, preserving their order.
+		 *
+		 * @param predicates The predicates
+		 * @param target The context to translate to
+		 *
+		 * @return the translated predicates
+		 */
+		static std::vector<z3::expr> translate(const expr_set & predicates, z3::context & target)
+		{
+			std::vector<z3::expr> result;
+			result.reserve(predicates.size());
+			for (const auto & pred : predicates)
+			{
+				result.push_back(translate(pred, target));
+			}
+
+			return result;
+		}
+
+
+		/**
+		 * Translates a data point into another context.
+		 *
+		 * @param dp The data point
+		 * @param target The context to translate to
+		 *
+		 * @return the translated data point
+		 */
+		static datapoint translate(const datapoint & dp, z3::context & target)
+		{
+			std::vector<z3::expr> values;
+			values.reserve(dp.values.size());
+			for (const auto & v : dp.values)
+			{
+				values.push_back(translate(v, target));
+			}
+
+			return datapoint(translate(dp.predicate, target), std::move(values));
+		}
+
+
+		/**
+		 * Translates a set of CHCs into the context of a worker.
+		 *
+		 * @param w The worker
+		 * @param chcs The CHCs
+		 */
+		static void translate_chcs(worker & w, const std::vector<constrainted_horn_clause> & chcs)
+		{
+			auto & target = *w.ctx;
+			w.chcs.reserve(chcs.size());
+
+			for (const auto & chc : chcs)
+			{
+
+				decl_set uninterpreted_predicates;
+				for (const auto & decl : chc.uninterpreted_predicates)
+				{
+					uninterpreted_predicates.insert(translate(decl, target));
+				}
+
+				auto lhs = translate(chc.predicates_in_lhs, target);
+				auto rhs = translate(chc.predicates_in_rhs, target);
+
+				w.chcs.emplace_back(translate(chc.expr, target), uninterpreted_predicates, expr_set(lhs.begin(), lhs.end()), expr_set(rhs.begin(), rhs.end()));
+				w.predicates_in_lhs.push_back(std::move(lhs));
+				w.predicates_in_rhs.push_back(std::move(rhs));
+
+			}
+		}
+
+
+		/**
+		 * Checks a CHC, either with a new solver or with its incremental solver (which is created if necessary).
+		 *
+		 * @param ctx The context of the CHC and the conjectures
+		 * @param chc The CHC
+		 * @param solver The incremental solver of the CHC (or nullptr if not created yet)
+		 * @param substitution The substitution of the conjectures
+		 * @param predicates_in_lhs The predicates of the left-hand-side of the CHC
+		 * @param predicates_in_rhs The predicates of the right-hand-side of the CHC
+		 *
+		 * @return the counterexamples (empty if the CHC is satisfied)
+		 */
+		template <class Predicates>
+		std::vector<std::unique_ptr<horn_counterexample>> check_chc(z3::context & ctx, const constrainted_horn_clause & chc, std::unique_ptr<incremental_chc_solver> & solver, predicate_substitution & substitution, const Predicates & predicates_in_lhs, const Predicates & predicates_in_rhs) const
+		{
+			if (!_use_incremental_solvers)
+			{
+				return chc_verifier::check_chc(ctx, chc, substitution, predicates_in_lhs, predicates_in_rhs, _number_of_counterexamples);
+			}
+
+			if (solver == nullptr)
+			{
+				solver = std::unique_ptr<incremental_chc_solver>(new incremental_chc_solver(ctx, chc));
+			}
+
+			return solver->check(substitution, predicates_in_lhs, predicates_in_rhs, _number_of_counterexamples);
+		}
+
+
+	public:
+
+		/**
+		 * Creates a new verifier.
+		 *
+		 * @param ctx The context of the problem
+		 * @param p The problem
+		 * @param number_of_workers The number of worker threads (if at most 1, CHCs are checked sequentially)
+		 * @param use_incremental_solvers Whether to keep one incremental solver per CHC
+		 * @param number_of_counterexamples The maximal number of counterexamples to extract per CHC
+		 */
+		parallel_chc_verifier(z3::context & ctx, const problem & p, unsigned number_of_workers, bool use_incremental_solvers = false, unsigned number_of_counterexamples = 1)
+			: _ctx(ctx), _problem(p), _use_incremental_solvers(use_incremental_solvers), _number_of_counterexamples(number_of_counterexamples), _substitution(ctx), _solvers(p.chcs.size())
+		{
+
+			if (number_of_workers > 1)
+			{
+
+				_workers.resize(number_of_workers);
+				for (auto & w : _workers)
+				{
+					w.ctx = std::unique_ptr<z3::context>(new z3::context());
+					w.substitution = std::unique_ptr<predicate_substitution>(new predicate_substitution(*w.ctx));
+					translate_chcs(w, p.chcs);
+				}
+
+			}
+
+		}
+
+
+		/**
+		 * Checks CHCs of the problem against conjectures.
+		 *
+		 * @param chc_indices The indices of the CHCs to check (in the CHCs of the problem)
+		 * @param conjectures The conjectures (in the context of the problem)
+		 *
+		 * @return for every CHC to check, the counterexamples in the context of the problem (empty if
+		 *         the CHC is satisfied)
+		 */
+		std::vector<std::vector<std::unique_ptr<horn_counterexample>>> check_chcs(const std::vector<std::size_t> & chc_indices, const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & conjectures)
+		{
+
+			std::vector<std::vector<std::unique_ptr<horn_counterexample>>> counterexamples(chc_indices.size());
+
+			//
+			// Check sequentially
+			//
+			if (_workers.empty())
+			{
+
+				for (const auto & pair : conjectures)
+				{
+					_substitution.add(pair.first, pair.second.expr, pair.second.variables);
+				}
+
+				for (std::size_t i = 0; i < chc_indices.size(); ++i)
+				{
+					const auto & chc = _problem.chcs[chc_indices[i]];
+					counterexamples[i] = check_chc(_ctx, chc, _solvers[chc_indices[i]], _substitution, chc.predicates_in_lhs, chc.predicates_in_rhs);
+				}
+
+				return counterexamples;
+
+			}
+
+
+			//
+			// Translate conjectures into the contexts of the workers (which reads the context of the problem and, hence, has to be done sequentially)
+			//
+			for (auto & w : _workers)
+			{
+
+				for (const auto & pair : conjectures)
+				{
+
+					z3::expr_vector variables(*w.ctx);
+					for (unsigned i = 0; i < pair.second.variables.size(); ++i)
+					{
+						variables.push_back(translate(pair.second.variables[i], *w.ctx));
+					}
+
+					w.substitution->add(translate(pair.first, *w.ctx), translate(pair.second.expr, *w.ctx), variables);
+
+				}
+
+			}
+
+
+			//
+			// Check CHCs in parallel (every worker checks the CHCs bound to it, in the order of the CHCs to check)
+			//
+			const auto number_of_workers = _workers.size();
+			std::vector<std::exception_ptr> errors(chc_indices.size());
+
+			#pragma omp parallel for schedule(dynamic, 1) num_threads(number_of_workers)
+			for (std::size_t worker_index = 0; worker_index < number_of_workers; ++worker_index)
+			{
+
+				auto & w = _workers[worker_index];
+
+				for (std::size_t i = 0; i < chc_indices.size(); ++i)
+				{
+
+					const auto index = chc_indices[i];
+					if (index % number_of_workers != worker_index)
+					{
+						continue;
+					}
+
+					try
+					{
+						counterexamples[i] = check_chc(*w.ctx, w.chcs[index], _solvers[index], *w.substitution, w.predicates_in_lhs[index], w.predicates_in_rhs[index]);
+					}
+					catch (...)
+					{
+						errors[i] = std::current_exception();
+					}
+
+				}
+
+			}
+
+			// Report the first error (in the order of the CHCs)
+			for (const auto & error : errors)
+			{
+				if (error)
+				{
+					std::rethrow_exception(error);
+				}
+			}
+
+
+			//
+			// Translate counterexamples back into the context of the problem
+			//
+			for (auto & chc_counterexamples : counterexamples)
+			{
+
+				for (auto & ce : chc_counterexamples)
+				{
+
+					std::list<datapoint> lhs;
+					for (const auto & dp : ce->lhs)
+					{
+						lhs.push_back(translate(dp, _ctx));
+					}
+
+					std::list<datapoint> rhs;
+					for (const auto & dp : ce->rhs)
+					{
+						rhs.push_back(translate(dp, _ctx));
+					}
+
+					ce = std::make_unique<horn_counterexample>(std::move(lhs), std::move(rhs));
+
+				}
+
+			}
+
+			return counterexamples;
+
+		}
+
+	};
+
+}; // End namespace chc_teacher
+
+#endif
@@ -0,0 +1,165 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __CHCTEACHER_RELATION_DESCRIPTOR_H__
+#define __CHCTEACHER_RELATION_DESCRIPTOR_H__
+
+// C++ includes
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "z3_helper.h"
+
+
+namespace chc_teacher
+{
+
+	/// Additional linear attributes of relations, each given by one coefficient per argument of the relation (see karr_analysis)
+	typedef std::unordered_map<z3::func_decl, std::vector<std::vector<int>>, ASTHasher, ASTComparer> linear_form_map;
+
+
+	/**
+	 * Describes how the data points of a relation (i.e., an uninterpreted predicate) are encoded
+	 * as learner data points: the value of the categorical attribute, the first integer attribute,
+	 * the sorts of the arguments (which determine the derived attributes) and the additional linear
+	 * attributes.
+	 *
+	 * @version 1.0
+	 */
+	struct relation_descriptor
+	{
+
+		/// The value of the categorical attribute "$func" of the relation
+		unsigned id;
+
+		/// The first integer attribute of the relation
+		unsigned base;
+
+		/// The number of arguments of the relation
+		unsigned arity;
+
+		/// The sort kinds of the arguments of the relation
+		std::vector<Z3_sort_kind> argument_sorts;
+
+		/// The coefficients (one per argument) of the additional linear attributes of the relation, which follow the derived attributes
+		std::vector<std::vector<int>> linear_forms;
+
+	};
+
+
+	/**
+	 * This class maps the declarations of relations to their descriptors. The descriptors are
+	 * stored in one vector (indexed by the id of the relation), and a declaration is looked up by
+	 * the (unique) id z3 assigns to it in a second vector, so a look-up neither hashes nor compares
+	 * z3 objects.
+	 *
+	 * @version 1.0
+	 */
+	class relation_table
+	{
+
+		/// The descriptors of the relations, indexed by their id
+		std::vector<relation_descriptor> _descriptors;
+
+		/// The smallest z3 id of the declaration of a relation
+		unsigned _first_decl_id;
+
+		/// For every z3 id of a declaration (minus _first_decl_id), the id of the relation it declares plus 1 (or 0 if it does not declare a relation)
+		std::vector<unsigned> _relation_of_decl;
+
+	public:
+
+		/**
+		 * Creates an empty table.
+		 */
+		relation_table()
+			: _first_decl_id(0)
+		{
+			// Nothing
+		}
+
+
+		/**
+		 * Adds a relation. The id of the relation is the number of relations added before.
+		 *
+		 * @param decl The declaration of the relation
+		 * @param base The first integer attribute of the relation
+		 * @param linear_forms The additional linear attributes of the relation
+		 *
+		 * @return the descriptor of the relation
+		 */
+		const relation_descriptor & add(const z3::func_decl & decl, unsigned base, const std::vector<std::vector<int>> & linear_forms = std::vector<std::vector<int>>())
+		{
+			relation_descriptor descriptor;
+			descriptor.id = _descriptors.size();
+			descriptor.base = base;
+			descriptor.linear_forms = linear_forms;
+			descriptor.arity = decl.arity();
+			descriptor.argument_sorts.reserve(decl.arity());
+			for (unsigned i = 0; i < decl.arity(); ++i)
+			{
+				descriptor.argument_sorts.push_back(decl.domain(i).sort_kind());
+			}
+
+			// z3 numbers declarations consecutively (but not from 0), so the ids of the relations are close to each other
+			const auto decl_id = Z3_get_func_decl_id(decl.ctx(), decl);
+			if (_relation_of_decl.empty())
+			{
+				_first_decl_id = decl_id;
+			}
+			else if (decl_id < _first_decl_id)
+			{
+				_relation_of_decl.insert(_relation_of_decl.begin(), _first_decl_id - decl_id, 0);
+				_first_decl_id = decl_id;
+			}
+			if (decl_id - _first_decl_id >= _relation_of_decl.size())
+			{
+				_relation_of_decl.resize(decl_id - _first_decl_id + 1, 0);
+			}
+			_relation_of_decl[decl_id - _first_decl_id] = descriptor.id + 1;
+
+			_descriptors.push_back(std::move(descriptor));
+			return _descriptors.back();
+		}
+
+
+		/**
+		 * Returns the descriptor of a relation.
+		 *
+		 * @param decl The declaration of the relation
+		 *
+		 * @return the descriptor of the relation
+		 */
+		const relation_descriptor & operator[](const z3::func_decl & decl) const
+		{
+			const auto decl_id = Z3_get_func_decl_id(decl.ctx(), decl);
+			if (decl_id < _first_decl_id || decl_id - _first_decl_id >= _relation_of_decl.size() || _relation_of_decl[decl_id - _first_decl_id] == 0)
+			{
+				throw std::runtime_error("Unknown relation");
+			}
+
+			return _descriptors[_relation_of_decl[decl_id - _first_decl_id] - 1];
+		}
+
+
+		/**
+		 * Returns the number of relations.
+		 *
+		 * @return the number of relations
+		 */
+		inline std::size_t size() const
+		{
+			return _descriptors.size();
+		}
+
+	};
+
+}; // End namespace chc_teacher
+
+#endif
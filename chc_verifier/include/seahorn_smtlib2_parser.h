@@ -28,6 +28,20 @@ namespace chc_teacher
 
 	public:
 
+		/**
+		 * Returns the 1-ary relation <em>R'</em> that replaces a 0-ary relation <em>R</em>.
+		 *
+		 * @param ctx The Z3 context to use
+		 * @param decl The declaration of the 0-ary relation
+		 *
+		 * @return the declaration of the 1-ary relation
+		 */
+		static z3::func_decl unary_relation(z3::context & ctx, const z3::func_decl & decl)
+		{
+			return ctx.function((decl.name().str() + "@").c_str(), ctx.bool_sort(), decl.range());
+		}
+
+
 		/**
 		 * Replaces every occurrence of an application of a 0-ary relation <em>R</em> with
 		 * the application of a new 1-ary relation <em>R'(true)</em> in a vector of expressions.
@@ -100,7 +114,7 @@ namespace chc_teacher
 					// 0-ary relation. Replace with 1-ary relation and record.
 					if (decl.arity() == 0 && old2new_relations.count(decl) == 0)
 					{
-						auto new_decl = ctx.function((decl.name().str() + "@").c_str(), ctx.bool_sort(), decl.range());
+						auto new_decl = unary_relation(ctx, decl);
 						old2new_relations.emplace(decl, new_decl);
 						relations.insert(new_decl);
 					}
@@ -216,7 +230,60 @@ namespace chc_teacher
 		}
 		
 		
+		/**
+		 * Reads the rules and queries of a file.
+		 *
+		 * @param ctx The Z3 context to use
+		 * @param filename The file to read
+		 * @param z3_rules The vector to which to add the rules
+		 * @param z3_queries The vector to which to add the queries
+		 */
+		static void read(z3::context & ctx, const std::string & filename, z3::expr_vector & z3_rules, z3::expr_vector & z3_queries)
+		{
+
+			z3::fixedpoint fp(ctx);
+			Z3_ast_vector r = Z3_fixedpoint_from_file(ctx, fp, filename.c_str());
+			// std::cout << fp << std::endl;
+			fp.check_error();
+
+			auto queries = z3::expr_vector(ctx, r);
+			for (unsigned i = 0; i < queries.size(); ++i)
+			{
+				z3_queries.push_back(queries[i]);
+			}
+
+			auto rules = fp.rules();
+			for (unsigned i = 0; i < rules.size(); ++i)
+			{
+				z3_rules.push_back(rules[i]);
+			}
+
+		}
+
+
 		static problem parse(z3::context & ctx, const std::string & filename)
+		{
+
+			z3::expr_vector z3_rules(ctx);
+			z3::expr_vector z3_queries(ctx);
+			read(ctx, filename, z3_rules, z3_queries);
+
+			return parse(ctx, z3_rules, z3_queries);
+
+		}
+
+
+		/**
+		 * Creates a problem from rules and queries (as read by <code>read()</code> or transformed by the
+		 * <code>muz_preprocessor</code>).
+		 *
+		 * @param ctx The Z3 context to use
+		 * @param z3_rules The rules
+		 * @param z3_queries The queries
+		 *
+		 * @return the problem
+		 */
+		static problem parse(z3::context & ctx, const z3::expr_vector & z3_rules, const z3::expr_vector & z3_queries)
 		{
 			
 			//
@@ -227,21 +294,11 @@ namespace chc_teacher
 			std::vector<constrainted_horn_clause> chcs;
 
 			
-			//
-			// Parse from file
-			//
-			z3::fixedpoint fp(ctx);
-			Z3_ast_vector r = Z3_fixedpoint_from_file(ctx, fp, filename.c_str());
-			// std::cout << fp << std::endl;
-			fp.check_error();
-			auto z3_queries = z3::expr_vector(ctx, r);
-			
-			
 			//
 			// Preprocess expressions (i.e., record all relations and substitute
 			// 0-ary relations with 1-ary relations).
 			//
-			auto rules = preprocess_expressions(ctx, fp.rules(), relations);
+			auto rules = preprocess_expressions(ctx, z3_rules, relations);
 			auto queries = preprocess_expressions(ctx, z3_queries, relations);
 			// std::cout << std::endl << "Read " << rules.size() << " rules and " << queries.size() << " queries (" << z3_queries.size() << ")" << std::endl;
 						
@@ -336,16 +393,16 @@ namespace chc_teacher
 				}
 				
 				//
-				// Rule is a forall expression
+				// Rule is a forall expression (or an implication without variables, as produced by the muz_preprocessor)
 				//
-				else if(expr.is_quantifier() && Z3_is_quantifier_forall(ctx, expr))
+				else if((expr.is_quantifier() && Z3_is_quantifier_forall(ctx, expr)) || (expr.is_app() && expr.decl().decl_kind() == Z3_decl_kind::Z3_OP_IMPLIES))
 				{
 
 					//
 					// Prepare some variables
 					//
 					// Total number of quantifier variables
-					unsigned num_vars = Z3_get_quantifier_num_bound(ctx, expr);
+					unsigned num_vars = expr.is_quantifier() ? Z3_get_quantifier_num_bound(ctx, expr) : 0;
 					// Set of uninterpreted predicates occurring in the CHC
 					decl_set chc_declarations;
 			
@@ -358,7 +415,7 @@ namespace chc_teacher
 					{
 						new_constants.push_back(ctx.constant(ctx.int_symbol(constant_id++), z3::sort(ctx, Z3_get_quantifier_bound_sort(ctx, expr, num_vars - i - 1))));
 					}
-					auto body = expr.body().substitute(new_constants);
+					auto body = expr.is_quantifier() ? expr.body().substitute(new_constants) : expr;
 			
 			
 					//
@@ -9,6 +9,7 @@
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // C includes
 #include <cassert>
@@ -162,6 +163,227 @@ namespace chc_teacher
 
 	};
 
+
+	/**
+	 * This class substitutes expressions for all applications of a set of uninterpreted functions
+	 * in a single traversal of an expression (in contrast to z3_helper::substitute(), which traverses
+	 * the expression once per function).
+	 *
+	 * The functions and the expressions to substitute are registered with add(). The traversal
+	 * works on the C API of z3 and caches the substituted subexpressions in vectors indexed by the
+	 * ids z3 assigns to expressions. The cache is only valid within one call of apply() (a call
+	 * invalidates the entries of the previous one by increasing a generation counter), whereas the
+	 * memory of the vectors is reused across calls. Subexpressions that contain no application of a
+	 * registered function are not rebuilt.
+	 *
+	 * @version 1.0
+	 */
+	class predicate_substitution
+	{
+
+		/**
+		 * An expression to substitute for the applications of a function.
+		 */
+		struct entry
+		{
+
+			/// The expression to substitute
+			z3::expr body;
+
+			/// The variables of the expression (which are replaced by the arguments of an application)
+			z3::expr_vector variables;
+
+			/// The variables of the expression as an array
+			std::vector<Z3_ast> variable_asts;
+
+		};
+
+		/// The context
+		z3::context & _ctx;
+
+		/// The substitution, indexed by the ids of the functions
+		std::unordered_map<unsigned, entry> _entries;
+
+		/// For every id of an expression, the call of apply() in which it was last substituted
+		std::vector<unsigned> _generation_of;
+
+		/// For every id of an expression, the index of its substitution in _results
+		std::vector<unsigned> _result_of;
+
+		/// The number of the current call of apply()
+		unsigned _generation;
+
+		/// The substituted subexpressions of the current call of apply() (which hold references to them)
+		std::vector<z3::expr> _results;
+
+		/// The worklist of the traversal
+		std::vector<Z3_ast> _worklist;
+
+		/// Buffer for the substituted arguments of an application
+		std::vector<Z3_ast> _arguments;
+
+
+		/**
+		 * Returns whether an expression has been substituted in the current call of apply().
+		 *
+		 * @param id The id of the expression
+		 *
+		 * @return whether the expression has been substituted
+		 */
+		inline bool is_substituted(unsigned id) const
+		{
+			return id < _generation_of.size() && _generation_of[id] == _generation;
+		}
+
+
+		/**
+		 * Records the substitution of an expression.
+		 *
+		 * @param id The id of the expression
+		 * @param result The substituted expression
+		 */
+		void record(unsigned id, Z3_ast result)
+		{
+			if (id >= _generation_of.size())
+			{
+				_generation_of.resize(id + 1, 0);
+				_result_of.resize(id + 1);
+			}
+
+			_generation_of[id] = _generation;
+			_result_of[id] = _results.size();
+			_results.push_back(z3::expr(_ctx, result));
+		}
+
+
+	public:
+
+		/**
+		 * Creates an empty substitution.
+		 *
+		 * @param ctx The context of the expressions
+		 */
+		explicit predicate_substitution(z3::context & ctx)
+			: _ctx(ctx), _generation(0)
+		{
+			// Nothing
+		}
+
+
+		/**
+		 * Registers the expression to substitute for the applications of a function.
+		 *
+		 * @param f The function
+		 * @param h The expression to substitute
+		 * @param variables The variables of h, which are replaced by the arguments of an application of f
+		 */
+		void add(const z3::func_decl & f, const z3::expr & h, const z3::expr_vector & variables)
+		{
+			assert (variables.size() == f.arity());
+
+			entry e { h, variables, std::vector<Z3_ast>() };
+			for (unsigned i = 0; i < variables.size(); ++i)
+			{
+				e.variable_asts.push_back(variables[i]);
+			}
+
+			_entries.erase(Z3_get_func_decl_id(_ctx, f));
+			_entries.emplace(Z3_get_func_decl_id(_ctx, f), std::move(e));
+		}
+
+
+		/**
+		 * Substitutes the registered expressions for all applications of the registered functions in an expression.
+		 *
+		 * @param e The expression (which must not contain quantifiers)
+		 *
+		 * @return the expression after the substitution
+		 */
+		z3::expr apply(const z3::expr & e)
+		{
+
+			++_generation;
+			_results.clear();
+			_worklist.clear();
+			_worklist.push_back(e);
+
+			while (!_worklist.empty())
+			{
+
+				auto cur = _worklist.back();
+				auto id = Z3_get_ast_id(_ctx, cur);
+				if (is_substituted(id))
+				{
+					_worklist.pop_back();
+					continue;
+				}
+
+				// We can only handle AST types AST_APP and numerals (as they are the only ones that should occur in our setting)
+				if (Z3_get_ast_kind(_ctx, cur) == Z3_NUMERAL_AST)
+				{
+					record(id, cur);
+					_worklist.pop_back();
+					continue;
+				}
+				assert (Z3_get_ast_kind(_ctx, cur) == Z3_APP_AST);
+				auto app = Z3_to_app(_ctx, cur);
+				auto num_args = Z3_get_app_num_args(_ctx, app);
+
+				// Substitute the arguments first
+				bool arguments_substituted = true;
+				for (unsigned i = 0; i < num_args; ++i)
+				{
+					auto arg = Z3_get_app_arg(_ctx, app, i);
+					if (!is_substituted(Z3_get_ast_id(_ctx, arg)))
+					{
+						_worklist.push_back(arg);
+						arguments_substituted = false;
+					}
+				}
+				if (!arguments_substituted)
+				{
+					continue;
+				}
+				_worklist.pop_back();
+
+				_arguments.clear();
+				bool arguments_changed = false;
+				for (unsigned i = 0; i < num_args; ++i)
+				{
+					auto arg = Z3_get_app_arg(_ctx, app, i);
+					Z3_ast result = _results[_result_of[Z3_get_ast_id(_ctx, arg)]];
+					_arguments.push_back(result);
+					arguments_changed |= (result != arg);
+				}
+
+				auto decl = Z3_get_app_decl(_ctx, app);
+				auto entry_it = _entries.find(Z3_get_func_decl_id(_ctx, decl));
+
+				// Application of a registered function, substitute its expression
+				if (entry_it != _entries.end())
+				{
+					record(id, Z3_substitute(_ctx, entry_it->second.body, num_args, entry_it->second.variable_asts.data(), _arguments.data()));
+				}
+				// Some argument has changed, rebuild the application
+				else if (arguments_changed)
+				{
+					record(id, Z3_mk_app(_ctx, decl, num_args, _arguments.data()));
+				}
+				// Nothing has changed
+				else
+				{
+					record(id, cur);
+				}
+				_ctx.check_error();
+
+			}
+
+			return _results[_result_of[Z3_get_ast_id(_ctx, e)]];
+
+		}
+
+	};
+
 }; // End namespace chc_teacher
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,114 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Benchmark comparing the substitution of conjectures into the CHCs of a problem (as done by the teacher in every round)
+ * one predicate at a time (z3_helper::substitute) and in a single pass (predicate_substitution). Every round uses new
+ * conjectures, which are conjunctions of linear inequalities over the arguments of a relation, and substitutes them into
+ * all CHCs. The benchmark fails if the two substitutions yield different expressions.
+ */
+
+// C++ includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Z3 includes
+#include "z3++.h"
+
+// Project includes
+#include "conjecture.h"
+#include "seahorn_smtlib2_parser.h"
+#include "z3_helper.h"
+
+using namespace chc_teacher;
+
+/* Create a conjecture for every relation that depends on the round */
+std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> make_conjectures(z3::context & ctx, const decl_set & relations, unsigned round) {
+	std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> conjectures;
+	for (const auto & decl : relations) {
+		z3::expr_vector variables(ctx);
+		z3::expr_vector conjuncts(ctx);
+		for (unsigned i = 0; i < decl.arity(); ++i) {
+			auto variable = ctx.constant((decl.name().str() + "#" + std::to_string(i)).c_str(), decl.domain(i));
+			variables.push_back(variable);
+			if (variable.is_bool()) {
+				conjuncts.push_back((round + i) % 2 == 0 ? variable : !variable);
+			} else {
+				conjuncts.push_back(variable <= ctx.int_val(static_cast<int>(round + i)));
+				if (i > 0) {
+					conjuncts.push_back(variable + variables[i - 1] > ctx.int_val(-static_cast<int>(round)));
+				}
+			}
+		}
+		conjectures.emplace(decl, conjecture(conjuncts.empty() ? ctx.bool_val(true) : z3::mk_and(conjuncts), variables));
+	}
+	return conjectures;
+}
+
+int main(int argc, char* argv[]){
+
+	if (argc < 2) {
+		std::cout << "Usage: " << argv[0] << " file.smt2 [number_of_rounds]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	unsigned number_of_rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+
+	z3::context ctx;
+	auto p = seahorn_smtlib2_parser::parse(ctx, argv[1]);
+
+	std::chrono::duration<double> per_predicate_time(0);
+	std::chrono::duration<double> single_pass_time(0);
+	unsigned mismatches = 0;
+	std::size_t substitutions = 0;
+	predicate_substitution substitution(ctx);
+
+	for (unsigned round = 0; round < number_of_rounds; ++round) {
+
+		auto conjectures = make_conjectures(ctx, p.relations, round);
+
+		// One predicate at a time
+		auto start = std::chrono::steady_clock::now();
+		std::vector<z3::expr> per_predicate;
+		for (const auto & chc : p.chcs) {
+			auto e = chc.expr;
+			for (const auto & decl : chc.uninterpreted_predicates) {
+				const auto & c = conjectures.at(decl);
+				e = z3_helper::substitute(ctx, e, decl, c.expr, c.variables);
+			}
+			per_predicate.push_back(e);
+		}
+		per_predicate_time += std::chrono::steady_clock::now() - start;
+
+		// Single pass
+		start = std::chrono::steady_clock::now();
+		std::vector<z3::expr> single_pass;
+		for (const auto & pair : conjectures) {
+			substitution.add(pair.first, pair.second.expr, pair.second.variables);
+		}
+		for (const auto & chc : p.chcs) {
+			single_pass.push_back(substitution.apply(chc.expr));
+		}
+		single_pass_time += std::chrono::steady_clock::now() - start;
+
+		for (std::size_t i = 0; i < p.chcs.size(); ++i) {
+			if (!z3::eq(per_predicate[i], single_pass[i])) {
+				mismatches++;
+			}
+		}
+		substitutions += p.chcs.size();
+
+	}
+
+	std::cout << "CHCs: " << p.chcs.size() << " (" << p.relations.size() << " relations)" << std::endl;
+	std::cout << "One predicate at a time: " << per_predicate_time.count() / number_of_rounds * 1000 << " ms per round" << std::endl;
+	std::cout << "Single pass: " << single_pass_time.count() / number_of_rounds * 1000 << " ms per round" << std::endl;
+	std::cout << "Speed-up: " << per_predicate_time.count() / single_pass_time.count() << std::endl;
+	std::cout << "Mismatches: " << mismatches << " of " << substitutions << std::endl;
+
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,7 +3,10 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 // C++ includes
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <unordered_map>
 #include <utility>
 
 // Project includes
@@ -520,33 +523,83 @@ namespace horn_verification
 	std::vector<horn_constraint<bool>> boogie_io::get_indistinguishable_datapoints(std::vector<datapoint<bool>> & datapoints, unsigned int threshold)
 	{
 
-                std::vector<horn_constraint<bool>> horn_constraints;
-		auto dpts_size = datapoints.size();
+		//
+		// Two data points are indistinguishable if and only if they agree on all categorical
+		// attributes and on all integer attributes clamped to [-threshold, threshold + 1]: values
+		// below -threshold (above threshold) cannot be separated by a cut of modulus at most
+		// threshold. Hence, indistinguishability is an equivalence relation, whose classes are
+		// found by hashing the clamped data points.
+		//
+		const long long lower = -static_cast<long long>(threshold);
+		const long long upper = static_cast<long long>(threshold) + 1;
+		auto clamp = [lower, upper](int value) { return std::min(std::max(static_cast<long long>(value), lower), upper); };
 
-		for(unsigned int i = 0; i < dpts_size; i++)
+		auto hash = [&datapoints, &clamp](unsigned i)
 		{
-			for (unsigned int j = i+1; j < dpts_size; j++)
+			std::size_t h = 0;
+			for (auto value : datapoints[i]._categorical_data)
+			{
+				h = h * 31 + std::hash<unsigned>()(value);
+			}
+			for (auto value : datapoints[i]._int_data)
 			{
-				if (! datapoints[i].is_distinguishable(datapoints[j], threshold))
-				{				        
-					//std::cout << "Cannot distinguish points: " << i << " and " << j << std::endl; 
+				h = h * 31 + std::hash<long long>()(clamp(value));
+			}
+			return h;
+		};
 
-					std::vector <datapoint<bool> *> premises1;
-                        		datapoint<bool> * consequence1 = nullptr;
+		auto indistinguishable = [&datapoints, &clamp](unsigned i, unsigned j)
+		{
+			if (datapoints[i]._categorical_data != datapoints[j]._categorical_data)
+			{
+				return false;
+			}
+			for (std::size_t k = 0; k < datapoints[i]._int_data.size(); ++k)
+			{
+				if (clamp(datapoints[i]._int_data[k]) != clamp(datapoints[j]._int_data[k]))
+				{
+					return false;
+				}
+			}
+			return true;
+		};
 
-                                	premises1.push_back(&datapoints[i]);
-                                	consequence1 = &datapoints[j];
-                        		horn_constraints.push_back(horn_constraint<bool>(premises1, consequence1));
 
-					std::vector <datapoint<bool> *> premises2;
-					datapoint<bool> * consequence2 = nullptr;
+		//
+		// Chain the data points of each equivalence class in the order of the data points and close
+		// the chain to a cycle, which forces all of them to the same label with one Horn constraint
+		// per data point (instead of two per pair of data points)
+		//
+		std::unordered_map<unsigned, unsigned, decltype(hash), decltype(indistinguishable)> class_of(datapoints.size(), hash, indistinguishable);
+		std::vector<std::pair<unsigned, unsigned>> first_and_last; // Of each class
 
-                                	premises2.push_back(&datapoints[j]);
-                                	consequence2 = &datapoints[i];
-                        		horn_constraints.push_back(horn_constraint<bool>(premises2, consequence2));
-				}
+		std::vector<horn_constraint<bool>> horn_constraints;
+		
+		for (unsigned i = 0; i < datapoints.size(); ++i)
+		{
+
+			auto result = class_of.emplace(i, first_and_last.size());
+			if (result.second)
+			{
+				first_and_last.push_back(std::make_pair(i, i));
+			}
+			else
+			{
+				auto & last = first_and_last[result.first->second].second;
+				horn_constraints.push_back(horn_constraint<bool>(std::vector<datapoint<bool> *>(1, &datapoints[last]), &datapoints[i]));
+				last = i;
 			}
+
 		}
+
+		for (const auto & pair : first_and_last)
+		{
+			if (pair.first != pair.second)
+			{
+				horn_constraints.push_back(horn_constraint<bool>(std::vector<datapoint<bool> *>(1, &datapoints[pair.second]), &datapoints[pair.first]));
+			}
+		}
+
 		return horn_constraints;
 
 	}
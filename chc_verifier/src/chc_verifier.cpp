@@ -5,7 +5,11 @@
 // C++ includes
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <chrono>
 #include <ctime>
 #include <getopt.h>
@@ -18,7 +22,10 @@
 #include "seahorn_smtlib2_parser.h"
 #include "chc_verifier.h"
 #include "conjecture.h"
+#include "karr_analysis.h"
 #include "learner_interface.h"
+#include "muz_preprocessor.h"
+#include "parallel_chc_verifier.h"
 
 
 using namespace chc_teacher;
@@ -84,11 +91,12 @@ void learn1(z3::context & ctx, const problem & p, bool do_horndini_prephase, boo
 }
 
 
-void learn2(z3::context & ctx, const problem & p, bool do_horndini_prephase, bool use_bounds)
+std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> learn2(z3::context & ctx, const problem & p, bool do_horndini_prephase, bool use_bounds, bool incremental, unsigned number_of_threads, bool use_incremental_solvers, unsigned number_of_counterexamples, bool report_times, const linear_form_map & linear_forms)
 {
 	
 	// Prepare auxiliary variables and data structures
-	learner_interface learner(p.relations, do_horndini_prephase, use_bounds);
+	learner_interface learner(p.relations, do_horndini_prephase, use_bounds, incremental, linear_forms);
+	parallel_chc_verifier verifier(ctx, p, number_of_threads, use_incremental_solvers, number_of_counterexamples);
 	std::list<std::reference_wrapper<const constrainted_horn_clause>> satisfied_chcs;
 	std::list<std::reference_wrapper<const constrainted_horn_clause>> unsatisfied_chcs;
 	std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> previous_conjectures;
@@ -112,27 +120,28 @@ void learn2(z3::context & ctx, const problem & p, bool do_horndini_prephase, boo
 		auto conjectures = learner.get_conjectures();
 		++learner_invocations;
 		
+		// Report how much of the previous tree has been reused
+		if (incremental)
+		{
+			auto statistics = learner.last_round_statistics();
+			std::cout << "Round " << learner_invocations << ": reused " << statistics.first << " nodes, rebuilt " << statistics.second << " nodes" << std::endl;
+		}
 		
-		// Check which conjectures have changed
-		std::unordered_map<z3::func_decl, bool, ASTHasher, ASTComparer> changed(conjectures.size());
-		bool all_as_before = true;
-		for (const auto & pair : conjectures)
+		// Report the time of every run of the learner (per bound)
+		if (report_times)
 		{
-			
-			// Get old conjecture for declaration (if exists)
-			auto previous_conjecture_it = previous_conjectures.find(pair.first);
-			
-			// Store whether conjecture has changed
-			auto has_changed = (previous_conjecture_it == previous_conjectures.end() || !(pair.second == previous_conjecture_it->second));
-			changed[pair.first] = has_changed;
-			if (has_changed)
+			const auto bound_times = learner.last_round_bound_times();
+			std::cout << "Round " << learner_invocations << ":";
+			for (std::size_t i = 0; i < bound_times.size(); ++i)
 			{
-				all_as_before = false;
+				std::cout << (i == 0 ? " " : ", ") << (bound_times[i].first > 0 ? "bound " + std::to_string(bound_times[i].first) : std::string("no bound")) << " " << bound_times[i].second * 1000 << " ms" << (i + 1 < bound_times.size() ? " (failed)" : "");
 			}
-			
+			std::cout << std::endl;
 		}
-
-		//assert (!all_as_before);
+		
+		
+		// Check which conjectures have changed (as reported by the learner, which tracks the subtree of every relation)
+		const auto & changed = learner.changed_conjectures();
 
 		// DEBUG
 		// std::cout << "---------- Changes of conjectures ----------" << std::endl;
@@ -149,94 +158,76 @@ void learn2(z3::context & ctx, const problem & p, bool do_horndini_prephase, boo
 		std::list<std::reference_wrapper<const constrainted_horn_clause>> now_satisfied_chcs;
 
 		
-		// Check previously unsatisfied chcs
-		// std::cout << "++++++++++ UNSATISFIED CHCS ++++++++++" << std::endl;
-		auto unsat_it = unsatisfied_chcs.begin();
-		while (unsat_it != unsatisfied_chcs.end())
+		// Collect the CHCs to check, i.e., those that contain a conjecture that has changed in the last round (first the previously
+		// unsatisfied CHCs, then the previously satisfied ones); all are checked against the same conjectures and, hence, independently
+		std::vector<std::list<std::reference_wrapper<const constrainted_horn_clause>>::iterator> unsat_checks;
+		std::vector<std::list<std::reference_wrapper<const constrainted_horn_clause>>::iterator> sat_checks;
+		std::vector<std::size_t> chc_indices;
+		for (auto * chcs : { &unsatisfied_chcs, &satisfied_chcs })
 		{
-			
-			// Check whether a conjecture has changed
-			bool has_changed = false;
-			for (const auto & decl : unsat_it->get().uninterpreted_predicates)
+			for (auto it = chcs->begin(); it != chcs->end(); ++it)
 			{
-				if (changed.at(decl))
+				
+				// Check whether a conjecture has changed
+				bool has_changed = false;
+				for (const auto & decl : it->get().uninterpreted_predicates)
 				{
-					has_changed = true;
-					break;
+					if (changed.at(decl))
+					{
+						has_changed = true;
+						break;
+					}
 				}
+				
+				if (has_changed)
+				{
+					(chcs == &unsatisfied_chcs ? unsat_checks : sat_checks).push_back(it);
+					chc_indices.push_back(&it->get() - p.chcs.data());
+				}
+				
 			}
+		}
+		
+		auto results = verifier.check_chcs(chc_indices, conjectures);
+		checked_chcs += chc_indices.size();
+		auto result_it = results.begin();
+		
+		
+		// Process previously unsatisfied chcs
+		// std::cout << "++++++++++ UNSATISFIED CHCS ++++++++++" << std::endl;
+		for (auto unsat_it : unsat_checks)
+		{
 			
+			auto chc_counterexamples = std::move(*result_it++);
 			
-			// Check if some conjecture changed
-			if (has_changed)
+			// CHC is not satisfied, counterexamples are returned
+			if (!chc_counterexamples.empty())
 			{
-
-				auto counterexample = chc_verifier::check_chc(ctx, *unsat_it, conjectures);
-				++checked_chcs;
-				
-				// CHC is not satisfied, counterexample is returned
-				if (counterexample != nullptr)
-				{
-					counterexamples.push_back(std::move(counterexample)); // NO use of variable counterexample beyond this point
-					++unsat_it;
-				}
-				// CHC is now satisfied
-				else
-				{
-					now_satisfied_chcs.push_back(*unsat_it);
-					unsat_it = unsatisfied_chcs.erase(unsat_it);
-				}
-
+				counterexamples.insert(counterexamples.end(), std::make_move_iterator(chc_counterexamples.begin()), std::make_move_iterator(chc_counterexamples.end()));
 			}
+			// CHC is now satisfied
 			else
 			{
-				++unsat_it;
+				now_satisfied_chcs.push_back(*unsat_it);
+				unsatisfied_chcs.erase(unsat_it);
 			}
 			
 		}
 
 		
-		// Check previously satisfied CHC if it contains a conjecture that has changed in the last round
+		// Process previously satisfied CHCs
 		// std::cout << "++++++++++ SATISFIED CHCS ++++++++++" << std::endl;
-		auto sat_it = satisfied_chcs.begin();
-		while (sat_it != satisfied_chcs.end())
+		for (auto sat_it : sat_checks)
 		{
 			
-			// Check whether a conjecture has changed
-			bool has_changed = false;
-			for (const auto & decl : sat_it->get().uninterpreted_predicates)
-			{
-				if (changed.at(decl))
-				{
-					has_changed = true;
-					break;
-				}
-			}
+			auto chc_counterexamples = std::move(*result_it++);
 			
-			// Check if some conjecture changed
-			if (has_changed)
-			{
-				
-				auto counterexample = chc_verifier::check_chc(ctx, *sat_it, conjectures);
-				++checked_chcs;
-				
-				// CHC is not satisfied, counterexample is returned
-				if (counterexample != nullptr)
-				{
-					counterexamples.push_back(std::move(counterexample)); // NO use of variable counterexample beyond this point
-					unsatisfied_chcs.push_back(*sat_it);
-					sat_it = satisfied_chcs.erase(sat_it);					
-				}
-				// CHC is now satisfied
-				else
-				{
-					++sat_it;
-				}
-				
-			}
-			else
+			// CHC is not satisfied, counterexamples are returned
+			if (!chc_counterexamples.empty())
 			{
-				++sat_it;
+				counterexamples.insert(counterexamples.end(), std::make_move_iterator(chc_counterexamples.begin()), std::make_move_iterator(chc_counterexamples.end()));
+				unsatisfied_chcs.push_back(*sat_it);
+				satisfied_chcs.erase(sat_it);
 			}
 			
 		}		
@@ -258,15 +249,59 @@ void learn2(z3::context & ctx, const problem & p, bool do_horndini_prephase, boo
 	
 	assert (chc_verifier::naive_check(ctx, p, previous_conjectures) == nullptr);
 	
-	//
-	// Output solution
-	//
 	std::cout << "Success (checked " << checked_chcs << " CHCs, invoked learner " << learner_invocations << " times)" << std::endl;
-	for (const auto & c : previous_conjectures)
+
+	return previous_conjectures;
+	
+}
+
+
+/**
+ * Parses a comma-separated list of muz transformers.
+ *
+ * @param list The list (any of coi, inline, subsumption and slice, or all)
+ *
+ * @return the options of the muz_preprocessor
+ */
+muz_preprocessor::options parse_transformers(const std::string & list)
+{
+
+	muz_preprocessor::options opts;
+
+	std::stringstream ss(list);
+	std::string item;
+	while (std::getline(ss, item, ','))
 	{
-		std::cout << c.first << " => " << c.second << std::endl;
+
+		if (item == "coi" || item == "all")
+		{
+			opts.coi = true;
+		}
+		if (item == "inline" || item == "all")
+		{
+			opts.inline_rules = true;
+		}
+		if (item == "subsumption" || item == "all")
+		{
+			opts.subsumption = true;
+		}
+		if (item == "slice" || item == "all")
+		{
+			opts.slice = true;
+		}
+		if (item == "karr")
+		{
+			opts.karr = true;
+		}
+		if (item != "coi" && item != "inline" && item != "karr" && item != "subsumption" && item != "slice" && item != "all")
+		{
+			throw std::runtime_error("Unknown transformer " + item);
+		}
+
 	}
-	
+
+	return opts;
+
 }
 
 
@@ -281,8 +316,17 @@ void print_help(std::ostream & out, const char * name)
 {
 	out << "Usage: " << name << " [options] file" << std::endl;
 	out << "Options are:" << std::endl;
+	out << "  -a\t\tAdd the affine equalities found by Karr's analysis as attributes" << std::endl;
 	out << "  -b\t\tBound the learner" << std::endl;
+	out << "  -e\t\tAssume the affine equalities found by Karr's analysis in the CHCs" << std::endl;
 	out << "  -h\t\tRun Horndini pre-phase" << std::endl;
+	out << "  -i\t\tRelearn the decision tree incrementally" << std::endl;
+	out << "  -j <n>\t\tCheck CHCs with n threads (default 1)" << std::endl;
+	out << "  -k <n>\t\tExtract up to n counterexamples per CHC and round (default 1)" << std::endl;
+	out << "  -p <list>\tSimplify the CHCs with Z3's muz transformers before learning; <list> is a comma-separated" << std::endl;
+	out << "  \t\tlist of coi, inline, subsumption and slice (or all) and karr (Z3's Karr invariants)" << std::endl;
+	out << "  -s\t\tKeep one incremental solver per CHC" << std::endl;
+	out << "  -t\t\tPrint the time of every run of the learner (per bound)" << std::endl;
 }
 
 
@@ -290,30 +334,70 @@ int main(int argc, char * argv[])
 {
 
 
-	/// Store the starting time of execution.
-	 std::clock_t c_start = std::clock();
+	/// Store the starting time of execution (wall-clock time, as the CPU time of several threads adds up).
+	auto c_start = std::chrono::steady_clock::now();
 
 
 	//
 	// Process command line arguments
 	//
+	bool use_karr_attributes = false;
+	bool assume_karr_invariants = false;
 	bool do_horndini_prephase = false;
 	bool use_bounds = false;
+	bool incremental = false;
+	unsigned number_of_threads = 1;
+	bool use_incremental_solvers = false;
+	unsigned number_of_counterexamples = 1;
+	bool report_times = false;
+	muz_preprocessor::options preprocessing;
 
 	int c;
-	while ((c = getopt (argc, argv, "bh")) != -1)
+	while ((c = getopt (argc, argv, "abehij:k:p:st")) != -1)
 	{
 
 		switch (c)
 		{
+			case 'a':
+				use_karr_attributes = true;
+				break;
+
 			case 'b':
 				use_bounds = true;
 				break;
+
+			case 'e':
+				assume_karr_invariants = true;
+				break;
 				
 			case 'h':
 				do_horndini_prephase = true;
 				break;
 
+			case 'i':
+				incremental = true;
+				break;
+
+			case 'j':
+				number_of_threads = std::stoul(optarg);
+				break;
+
+			case 'k':
+				number_of_counterexamples = std::stoul(optarg);
+				break;
+
+			case 'p':
+				preprocessing = parse_transformers(optarg);
+				break;
+
+			case 's':
+				use_incremental_solvers = true;
+				break;
+
+			case 't':
+				report_times = true;
+				break;
+
 			default:
 				print_help(std::cout, argv[0]);
 				return EXIT_FAILURE;
@@ -337,18 +421,81 @@ int main(int argc, char * argv[])
 	// Create Z3 context and parse
 	//
 	z3::context ctx;
-	auto p = seahorn_smtlib2_parser::parse(ctx, filename);
+	z3::expr_vector rules(ctx);
+	z3::expr_vector queries(ctx);
+	seahorn_smtlib2_parser::read(ctx, filename, rules, queries);
+	auto p = seahorn_smtlib2_parser::parse(ctx, rules, queries);
 	//// std::cout << p << std::endl;
 
 	//
-	// Learn
+	// Learn (on the simplified problem if requested, whose solution is then mapped back to the original problem)
 	//
 	//learn1(ctx, p); // Simple (original)
-	learn2(ctx, p, do_horndini_prephase, use_bounds); // Improved?
+	auto learn = [&](const problem & q)
+	{
+
+		if (!use_karr_attributes && !assume_karr_invariants)
+		{
+			return learn2(ctx, q, do_horndini_prephase, use_bounds, incremental, number_of_threads, use_incremental_solvers, number_of_counterexamples, report_times, linear_form_map());
+		}
+
+		// Karr's analysis (its invariants are inductive, so that the strengthened problem has the same solutions up to conjoining them)
+		karr_analysis analysis(ctx, q);
+		auto linear_forms = use_karr_attributes ? analysis.linear_forms() : linear_form_map();
+
+		std::size_t number_of_forms = 0;
+		for (const auto & forms : linear_forms)
+		{
+			number_of_forms += forms.second.size();
+		}
+		std::cout << "Karr's analysis: " << number_of_forms << " linear attributes for " << linear_forms.size() << " relations (" << analysis.number_of_checks() << " CHC checks)" << std::endl;
+
+		if (!assume_karr_invariants)
+		{
+			return learn2(ctx, q, do_horndini_prephase, use_bounds, incremental, number_of_threads, use_incremental_solvers, number_of_counterexamples, report_times, linear_forms);
+		}
+
+		auto strengthened_q = analysis.strengthen(q);
+		return analysis.conjoin(learn2(ctx, strengthened_q, do_horndini_prephase, use_bounds, incremental, number_of_threads, use_incremental_solvers, number_of_counterexamples, report_times, linear_forms));
+
+	};
+
+	std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> solution;
+	if (preprocessing.any())
+	{
+
+		muz_preprocessor preprocessor(ctx, preprocessing);
+		preprocessor.transform(rules, queries);
+		auto transformed_p = seahorn_smtlib2_parser::parse(ctx, rules, queries);
+		std::cout << "Preprocessing: " << preprocessor.number_of_rules().first << " rules and " << p.relations.size() << " relations reduced to " << preprocessor.number_of_rules().second << " rules and " << transformed_p.relations.size() << " relations" << std::endl;
+
+		auto transformed_solution = learn(transformed_p);
+		solution = preprocessor.map_back(transformed_solution, p.relations);
+
+	}
+	else
+	{
+		solution = learn(p); // Improved?
+	}
+
+	// The learner only checked the conjectures against the simplified or strengthened CHCs
+	if ((preprocessing.any() || assume_karr_invariants) && chc_verifier::naive_check(ctx, p, solution) != nullptr)
+	{
+		std::cout << "Conjectures do not satisfy the original CHCs" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	//
+	// Output solution
+	//
+	for (const auto & c : solution)
+	{
+		std::cout << c.first << " => " << c.second << std::endl;
+	}
 	
 	/// Store the finishing time of execution.
-	std::clock_t c_end = std::clock();
+	auto c_end = std::chrono::steady_clock::now();
 
-	std::cout << "Total time: " << ((c_end-c_start)*100 / CLOCKS_PER_SEC)/100.00 << std::endl;
+	std::cout << "Total time: " << (std::chrono::duration_cast<std::chrono::milliseconds>(c_end - c_start).count() / 10) / 100.00 << std::endl;
 
 }
@@ -26,15 +26,6 @@ namespace horn_verification
 		_identifier = identifier;
 	}
 
-	template <class T>
-	datapoint<T>::datapoint(T classification, bool is_classified, std::unordered_set <datapoint<T> *> list_of_marking, std::unordered_set <horn_constraint<T> *> list_of_horn_constraints, unsigned identifier) {
-		_classification = classification;
-		_is_classified = is_classified;
-		_list_of_marking = list_of_marking;
-		_list_of_horn_constraints = list_of_horn_constraints;
-		_identifier = identifier;
-	}
-
 	template <class T>
 	bool datapoint<T>::set_classification(T classification) {
 		if (_is_classified) {
@@ -48,19 +39,6 @@ namespace horn_verification
 		return true;
 	}
 
-	template <class T>
-	void datapoint<T>::remove_satisfied_horn_clauses() {
-		for(auto horn_constraint_itrator = _list_of_horn_constraints.begin(); horn_constraint_itrator != _list_of_horn_constraints.end(); horn_constraint_itrator++) {
-			if((*horn_constraint_itrator)->_satisfiable == true) {
-				_list_of_horn_constraints.erase(horn_constraint_itrator);
-				if (!_list_of_horn_constraints.empty()) {
-					horn_constraint_itrator = _list_of_horn_constraints.begin();
-				} else {
-					break;
-				}
-			}
-		}
-	}
 	       
 	template <class T>
 	bool datapoint<T>::is_distinguishable(const datapoint<T> & other, unsigned int threshold)
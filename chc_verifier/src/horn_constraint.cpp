@@ -36,17 +36,18 @@ namespace horn_verification
 	}
 
 	template <class T>
-	void horn_constraint<T>::compute_marking() const{
+	void horn_constraint<T>::compute_marking(std::unordered_map<datapoint<T> *, std::unordered_set<datapoint<T> *> > & markings, const std::unordered_map<datapoint<T> *, std::unordered_set<horn_constraint<T> *> > & horn_constraints_of) const{
 		if(_premises.size()){
-			datapoint<T> *master_datapoint = _premises.at(0);
+			const auto & master_markings = markings[_premises.at(0)];
+			auto & conclusion_markings = markings[_conclusion];
 			bool propagate_marking = false;
-			for(auto master_marking_itrator = master_datapoint->_list_of_marking.begin(); master_marking_itrator != master_datapoint->_list_of_marking.end(); master_marking_itrator++) {
+			for(auto master_marking_itrator = master_markings.begin(); master_marking_itrator != master_markings.end(); master_marking_itrator++) {
 				datapoint<T> *master_marking = (*master_marking_itrator);
 				bool master_common_marking_satus = true;
 				for( unsigned j = 1; (_premises.size() > 1)&&(j < _premises.size()); j++) {
-					datapoint<T> *current_datapoint = _premises.at(j);
+					const auto & local_markings = markings[_premises.at(j)];
 					bool local_common_marking_satus = false;
-					for(auto local_marking_itrator = current_datapoint->_list_of_marking.begin(); local_marking_itrator != current_datapoint->_list_of_marking.end(); local_marking_itrator++) {
+					for(auto local_marking_itrator = local_markings.begin(); local_marking_itrator != local_markings.end(); local_marking_itrator++) {
 						datapoint<T> *local_marking = (*local_marking_itrator);
 						if (local_marking == master_marking) {
 							local_common_marking_satus = true;
@@ -59,16 +60,17 @@ namespace horn_verification
 					}
 				}
 				if(master_common_marking_satus == true) {
-					if (_conclusion->_list_of_marking.count(master_marking) == 0) {
-						_conclusion->_list_of_marking.insert(master_marking);
+					if (conclusion_markings.count(master_marking) == 0) {
+						conclusion_markings.insert(master_marking);
 						propagate_marking = true;
 					}
 				}
 			}
-			if(propagate_marking == true) {
-				for ( auto horn_constraint_itrator = _conclusion->_list_of_horn_constraints.begin(); horn_constraint_itrator != _conclusion->_list_of_horn_constraints.end(); horn_constraint_itrator++) {
+			auto conclusion_horn_constraints = horn_constraints_of.find(_conclusion);
+			if(propagate_marking == true && conclusion_horn_constraints != horn_constraints_of.end()) {
+				for ( auto horn_constraint_itrator = conclusion_horn_constraints->second.begin(); horn_constraint_itrator != conclusion_horn_constraints->second.end(); horn_constraint_itrator++) {
 					if((*horn_constraint_itrator)->_satisfiable ==false && (*horn_constraint_itrator)->_conclusion != _conclusion){
-						(*horn_constraint_itrator)->compute_marking();
+						(*horn_constraint_itrator)->compute_marking(markings, horn_constraints_of);
 					}
 				}
 			}
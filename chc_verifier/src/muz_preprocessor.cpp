@@ -0,0 +1,421 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// C++ includes
+#include <stdexcept>
+#include <string>
+
+// Z3 includes (internal API)
+#include "api/api_context.h"
+#include "api/api_util.h"
+#include "ast/for_each_expr.h"
+#include "model/model.h"
+#include "muz/base/dl_context.h"
+#include "muz/base/dl_rule_transformer.h"
+#include "muz/fp/dl_register_engine.h"
+#include "muz/transforms/dl_mk_coi_filter.h"
+#include "muz/transforms/dl_mk_karr_invariants.h"
+#include "muz/transforms/dl_mk_rule_inliner.h"
+#include "muz/transforms/dl_mk_slice.h"
+#include "muz/transforms/dl_mk_subsumption_checker.h"
+#include "smt/params/smt_params.h"
+
+// Project includes
+#include "muz_preprocessor.h"
+#include "seahorn_smtlib2_parser.h"
+
+
+namespace chc_teacher
+{
+
+	/**
+	 * Collects the relations (i.e., the uninterpreted functions with Boolean range) of an expression.
+	 */
+	struct relation_collector
+	{
+
+		ast_manager & m;
+
+		obj_hashtable<func_decl> & relations;
+
+		relation_collector(ast_manager & m, obj_hashtable<func_decl> & relations)
+			: m(m), relations(relations)
+		{
+			// Nothing
+		}
+
+		void operator()(app * a)
+		{
+			if (a->get_family_id() == null_family_id && m.is_bool(a))
+			{
+				relations.insert(a->get_decl());
+			}
+		}
+
+		void operator()(var *)
+		{
+			// Nothing
+		}
+
+		void operator()(quantifier *)
+		{
+			// Nothing
+		}
+
+	};
+
+
+	class muz_preprocessor::impl
+	{
+
+	public:
+
+		/// The Z3 context of the rules and queries
+		z3::context & ctx;
+
+		/// The internal AST manager of the Z3 context
+		ast_manager & m;
+
+		/// The transformers to run
+		options opts;
+
+		/// SMT parameters of the datalog context (unused by the transformers)
+		smt_params fparams;
+
+		/// The engine registry of the datalog context (no engine is run)
+		datalog::register_engine engine;
+
+		/// The datalog context that runs the transformers
+		datalog::context dctx;
+
+		/// The relations of the original rules and queries
+		func_decl_ref_vector original_relations;
+
+		/// The relations of the transformed rules and queries
+		func_decl_ref_vector transformed_relations;
+
+		/// The number of rules before and after the transformation
+		std::pair<unsigned, unsigned> number_of_rules;
+
+		/// Whether the transformation has been performed
+		bool is_transformed;
+
+
+		impl(z3::context & ctx, const options & opts)
+			: ctx(ctx), m(mk_c(ctx)->m()), opts(opts), dctx(m, engine, fparams), original_relations(m), transformed_relations(m), number_of_rules(0, 0), is_transformed(false)
+		{
+			// Nothing
+		}
+
+
+		/**
+		 * Converts an internal expression into an expression of the public API.
+		 */
+		z3::expr to_public(expr * e) const
+		{
+			return z3::expr(ctx, of_expr(e));
+		}
+
+
+		/**
+		 * Converts an internal rule into a formula that the SeaHorn parser accepts (i.e., the left-hand-side
+		 * of an implication is always a conjunction).
+		 */
+		expr_ref to_formula(const datalog::rule & r)
+		{
+
+			expr_ref fml(m);
+			dctx.get_rule_manager().to_formula(r, fml);
+
+			expr * body = is_forall(fml) ? to_quantifier(fml)->get_expr() : fml.get();
+			expr * lhs;
+			expr * rhs;
+			if (m.is_implies(body, lhs, rhs) && !m.is_and(lhs))
+			{
+
+				expr_ref new_body(m.mk_implies(m.mk_app(m.get_basic_family_id(), OP_AND, lhs), rhs), m);
+				fml = is_forall(fml) ? m.update_quantifier(to_quantifier(fml), new_body) : new_body;
+
+			}
+
+			return fml;
+
+		}
+
+	};
+
+
+	muz_preprocessor::muz_preprocessor(z3::context & ctx, const options & opts)
+		: _impl(new impl(ctx, opts))
+	{
+		// Nothing
+	}
+
+
+	muz_preprocessor::~muz_preprocessor()
+	{
+		// Nothing
+	}
+
+
+	void muz_preprocessor::transform(z3::expr_vector & rules, z3::expr_vector & queries)
+	{
+
+		if (_impl->is_transformed)
+		{
+			throw std::runtime_error("Rules have already been transformed");
+		}
+		_impl->is_transformed = true;
+
+		auto & m = _impl->m;
+		auto & dctx = _impl->dctx;
+
+
+		//
+		// Register relations and add rules
+		//
+		obj_hashtable<func_decl> relations;
+		relation_collector collector(m, relations);
+		expr_mark visited;
+		for (unsigned i = 0; i < rules.size(); ++i)
+		{
+			for_each_expr(collector, visited, to_expr(rules[i]));
+		}
+		for (unsigned i = 0; i < queries.size(); ++i)
+		{
+			for_each_expr(collector, visited, to_expr(queries[i]));
+		}
+
+		for (auto * r : relations)
+		{
+			dctx.register_predicate(r, false);
+			_impl->original_relations.push_back(r);
+		}
+
+		for (unsigned i = 0; i < rules.size(); ++i)
+		{
+			dctx.add_rule(to_expr(rules[i]), symbol::null);
+		}
+
+		for (unsigned i = 0; i < queries.size(); ++i)
+		{
+
+			expr * q = to_expr(queries[i]);
+			if (!is_app(q) || !dctx.is_predicate(to_app(q)->get_decl()))
+			{
+				throw std::runtime_error("Query is not an application of a relation");
+			}
+
+			dctx.set_output_predicate(to_app(q)->get_decl());
+
+		}
+
+		_impl->number_of_rules.first = dctx.get_rules().get_num_rules();
+
+
+		//
+		// Run transformers (each of which adds its model converter to the context)
+		//
+		dctx.get_model_converter() = datalog::mk_skip_model_converter();
+		dctx.ensure_closed();
+
+		datalog::rule_transformer transformer(dctx);
+		if (_impl->opts.coi)
+		{
+			transformer.register_plugin(alloc(datalog::mk_coi_filter, dctx));
+		}
+		if (_impl->opts.inline_rules)
+		{
+			transformer.register_plugin(alloc(datalog::mk_rule_inliner, dctx));
+		}
+		if (_impl->opts.subsumption)
+		{
+			transformer.register_plugin(alloc(datalog::mk_subsumption_checker, dctx));
+		}
+		if (_impl->opts.slice)
+		{
+			transformer.register_plugin(alloc(datalog::mk_slice, dctx));
+		}
+		if (_impl->opts.karr)
+		{
+			// The transformer does nothing unless enabled in the parameters; it uses the priority of Z3's default pipeline
+			params_ref params;
+			params.set_bool("karr", true);
+			dctx.updt_params(params);
+			transformer.register_plugin(alloc(datalog::mk_karr_invariants, dctx, 36010));
+		}
+		dctx.transform_rules(transformer);
+
+
+		//
+		// Replace rules and queries
+		//
+		const auto & rule_set = dctx.get_rules();
+		_impl->number_of_rules.second = rule_set.get_num_rules();
+
+		z3::expr_vector new_rules(_impl->ctx);
+		for (auto * r : rule_set)
+		{
+			new_rules.push_back(_impl->to_public(_impl->to_formula(*r)));
+		}
+
+		z3::expr_vector new_queries(_impl->ctx);
+		for (auto * q : rule_set.get_output_predicates())
+		{
+			new_queries.push_back(_impl->to_public(m.mk_const(q)));
+		}
+
+		obj_hashtable<func_decl> transformed_relations;
+		for (auto * r : rule_set)
+		{
+			transformed_relations.insert(r->get_decl());
+			for (unsigned i = 0; i < r->get_uninterpreted_tail_size(); ++i)
+			{
+				transformed_relations.insert(r->get_decl(i));
+			}
+		}
+		for (auto * q : rule_set.get_output_predicates())
+		{
+			transformed_relations.insert(q);
+		}
+		for (auto * r : transformed_relations)
+		{
+			_impl->transformed_relations.push_back(r);
+		}
+
+		rules = new_rules;
+		queries = new_queries;
+
+	}
+
+
+	std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> muz_preprocessor::map_back(const std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> & conjectures, const decl_set & relations) const
+	{
+
+		auto & ctx = _impl->ctx;
+		auto & m = _impl->m;
+
+
+		//
+		// Build a model of the transformed relations from the conjectures. The variables of a conjecture
+		// become the de Bruijn indices of the arguments (the 1-ary replacement of a 0-ary relation is
+		// evaluated at true).
+		//
+		model_ref md = alloc(model, m);
+		for (auto * r : _impl->transformed_relations)
+		{
+
+			z3::func_decl decl(ctx, of_func_decl(r));
+			if (r->get_arity() == 0)
+			{
+				decl = seahorn_smtlib2_parser::unary_relation(ctx, decl);
+			}
+
+			auto it = conjectures.find(decl);
+			if (it == conjectures.end())
+			{
+				continue;
+			}
+
+			if (r->get_arity() == 0)
+			{
+
+				z3::expr_vector dst(ctx);
+				dst.push_back(ctx.bool_val(true));
+				z3::expr value = it->second.expr;
+				value = value.substitute(it->second.variables, dst);
+
+				md->register_decl(r, to_expr(value));
+
+			}
+			else
+			{
+
+				z3::expr_vector dst(ctx);
+				for (unsigned i = 0; i < it->second.variables.size(); ++i)
+				{
+					dst.push_back(z3::expr(ctx, Z3_mk_bound(ctx, i, it->second.variables[i].get_sort())));
+				}
+				z3::expr body = it->second.expr;
+				body = body.substitute(it->second.variables, dst);
+
+				auto * fi = alloc(func_interp, m, r->get_arity());
+				fi->set_else(to_expr(body));
+				md->register_decl(r, fi);
+
+			}
+
+		}
+
+
+		//
+		// Apply the model converters of the transformers
+		//
+		model_converter_ref mc = _impl->dctx.get_model_converter();
+		if (mc)
+		{
+			(*mc)(md);
+		}
+
+
+		//
+		// Read off the conjectures of the original relations (the variables are named as the learner names them)
+		//
+		std::unordered_map<z3::func_decl, conjecture, ASTHasher, ASTComparer> original_conjectures;
+		for (auto * r : _impl->original_relations)
+		{
+
+			z3::func_decl decl(ctx, of_func_decl(r));
+			if (r->get_arity() == 0)
+			{
+				decl = seahorn_smtlib2_parser::unary_relation(ctx, decl);
+			}
+
+			if (relations.count(decl) == 0)
+			{
+				continue;
+			}
+
+			z3::expr_vector variables(ctx);
+			expr_ref interpretation(m);
+			if (r->get_arity() == 0)
+			{
+
+				variables.push_back(ctx.constant((decl.name().str() + "#0").c_str(), ctx.bool_sort()));
+
+				interpretation = md->get_const_interp(r);
+
+			}
+			else
+			{
+
+				for (unsigned i = 0; i < decl.arity(); ++i)
+				{
+					variables.push_back(ctx.constant((decl.name().str() + "#" + std::to_string(i)).c_str(), decl.domain(i)));
+				}
+
+				auto * fi = md->get_func_interp(r);
+				if (fi != nullptr)
+				{
+					interpretation = fi->get_interp();
+				}
+
+			}
+
+			auto expr = interpretation ? _impl->to_public(interpretation).substitute(variables) : ctx.bool_val(true);
+			original_conjectures.emplace(decl, conjecture(expr, variables));
+
+		}
+
+		return original_conjectures;
+
+	}
+
+
+	std::pair<unsigned, unsigned> muz_preprocessor::number_of_rules() const
+	{
+		return _impl->number_of_rules;
+	}
+
+}; // End namespace chc_teacher
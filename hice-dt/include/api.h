@@ -25,6 +25,20 @@ namespace horn_verification
 
 			bool do_horndini_prephase;
 
+			bool incremental = false;
+
+			/// The tree learned in the previous round (only kept if the learner works incrementally)
+			decision_tree previous_tree;
+
+			/// The number of nodes of the last tree learned from scratch (only used if the learner works incrementally)
+			std::size_t from_scratch_size = 0;
+
+			/// The number of reused and rebuilt nodes for each round of learning
+			std::vector<std::pair<std::size_t, std::size_t>> round_statistics;
+
+			/// The bound (or 0 if no bound is used) and the time in seconds of every run of the learner for each round of learning
+			std::vector<std::vector<std::pair<int, double>>> round_bound_times;
+
 			attributes_metadata metadata;
 
 			std::vector<std::pair<unsigned, unsigned>> intervals;
@@ -35,17 +49,53 @@ namespace horn_verification
 
 			std::unordered_map<unsigned, horn_verification::datapoint<bool>> identifier_to_datapoint;
 
+			/// The data points as seen by the learner (copied once and then only updated with new classifications)
+			std::vector<horn_verification::datapoint<bool>> datapoints;
+
+			/// Whether all data points fit the intervals (see simple_job_manager::fits_attribute_intervals())
+			bool datapoints_fit_intervals = true;
+
+			/// The learner, which keeps the sample and the Horn solver across rounds
+			horn_verification::api_helper learner_obj {metadata, datapoints, horn_indexes, intervals};
+
 	public:
 			void reserve_datapoint_ptrs (unsigned number_of_datapoints) {
 
 				datapoint_ptrs.reserve(number_of_datapoints);
+
+				datapoints.reserve(number_of_datapoints);
 			}
 
-			void configure_learner (bool _do_horndini_prephase, bool _use_bounds) {
+			void configure_learner (bool _do_horndini_prephase, bool _use_bounds, bool _incremental = false) {
 
 				use_bounds = _use_bounds;
 
 				do_horndini_prephase = _do_horndini_prephase;
+
+				incremental = _incremental;
+			}
+
+			/**
+			 * Returns, for each round of learning so far, the number of nodes reused from the
+			 * previous tree and the number of nodes built from scratch.
+			 *
+			 * @return a vector of pairs (reused nodes, rebuilt nodes), one pair per round
+			 */
+			const std::vector<std::pair<std::size_t, std::size_t>> & get_round_statistics() const {
+
+				return round_statistics;
+			}
+
+			/**
+			 * Returns, for each round of learning so far, the bound (or 0 if no bound is used) and
+			 * the time in seconds of every run of the learner. All but the last run of a round have
+			 * failed.
+			 *
+			 * @return a vector of runs (bound, time), one vector per round
+			 */
+			const std::vector<std::vector<std::pair<int, double>>> & get_round_bound_times() const {
+
+				return round_bound_times;
 			}
 			
 			void add_intervals(unsigned left, unsigned right) {
@@ -99,23 +149,51 @@ namespace horn_verification
 			horn_indexes.push_back(std::make_pair(premises, consequence));
 		}
 
-			
+
+		/**
+		 * Learns a decision tree from the data points and Horn constraints added so far. Only the data
+		 * points and Horn constraints added since the previous round are passed on to the learner, which
+		 * keeps its sample and Horn solver across rounds. If the learner works incrementally, the tree of
+		 * the previous round is reused as far as it is still useful (see
+		 * simple_job_manager::next_replay_job()).
+		 *
+		 * @return the learned decision tree
+		 */
 		decision_tree learn_decision_tree() {
 
-			std::vector<datapoint<bool>> datapoints_copy;
+			for (std::size_t i = 0; i < datapoints.size(); ++i) {
+
+				datapoints[i]._is_classified = datapoint_ptrs[i]->_is_classified;
+
+				datapoints[i]._classification = datapoint_ptrs[i]->_classification;
+			}
+
+			for (std::size_t i = datapoints.size(); i < datapoint_ptrs.size(); ++i) {
+
+				datapoints.push_back(*datapoint_ptrs[i]);
 
-			datapoints_copy.reserve(datapoint_ptrs.size());
+				datapoints_fit_intervals = datapoints_fit_intervals && simple_job_manager::fits_attribute_intervals(datapoints.back(), intervals);
+			}
 
-			for (unsigned i = 0; i < datapoint_ptrs.size(); ++i) {
+			auto tree = learner_obj.learn_decision_tree(do_horndini_prephase, use_bounds, datapoints_fit_intervals, incremental ? previous_tree.root() : nullptr);
 
-				datapoints_copy.push_back(*datapoint_ptrs[i]);
+			if (incremental && learner_obj.number_of_reused_nodes() == 0) {
 
-				//assert (datapoint_ptrs[i]->_identifier == i);
+				from_scratch_size = learner_obj.number_of_rebuilt_nodes();
 			}
 
-			horn_verification::api_helper learner_obj(metadata, datapoints_copy, horn_indexes, intervals);
+			round_statistics.push_back(std::make_pair(learner_obj.number_of_reused_nodes(), learner_obj.number_of_rebuilt_nodes()));
+
+			round_bound_times.push_back(learner_obj.bound_level_times());
+
+			// A reused tree that has grown well past the last tree learned from scratch most likely keeps splits that
+			// a tree learned from scratch would not need, hence the next round learns from scratch
+			if (incremental && tree.root() != nullptr) {
+
+				previous_tree = learner_obj.number_of_reused_nodes() + learner_obj.number_of_rebuilt_nodes() > from_scratch_size + from_scratch_size / 2 ? decision_tree() : tree;
+			}
 
-			return learner_obj.learn_decision_tree(do_horndini_prephase, use_bounds);
+			return tree;
 		}
 
 	};
@@ -7,7 +7,9 @@
 
 // C++ includes
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <unordered_set>
 #include <stdexcept>
 #include <string>
@@ -19,10 +21,11 @@
 // Project includes
 #include "boogie_io.h"
 #include "bound.h"
+#include "bounded_sample.h"
 #include "simple_job_manager.h"
 #include "debug_job_manager.h"
 #include "horndini.h"
-#include "horn_solver.h"
+#include "incremental_horn_solver.h"
 #include "learner.h"
 #include "pretty_print_visitor.h" // DEBUG
 
@@ -47,6 +50,18 @@ namespace horn_verification
 
 			horn_verification::boogie_io boogie_io_object;
 
+			/// The sample, which is kept across calls of learn_decision_tree (unless a call fails)
+			std::unique_ptr<bounded_sample> sample;
+
+			/// The number of nodes reused from the previous tree during the last call of learn_decision_tree
+			std::size_t reused_nodes = 0;
+
+			/// The number of nodes built from scratch during the last call of learn_decision_tree
+			std::size_t rebuilt_nodes = 0;
+
+			/// The bound (or 0 if no bound is used) and the time in seconds of every run of the decision tree learner during the last call of learn_decision_tree
+			std::vector<std::pair<int, double>> bound_times;
+
 		public:
 
 			api_helper (attributes_metadata & _metadata, std::vector<datapoint<bool>> & _datapoints, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & _horn_indexes, std::vector<std::pair<unsigned, unsigned>> & _intervals): metadata(_metadata), datapoints(_datapoints), horn_indexes(_horn_indexes), intervals(_intervals)
@@ -59,10 +74,9 @@ namespace horn_verification
  *
  * 1) It generates derived predicates for each integer attribute of the form
  *    x <= c, x >= c, and x = c, where c is a constant given by the user
- * 2) It generates a new set of data points based on the derived attributes
- * 3) It generates a new set of Horn constraints based on these data points
- * 4) It runs Houdini on the data points and Horn constraints
- * 5) If a consistent conjunction exists, it constructs an equivalent decision
+ * 2) It evaluates the derived predicates on the data points (packed as bitsets)
+ * 3) It runs Houdini on these values and the Horn constraints
+ * 4) If a consistent conjunction exists, it constructs an equivalent decision
  *    tree and returns
  *
  * Throws an <code>no_conjunction_exists_exception</code> if no conjunction exists.
@@ -82,8 +96,7 @@ decision_tree horndini_prephase(const attributes_metadata & metadata, const std:
 	//
 	auto derived_predicates_and_intervals = horndini::generate_derived_predicates_and_intervals(intervals, c);
 
-	auto derived_datapoints = horndini::generate_derived_datapoints(datapoints, derived_predicates_and_intervals.first);
-	auto derived_horn_constraints = boogie_io_object.indexes2horn_constraints(horn_indexes, derived_datapoints);
+	derived_values values(datapoints, derived_predicates_and_intervals.first, derived_predicates_and_intervals.second);
 	assert (metadata.number_of_categories().size() == 1 && metadata.number_of_categories()[0] == derived_predicates_and_intervals.second.size());
 
 
@@ -104,7 +117,7 @@ decision_tree horndini_prephase(const attributes_metadata & metadata, const std:
 	// Run Horndini
 	//
 
-	horndini::learn(derived_datapoints, derived_horn_constraints, conjunctions);
+	horndini::learn(datapoints, values, horn_indexes, conjunctions);
 	auto horndini_tree = horndini::conjunctions2tree(metadata, derived_predicates_and_intervals.first, conjunctions);
 			
 	// Debug checks			
@@ -141,7 +154,97 @@ void print_help(std::ostream & out, const char * name)
 }
 
 
-decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
+/**
+ * Returns the number of nodes reused from the previous tree during the last call of learn_decision_tree().
+ *
+ * @return the number of reused nodes
+ */
+std::size_t number_of_reused_nodes() const
+{
+	return reused_nodes;
+}
+
+
+/**
+ * Returns the number of nodes built from scratch during the last call of learn_decision_tree().
+ *
+ * @return the number of rebuilt nodes
+ */
+std::size_t number_of_rebuilt_nodes() const
+{
+	return rebuilt_nodes;
+}
+
+
+/**
+ * Returns the bound (or 0 if no bound is used) and the time in seconds of every run of the decision
+ * tree learner during the last call of learn_decision_tree(). All but the last run have failed.
+ *
+ * @return the bound and time of every run
+ */
+const std::vector<std::pair<int, double>> & bound_level_times() const
+{
+	return bound_times;
+}
+
+
+/**
+ * Counts the nodes of the (sub)tree rooted at a given node.
+ *
+ * @param node The root of the (sub)tree
+ *
+ * @return the number of nodes
+ */
+static std::size_t count_nodes(base_node * node)
+{
+
+	if (node == nullptr)
+	{
+		return 0;
+	}
+
+	std::size_t count = 1;
+	if (auto cat_node = dynamic_cast<categorical_node *>(node))
+	{
+		for (const auto & child : cat_node->children())
+		{
+			count += count_nodes(child);
+		}
+	}
+	else if (auto i_node = dynamic_cast<int_node *>(node))
+	{
+		for (const auto & child : i_node->children())
+		{
+			count += count_nodes(child);
+		}
+	}
+
+	return count;
+
+}
+
+
+/**
+ * Learns a decision tree that is consistent with the sample. If the root of a previously learned
+ * tree is given, the decision tree learner reuses all nodes of this tree that are still consistent
+ * and only regrows the remaining subtrees.
+ *
+ * The sample (and the Horn solver) are kept across calls, hence the data points and Horn constraints
+ * may only grow between calls, and data points may only be classified (see bounded_sample::extend()).
+ *
+ * @param do_horndini_prephase Whether to run the Horndini pre-phase
+ * @param use_bounds Whether to bound the learner
+ * @param use_attribute_intervals Whether every data point fits the intervals, such that the split search
+ *        can be restricted to them (see simple_job_manager::fits_attribute_intervals())
+ * @param previous_root The root of a previously learned tree to reuse (or \c nullptr to learn from scratch)
+ *
+ * @return the learned decision tree
+ */
+decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds, bool use_attribute_intervals, base_node * previous_root = nullptr) {
+
+	reused_nodes = 0;
+	rebuilt_nodes = 0;
+	bound_times.clear();
 
 	//
 	// Run the learner and allow a graceful exit if something goes wrong
@@ -216,6 +319,7 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 				auto horndini_consistent = learner<complex_job_manager>::is_consistent(horndini_tree, datapoint_ptrs, horn_constraints);
 				if (horndini_consistent)
 				{
+					rebuilt_nodes = count_nodes(horndini_tree.root());
 					return horndini_tree;
 				}
 			}
@@ -233,6 +337,20 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 		 *
 		 ************************************************************************************/
 
+		//
+		// Create copy of data points, pointers thereof and Horn constraints, and label the data
+		// points derived from the Horn constraints (once for all bounds), or extend the sample of
+		// the previous call by the data points and Horn constraints added since
+		//
+		if (sample)
+		{
+			sample->extend(datapoints, horn_indexes);
+		}
+		else
+		{
+			sample.reset(new bounded_sample(datapoints, horn_indexes));
+		}
+
 		//
 		// Loop over increasing bounds (depending on the implementation of the bounds object, at some point no bound is used)
 		//
@@ -241,6 +359,9 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 		{
 			terminate = !cur_bound.use_bound();
 
+			auto start = std::chrono::steady_clock::now();
+			auto level = cur_bound.use_bound() ? cur_bound.get_bound() : 0;
+
 
 			//
 			// Try-catch block is used to handle situations where bounds are too small and need to be increased
@@ -249,72 +370,13 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 			{
 
 				//
-				// Create copy of data points and pointers thereof
-				//
-				std::vector<datapoint<bool>> datapoints_copy;
-				datapoints_copy.reserve(datapoints.size());
-				for (unsigned i = 0; i < datapoints.size(); ++i)
-				{
-					datapoints_copy.push_back(datapoints[i]);
-				}
-				std::vector<datapoint<bool> *> datapoint_ptrs;
-				datapoint_ptrs.reserve(datapoints.size());
-				for (unsigned i = 0; i < datapoints_copy.size(); ++i)
-				{
-					datapoint_ptrs.push_back(&datapoints_copy[i]);
-				}
-
-
-				//
-				// Generate Horn constraints
-				//
-				auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints_copy);
-
-				//
-				// Create bound constraints if necessary
-				//
-				if (cur_bound.use_bound())
-				{
-					
-					std::vector<horn_constraint<bool>> indistinguishability_horn_constraints;
-					
-					// Infer horn constraints which arise due to indistinguishability of data points
-					indistinguishability_horn_constraints = boogie_io::get_indistinguishable_datapoints(datapoints_copy, cur_bound.get_bound());
-
-					// Push these indistinguishability_horn_constraints to horn_constraints
-					horn_constraints.insert(horn_constraints.end(), std::make_move_iterator(indistinguishability_horn_constraints.begin()), std::make_move_iterator(indistinguishability_horn_constraints.end()));
-					
-				}
-
-				//
-				// Instantiate Horn solver and perform initial run to label data points if necessary
+				// Add bound constraints if necessary and perform initial run of the Horn solver
 				//
-				horn_solver<bool> solver;
-				std::unordered_set<datapoint<bool> *> positive_ptrs;
-				std::unordered_set<datapoint<bool> *> negative_ptrs;
+				sample->prepare(cur_bound);
 
-				// Initial run
-				auto ok = solver.solve(datapoint_ptrs, horn_constraints, positive_ptrs, negative_ptrs);
-				
-				if (ok)
-				{
-					
-					for (auto & dp : positive_ptrs)
-					{
-						dp->_is_classified = true;
-						dp->_classification = true;	
-					}
-
-					for (auto & dp : negative_ptrs)
-					{
-						dp->_is_classified = true;
-						dp->_classification = false;	
-					}					
-				}
-				else
-				{
-					throw sample_error("No consistent decision tree exists (Horn clauses are contradictory)");
-				}
+				auto & datapoint_ptrs = sample->datapoint_ptrs();
+				auto & horn_constraints = sample->horn_constraints();
+				auto & solver = sample->solver();
 
 				//
 				// Run decision tree learner
@@ -327,13 +389,21 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 				auto ec = EntropyComputation::PENALTY;
 				auto cs = ConjunctiveSetting::NOPREFERENCEFORCONJUNCTS;
 				auto manager = cur_bound.use_bound() ? complex_job_manager(datapoint_ptrs, horn_constraints, solver, cur_bound.get_bound(), ns, ec, cs) : complex_job_manager(datapoint_ptrs, horn_constraints, solver, ns, ec, cs);
+				if (use_attribute_intervals)
+				{
+					manager.set_attribute_intervals(intervals);
+				}
 				learner<complex_job_manager> l(manager);
-				auto decision_tree = l.learn(metadata, datapoint_ptrs, horn_constraints);
+				auto decision_tree = l.learn(metadata, datapoint_ptrs, horn_constraints, previous_root);
+				reused_nodes = l.manager().reused_nodes();
+				rebuilt_nodes = l.number_of_nodes() - reused_nodes;
 
 				//
 				// Debug
 				//
 				assert (l.is_consistent(decision_tree, datapoint_ptrs, horn_constraints));
+
+				bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
 				
 				terminate = true;
 
@@ -344,6 +414,8 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 			catch (const sample_error & ex)
 			{
 
+				bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+
 				// Increase bounds or declare inconsistent sample if no bounds ought to be used
 				if(cur_bound.use_bound())
 				{
@@ -361,6 +433,8 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 			catch (const split_not_possible_error & ex)
 			{
 			
+				bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+
 				// Increase bounds or declare inconsistent sample if no bounds ought to be used
 				if(cur_bound.use_bound())
 				{
@@ -380,10 +454,12 @@ decision_tree learn_decision_tree (bool do_horndini_prephase, bool use_bounds) {
 	//
 	catch (const std::exception & ex)
 	{
+		sample.reset();
 		std::cerr << ex.what() << std::endl;
 	}
 	catch (...)
 	{
+		sample.reset();
 		std::cerr << "The learner crashed due to an unknown reason" << std::endl;
 	}
 }
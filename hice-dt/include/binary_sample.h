@@ -0,0 +1,530 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __BINARY_SAMPLE_H__
+#define __BINARY_SAMPLE_H__
+
+// C++ includes
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// C includes (memory mapping is only available on POSIX systems)
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Project includes
+#include "attributes_metadata.h"
+#include "datapoint.h"
+#include "error.h"
+
+namespace horn_verification
+{
+
+	/**
+	 * This namespace defines the binary sample format, an alternative to the textual data and Horn
+	 * files that can be mapped into memory and only ever grows at its end.
+	 *
+	 * All numbers are 32 bit integers in little-endian byte order (the reader assumes a little-endian
+	 * machine and copies values directly from the mapped file).
+	 *
+	 * A <em>binary data file</em> (<tt>file_stem.data.bin</tt>) starts with a header consisting of
+	 * the magic number \ref data_magic, the number of categorical attributes and the number of integer
+	 * attributes, followed by one record of fixed size per data point: its label (see \ref label), the
+	 * values of its categorical attributes and the values of its integer attributes (in the order of
+	 * the attributes file). New data points are appended; the label of a data point is the only field
+	 * that can be overwritten later (as data points can get labeled in later rounds).
+	 *
+	 * A <em>binary Horn file</em> (<tt>file_stem.horn.bin</tt>) starts with the magic number
+	 * \ref horn_magic, followed by one record per Horn constraint: the index of its head (or
+	 * \ref no_head), the number of data points in its body and their indexes. New Horn constraints
+	 * are appended.
+	 *
+	 * Records that are only partially written (i.e., that end beyond the end of a file) are ignored.
+	 */
+	namespace binary_sample
+	{
+
+		/// Magic number of a binary data file ("HICEDAT1")
+		static const char data_magic[8] = { 'H', 'I', 'C', 'E', 'D', 'A', 'T', '1' };
+
+		/// Magic number of a binary Horn file ("HICEHRN1")
+		static const char horn_magic[8] = { 'H', 'I', 'C', 'E', 'H', 'R', 'N', '1' };
+
+		/// Head index of a Horn constraint without head
+		static const std::uint32_t no_head = 0xFFFFFFFF;
+
+		/// Size of the header of a binary data file in bytes
+		static const std::size_t data_header_size = sizeof(data_magic) + 2 * sizeof(std::uint32_t);
+
+		/// Labels of data points (the encoding used by MLHoudini)
+		enum label : std::uint32_t
+		{
+			unlabeled = 0,
+			positive = 1,
+			negative = 2
+		};
+
+	}; // End namespace binary_sample
+
+
+
+	/**
+	 * This class maps a file read-only into memory. The mapping can be refreshed to include data that
+	 * has been appended to the file since it was mapped.
+	 *
+	 * On POSIX systems, the file is mapped with <code>mmap</code>. On Windows, the file is read into
+	 * a buffer instead (and read again when refreshed after its size has changed).
+	 *
+	 * @version 1.0
+	 */
+	class mapped_file
+	{
+
+#ifdef _WIN32
+
+		/// The name of the file
+		std::string _filename;
+
+		/// The contents of the file
+		std::vector<unsigned char> _buffer;
+
+#else
+
+		/// The file descriptor (or -1 if the file is not open)
+		int _fd;
+
+#endif
+
+		/// The mapped memory (or nullptr if the file is empty)
+		const unsigned char * _data;
+
+		/// The number of mapped bytes
+		std::size_t _size;
+
+
+		/**
+		 * Unmaps the file.
+		 */
+		void unmap()
+		{
+#ifdef _WIN32
+			_buffer.clear();
+			_data = nullptr;
+#else
+			if (_data != nullptr)
+			{
+				munmap(const_cast<unsigned char *>(_data), _size);
+				_data = nullptr;
+			}
+#endif
+			_size = 0;
+		}
+
+
+	public:
+
+		/**
+		 * Opens and maps a file.
+		 *
+		 * @param filename The name of the file
+		 */
+		explicit mapped_file(const std::string & filename)
+#ifdef _WIN32
+			: _filename(filename), _data(nullptr), _size(0)
+		{
+			if (!std::ifstream(filename, std::ios::binary))
+			{
+				throw boogie_io_error("Error opening " + filename);
+			}
+
+			refresh();
+		}
+#else
+			: _fd(open(filename.c_str(), O_RDONLY)), _data(nullptr), _size(0)
+		{
+			if (_fd < 0)
+			{
+				throw boogie_io_error("Error opening " + filename);
+			}
+
+			refresh();
+		}
+#endif
+
+
+		mapped_file(const mapped_file &) = delete;
+
+		mapped_file & operator=(const mapped_file &) = delete;
+
+
+		/**
+		 * Unmaps and closes the file.
+		 */
+		~mapped_file()
+		{
+			unmap();
+#ifndef _WIN32
+			close(_fd);
+#endif
+		}
+
+
+		/**
+		 * Maps the file again if its size has changed since it was last mapped.
+		 */
+		void refresh()
+		{
+
+#ifdef _WIN32
+
+			std::ifstream infile(_filename, std::ios::binary | std::ios::ate);
+			if (!infile)
+			{
+				throw boogie_io_error("Error reading file status");
+			}
+
+			auto size = static_cast<std::size_t>(infile.tellg());
+			if (size == _size)
+			{
+				return;
+			}
+
+			unmap();
+			if (size > 0)
+			{
+
+				_buffer.resize(size);
+				infile.seekg(0);
+				if (!infile.read(reinterpret_cast<char *>(_buffer.data()), size))
+				{
+					throw boogie_io_error("Error reading file " + _filename);
+				}
+
+				_data = _buffer.data();
+				_size = size;
+
+			}
+
+#else
+
+			struct stat st;
+			if (fstat(_fd, &st) != 0)
+			{
+				throw boogie_io_error("Error reading file status");
+			}
+
+			auto size = static_cast<std::size_t>(st.st_size);
+			if (size == _size && (size == 0 || _data != nullptr))
+			{
+				return;
+			}
+
+			unmap();
+			if (size > 0)
+			{
+
+				auto data = mmap(nullptr, size, PROT_READ, MAP_SHARED, _fd, 0);
+				if (data == MAP_FAILED)
+				{
+					throw boogie_io_error("Error mapping file into memory");
+				}
+
+				_data = static_cast<const unsigned char *>(data);
+				_size = size;
+
+			}
+
+#endif
+
+		}
+
+
+		/**
+		 * Returns the mapped memory.
+		 *
+		 * @return the mapped memory (nullptr if the file is empty)
+		 */
+		inline const unsigned char * data() const
+		{
+			return _data;
+		}
+
+
+		/**
+		 * Returns the number of mapped bytes.
+		 *
+		 * @return the number of mapped bytes
+		 */
+		inline std::size_t size() const
+		{
+			return _size;
+		}
+
+	};
+
+
+
+	/**
+	 * This class reads a sample in the binary sample format (see \ref binary_sample) from a data file
+	 * and a Horn file that are mapped into memory.
+	 *
+	 * The reader remembers how far it has read both files. Hence, a reader that is kept across
+	 * rounds (as the server mode of hice-dt does for its <code>binary</code> messages) only converts
+	 * the records appended since the previous round (and rereads the labels of the data points it
+	 * has already read, which is a single integer per data point).
+	 *
+	 * @version 1.0
+	 */
+	class binary_sample_reader
+	{
+
+		/// The binary data file
+		mapped_file _data_file;
+
+		/// The binary Horn file
+		mapped_file _horn_file;
+
+		/// The number of categorical attributes
+		std::size_t _number_of_categorical;
+
+		/// The number of integer attributes
+		std::size_t _number_of_int;
+
+		/// The number of categories of the categorical attributes
+		std::vector<std::size_t> _number_of_categories;
+
+		/// The number of data points read so far
+		std::size_t _datapoints_read;
+
+		/// The offset of the first unread Horn constraint in the Horn file
+		std::size_t _horn_offset;
+
+
+		/**
+		 * Reads a 32 bit integer from memory (which need not be aligned).
+		 *
+		 * @param p The memory to read from
+		 *
+		 * @return the integer
+		 */
+		static std::uint32_t read_uint32(const unsigned char * p)
+		{
+			std::uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+
+		/**
+		 * Returns the size of a data point record in bytes.
+		 *
+		 * @return the size of a data point record
+		 */
+		inline std::size_t record_size() const
+		{
+			return (1 + _number_of_categorical + _number_of_int) * sizeof(std::uint32_t);
+		}
+
+
+		/**
+		 * Sets the label of a data point.
+		 *
+		 * @param dp The data point
+		 * @param label The label as stored in the data file
+		 * @param index The index of the data point (for error messages)
+		 */
+		static void set_label(datapoint<bool> & dp, std::uint32_t label, std::size_t index)
+		{
+			switch (label)
+			{
+				case binary_sample::unlabeled:
+					dp._is_classified = false;
+					dp._classification = false; // Unimportant
+					break;
+
+				case binary_sample::positive:
+					dp._is_classified = true;
+					dp._classification = true;
+					break;
+
+				case binary_sample::negative:
+					dp._is_classified = true;
+					dp._classification = false;
+					break;
+
+				default:
+					throw boogie_io_error("Invalid classification of data point " + std::to_string(index));
+			}
+		}
+
+
+	public:
+
+		/**
+		 * Creates a reader for a binary data file and a binary Horn file and checks that the data file
+		 * matches the given attributes.
+		 *
+		 * @param data_filename The name of the binary data file
+		 * @param horn_filename The name of the binary Horn file
+		 * @param metadata Meta data of the attributes
+		 */
+		binary_sample_reader(const std::string & data_filename, const std::string & horn_filename, const attributes_metadata & metadata)
+			: _data_file(data_filename), _horn_file(horn_filename), _number_of_categorical(metadata.categorical_names().size()), _number_of_int(metadata.int_names().size()), _number_of_categories(metadata.number_of_categories()), _datapoints_read(0), _horn_offset(sizeof(binary_sample::horn_magic))
+		{
+
+			// Check header of data file
+			if (_data_file.size() < binary_sample::data_header_size || std::memcmp(_data_file.data(), binary_sample::data_magic, sizeof(binary_sample::data_magic)) != 0)
+			{
+				throw boogie_io_error("Invalid header of " + data_filename);
+			}
+			if (read_uint32(_data_file.data() + 8) != _number_of_categorical || read_uint32(_data_file.data() + 12) != _number_of_int)
+			{
+				throw boogie_io_error("Number of attributes in " + data_filename + " does not match attributes file");
+			}
+
+			// Check header of Horn file
+			if (_horn_file.size() < sizeof(binary_sample::horn_magic) || std::memcmp(_horn_file.data(), binary_sample::horn_magic, sizeof(binary_sample::horn_magic)) != 0)
+			{
+				throw boogie_io_error("Invalid header of " + horn_filename);
+			}
+
+		}
+
+
+		/**
+		 * Reads the data points that have been appended to the data file since the last call and adds
+		 * them to \p datapoints, which needs to contain the data points read before (in the same order).
+		 * The labels of the latter are updated.
+		 *
+		 * \post Ensures that each data point has the correct number of values for each type of
+		 *       attribute type and that each categorical value is valid.
+		 *
+		 * @param datapoints The data points to update and extend
+		 */
+		void read_datapoints(std::vector<datapoint<bool>> & datapoints)
+		{
+
+			_data_file.refresh();
+
+			if (datapoints.size() != _datapoints_read)
+			{
+				throw boogie_io_error("Data points do not match the data points read before");
+			}
+
+			const auto record = record_size();
+			const auto number_of_datapoints = (_data_file.size() - binary_sample::data_header_size) / record;
+			const auto * records = _data_file.data() + binary_sample::data_header_size;
+
+
+			// Update labels of known data points
+			for (std::size_t i = 0; i < _datapoints_read; ++i)
+			{
+				set_label(datapoints[i], read_uint32(records + i * record), i);
+			}
+
+
+			// Convert new data points
+			datapoints.reserve(number_of_datapoints);
+			for (std::size_t i = _datapoints_read; i < number_of_datapoints; ++i)
+			{
+
+				const auto * p = records + i * record;
+
+				datapoint<bool> dp;
+				set_label(dp, read_uint32(p), i);
+				dp._identifier = i;
+				p += sizeof(std::uint32_t);
+
+				// Categorical attributes
+				dp._categorical_data.resize(_number_of_categorical);
+				if (_number_of_categorical > 0)
+				{
+					std::memcpy(dp._categorical_data.data(), p, _number_of_categorical * sizeof(std::uint32_t));
+				}
+				p += _number_of_categorical * sizeof(std::uint32_t);
+
+				for (std::size_t j = 0; j < _number_of_categorical; ++j)
+				{
+					if (dp._categorical_data[j] >= _number_of_categories[j])
+					{
+						throw boogie_io_error("Invalid category value of data point " + std::to_string(i));
+					}
+				}
+
+				// Integer attributes
+				dp._int_data.resize(_number_of_int);
+				if (_number_of_int > 0)
+				{
+					std::memcpy(dp._int_data.data(), p, _number_of_int * sizeof(std::int32_t));
+				}
+
+				datapoints.push_back(std::move(dp)); // No use of dp after this point
+
+			}
+
+			_datapoints_read = number_of_datapoints;
+
+		}
+
+
+		/**
+		 * Reads the Horn constraints that have been appended to the Horn file since the last call and
+		 * adds them to \p horn_constraints as pair of sets of indexes (see boogie_io::read_horn_file).
+		 *
+		 * @param horn_constraints The Horn constraints to extend
+		 */
+		void read_horn_constraints(std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints)
+		{
+
+			_horn_file.refresh();
+
+			const auto * data = _horn_file.data();
+			const auto size = _horn_file.size();
+
+			while (_horn_offset + 2 * sizeof(std::uint32_t) <= size)
+			{
+
+				auto head = read_uint32(data + _horn_offset);
+				auto body_size = read_uint32(data + _horn_offset + sizeof(std::uint32_t));
+				auto end = _horn_offset + (2 + static_cast<std::size_t>(body_size)) * sizeof(std::uint32_t);
+
+				// Partially written record
+				if (end > size)
+				{
+					break;
+				}
+
+				std::set<unsigned> premises;
+				for (std::size_t p = _horn_offset + 2 * sizeof(std::uint32_t); p < end; p += sizeof(std::uint32_t))
+				{
+					premises.insert(read_uint32(data + p));
+				}
+
+				std::set<unsigned> consequence;
+				if (head != binary_sample::no_head)
+				{
+					consequence.insert(head);
+				}
+
+				horn_constraints.push_back(std::make_pair(std::move(premises), std::move(consequence)));
+				_horn_offset = end;
+
+			}
+
+		}
+
+	};
+
+}; // End namespace horn_verification
+
+#endif
@@ -8,6 +8,8 @@
 // C++ includes
 #include <algorithm>
 #include <functional> 
+#include <istream>
+#include <ostream>
 #include <set>
 #include <sstream>
 #include <string>
@@ -174,6 +176,23 @@ namespace horn_verification
 		 * @returns the data points read from file
 		 */
 		static std::vector<datapoint<bool>> read_data_file(const std::string & filename, const attributes_metadata & metadata);
+
+
+		/**
+		 * Reads data points in the format of \ref read_data_file from an input stream and appends
+		 * them to \p datapoints. The identifiers of the new data points continue the numbering of
+		 * the data points already in \p datapoints.
+		 *
+		 * Reading stops at the end of the stream or at the first line that equals \p terminator
+		 * (which is consumed). An empty terminator never matches.
+		 *
+		 * @param in The input stream to read from
+		 * @param filename The name of the input used in error messages
+		 * @param metadata Meta data of the attributes
+		 * @param datapoints The vector to which the data points are added
+		 * @param terminator The line that ends the data points
+		 */
+		static void read_data(std::istream & in, const std::string & filename, const attributes_metadata & metadata, std::vector<datapoint<bool>> & datapoints, const std::string & terminator = "");
 	
 	
 		/**
@@ -201,6 +220,21 @@ namespace horn_verification
 		 * @returns the horn constraints as indexes read from file
 		 */		
 		static std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> read_horn_file(const std::string & filename);
+
+
+		/**
+		 * Reads Horn constraints in the format of \ref read_horn_file from an input stream and
+		 * appends them (as pairs of sets of indexes) to \p horn_constraints.
+		 *
+		 * Reading stops at the end of the stream or at the first line that equals \p terminator
+		 * (which is consumed). An empty terminator never matches.
+		 *
+		 * @param in The input stream to read from
+		 * @param filename The name of the input used in error messages
+		 * @param horn_constraints The vector to which the Horn constraints are added
+		 * @param terminator The line that ends the Horn constraints
+		 */
+		static void read_horn_constraints(std::istream & in, const std::string & filename, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints, const std::string & terminator = "");
 	
 		
 		/**
@@ -214,6 +248,39 @@ namespace horn_verification
 		static std::vector<horn_constraint<bool>> read_horn_file(const std::string & filename, std::vector<datapoint<bool>> & datapoints);
 	
 	
+		/**
+		 * Reads data points and Horn constraints in the binary sample format (see \ref binary_sample)
+		 * from the files <tt>file_stem.data.bin</tt> and <tt>file_stem.horn.bin</tt>. The result is the
+		 * same as reading the equivalent text files with \ref read_data_file and \ref read_horn_file.
+		 *
+		 * @param file_stem The file stem
+		 * @param metadata Meta data of the attributes
+		 * @param datapoints The vector to which the data points are added
+		 * @param horn_constraints The vector to which the Horn constraints (as indexes) are added
+		 */
+		static void read_binary_sample(const std::string & file_stem, const attributes_metadata & metadata, std::vector<datapoint<bool>> & datapoints, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints);
+
+
+		/**
+		 * Writes data points to a binary data file (see \ref binary_sample).
+		 *
+		 * @param filename The name of the file to write
+		 * @param datapoints The data points
+		 * @param metadata Meta data of the attributes
+		 */
+		static void write_binary_data_file(const std::string & filename, const std::vector<datapoint<bool>> & datapoints, const attributes_metadata & metadata);
+
+
+		/**
+		 * Writes Horn constraints given as pairs of sets of indexes to a binary Horn file (see
+		 * \ref binary_sample).
+		 *
+		 * @param filename The name of the file to write
+		 * @param horn_constraints The Horn constraints as indexes
+		 */
+		static void write_binary_horn_file(const std::string & filename, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints);
+
+
 		/**
 		 * Converts Horn constraints as a pair of sets of indexes into horn_constraint objects.
 		 *
@@ -236,6 +303,17 @@ namespace horn_verification
 		static void write_json_file(const std::string & filename, decision_tree & tree, const attributes_metadata & metadata);
 
 
+		/**
+		 * Write a JSON serialization of a decision tree (with attribute given by \p metadata) to an
+		 * output stream.
+		 *
+		 * @param out The output stream to write to
+		 * @param tree The decision tree to serialize
+		 * @param metadata Meta data of the attributes
+		 */
+		static void write_json(std::ostream & out, decision_tree & tree, const attributes_metadata & metadata);
+
+
 		/**
 		 * Reads an interval file from file.
 		 * Each interval is represented by a line containing two natural numbers:
@@ -249,7 +327,13 @@ namespace horn_verification
 		
 
 		/**
-		 * Get Horn contraints for all pairs of points in \p datapoint, which are indistinguishable using |thresholds| < \p threshold.
+		 * Get Horn contraints that force points in \p datapoint, which are indistinguishable using |thresholds| < \p threshold,
+		 * to the same label.
+		 *
+		 * Since indistinguishability is an equivalence relation, the data points are grouped into classes (by hashing them with
+		 * their integer values clamped to [-\p threshold, \p threshold + 1]) and the data points of each class are linked by a
+		 * cycle of Horn constraints. This takes linear time (instead of quadratic time) and yields one Horn constraint per data
+		 * point in a class with more than one data point (instead of two per pair of indistinguishable data points).
 		 *
 		 * @param datapoint The datapoints passed to the learner
 		 * @param threshold Determines which datapoints are induistinguishable. A Pair of datapoints d1, d2 are indistinguishable 
@@ -0,0 +1,312 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __BOUNDED_SAMPLE_H__
+#define __BOUNDED_SAMPLE_H__
+
+// C++ includes
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Project includes
+#include "boogie_io.h"
+#include "bound.h"
+#include "datapoint.h"
+#include "error.h"
+#include "horn_constraint.h"
+#include "incremental_horn_solver.h"
+
+namespace horn_verification
+{
+
+	/**
+	 * This class prepares a sample for the decision tree learner at increasing bounds.
+	 *
+	 * The parts of a sample that do not depend on the bound are built once: the copy of the data
+	 * points (which the learner labels), the pointers thereof, the Horn constraints of the sample
+	 * and the classifications that the Horn solver derives from them. Before the learner runs at
+	 * a bound, prepare() only restores these classifications and the order of the pointers (both
+	 * of which a failed run changes) and replaces the indistinguishability constraints of the
+	 * previous bound by those of the new bound.
+	 *
+	 * The sample also keeps the Horn solver for the learner. After the Horn constraints of the
+	 * sample have been propagated, the state of the solver is saved (see
+	 * incremental_horn_solver::checkpoint()), and prepare() returns the solver to this state
+	 * instead of rebuilding it. Only the indistinguishability constraints of the bound are added.
+	 *
+	 * A sample can be kept across rounds of learning: extend() adds the data points, the
+	 * classifications and the Horn constraints that are new in a round and propagates only these,
+	 * unless the vector of data points has to grow, which moves the data points and, hence,
+	 * requires to rebuild the solver.
+	 *
+	 * @version 1.0
+	 */
+	class bounded_sample
+	{
+
+		/// The data points (labeled by the learner)
+		std::vector<datapoint<bool>> _datapoints;
+
+		/// Pointers to the data points (reordered by the learner)
+		std::vector<datapoint<bool> *> _datapoint_ptrs;
+
+		/// The Horn constraints of the sample followed by the indistinguishability constraints of the current bound
+		std::vector<horn_constraint<bool>> _horn_constraints;
+
+		/// The number of Horn constraints of the sample
+		std::size_t _number_of_sample_constraints = 0;
+
+		/// The classification of every data point derived from the Horn constraints of the sample (is classified, classification)
+		std::vector<std::pair<bool, bool>> _labels;
+
+		/// The Horn solver (used by the learner)
+		incremental_horn_solver<bool> _solver;
+
+
+		/**
+		 * Runs the Horn solver on all Horn constraints and classifies the data points it derives.
+		 */
+		void propagate()
+		{
+
+			std::unordered_set<datapoint<bool> *> positive_ptrs;
+			std::unordered_set<datapoint<bool> *> negative_ptrs;
+
+			if (!_solver.solve(_datapoint_ptrs, _horn_constraints, positive_ptrs, negative_ptrs))
+			{
+				throw sample_error("No consistent decision tree exists (Horn clauses are contradictory)");
+			}
+
+			for (auto & dp : positive_ptrs)
+			{
+				dp->_is_classified = true;
+				dp->_classification = true;
+			}
+
+			for (auto & dp : negative_ptrs)
+			{
+				dp->_is_classified = true;
+				dp->_classification = false;
+			}
+
+		}
+
+
+		/**
+		 * Restores the state after the propagation of the Horn constraints of the sample: the
+		 * classifications and the order of the pointers, the Horn constraints and the solver.
+		 */
+		void restore()
+		{
+
+			for (std::size_t i = 0; i < _datapoints.size(); ++i)
+			{
+				_datapoints[i]._is_classified = _labels[i].first;
+				_datapoints[i]._classification = _labels[i].second;
+				_datapoint_ptrs[i] = &_datapoints[i];
+			}
+
+			_horn_constraints.erase(_horn_constraints.begin() + _number_of_sample_constraints, _horn_constraints.end());
+
+			_solver.rollback();
+
+		}
+
+
+		/**
+		 * Makes room for new data points. If the data points have to be moved, the pointers to them
+		 * are updated and the solver is rebuilt at its next call.
+		 *
+		 * @param number_of_datapoints The number of data points to make room for
+		 */
+		void reserve(std::size_t number_of_datapoints)
+		{
+
+			if (number_of_datapoints <= _datapoints.capacity())
+			{
+				return;
+			}
+
+			std::vector<datapoint<bool>> datapoints;
+			datapoints.reserve(std::max(number_of_datapoints, 2 * _datapoints.capacity()));
+			datapoints.insert(datapoints.end(), std::make_move_iterator(_datapoints.begin()), std::make_move_iterator(_datapoints.end()));
+
+			auto move = [this, &datapoints](datapoint<bool> * dp) { return dp == nullptr ? nullptr : &datapoints[dp - _datapoints.data()]; };
+			for (auto & dp : _datapoint_ptrs)
+			{
+				dp = move(dp);
+			}
+			for (auto & constraint : _horn_constraints)
+			{
+				for (auto & dp : constraint._premises)
+				{
+					dp = move(dp);
+				}
+				constraint._conclusion = move(constraint._conclusion);
+			}
+
+			_datapoints.swap(datapoints);
+			_solver.next_generation();
+
+		}
+
+
+	public:
+
+		/**
+		 * Creates a new sample from data points and Horn constraints and classifies the data
+		 * points derived from the Horn constraints.
+		 *
+		 * Throws a <code>sample_error</code> if the Horn constraints are contradictory (no bound
+		 * can make up for this).
+		 *
+		 * @param datapoints The data points
+		 * @param horn_indexes The Horn constraints, modeled as indexes into the <code>datapoints</code> vector
+		 */
+		bounded_sample(const std::vector<datapoint<bool>> & datapoints, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_indexes)
+		{
+			extend(datapoints, horn_indexes);
+		}
+
+
+		bounded_sample(const bounded_sample &) = delete;
+
+		bounded_sample & operator=(const bounded_sample &) = delete;
+
+
+		/**
+		 * Extends the sample by the data points, classifications and Horn constraints that have
+		 * been added since the sample was created or last extended, and classifies the data points
+		 * derived from them. The data points and Horn constraints of the sample need to be a prefix
+		 * of the given ones, and the data points of the sample may only have been classified (in
+		 * accordance with the sample) since.
+		 *
+		 * Throws a <code>sample_error</code> if the Horn constraints are contradictory, after which
+		 * the sample must not be used anymore.
+		 *
+		 * @param datapoints The data points
+		 * @param horn_indexes The Horn constraints, modeled as indexes into the <code>datapoints</code> vector
+		 */
+		void extend(const std::vector<datapoint<bool>> & datapoints, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_indexes)
+		{
+
+			assert (datapoints.size() >= _datapoints.size() && horn_indexes.size() >= _number_of_sample_constraints);
+
+			restore();
+			reserve(datapoints.size());
+
+			// Data points that are new or have been classified since
+			std::vector<datapoint<bool> *> changed_ptrs;
+
+			for (std::size_t i = 0; i < _datapoints.size(); ++i)
+			{
+				if (datapoints[i]._is_classified && (!_datapoints[i]._is_classified || _datapoints[i]._classification != datapoints[i]._classification))
+				{
+					_datapoints[i]._is_classified = true;
+					_datapoints[i]._classification = datapoints[i]._classification;
+					changed_ptrs.push_back(&_datapoints[i]);
+				}
+			}
+
+			for (std::size_t i = _datapoints.size(); i < datapoints.size(); ++i)
+			{
+				_datapoints.push_back(datapoints[i]);
+				_datapoint_ptrs.push_back(&_datapoints.back());
+				changed_ptrs.push_back(&_datapoints.back());
+			}
+
+			// New Horn constraints
+			auto horn_constraints = boogie_io::indexes2horn_constraints(std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>>(horn_indexes.begin() + _number_of_sample_constraints, horn_indexes.end()), _datapoints);
+
+			_solver.extend(changed_ptrs, horn_constraints);
+			_horn_constraints.insert(_horn_constraints.end(), std::make_move_iterator(horn_constraints.begin()), std::make_move_iterator(horn_constraints.end()));
+			_number_of_sample_constraints = _horn_constraints.size();
+
+			// Propagate and save the result
+			propagate();
+
+			_labels.resize(_datapoints.size());
+			for (std::size_t i = 0; i < _datapoints.size(); ++i)
+			{
+				_labels[i] = std::make_pair(_datapoints[i]._is_classified, _datapoints[i]._classification);
+			}
+
+			_solver.checkpoint();
+
+		}
+
+
+		/**
+		 * Prepares the sample for a run of the learner at the given bound (or without bound if
+		 * the bound is not to be used) and performs the initial run of the Horn solver, which the
+		 * learner then uses.
+		 *
+		 * Throws a <code>sample_error</code> if the indistinguishability constraints contradict
+		 * the sample.
+		 *
+		 * @param cur_bound The bound
+		 */
+		void prepare(const bound<> & cur_bound)
+		{
+
+			restore();
+
+			// Add indistinguishability constraints
+			if (cur_bound.use_bound())
+			{
+
+				auto indistinguishability_horn_constraints = boogie_io::get_indistinguishable_datapoints(_datapoints, cur_bound.get_bound());
+				_solver.extend(std::vector<datapoint<bool> *>(), indistinguishability_horn_constraints);
+				_horn_constraints.insert(_horn_constraints.end(), std::make_move_iterator(indistinguishability_horn_constraints.begin()), std::make_move_iterator(indistinguishability_horn_constraints.end()));
+
+			}
+
+			// Initial run (which also sets up the solver for the learner)
+			propagate();
+
+		}
+
+
+		/**
+		 * Returns the pointers to the data points, which are passed to the learner.
+		 *
+		 * @return the pointers to the data points
+		 */
+		std::vector<datapoint<bool> *> & datapoint_ptrs()
+		{
+			return _datapoint_ptrs;
+		}
+
+
+		/**
+		 * Returns the Horn constraints for the current bound, which are passed to the learner.
+		 *
+		 * @return the Horn constraints
+		 */
+		std::vector<horn_constraint<bool>> & horn_constraints()
+		{
+			return _horn_constraints;
+		}
+
+
+		/**
+		 * Returns the Horn solver for the current bound, which is passed to the learner.
+		 *
+		 * @return the Horn solver
+		 */
+		incremental_horn_solver<bool> & solver()
+		{
+			return _solver;
+		}
+
+	};
+
+}; // End namespace horn_verification
+
+#endif
@@ -0,0 +1,248 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __COLUMNAR_SAMPLE_H__
+#define __COLUMNAR_SAMPLE_H__
+
+// C++ includes
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// Project includes
+#include "datapoint.h"
+
+namespace horn_verification
+{
+
+	/**
+	 * This class stores the data of a sample column by column: every attribute occupies one
+	 * contiguous column, and the labels of the data points are packed into two bitsets (whether
+	 * a data point is classified and, if so, its classification). A data point is identified by
+	 * its row, i.e., its index in the vector of data points the sample was built from.
+	 *
+	 * In contrast to a vector of data points, which stores two vectors per data point on the heap,
+	 * a scan over one attribute of a columnar sample reads consecutive memory only. Information
+	 * that refers to data points, such as the horn constraints in which they occur, is kept apart
+	 * from the sample by whoever needs it (indexed by row).
+	 *
+	 * @version 1.0
+	 */
+	class columnar_sample
+	{
+
+		/// The number of data points
+		std::size_t _size;
+
+		/// The columns of the categorical attributes
+		std::vector<std::vector<unsigned int>> _categorical_columns;
+
+		/// The columns of the integer attributes
+		std::vector<std::vector<int>> _int_columns;
+
+		/// Bitset of the data points that are classified
+		std::vector<std::uint64_t> _is_classified;
+
+		/// Bitset of the data points that are classified as positive
+		std::vector<std::uint64_t> _classification;
+
+
+		/**
+		 * Sets or clears a bit of a bitset.
+		 *
+		 * @param bits The bitset
+		 * @param row The bit
+		 * @param value The new value of the bit
+		 */
+		static void set_bit(std::vector<std::uint64_t> & bits, std::size_t row, bool value)
+		{
+			if (value)
+			{
+				bits[row / 64] |= std::uint64_t(1) << (row % 64);
+			}
+			else
+			{
+				bits[row / 64] &= ~(std::uint64_t(1) << (row % 64));
+			}
+		}
+
+		/**
+		 * Returns a bit of a bitset.
+		 *
+		 * @param bits The bitset
+		 * @param row The bit
+		 *
+		 * @return the value of the bit
+		 */
+		static bool get_bit(const std::vector<std::uint64_t> & bits, std::size_t row)
+		{
+			return (bits[row / 64] >> (row % 64)) & 1;
+		}
+
+	public:
+
+		/**
+		 * Creates an empty sample.
+		 */
+		columnar_sample()
+			: _size(0)
+		{
+			// Nothing
+		}
+
+
+		/**
+		 * Creates a columnar copy of data points. All data points need to have the same number of
+		 * categorical and integer attributes.
+		 *
+		 * @param datapoint_ptrs The data points (row \c i of the sample is <code>datapoint_ptrs[i]</code>)
+		 */
+		explicit columnar_sample(const std::vector<datapoint<bool> *> & datapoint_ptrs)
+			: _size(datapoint_ptrs.size())
+		{
+			if (datapoint_ptrs.empty())
+			{
+				return;
+			}
+
+			_categorical_columns.assign(datapoint_ptrs.front()->_categorical_data.size(), std::vector<unsigned int>(_size));
+			_int_columns.assign(datapoint_ptrs.front()->_int_data.size(), std::vector<int>(_size));
+			_is_classified.assign((_size + 63) / 64, 0);
+			_classification.assign((_size + 63) / 64, 0);
+
+			for (std::size_t row = 0; row < _size; ++row)
+			{
+				const auto dp = datapoint_ptrs[row];
+				assert (dp->_categorical_data.size() == _categorical_columns.size());
+				assert (dp->_int_data.size() == _int_columns.size());
+
+				for (std::size_t attribute = 0; attribute < _categorical_columns.size(); ++attribute)
+				{
+					_categorical_columns[attribute][row] = dp->_categorical_data[attribute];
+				}
+				for (std::size_t attribute = 0; attribute < _int_columns.size(); ++attribute)
+				{
+					_int_columns[attribute][row] = dp->_int_data[attribute];
+				}
+				set_label(row, *dp);
+			}
+		}
+
+
+		/**
+		 * Returns the number of data points.
+		 *
+		 * @return the number of data points
+		 */
+		inline std::size_t size() const
+		{
+			return _size;
+		}
+
+
+		/**
+		 * Returns the column of a categorical attribute.
+		 *
+		 * @param attribute The categorical attribute
+		 *
+		 * @return the values of the attribute, indexed by row
+		 */
+		inline const std::vector<unsigned int> & categorical_column(std::size_t attribute) const
+		{
+			return _categorical_columns[attribute];
+		}
+
+
+		/**
+		 * Returns the column of an integer attribute.
+		 *
+		 * @param attribute The integer attribute
+		 *
+		 * @return the values of the attribute, indexed by row
+		 */
+		inline const std::vector<int> & int_column(std::size_t attribute) const
+		{
+			return _int_columns[attribute];
+		}
+
+
+		/**
+		 * Returns whether a data point is classified.
+		 *
+		 * @param row The row of the data point
+		 *
+		 * @return whether the data point is classified
+		 */
+		inline bool is_classified(std::size_t row) const
+		{
+			return get_bit(_is_classified, row);
+		}
+
+
+		/**
+		 * Returns the classification of a data point (\c false if it is not classified).
+		 *
+		 * @param row The row of the data point
+		 *
+		 * @return whether the data point is classified as positive
+		 */
+		inline bool classification(std::size_t row) const
+		{
+			return get_bit(_classification, row);
+		}
+
+
+		/**
+		 * Copies the label of a data point into a row, e.g., after the data point has been classified.
+		 *
+		 * @param row The row of the data point
+		 * @param dp The data point
+		 */
+		inline void set_label(std::size_t row, const datapoint<bool> & dp)
+		{
+			set_bit(_is_classified, row, dp._is_classified);
+			set_bit(_classification, row, dp._is_classified && dp._classification);
+		}
+
+
+		/**
+		 * Returns the number of bytes this sample occupies per data point (excluding the unused
+		 * capacity of its vectors).
+		 *
+		 * @return the number of bytes per data point
+		 */
+		double bytes_per_point() const
+		{
+			if (_size == 0)
+			{
+				return 0;
+			}
+
+			std::size_t bytes = sizeof(columnar_sample);
+			bytes += _categorical_columns.size() * (sizeof(std::vector<unsigned int>) + _size * sizeof(unsigned int));
+			bytes += _int_columns.size() * (sizeof(std::vector<int>) + _size * sizeof(int));
+			bytes += (_is_classified.size() + _classification.size()) * sizeof(std::uint64_t);
+
+			return static_cast<double>(bytes) / _size;
+		}
+
+
+		/**
+		 * Returns the number of bytes a data point occupies as an object of its own, including the
+		 * data of its attributes on the heap (but excluding the bookkeeping of the memory allocator).
+		 *
+		 * @param dp The data point
+		 *
+		 * @return the number of bytes of the given data point
+		 */
+		static std::size_t bytes_of(const datapoint<bool> & dp)
+		{
+			return sizeof(datapoint<bool>) + dp._categorical_data.capacity() * sizeof(unsigned int) + dp._int_data.capacity() * sizeof(int);
+		}
+
+	};
+
+}; // End namespace horn_verification
+
+#endif
@@ -9,7 +9,6 @@
 #include <ostream>
 #include <string>
 #include <vector>
-#include <unordered_set>
 
 // Project includes
 #include "horn_constraint.h"
@@ -98,23 +97,12 @@ namespace horn_verification
 		/// Identifier of a datapoint.
 		unsigned _identifier;
 
-		/// Container for the weak markings of a datapoint.
-		mutable std::unordered_set <datapoint<T> *> _list_of_marking;
-
-		/// Container for the horn constraints in which the datapoint is present.
-		mutable std::unordered_set <horn_constraint<T> *> _list_of_horn_constraints;
-
 		/**
 		* Set the classification of a datapoint.
 		* @param classification
 		*/
 		bool set_classification(T classification);
 
-		/**
-		* Remove all satisfied horn constraints.
-		*/
-		void remove_satisfied_horn_clauses();
-
 		/**
 		* Constructor.
 		* @param identifier
@@ -130,17 +118,6 @@ namespace horn_verification
 		datapoint(T classification, bool is_classified, unsigned identifier);
 
 
-		/**
-		* Copy constructor.
-		* @param classification
-		* @param is_classified
-		* @param list_of_marking
-		* @param list_of_horn_constraints
-		* @param identifier
-		*/
-		datapoint(T classification, bool is_classified, std::unordered_set <datapoint<T> *> list_of_marking, std::unordered_set <horn_constraint<T> *> list_of_horn_constraints, unsigned identifier);
-
-
 		/**
 		 * Checks whether this data point is distinguishable from the other datapoint, given the threshold
 		 *
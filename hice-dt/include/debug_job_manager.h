@@ -90,10 +90,9 @@ namespace horn_verification
 	 *      This method adds a new \ref slice to the job manager.</li>
 	 *  <li>next_job(): This method returns the job the manager wants to have
 	 *      performed next. A job can be to splt a node (i.e., either a
-	 *      \ref categorical_split_job or an \ref int_split_job, depending on
-	 *      which type of attribute the learner should split on) or to create a
-	 *      leaf node (i.e., a \ref leaf_creation_job). In order to facilitate
-	 *      polymorphism and be exception safe, the manager returns a \p unique_ptr.</li>
+	 *      categorical or an integer split, depending on which type of attribute
+	 *      the learner should split on) or to create a leaf node. The manager
+	 *      returns the job by value as a \ref node_job.</li>
 	 *  <li>has_jobs(): This method returns whether there are jobts that the
 	 *      learner needs to process.</li>
 	 * </ul>
@@ -186,9 +185,9 @@ namespace horn_verification
 		 * This implementation is simplistic in that it retrieves slices in a breadth-first order
 		 * and uses a simple entropy measure to split slices.
 		 *
-		 * @returns a unique pointer to the next job
+		 * @returns the next job
 		 */
-		std::unique_ptr<abstract_job> next_job()
+		node_job next_job()
 		{
 		
 			//
@@ -212,7 +211,7 @@ namespace horn_verification
 				}
 				
 				_is_first_split = false;
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, 0) };
+				return node_job::categorical_split(sl, 0);
 				
 			}
 		
@@ -228,7 +227,7 @@ namespace horn_verification
 			// Slice can be turned into a leaf node
 			if (can_be_turned_into_leaf)
 			{
-				return std::unique_ptr<abstract_job> {std::make_unique<leaf_creation_job>(sl, label, std::move(positive_ptrs), std::move(negative_ptrs))};
+				return node_job::leaf_creation(sl, label, std::move(positive_ptrs), std::move(negative_ptrs));
 			}
 			// Slice needs to be split
 			else
@@ -520,9 +519,9 @@ namespace horn_verification
 		 *
 		 * @param sl The slice of data points to be split
 		 *
-		 * @returns a unique pointer to the job created
+		 * @returns the job created
 		 */
-		std::unique_ptr<abstract_job> find_best_split(const slice & sl)
+		node_job find_best_split(const slice & sl)
 		{
 		
 			//std::cout << "---------- " << sl << " ----------" << std::endl;
@@ -666,12 +665,12 @@ namespace horn_verification
 			
 			else if (int_split_possible && !cat_split_possible)
 			{
-				return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+				return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 			}
 			
 			else if (!int_split_possible && cat_split_possible)
 			{
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+				return node_job::categorical_split(sl, best_cat_attribute);
 			}
 			
 			else
@@ -679,11 +678,11 @@ namespace horn_verification
 				
 				if (best_int_entropy <= best_cat_entropy)
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+					return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 				}
 				else
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+					return node_job::categorical_split(sl, best_cat_attribute);
 				}
 
 			}
@@ -7,6 +7,10 @@
 
 // C++ includes
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <vector>
 
 
@@ -125,11 +129,11 @@ namespace horn_verification
 		
 	
 		/**
-		 * Destructor.
+		 * Destructor. The children are not deleted, as they are owned by the tree (see \ref decision_tree).
 		 */
 		~categorical_node()
 		{
-			for_each (_children.begin(), _children.end(), [](base_node * child){ if (child) delete child; });
+			// Nothing
 		}
 	
 	
@@ -208,7 +212,7 @@ namespace horn_verification
 		int _threshold;
 
 		/// The children of this node
-		std::vector<base_node *> _children;
+		std::array<base_node *, 2> _children;
 	
 	
 	public:
@@ -220,7 +224,7 @@ namespace horn_verification
 		 * @param threshold The decision threshold
 		 */
 		int_node(std::size_t attribute, int threshold)
-			: _attribute(attribute), _threshold(threshold), _children(2)
+			: _attribute(attribute), _threshold(threshold), _children({ { nullptr, nullptr } })
 		{
 			// Nothing
 		}
@@ -232,7 +236,7 @@ namespace horn_verification
 		 * @param other The object to copy
 		 */
 		int_node(const int_node & other)
-			: _attribute(other._attribute), _threshold(other._threshold), _children(2)
+			: _attribute(other._attribute), _threshold(other._threshold), _children({ { nullptr, nullptr } })
 		{
 			
 			// Clone children
@@ -254,18 +258,18 @@ namespace horn_verification
 		 * @param other The object to move
 		 */
 		int_node(int_node && other)
-			: _attribute(other._attribute), _threshold(other._threshold), _children(std::move(other._children))
+			: _attribute(other._attribute), _threshold(other._threshold), _children(other._children)
 		{
-			// Nothing
+			other._children = { { nullptr, nullptr } };
 		}
 		
 	
 		/**
-		 * Destructor.
+		 * Destructor. The children are not deleted, as they are owned by the tree (see \ref decision_tree).
 		 */
 		~int_node()
 		{
-			for_each (_children.begin(), _children.end(), [](base_node * child){ if (child) delete child; });
+			// Nothing
 		}
 	
 	
@@ -328,7 +332,7 @@ namespace horn_verification
 		 *
 		 * @return the children of this node
 		 */
-		inline std::vector<base_node *> & children()
+		inline std::array<base_node *, 2> & children()
 		{
 			return _children;
 		}
@@ -434,9 +438,160 @@ namespace horn_verification
 	};
 	
 	
+	/**
+	 * This class owns the nodes of a decision tree created by the learner. The nodes are constructed
+	 * one after another in blocks of memory (whose sizes double), and all of them are released
+	 * together when the arena is destroyed. Integer and leaf nodes do not hold any resources and are
+	 * not destroyed individually. Only categorical nodes are, because they keep their children in a
+	 * vector (a tree typically has only few of them).
+	 *
+	 * @version 1.0
+	 */
+	class node_arena
+	{
+
+		/// The blocks of memory
+		std::vector<std::unique_ptr<char[]>> _blocks;
+
+		/// The size of the next block to allocate
+		std::size_t _next_block_size;
+
+		/// The next free byte in the current block
+		char * _next;
+
+		/// The end of the current block
+		char * _end;
+
+		/// The categorical nodes (to be destroyed with the arena)
+		std::vector<categorical_node *> _categorical_nodes;
+
+		/// The number of nodes
+		std::size_t _number_of_nodes;
+
+
+		/**
+		 * Returns memory for an object, whose size and alignment are at most those of \c std::max_align_t.
+		 *
+		 * @param size The size of the object
+		 *
+		 * @return a pointer to the memory
+		 */
+		void * allocate(std::size_t size)
+		{
+
+			const auto alignment = alignof(std::max_align_t);
+			size = (size + alignment - 1) / alignment * alignment;
+
+			if (static_cast<std::size_t>(_end - _next) < size)
+			{
+				_next_block_size = std::max(_next_block_size * 2, size);
+				_blocks.emplace_back(new char[_next_block_size]);
+				_next = _blocks.back().get();
+				_end = _next + _next_block_size;
+			}
+
+			auto result = _next;
+			_next += size;
+			++_number_of_nodes;
+
+			return result;
+
+		}
+
+
+	public:
+
+		/**
+		 * Creates an empty arena.
+		 */
+		node_arena()
+			: _next_block_size(1024), _next(nullptr), _end(nullptr), _number_of_nodes(0)
+		{
+			// Nothing
+		}
+
+
+		node_arena(const node_arena &) = delete;
+
+		node_arena & operator=(const node_arena &) = delete;
+
+
+		/**
+		 * Destructor.
+		 */
+		~node_arena()
+		{
+			for (auto node : _categorical_nodes)
+			{
+				node->~categorical_node();
+			}
+		}
+
+
+		/**
+		 * Creates a categorical decision node (see \ref categorical_node).
+		 *
+		 * @param attribute The decision attribute
+		 * @param number_of_categories The number of categories
+		 *
+		 * @return a pointer to the new node
+		 */
+		categorical_node * new_categorical_node(std::size_t attribute, std::size_t number_of_categories)
+		{
+			auto node = new (allocate(sizeof(categorical_node))) categorical_node(attribute, number_of_categories);
+			_categorical_nodes.push_back(node);
+			return node;
+		}
+
+
+		/**
+		 * Creates an integer decision node (see \ref int_node).
+		 *
+		 * @param attribute The decision attribute
+		 * @param threshold The decision threshold
+		 *
+		 * @return a pointer to the new node
+		 */
+		int_node * new_int_node(std::size_t attribute, int threshold)
+		{
+			return new (allocate(sizeof(int_node))) int_node(attribute, threshold);
+		}
+
+
+		/**
+		 * Creates a leaf node (see \ref leaf_node).
+		 *
+		 * @param output The output of the node
+		 *
+		 * @return a pointer to the new node
+		 */
+		leaf_node * new_leaf_node(bool output)
+		{
+			return new (allocate(sizeof(leaf_node))) leaf_node(output);
+		}
+
+
+		/**
+		 * Returns the number of nodes created in this arena.
+		 *
+		 * @return the number of nodes
+		 */
+		inline std::size_t number_of_nodes() const
+		{
+			return _number_of_nodes;
+		}
+
+	};
+	
+	
 	/**
 	 * This class represents a decision tree.
 	 *
+	 * The nodes of a tree learned by the \ref learner are owned by a \ref node_arena, which is shared
+	 * by all copies of the tree (a learned tree is not changed anymore) and released with the last
+	 * of them. The nodes of a tree created from a given root (e.g., by Horndini) are owned by the
+	 * tree itself, which deletes them one by one and copies them when the tree is copied.
+	 *
 	 * @author Daniel Neider
 	 *
 	 * @version 1.0
@@ -451,6 +606,17 @@ namespace horn_verification
 		/// Root node of the decision tree
 		base_node * _root;
 		
+		/// The arena owning the nodes (or \c nullptr if the tree owns its nodes itself)
+		std::shared_ptr<node_arena> _arena;
+		
+		
+		/**
+		 * Deletes the nodes of a tree that owns its nodes itself.
+		 *
+		 * @param root The root of the nodes to delete
+		 */
+		static void delete_nodes(base_node * root);
+		
 		
 	public:
 	
@@ -465,7 +631,7 @@ namespace horn_verification
 		
 		
 		/**
-		 * Creates a decision tree with ethe given root.
+		 * Creates a decision tree with ethe given root. The tree takes ownership of the nodes.
 		 */
 		decision_tree(base_node * root)
 			: _root(root) 
@@ -474,13 +640,25 @@ namespace horn_verification
 		}
 		
 		
+		/**
+		 * Creates an empty decision tree whose nodes are owned by an arena.
+		 *
+		 * @param arena The arena owning the nodes
+		 */
+		explicit decision_tree(const std::shared_ptr<node_arena> & arena)
+			: _root(nullptr), _arena(arena)
+		{
+			// Nothing
+		}
+		
+		
 		/**
 		 * Copy constructor.
 		 *
 		 * @param other The decision tree to copy
 		 */
 		decision_tree(const decision_tree & other)
-			: _root(other._root->clone())
+			: _root(other._arena || !other._root ? other._root : other._root->clone()), _arena(other._arena)
 		{
 			// Nothing
 		}
@@ -492,7 +670,7 @@ namespace horn_verification
 		 * @param other The decision tree to be movedata
 		 */
 		decision_tree(decision_tree && other)
-			: _root(other._root)
+			: _root(other._root), _arena(std::move(other._arena))
 		{
 			other._root = nullptr;
 		}
@@ -503,9 +681,9 @@ namespace horn_verification
 		 */
 		~decision_tree()
 		{
-			if(_root)
+			if(_root && !_arena)
 			{
-				delete _root;
+				delete_nodes(_root);
 			}
 		}
 		
@@ -523,6 +701,7 @@ namespace horn_verification
 			decision_tree tmp(rhs);
 			
 			std::swap(_root, tmp._root);
+			std::swap(_arena, tmp._arena);
 			
 			return *this;
 			
@@ -542,12 +721,13 @@ namespace horn_verification
 			if (this != &rhs)
 			{
 				
-				if (_root)
+				if (_root && !_arena)
 				{
-					delete _root;
+					delete_nodes(_root);
 				}
 				
 				_root = rhs._root;
+				_arena = std::move(rhs._arena);
 				rhs._root = nullptr;
 				
 			}
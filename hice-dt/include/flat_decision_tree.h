@@ -0,0 +1,405 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef __FLAT_DECISION_TREE_H__
+#define __FLAT_DECISION_TREE_H__
+
+// C++ includes
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+// C includes
+#include <cassert>
+
+// Project includes
+#include "columnar_sample.h"
+#include "datapoint.h"
+#include "decision_tree.h"
+#include "error.h"
+#include "visitor.h"
+
+
+namespace horn_verification
+{
+
+	/**
+	 * This class is a compiled form of a decision tree that classifies many data points at once.
+	 * The nodes are stored in one vector in breadth-first order, such that the children of a node
+	 * are consecutive. Every node selects its child by an offset from its first child: an integer
+	 * node by <code>value > threshold</code>, a categorical node by the value itself and a leaf by 0
+	 * (i.e., a leaf is its own first child). Thus, a data point moves down one level per step
+	 * without branching on the type of node, and once it has reached a leaf it stays there.
+	 *
+	 * The tree is evaluated on blocks of 64 data points, one level at a time, whereby the values
+	 * of the attributes are read from columns (see \ref columnar_sample). A block of data points is
+	 * classified into one word of a bitset.
+	 *
+	 * @version 1.0
+	 */
+	class flat_decision_tree
+	{
+
+	public:
+
+		/// The number of data points classified at once (i.e., the number of bits of a word of the result)
+		static const std::size_t block_size = 64;
+
+	private:
+
+		/**
+		 * A node of the flat decision tree.
+		 */
+		struct flat_node
+		{
+
+			/// The column (i.e., the index into flat_decision_tree::_columns) of the decision attribute (0 for leaves)
+			unsigned column;
+
+			/// The decision threshold (integer nodes only)
+			int threshold;
+
+			/// -1 if this node is an integer node, 0 otherwise
+			int int_mask;
+
+			/// -1 if this node is a categorical node, 0 otherwise
+			int categorical_mask;
+
+			/// The index of the first child (the index of this node for leaves)
+			unsigned first_child;
+
+			/// The number of children
+			unsigned number_of_children;
+
+			/// The output (leaves only)
+			bool output;
+
+			/// Whether this node stands for a missing child of a categorical node
+			bool is_missing;
+
+		};
+
+
+		/**
+		 * This visitor fills in the node it visits, which has been created by its parent.
+		 */
+		class flattener : public base_visitor
+		{
+
+			/// The tree to build
+			flat_decision_tree & _tree;
+
+			/// The index of the node to fill in
+			unsigned _index;
+
+			/// The nodes whose children remain to be flattened (together with their indices)
+			std::deque<std::pair<base_node *, unsigned>> & _queue;
+
+			/// The columns of the attributes seen so far
+			std::map<std::pair<bool, std::size_t>, unsigned> & _column_of;
+
+
+			/**
+			 * Returns the column of an attribute, which is added if it has not been seen before.
+			 */
+			unsigned column(bool is_categorical, std::size_t attribute)
+			{
+				auto it = _column_of.emplace(std::make_pair(is_categorical, attribute), _tree._columns.size());
+				if (it.second)
+				{
+					_tree._columns.push_back(std::make_pair(is_categorical, attribute));
+				}
+				return it.first->second;
+			}
+
+
+			/**
+			 * Appends the children of the visited node to the tree and queues them.
+			 */
+			template <class Children>
+			void add_children(Children & children)
+			{
+				_tree._nodes[_index].first_child = _tree._nodes.size();
+				_tree._nodes[_index].number_of_children = children.size();
+
+				for (auto child : children)
+				{
+					flat_node node = { 0, 0, 0, 0, 0, 0, false, child == nullptr };
+					node.first_child = _tree._nodes.size();
+					_tree._nodes.push_back(node);
+
+					if (child)
+					{
+						_queue.push_back(std::make_pair(child, node.first_child));
+					}
+				}
+			}
+
+		public:
+
+			flattener(flat_decision_tree & tree, std::deque<std::pair<base_node *, unsigned>> & queue, std::map<std::pair<bool, std::size_t>, unsigned> & column_of)
+				: _tree(tree), _index(0), _queue(queue), _column_of(column_of)
+			{
+				// Nothing
+			}
+
+			void set_index(unsigned index)
+			{
+				_index = index;
+			}
+
+			void visit(categorical_node & n) override
+			{
+				_tree._nodes[_index].column = column(true, n.attribute());
+				_tree._nodes[_index].categorical_mask = -1;
+				add_children(n.children());
+			}
+
+			void visit(int_node & n) override
+			{
+				_tree._nodes[_index].column = column(false, n.attribute());
+				_tree._nodes[_index].threshold = n.threshold();
+				_tree._nodes[_index].int_mask = -1;
+				add_children(n.children());
+			}
+
+			void visit(leaf_node & n) override
+			{
+				_tree._nodes[_index].output = n.output();
+			}
+
+		};
+
+
+		/// The nodes in breadth-first order (the root has index 0)
+		std::vector<flat_node> _nodes;
+
+		/// The attributes the tree decides on (whether the attribute is categorical and the attribute)
+		std::vector<std::pair<bool, std::size_t>> _columns;
+
+
+		/**
+		 * Classifies a block of data points.
+		 *
+		 * @param columns The values of the data points of the block, one pointer per column of the tree
+		 * @param count The number of data points of the block (at most block_size)
+		 *
+		 * @return the classification of the data points (bit \c i for the <code>i</code>-th data point)
+		 */
+		std::uint64_t classify_block(const int * const * columns, std::size_t count) const
+		{
+
+			assert (count <= block_size);
+
+			// A tree that is a leaf does not read any column
+			if (_columns.empty())
+			{
+				return _nodes[0].output ? (count == block_size ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1) : 0;
+			}
+
+			unsigned current[block_size] = { 0 };
+
+			// Move every data point one level down until all data points have reached a leaf
+			bool is_changed = true;
+			while (is_changed)
+			{
+
+				unsigned changed = 0;
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const auto & n = _nodes[current[i]];
+					const int value = columns[n.column][i];
+					const unsigned next = n.first_child + static_cast<unsigned>((static_cast<int>(value > n.threshold) & n.int_mask) | (value & n.categorical_mask));
+					assert (next - n.first_child < std::max(n.number_of_children, 1u));
+					changed |= next ^ current[i];
+					current[i] = next;
+				}
+				is_changed = changed != 0;
+
+			}
+
+			std::uint64_t result = 0;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const auto & n = _nodes[current[i]];
+				if (n.is_missing)
+				{
+					throw internal_error("No child for categorical value in the tree");
+				}
+				result |= static_cast<std::uint64_t>(n.output) << i;
+			}
+
+			return result;
+
+		}
+
+	public:
+
+		/**
+		 * Compiles a decision tree.
+		 *
+		 * @param root The root of the decision tree
+		 */
+		explicit flat_decision_tree(base_node & root)
+		{
+
+			std::deque<std::pair<base_node *, unsigned>> queue;
+			std::map<std::pair<bool, std::size_t>, unsigned> column_of;
+			flattener f(*this, queue, column_of);
+
+			_nodes.push_back(flat_node { 0, 0, 0, 0, 0, 0, false, false });
+			queue.push_back(std::make_pair(&root, 0));
+
+			while (!queue.empty())
+			{
+				f.set_index(queue.front().second);
+				queue.front().first->accept(f);
+				queue.pop_front();
+			}
+
+		}
+
+
+		/**
+		 * Returns the number of nodes (including a node per missing child of a categorical node).
+		 *
+		 * @return the number of nodes
+		 */
+		inline std::size_t size() const
+		{
+			return _nodes.size();
+		}
+
+
+		/**
+		 * Classifies a single data point.
+		 *
+		 * @param dp The data point
+		 *
+		 * @return the output of the tree on the data point
+		 */
+		bool output(const datapoint<bool> & dp) const
+		{
+
+			unsigned current = 0;
+			while (_nodes[current].int_mask != 0 || _nodes[current].categorical_mask != 0)
+			{
+				const auto & n = _nodes[current];
+				const auto & attribute = _columns[n.column];
+				current = attribute.first ? n.first_child + dp._categorical_data[attribute.second] : n.first_child + (dp._int_data[attribute.second] > n.threshold);
+			}
+
+			if (_nodes[current].is_missing)
+			{
+				throw internal_error("No child for categorical value in the tree");
+			}
+
+			return _nodes[current].output;
+
+		}
+
+
+		/**
+		 * Classifies the data points of a columnar sample.
+		 *
+		 * @param sample The sample
+		 *
+		 * @return a bitset of the data points classified as positive (bit \c i for row \c i)
+		 */
+		std::vector<std::uint64_t> classify(const columnar_sample & sample) const
+		{
+
+			std::vector<std::uint64_t> result((sample.size() + block_size - 1) / block_size, 0);
+			std::vector<const int *> columns(_columns.size());
+
+			for (std::size_t begin = 0; begin < sample.size(); begin += block_size)
+			{
+
+				for (std::size_t c = 0; c < _columns.size(); ++c)
+				{
+					columns[c] = _columns[c].first ? reinterpret_cast<const int *>(sample.categorical_column(_columns[c].second).data()) + begin : sample.int_column(_columns[c].second).data() + begin;
+				}
+
+				result[begin / block_size] = classify_block(columns.data(), std::min(std::size_t(block_size), sample.size() - begin));
+
+			}
+
+			return result;
+
+		}
+
+
+		/**
+		 * Classifies data points. The values of the attributes the tree decides on are copied block by
+		 * block into columns, all other attributes are not touched.
+		 *
+		 * @param datapoint_ptrs The data points
+		 *
+		 * @return a bitset of the data points classified as positive (bit \c i for <code>datapoint_ptrs[i]</code>)
+		 */
+		std::vector<std::uint64_t> classify(const std::vector<datapoint<bool> *> & datapoint_ptrs) const
+		{
+
+			std::vector<std::uint64_t> result((datapoint_ptrs.size() + block_size - 1) / block_size, 0);
+			std::vector<int> values(_columns.size() * block_size);
+			std::vector<const int *> columns(_columns.size());
+			for (std::size_t c = 0; c < _columns.size(); ++c)
+			{
+				columns[c] = values.data() + c * block_size;
+			}
+
+			for (std::size_t begin = 0; begin < datapoint_ptrs.size(); begin += block_size)
+			{
+
+				const auto count = std::min(std::size_t(block_size), datapoint_ptrs.size() - begin);
+				for (std::size_t c = 0; c < _columns.size(); ++c)
+				{
+					auto column = values.data() + c * block_size;
+					const auto attribute = _columns[c].second;
+					if (_columns[c].first)
+					{
+						for (std::size_t i = 0; i < count; ++i)
+						{
+							column[i] = datapoint_ptrs[begin + i]->_categorical_data[attribute];
+						}
+					}
+					else
+					{
+						for (std::size_t i = 0; i < count; ++i)
+						{
+							column[i] = datapoint_ptrs[begin + i]->_int_data[attribute];
+						}
+					}
+				}
+
+				result[begin / block_size] = classify_block(columns.data(), count);
+
+			}
+
+			return result;
+
+		}
+
+
+		/**
+		 * Returns a bit of a bitset returned by classify().
+		 *
+		 * @param bits The bitset
+		 * @param row The bit
+		 *
+		 * @return the value of the bit
+		 */
+		static inline bool bit(const std::vector<std::uint64_t> & bits, std::size_t row)
+		{
+			return (bits[row / block_size] >> (row % block_size)) & 1;
+		}
+
+	};
+
+}; // End namespace horn_verification
+
+#endif
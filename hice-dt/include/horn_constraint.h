@@ -7,6 +7,8 @@
 
 // C++ includes
 #include <ostream>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // Project includes
@@ -43,11 +45,13 @@ namespace horn_verification {
 			virtual ~horn_constraint();
 
 			/**
-			 * Find the common markings of premises and insert the common markings to list_of_marking of conclusion.
+			 * Find the common markings of premises and insert the common markings to the markings of conclusion.
 			 * If the markings of conclusion get incremented then compute markings of all horn clauses depends on conclusion.
 			 * This is a costlier operation, will modify using bitvectors.
+			 * @param markings The markings of the datapoints (kept by the horn solver)
+			 * @param horn_constraints_of The horn constraints in which each datapoint is present (kept by the horn solver)
 			 */
-			void compute_marking() const;
+			void compute_marking(std::unordered_map<datapoint<T> *, std::unordered_set<datapoint<T> *> > & markings, const std::unordered_map<datapoint<T> *, std::unordered_set<horn_constraint<T> *> > & horn_constraints_of) const;
 
 			/**
 			 * Constructor.
@@ -10,6 +10,7 @@
 #include <vector>
 #include <ctime>
 #include <sys/time.h>
+#include <unordered_map>
 #include <unordered_set>
 
 // Project includes
@@ -62,6 +63,12 @@ namespace horn_verification {
 			/// Create an exclusive false datapoint.
 			mutable datapoint<T> _false_datapoint;
 
+			/// Store the weak markings of each datapoint.
+			mutable std::unordered_map<datapoint<T> *, std::unordered_set<datapoint<T> *> > _markings;
+
+			/// Store the horn constraints in which each datapoint is present.
+			mutable std::unordered_map<datapoint<T> *, std::unordered_set<horn_constraint<T> *> > _horn_constraints_of;
+
 			/// Flag for indicating presence of horn constraints without conclusion.
 			mutable bool _horn_constraints_without_conclusion = false;
 
@@ -97,6 +104,12 @@ namespace horn_verification {
 			*/
 			bool verify_constraints_satisfiability(std::unordered_set <datapoint<T> *> & positive, std::unordered_set <datapoint<T> *> & negative) const;
 
+			/**
+			* Remove all satisfied horn constraints from the horn constraints in which a datapoint is present.
+			* @param horn constraints of the datapoint.
+			*/
+			void remove_satisfied_horn_clauses(std::unordered_set <horn_constraint<T> *> &horn_constraints) const;
+
 			/**
 			* Remove a datapoint from a vector of datapoints if the given datapoint is present in the vector.
 			* @param vector of datapoints.
@@ -123,8 +136,8 @@ namespace horn_verification {
 			bool propagate_false_classification(horn_constraint<T> *current_horn_clause_addr, datapoint<T> *current_variable_addr, std::unordered_set <datapoint<T> *> & negative) const;
 
 			/**
-			* Compute the initial marking of datapoints and store in list_of_marking.
-			* Compute the set of horn constraints which uses the datapoint as either a premise or conclusion and store in list_of_horn_constraints.
+			* Compute the initial marking of datapoints and store in _markings.
+			* Compute the set of horn constraints which uses the datapoint as either a premise or conclusion and store in _horn_constraints_of.
 			* @param vector of datapoints.
 			* @param vector of horn constraints.
 			*/
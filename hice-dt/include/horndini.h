@@ -6,11 +6,14 @@
 #define __HORNDINI_H__
 
 // C++ includes
+#include <cstdint>
 #include <exception>
 #include <iostream>
 #include <list>
 #include <numeric>
+#include <set>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 // C includes
@@ -128,6 +131,173 @@ namespace horn_verification
 	};
 	
 
+	/**
+	 * This class stores the values of the derived predicates for a set of data points, packed as
+	 * bitsets. The bitset of a data point only covers the derived predicates of its relation (i.e.,
+	 * of the interval given by its first categorical attribute): bit j refers to the j-th derived
+	 * predicate of the interval.
+	 *
+	 * @version 1.0
+	 */
+	class derived_values
+	{
+
+		/// The intervals of derived predicates, one for each relation
+		std::vector<std::pair<unsigned, unsigned>> _derived_intervals;
+
+		/// The relation of every data point
+		std::vector<std::size_t> _relations;
+
+		/// The position of the bitset of every data point in _words
+		std::vector<std::size_t> _offsets;
+
+		/// The bitsets of all data points
+		std::vector<std::uint64_t> _words;
+
+
+	public:
+
+		/**
+		 * Evaluates the derived predicates on the integer attributes of the given data points.
+		 *
+		 * @param datapoints The data points
+		 * @param derived_predicates The derived predicates
+		 * @param derived_intervals The intervals of derived predicates, one for each relation
+		 */
+		derived_values(const std::vector<datapoint<bool>> & datapoints, const std::vector<derived_predicate> & derived_predicates, const std::vector<std::pair<unsigned, unsigned>> & derived_intervals)
+			: _derived_intervals(derived_intervals)
+		{
+
+			_relations.reserve(datapoints.size());
+			_offsets.reserve(datapoints.size());
+
+			for (const auto & dp : datapoints)
+			{
+
+				const auto r = dp._categorical_data[0];
+				assert (r < _derived_intervals.size());
+
+				_relations.push_back(r);
+				_offsets.push_back(_words.size());
+				_words.resize(_words.size() + number_of_words(r), 0);
+
+				auto dp_values = &_words[_offsets.back()];
+				for (unsigned j = _derived_intervals[r].first; j <= _derived_intervals[r].second; ++j)
+				{
+
+					const auto & pred = derived_predicates[j];
+					const auto value = dp._int_data[pred._index];
+
+					bool holds = false;
+					switch (pred._type)
+					{
+
+						case derived_predicate::type::GE:
+							holds = value >= pred._threshold;
+							break;
+
+						case derived_predicate::type::LE:
+							holds = value <= pred._threshold;
+							break;
+
+						case derived_predicate::type::EQ:
+							holds = value == pred._threshold;
+							break;
+
+					}
+
+					if (holds)
+					{
+						const auto bit = bit_of(r, j);
+						dp_values[bit / 64] |= std::uint64_t(1) << (bit % 64);
+					}
+
+				}
+
+			}
+
+		}
+
+
+		/**
+		 * Returns the number of data points.
+		 *
+		 * @return the number of data points
+		 */
+		inline std::size_t size() const
+		{
+			return _relations.size();
+		}
+
+
+		/**
+		 * Returns the number of relations.
+		 *
+		 * @return the number of relations
+		 */
+		inline std::size_t number_of_relations() const
+		{
+			return _derived_intervals.size();
+		}
+
+
+		/**
+		 * Returns the number of 64 bit words of the bitsets of a relation.
+		 *
+		 * @param relation The relation
+		 *
+		 * @return the number of words
+		 */
+		inline std::size_t number_of_words(std::size_t relation) const
+		{
+			return (_derived_intervals[relation].second - _derived_intervals[relation].first + 1 + 63) / 64;
+		}
+
+
+		/**
+		 * Returns the bit of a derived predicate in the bitsets of a relation.
+		 *
+		 * @param relation The relation
+		 * @param pred The derived predicate (which has to belong to the relation)
+		 *
+		 * @return the bit of the derived predicate
+		 */
+		inline std::size_t bit_of(std::size_t relation, unsigned pred) const
+		{
+			assert (pred >= _derived_intervals[relation].first && pred <= _derived_intervals[relation].second);
+			return pred - _derived_intervals[relation].first;
+		}
+
+
+		/**
+		 * Returns the relation of a data point.
+		 *
+		 * @param i The index of the data point
+		 *
+		 * @return the relation of the data point
+		 */
+		inline std::size_t relation(std::size_t i) const
+		{
+			return _relations[i];
+		}
+
+
+		/**
+		 * Returns the values of the derived predicates of a data point (<code>number_of_words(relation(i))</code>
+		 * words).
+		 *
+		 * @param i The index of the data point
+		 *
+		 * @return a pointer to the bitset of the data point
+		 */
+		inline const std::uint64_t * values(std::size_t i) const
+		{
+			return &_words[_offsets[i]];
+		}
+
+	};
+
+
 	/**
 	 * This class implements the Houdini algorithm for Horn clauses.
 	 *
@@ -195,194 +365,182 @@ namespace horn_verification
 		
 
 		/**
-		 * Generates derived data point for derived attributes.
+		 * Runs Houdini.
+		 * An initial (vector of) set of predicates must be given. Houdini
+		 * then removes predicates from this set.
 		 *
-		 * @param datapoints The original data points
-		 * @param derived_predicates The derived predicates
+		 * The conjunctions are kept as bitsets (like the values of the derived predicates), and the
+		 * Horn constraints are indexed by their premises: when the conjunction of a relation is
+		 * weakened, only the premises of this relation that have not been satisfied so far are
+		 * checked again, and a Horn constraint is only considered once all its premises are
+		 * satisfied (which happens at most once, as conjunctions only get weaker).
 		 *
-		 * @return derived data point for the given derived attributes.
+		 * Throws a <code>no_conjunction_exists_exception</code> if no conjunction exists.
+		 *
+		 * @param datapoints The data points to learn from
+		 * @param values The values of the derived predicates of the data points
+		 * @param horn_indexes The Horn constraints to learn from, modeled as indexes into the <code>datapoints</code> vector
+		 * @param conjunctions Reference to an initial set of predicates. Houdini removes predicates from this set
 		 */
-		static std::vector<datapoint<bool>> generate_derived_datapoints(const std::vector<datapoint<bool>> & datapoints, const std::vector<derived_predicate> & derived_predicates)
+		static void learn(const std::vector<datapoint<bool>> & datapoints, const derived_values & values, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_indexes, std::vector<std::list<unsigned>> & conjunctions)
 		{
-			
-			std::vector<datapoint<bool>> derived_datapoints;
-			derived_datapoints.reserve(datapoints.size());
 
-			
-			for (unsigned i = 0; i < datapoints.size(); ++i)
+			assert (datapoints.size() == values.size());
+			assert (conjunctions.size() == values.number_of_relations());
+
+			//
+			// Convert conjunctions into bitsets
+			//
+			std::vector<std::vector<std::uint64_t>> conjunction_bits(conjunctions.size());
+			for (std::size_t r = 0; r < conjunctions.size(); ++r)
 			{
+				conjunction_bits[r].assign(values.number_of_words(r), 0);
+				for (auto pred : conjunctions[r])
+				{
+					const auto bit = values.bit_of(r, pred);
+					conjunction_bits[r][bit / 64] |= std::uint64_t(1) << (bit % 64);
+				}
+			}
 
-				//
-				// Generate boolean data from int data
-				//
-				std::vector<int> bool_data(derived_predicates.size());
-	
-				for (unsigned j = 0; j < derived_predicates.size(); ++j)
+
+			//
+			// Index Horn constraints by their premises and collect the data points occurring as premise by relation
+			//
+			std::vector<std::vector<std::size_t>> constraints_with_premise(datapoints.size());
+			std::vector<std::size_t> unsatisfied_premises(horn_indexes.size());
+			std::vector<std::vector<unsigned>> pending_premises(conjunctions.size());
+			std::vector<unsigned> positive_indexes;
+
+			for (std::size_t i = 0; i < horn_indexes.size(); ++i)
+			{
+
+				for (auto premise : horn_indexes[i].first)
 				{
-					
-					switch (derived_predicates[j]._type)
+					assert (premise < datapoints.size());
+
+					if (constraints_with_premise[premise].empty())
 					{
-						
-						case derived_predicate::type::GE:
-						{
-							bool_data[j] = (datapoints[i]._int_data[derived_predicates[j]._index] >= derived_predicates[j]._threshold);
-							break;
-						}
-						
-						case derived_predicate::type::LE:
-						{
-							bool_data[j] = (datapoints[i]._int_data[derived_predicates[j]._index] <= derived_predicates[j]._threshold);
-							break;
-						}
-						
-						case derived_predicate::type::EQ:
-						{
-							bool_data[j] = (datapoints[i]._int_data[derived_predicates[j]._index] == derived_predicates[j]._threshold);
-							break;
-						}
-						
+						pending_premises[values.relation(premise)].push_back(premise);
 					}
-					
+					constraints_with_premise[premise].push_back(i);
 				}
-	
-				
-				//
-				// Add data point
-				//
-				datapoint<bool> derived_datapoint(datapoints[i]._classification, datapoints[i]._is_classified);
-				derived_datapoint._categorical_data = datapoints[i]._categorical_data;
-				derived_datapoint._int_data = std::move(bool_data);
-				
-				derived_datapoints.push_back(std::move(derived_datapoint));
-		
+
+				unsatisfied_premises[i] = horn_indexes[i].first.size();
+				if (unsatisfied_premises[i] == 0)
+				{
+					derive_conclusion(horn_indexes[i], positive_indexes);
+				}
+
 			}
-			
-			return derived_datapoints;
-		
-		}
-	
-		
-		/**
-		 * Runs Houdini.
-		 * An initial (vector of) set of predicates must be given. Houdini
-		 * then removes predicates from this set.
-		 *
-		 * @param datapoints The data points to learn from
-		 * @param horn_constraints The Horn constraints to learn from
-		 * @param conjunctions Reference to an initial set of predicates. Houdini removes predicates from this set
-		 */
-		static void learn(const std::vector<datapoint<bool>> & datapoints, std::vector<horn_constraint<bool>> & horn_constraints, std::vector<std::list<unsigned>> & conjunctions)
-		{
-		
-			
+
+
 			//
 			// Create list of positive data points to start with
 			//
-			std::list<const datapoint<bool> *> positive_ptrs;
-			for (const auto & dp : datapoints)
+			for (unsigned i = 0; i < datapoints.size(); ++i)
 			{
-				if (dp._is_classified && dp._classification)
+				if (datapoints[i]._is_classified && datapoints[i]._classification)
 				{
-					positive_ptrs.push_back(&dp);
+					positive_indexes.push_back(i);
 				}
 			}
-		
-		
+
+
 			//
-			// Run Horndini
+			// Run Horndini (initially, the premises of every relation need to be checked)
 			//
+			std::vector<bool> is_weakened(conjunctions.size(), true);
+			std::vector<std::size_t> weakened_relations(conjunctions.size());
+			std::iota(weakened_relations.begin(), weakened_relations.end(), 0);
+			std::vector<bool> is_positive(datapoints.size(), false);
+
 			do
 			{
-				
+
 				//
-				// Process positive datapoints
+				// Process positive data points
 				//
-				if (!positive_ptrs.empty())
+				for (auto i : positive_indexes)
 				{
-										
-					// For each positive data point
-					for (const auto & dp : positive_ptrs)
+
+					if (is_positive[i])
 					{
-					
-						// Get function associated with current data point
-						auto cur_function = dp->_categorical_data[0];
-						assert (cur_function < conjunctions.size());
-					
-						// Consider all remaning predicates of the function associated with the current data point
-						auto pred_it = conjunctions[cur_function].begin();
-						while (pred_it !=  conjunctions[cur_function].end())
-						{					
-					
-							// Knock off if entry is false
-							if (!dp->_int_data[*pred_it])
-							{
-								pred_it =  conjunctions[cur_function].erase(pred_it);
-							}
-							// Skip if entry is true
-							else
-							{
-								++pred_it;
-							}
-					
-						}
-					
+						continue;
+					}
+					is_positive[i] = true;
+
+					// Knock off the predicates that are false
+					const auto r = values.relation(i);
+					const auto dp_values = values.values(i);
+					bool is_changed = false;
+					for (std::size_t w = 0; w < conjunction_bits[r].size(); ++w)
+					{
+						const auto weakened = conjunction_bits[r][w] & dp_values[w];
+						is_changed = is_changed || weakened != conjunction_bits[r][w];
+						conjunction_bits[r][w] = weakened;
+					}
+
+					if (is_changed && !is_weakened[r])
+					{
+						is_weakened[r] = true;
+						weakened_relations.push_back(r);
 					}
-					
-					positive_ptrs.clear();
 
 				}
-			
+				positive_indexes.clear();
+
+
 				//
-				// Process Horn constraints
+				// Process the Horn constraints whose premises have become satisfied
 				//
-				auto horn_it = horn_constraints.begin();
-				while (horn_it != horn_constraints.end())
+				for (auto r : weakened_relations)
 				{
 
-					// Check whether data point of left-hand-side is satisfied
-					auto lhs_it = horn_it->_premises.begin();
-					while (lhs_it != horn_it->_premises.end())
-					{
-						
-						auto cur_function = (*lhs_it)->_categorical_data[0];
-						assert (cur_function < conjunctions.size());
-						
-						// Remove data point from lhs if it satisfies the conjunction
-						if (satisfies(**lhs_it, conjunctions[cur_function]))
-						{
-							lhs_it = horn_it->_premises.erase(lhs_it);
-						}
-						else
-						{
-							++lhs_it;
-						}
-						
-					}
-			
-					// If left-hand-side is empty, add right-hand-side to positive
-					if (horn_it->_premises.empty())
+					is_weakened[r] = false;
+
+					auto & pending = pending_premises[r];
+					std::size_t kept = 0;
+					for (std::size_t j = 0; j < pending.size(); ++j)
 					{
-						
-						if (horn_it->_conclusion == nullptr)
+
+						const auto premise = pending[j];
+
+						// Keep premise if it does not satisfy the conjunction
+						if (!satisfies(values.values(premise), conjunction_bits[r]))
 						{
-							throw no_conjunction_exists_exception("No consistent conjunction exists");
+							pending[kept++] = premise;
+							continue;
 						}
-						else
+
+						// If all premises of a Horn constraint are satisfied, its conclusion becomes positive
+						for (auto c : constraints_with_premise[premise])
 						{
-							positive_ptrs.push_back(horn_it->_conclusion);
-							horn_it = horn_constraints.erase(horn_it);
+							if (--unsatisfied_premises[c] == 0)
+							{
+								derive_conclusion(horn_indexes[c], positive_indexes);
+							}
 						}
-						
-					}
-					else
-					{
-						++ horn_it;
+
 					}
-					
+					pending.resize(kept);
+
 				}
+				weakened_relations.clear();
+
+			} while (!positive_indexes.empty());
+
+
+			//
+			// Remove the predicates that have been knocked off from the conjunctions
+			//
+			for (std::size_t r = 0; r < conjunctions.size(); ++r)
+			{
+				conjunctions[r].remove_if([&](unsigned pred) {
+					const auto bit = values.bit_of(r, pred);
+					return !(conjunction_bits[r][bit / 64] & (std::uint64_t(1) << (bit % 64)));
+				});
+			}
 
-			} while(!positive_ptrs.empty());
-		
 		}
 
 
@@ -412,19 +570,20 @@ namespace horn_verification
 	
 	
 		/**
-		 * Checks whether a data point satisfies a conjunction.
+		 * Checks whether a data point satisfies a conjunction, both given as bitsets over the derived
+		 * predicates of a relation.
 		 *
-		 * @param dp The data point
+		 * @param dp_values The values of the derived predicates of the data point
 		 * @param conjunction The conjunction
 		 *
 		 * @return true if the data point satisfies the conjunction and false otherwise
 		 */
-		static bool satisfies(const datapoint<bool> & dp, const std::list<unsigned> & conjunction)
+		static bool satisfies(const std::uint64_t * dp_values, const std::vector<std::uint64_t> & conjunction)
 		{
 
-			for (const auto & c : conjunction)
+			for (std::size_t w = 0; w < conjunction.size(); ++w)
 			{
-				if (!dp._int_data[c])
+				if ((dp_values[w] & conjunction[w]) != conjunction[w])
 				{
 					return false;
 				}
@@ -436,6 +595,28 @@ namespace horn_verification
 
 
 		protected:
+
+		/**
+		 * Adds the conclusion of a Horn constraint whose premises are all satisfied to the positive
+		 * data points.
+		 *
+		 * Throws a <code>no_conjunction_exists_exception</code> if the Horn constraint has no conclusion.
+		 *
+		 * @param horn_index The Horn constraint, modeled as indexes into the data points
+		 * @param positive_indexes The indexes of the positive data points
+		 */
+		static void derive_conclusion(const std::pair<std::set<unsigned>, std::set<unsigned>> & horn_index, std::vector<unsigned> & positive_indexes)
+		{
+
+			if (horn_index.second.empty())
+			{
+				throw no_conjunction_exists_exception("No consistent conjunction exists");
+			}
+
+			positive_indexes.push_back(*horn_index.second.begin());
+
+		}
+
 		
 		/**
 		 * Translates a set of conjunction of predicates into an equivalent decision tree.
@@ -465,7 +646,7 @@ namespace horn_verification
 				{
 					
 					int_node * ret = new int_node(derived_predicates[*cur_it]._index, derived_predicates[*cur_it]._threshold - 1);
-					ret->children() = std::vector<base_node *>({new leaf_node(false), conjunction2tree(derived_predicates, ++cur_it, end_it)});
+					ret->children() = {{ new leaf_node(false), conjunction2tree(derived_predicates, ++cur_it, end_it) }};
 					return ret;
 					
 				}
@@ -474,7 +655,7 @@ namespace horn_verification
 				{
 					
 					int_node * ret = new int_node(derived_predicates[*cur_it]._index, derived_predicates[*cur_it]._threshold);
-					ret->children() = std::vector<base_node *>({conjunction2tree(derived_predicates, ++cur_it, end_it), new leaf_node(false)});
+					ret->children() = {{ conjunction2tree(derived_predicates, ++cur_it, end_it), new leaf_node(false) }};
 					return ret;
 
 				}
@@ -484,8 +665,8 @@ namespace horn_verification
 					
 					int_node * ret1 = new int_node(derived_predicates[*cur_it]._index, derived_predicates[*cur_it]._threshold);
 					int_node * ret2 = new int_node(derived_predicates[*cur_it]._index, derived_predicates[*cur_it]._threshold - 1);
-					ret2->children() = std::vector<base_node *>({new leaf_node(false), conjunction2tree(derived_predicates, ++cur_it, end_it)});
-					ret1->children() = std::vector<base_node *>({ret2, new leaf_node(false)});
+					ret2->children() = {{ new leaf_node(false), conjunction2tree(derived_predicates, ++cur_it, end_it) }};
+					ret1->children() = {{ ret2, new leaf_node(false) }};
 					
 					return ret1;
 					
@@ -0,0 +1,255 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef INCREMENTAL_HORN_SOLVER_H_
+#define INCREMENTAL_HORN_SOLVER_H_
+
+// C++ includes
+#include <vector>
+#include <ctime>
+#include <unordered_map>
+#include <unordered_set>
+
+// Project includes
+#include "horn_constraint.h"
+
+namespace horn_verification {
+
+	/**
+ 	 * This class represents an incremental horn solver that computes the same classifications as \ref horn_solver,
+ 	 * but keeps its state between calls instead of copying and rolling back all datapoints and horn constraints.
+ 	 *
+ 	 * The solver works like the unit propagator of a SAT solver. Each horn constraint is treated as the clause
+ 	 * <code>!p_1 || ... || !p_n || c</code> (where a missing conclusion is a dedicated point that is always false)
+ 	 * of which two literals are watched. The classifications of the datapoints form the assignment at level 0,
+ 	 * the positive and negative datapoints of a call of solve() are pushed as assumptions at level 1 and, after
+ 	 * propagating them, the solver backtracks to level 0 again. Datapoints that are implied to be false because
+ 	 * classifying them as true would violate a horn constraint are detected by probing only those datapoints
+ 	 * whose implications may have changed due to the assumptions.
+ 	 *
+ 	 * The solver is built for the datapoints and horn constraints of its first call and keeps its state as long as
+ 	 * the generation of the sample stays the same. Between two calls, the classification of datapoints may only
+ 	 * change by applying the positive and negative datapoints returned by the last successful call (as the learner
+ 	 * does when creating a leaf); the solver picks up these changes at the beginning of the next call. Any other
+ 	 * change of the sample (passing other vectors, adding, removing or editing datapoints or horn constraints, or
+ 	 * changing classifications otherwise) requires a call of next_generation(), which makes the next call rebuild
+ 	 * the solver. The solver does not try to detect such changes itself.
+ 	 *
+ 	 * Instead of being rebuilt, the solver can also follow a sample that grows: checkpoint() saves the state at
+ 	 * level 0, rollback() returns to it (undoing the classifications applied since and removing the horn constraints
+ 	 * added since) and extend() adds datapoints, classifications and horn constraints. This way, the solver can be
+ 	 * kept across runs of the learner, as long as the classifications of the datapoints are restored to those at the
+ 	 * checkpoint together with the call of rollback().
+ 	 *
+ 	 * @tparam T Type of a horn solver.
+ 	 *
+ 	 * @version 1.0
+ 	 */
+	template <class T> class incremental_horn_solver {
+	public:
+		/// Elapsed time during the entire itrations.
+		clock_t elapsed_time;
+
+		/// Number of invocations of the solver.
+		unsigned long invocation_count;
+
+	private:
+
+		/// Values of a datapoint in the current (partial) assignment.
+		enum : char { UNASSIGNED = 0, ASSIGNED_TRUE, ASSIGNED_FALSE };
+
+		/// Generation of the sample, which is increased by next_generation().
+		unsigned long _generation = 1;
+
+		/// Generation of the sample the solver has been built for (0 if the solver has not been built yet).
+		unsigned long _built_generation = 0;
+
+		/// Maps the index of a variable to its datapoint (the variable of the false point has no datapoint).
+		std::vector<datapoint<T> *> _points;
+
+		/// Maps a datapoint to the index of its variable.
+		std::unordered_map<datapoint<T> *, unsigned> _point_index;
+
+		/// Index of the variable that represents the conclusion of horn constraints without conclusion.
+		unsigned _false_point;
+
+		/// Literals of each clause; literal 2v means "v is true" and literal 2v+1 means "v is false". The first two literals are watched.
+		std::vector<std::vector<unsigned> > _clauses;
+
+		/// Variable of the conclusion of each clause.
+		std::vector<unsigned> _conclusions;
+
+		/// Clauses watching a literal (indexed by literal).
+		std::vector<std::vector<unsigned> > _watches;
+
+		/// Clauses in which a variable occurs as premise (indexed by variable).
+		std::vector<std::vector<unsigned> > _clauses_with_premise;
+
+		/// Clauses in which a variable occurs as conclusion (indexed by variable).
+		std::vector<std::vector<unsigned> > _clauses_with_conclusion;
+
+		/// Current value of each variable.
+		std::vector<char> _values;
+
+		/// Assigned variables in the order of their assignment.
+		std::vector<unsigned> _trail;
+
+		/// Positions in the trail at which the levels above 0 start.
+		std::vector<std::size_t> _trail_limits;
+
+		/// Position in the trail up to which assignments have been propagated.
+		std::size_t _propagation_head = 0;
+
+		/// Flag for indicating that the classification of the datapoints (level 0) already violates a horn constraint.
+		bool _base_conflict = false;
+
+		/// Variables assigned at level 0 whose datapoints were unclassified at the time (horn_solver reports these in every call).
+		std::vector<unsigned> _base_derived;
+
+		/// Variables returned by the last successful call, which might have been classified since then.
+		std::vector<unsigned> _pending;
+
+		/// Marks variables that have been collected as candidates for probing.
+		std::vector<char> _is_candidate;
+
+		/// Generation of the sample at the last checkpoint (0 if there is no checkpoint for the current build).
+		unsigned long _checkpoint_generation = 0;
+
+		/// Size of the trail, number of clauses and number of variables in _base_derived at the last checkpoint.
+		std::size_t _checkpoint_trail = 0;
+		std::size_t _checkpoint_clauses = 0;
+		std::size_t _checkpoint_base_derived = 0;
+
+		/**
+		* Build the clauses, watch lists and the level 0 assignment for a vector of datapoints and horn constraints.
+		* @param vector of datapoints.
+		* @param vector of horn constraints.
+		*/
+		void build(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints);
+
+		/**
+		* Add the clause of a horn constraint (or assign its conclusion at level 0 if it is a fact).
+		* @param horn constraint.
+		*/
+		void add_clause(const horn_constraint<T> &constraint);
+
+		/**
+		* Assign the classifications of datapoints returned by the last successful call at level 0 if they have been applied since.
+		*/
+		void synchronize();
+
+		/**
+		* Return the index of the variable of a datapoint, adding a new variable if the datapoint is unknown.
+		* @param datapoint.
+		* @returns index of the variable.
+		*/
+		unsigned index_of(datapoint<T> *datapoint_addr);
+
+		/**
+		* Return the value of a literal.
+		* @param literal.
+		* @returns ASSIGNED_TRUE, ASSIGNED_FALSE or UNASSIGNED.
+		*/
+		char value_of_literal(unsigned literal) const;
+
+		/**
+		* Return whether a clause contains a literal that is true.
+		* @param index of the clause.
+		*/
+		bool is_satisfied(unsigned clause) const;
+
+		/**
+		* Assign a value to a variable and put it on the trail.
+		* @param index of the variable.
+		* @param classification.
+		* @returns false if the variable is already assigned the opposite value.
+		*/
+		bool enqueue(unsigned variable, bool classification);
+
+		/**
+		* Propagate all assignments on the trail that have not been propagated yet using the watched literals.
+		* @returns false if a clause is violated.
+		*/
+		bool propagate();
+
+		/**
+		* Open a new level.
+		*/
+		void new_level();
+
+		/**
+		* Undo all assignments above a level.
+		* @param level.
+		*/
+		void backtrack(std::size_t level);
+
+		/**
+		* Assign false to every unassigned variable that, if assigned true, would violate a clause. Only variables whose
+		* implications may have changed due to the assignments on the trail from a given position onwards or due to the
+		* clauses from a given index onwards are probed.
+		* @param position in the trail.
+		* @param index of the first new clause.
+		* @returns false if a clause is violated.
+		*/
+		bool assign_implied_negatives(std::size_t trail_start, std::size_t first_clause);
+
+	public:
+
+		/**
+		* Implementation of external interface of horn solver (see \ref horn_solver::solve).
+		* This functor computes extra classifications of datapoints derivable from a given set of partial classifications of datapoints and a given
+		* set of horn constraints.
+		* @param datapoints vector
+		* @param horn_constraints vector
+		* @param positive datapoints vector
+		* @param negative datapoints vector
+		* @returns true if no horn constraint is violated and extra classifications will be stored in vector of positive and negative datapoints.
+		* @returns false if any horn constraint get violated, then vector of positive and negative datapoints will be unchanged.
+		*/
+		bool solve(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints, std::unordered_set <datapoint<T> *> &positive, std::unordered_set <datapoint<T> *> &negative);
+
+		/**
+		* Declare that the sample has changed other than by applying the results of solve(), such that the solver is
+		* rebuilt at the next call.
+		*/
+		void next_generation();
+
+		/**
+		* Return the generation of the sample.
+		* @returns generation.
+		*/
+		unsigned long generation() const;
+
+		/**
+		* Save the state at level 0, to which rollback() returns. The solver must not be in conflict with the sample.
+		*/
+		void checkpoint();
+
+		/**
+		* Return to the state saved by the last call of checkpoint(), undoing all classifications and removing all horn
+		* constraints added since. The caller has to restore the classifications of the datapoints to those at the
+		* checkpoint. Does nothing if the solver is rebuilt at the next call anyway.
+		*/
+		void rollback();
+
+		/**
+		* Add datapoints, classifications of known datapoints and horn constraints to the sample the solver has been
+		* built for and propagate them at level 0. Does nothing if the solver is rebuilt at the next call anyway.
+		* @param datapoints that are new or have been classified since the solver was built or last extended.
+		* @param new horn constraints.
+		*/
+		void extend(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints);
+
+		virtual ~incremental_horn_solver();
+
+		/**
+		* Constructor.
+		*/
+		incremental_horn_solver(){
+			invocation_count = 0;
+			elapsed_time = 0;
+		};
+	};
+};
+#endif /* INCREMENTAL_HORN_SOLVER_H_ */
@@ -7,11 +7,13 @@
 
 // C++ includes
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 // Project includes
 #include "attributes_metadata.h"
 #include "datapoint.h"
+#include "decision_tree.h"
 #include "slice.h"
 
 
@@ -19,163 +21,121 @@ namespace horn_verification
 {
 
 	/**
-	 * This class represents an (abstract) job, which can either be a job to split a node or
-	 * a job to turn a node into a leaf.
+	 * This class represents a job, which can either be a job to split a node (on a categorical or
+	 * an integer attribute) or a job to turn a node into a leaf. Jobs are passed around by value:
+	 * a job stores the data of all kinds of jobs and its kind determines which of them is used.
+	 * A default constructed job is empty (i.e., there is no job).
 	 *
 	 * @author Daniel Neider
 	 * @version 1.0
 	 */
-	class abstract_job
+	class node_job
 	{
 
-	protected:
+	public:
+
+		/// The kinds of jobs
+		enum job_kind { NO_JOB, CATEGORICAL_SPLIT, INT_SPLIT, LEAF_CREATION };
+
+	private:
+
+		/// The kind of this job
+		job_kind _kind;
 
 		/// The slice of data points to be processed
 		slice _slice;
 
+		/// The attribute to split on (splits only)
+		std::size_t _attribute;
+
+		/// The threshold to split on (integer splits only)
+		int _threshold;
+
+		/// Whether the data points of the slice are already sorted according to the attribute (splits only)
+		bool _is_sorted;
+
+		/// The label of the node to create (leaf creation only)
+		bool _label;
+
+		/// Data points to be turned positive (leaf creation only)
+		std::unordered_set<datapoint<bool> * > _positive_ptrs;
+
+		/// Data points to be turned negative (leaf creation only)
+		std::unordered_set<datapoint<bool> * > _negative_ptrs;
+
 
 		/**
 		 * Creates a new job.
 		 *
+		 * @param kind The kind of the job
 		 * @param sl The slice of this job
+		 * @param attribute The attribute to split on
+		 * @param threshold The threshold to split on
+		 * @param label The label of the leaf node
 		 */
-		abstract_job(const slice & sl)
-			: _slice(sl)
+		node_job(job_kind kind, const slice & sl, std::size_t attribute, int threshold, bool label)
+			: _kind(kind), _slice(sl), _attribute(attribute), _threshold(threshold), _is_sorted(false), _label(label)
 		{
 			// Nothing
 		}
-	
+
+
 		/**
-		 * Creates a new job.
-		 *
-		 * @param sl The slice of this job
+		 * Runs a split on a categorical attribute.
 		 */
-		abstract_job(slice && sl)
-			: _slice(std::move(sl))
-		{
-			// Nothing
-		}
-	
-	
-	public:
-	
+		void run_categorical_split(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata, node_arena & arena, std::vector<slice> & new_slices);
+
 		/**
-		 * Destructor.
+		 * Runs a split on an integer attribute.
 		 */
-		virtual ~abstract_job()
-		{
-			// Nothing
-		}
-	
+		void run_int_split(std::vector<datapoint<bool> *> & datapoint_ptrs, node_arena & arena, std::vector<slice> & new_slices);
 
 		/**
-		 * Performs the job on the given data points (and thier meta data). This method returns a list of
-		 * new slices (e.g., in the case that a node was split).
-		 *
-		 * @param datapoint_ptrs The data points to run this job on
-		 * @param metadata Meta data describing the data points
+		 * Runs the creation of a leaf node.
 		 */
-		virtual std::vector<slice> run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata) = 0;
-	
-	};
+		void run_leaf_creation(node_arena & arena);
 
-	
-	/**
-	 * This class represents a split on a categorical attribute.
-	 *
-	 * @author Daniel Neider
-	 * @version 1.0
-	 */
-	class categorical_split_job : public abstract_job
-	{
-		
-		/// The attribute to split on
-		std::size_t _attribute;
 
-		
 	public:
 
+		/**
+		 * Creates an empty job.
+		 */
+		node_job()
+			: node_job(NO_JOB, slice(0, 0, nullptr), 0, 0, false)
+		{
+			// Nothing
+		}
+
+
 		/**
 		 * Creates a new job for splitting on an categorical attribute.
 		 *
 		 * @param sl The slice of data points to be split
 		 * @param attribute The categorical attribute to split on
+		 *
+		 * @return the job
 		 */
-		categorical_split_job(const slice & sl, std::size_t attribute)
-			: abstract_job(sl), _attribute(attribute)
+		static node_job categorical_split(const slice & sl, std::size_t attribute)
 		{
-			// Nothing
+			return node_job(CATEGORICAL_SPLIT, sl, attribute, 0, false);
 		}
-	
 
-		/*
-		 * Implements super class method.
-		 */
-		std::vector<slice> run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata) override;
-		
-	};
-	
-	
-	/**
-	 * This class represents a split on an integer attribute.
-	 *
-	 * @author Daniel Neider
-	 * @version 1.0
-	 */
-	class int_split_job : public abstract_job
-	{
-		
-		/// The attribute to split on
-		std::size_t _attribute;
-
-		/// The threshold to split on
-		int _threshold;
-	
-	
-	public:
 
 		/**
 		 * Creates a new job for splitting on an integer attribute.
 		 *
 		 * @param sl The slice of data points to be split
-		 * @param attribute The categorical attribute to split on
+		 * @param attribute The integer attribute to split on
 		 * @param threshold The threshold to split on
+		 *
+		 * @return the job
 		 */
-		int_split_job(const slice & sl, std::size_t attribute, int threshold)
-			: abstract_job(sl), _attribute(attribute), _threshold(threshold)
+		static node_job int_split(const slice & sl, std::size_t attribute, int threshold)
 		{
-			// Nothing
+			return node_job(INT_SPLIT, sl, attribute, threshold, false);
 		}
 
-		
-		/*
-		 * Implements super class method.
-		 */	
-		std::vector<slice> run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata) override;
-		
-	};
-
-	
-	/**
-	 * This class represents the creation of a leaf node.
-	 *
-	 * @author Daniel Neider
-	 * @version 1.0
-	 */
-	class leaf_creation_job : public abstract_job
-	{
-		
-		/// The label of the node to create
-		bool _label;
-		
-		/// Data points to be turned positive
-		std::unordered_set<datapoint<bool> * > _positive_ptrs;
-		
-		/// Data points to be turned negative
-		std::unordered_set<datapoint<bool> * > _negative_ptrs;
-		
-	
-	public:
 
 		/**
 		 * Creates a new job for creating a leaf node.
@@ -184,22 +144,120 @@ namespace horn_verification
 		 * @param label The label of the leaf node
 		 * @param positive_ptrs A set of pointers to data points that need to be labeled positively
 		 * @param negative_ptrs A set of pointers to data points that need to be labeled negatively
+		 *
+		 * @return the job
 		 */
-		leaf_creation_job(const slice & sl, bool label, std::unordered_set<datapoint<bool> * > && positive_ptrs, std::unordered_set<datapoint<bool> * > && negative_ptrs)
-			: abstract_job(sl), _label(label), _positive_ptrs(std::move(positive_ptrs)), _negative_ptrs(std::move(negative_ptrs))
+		static node_job leaf_creation(const slice & sl, bool label, std::unordered_set<datapoint<bool> * > && positive_ptrs, std::unordered_set<datapoint<bool> * > && negative_ptrs)
 		{
-			// Nothing
+			node_job job(LEAF_CREATION, sl, 0, 0, label);
+			job._positive_ptrs = std::move(positive_ptrs);
+			job._negative_ptrs = std::move(negative_ptrs);
+			return job;
+		}
+
+
+		/**
+		 * Returns whether this job is not empty.
+		 *
+		 * @return whether there is a job
+		 */
+		explicit operator bool() const
+		{
+			return _kind != NO_JOB;
+		}
+
+
+		/**
+		 * Returns the kind of this job.
+		 *
+		 * @return the kind of this job
+		 */
+		inline job_kind kind() const
+		{
+			return _kind;
+		}
+
+
+		/**
+		 * Returns the slice of data points this job processes.
+		 *
+		 * @return the slice of this job
+		 */
+		inline const slice & job_slice() const
+		{
+			return _slice;
+		}
+
+
+		/**
+		 * Returns the attribute to split on (splits only).
+		 *
+		 * @return the attribute to split on
+		 */
+		inline std::size_t attribute() const
+		{
+			return _attribute;
+		}
+
+
+		/**
+		 * Returns the threshold to split on (integer splits only).
+		 *
+		 * @return the threshold to split on
+		 */
+		inline int threshold() const
+		{
+			return _threshold;
 		}
 
 
-		/*
-		 * Implements super class method.
+		/**
+		 * Declares that the data points of the slice are already sorted according to the attribute
+		 * to split on, so that running this job does not need to sort them again (splits only).
 		 */
-		std::vector<slice> run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata) override;
-		
+		inline void set_sorted()
+		{
+			_is_sorted = true;
+		}
+
+
+		/**
+		 * Returns the data points this job labels positively (leaf creation only).
+		 *
+		 * @return a set of pointers to the data points to be labeled positively
+		 */
+		inline const std::unordered_set<datapoint<bool> * > & positive_ptrs() const
+		{
+			return _positive_ptrs;
+		}
+
+
+		/**
+		 * Returns the data points this job labels negatively (leaf creation only).
+		 *
+		 * @return a set of pointers to the data points to be labeled negatively
+		 */
+		inline const std::unordered_set<datapoint<bool> * > & negative_ptrs() const
+		{
+			return _negative_ptrs;
+		}
+
+
+		/**
+		 * Performs the job on the given data points (and thier meta data). The new node is created
+		 * in the given arena, and the new slices (e.g., in the case that a node was split) are
+		 * appended to the given vector.
+		 *
+		 * @param datapoint_ptrs The data points to run this job on
+		 * @param metadata Meta data describing the data points
+		 * @param arena The arena in which to create the new node
+		 * @param new_slices The vector to which to append the new slices
+		 */
+		void run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata, node_arena & arena, std::vector<slice> & new_slices);
+
 	};
-	
+
 
 }; // End namespace horn_verification
 
-#endif
\ No newline at end of file
+#endif
@@ -6,6 +6,8 @@
 #define __LEARNER_H__
 
 // C++ includes
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 // C includes
@@ -15,6 +17,7 @@
 #include "attributes_metadata.h"
 #include "datapoint.h"
 #include "decision_tree.h"
+#include "flat_decision_tree.h"
 #include "horn_constraint.h"
 #include "slice.h"
 
@@ -37,6 +40,9 @@ namespace horn_verification
 
 		/// The job manager
 		JobManager _manager;
+		
+		/// The number of nodes created during the last run of the learner
+		std::size_t _number_of_nodes = 0;
 	
 	public:
 
@@ -69,23 +75,40 @@ namespace horn_verification
 		 * During the learning process, the data points will be rearranged and altered (the latter happens)
 		 * in response to resolving unlabaled data points with respect to the horn constraints.
 		 *
+		 * If the root of a previously learned tree is given, the learner relearns incrementally: it
+		 * pushes the data points down the previous tree and keeps every node that is still consistent,
+		 * while only the subtrees whose leaves became inconsistent are regrown.
+		 *
+		 * The nodes of the learned tree are created in a new \ref node_arena, which the tree (and all
+		 * of its copies) keeps alive and which is released in one go with the last of them.
+		 *
 		 * @param metadata Meta data describing the datapoints (attributes, number of categories, etc.)
 		 * @param datapoint_ptrs A vector of pointers to the data points
 		 * @param horn_constraints
+		 * @param previous_root The root of a previously learned tree to reuse (or \c nullptr to learn from scratch)
 		 *
 		 * @return the learned decision tree
 		 */
-		decision_tree learn(const attributes_metadata & metadata, std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints)
+		decision_tree learn(const attributes_metadata & metadata, std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, base_node * previous_root = nullptr)
 		{
 			
+			_number_of_nodes = 0;
+			
+			//
+			// Create the arena that owns the nodes of the new tree
+			//
+			auto arena = std::make_shared<node_arena>();
+			
+			
 			//
 			// If no data points were given, return trivial decision tree (any tree is consistent)
 			//
 			if (datapoint_ptrs.empty())
 			{
 				
-				auto tree = decision_tree();
-				tree._root = new leaf_node(true); // Leaf can have any label
+				auto tree = decision_tree(arena);
+				tree._root = arena->new_leaf_node(true); // Leaf can have any label
+				_number_of_nodes = 1;
 				
 				return tree;
 				
@@ -95,27 +118,30 @@ namespace horn_verification
 			//
 			// Create empty decision tree
 			//
-			decision_tree tree;
+			decision_tree tree(arena);
 			
 			
 			//
 			// Create task list and add initial slice
 			//
-			_manager.add_slice(slice(0, datapoint_ptrs.size() - 1, &tree._root));
+			_manager.add_slice(slice(0, datapoint_ptrs.size() - 1, &tree._root, previous_root));
 			
 			
 			//
 			// Learning loop
 			//
+			std::vector<slice> new_slices;
 			while (_manager.has_jobs())
 			{
 				
 				// Get next job
-				const auto next_job = _manager.next_job();
+				auto next_job = _manager.next_job();
 				
 					
-				// Execute job
-				const auto new_slices = next_job->run(datapoint_ptrs, metadata);
+				// Execute job (every job creates exactly one node)
+				new_slices.clear();
+				next_job.run(datapoint_ptrs, metadata, *arena, new_slices);
+				++_number_of_nodes;
 				
 				// Add new slices
 				for (const auto & sl : new_slices)
@@ -132,6 +158,28 @@ namespace horn_verification
 		}
 		
 		
+		/**
+		 * Returns the job manager of this learner.
+		 *
+		 * @return the job manager of this learner
+		 */
+		inline const JobManager & manager() const
+		{
+			return _manager;
+		}
+		
+		
+		/**
+		 * Returns the number of nodes of the decision tree created during the last run of the learner.
+		 *
+		 * @return the number of nodes of the last learned decision tree
+		 */
+		inline std::size_t number_of_nodes() const
+		{
+			return _number_of_nodes;
+		}
+		
+		
 		/**
 		 * Checks whether a decision tree is consistent with a Horn sample given
 		 * as a set of data points and a set of Horn constraints.
@@ -154,13 +202,20 @@ namespace horn_verification
 			}
 
 			
+			//
+			// Classify all data points at once with the compiled tree
+			//
+			flat_decision_tree flat_tree(*tree.root());
+			const auto outputs = flat_tree.classify(datapoint_ptrs);
+			
+			
 			//
 			// Check data points
 			//
-			output_visitor v;
-			for (const auto & dp : datapoint_ptrs)
+			for (std::size_t row = 0; row < datapoint_ptrs.size(); ++row)
 			{
-				if (dp->_is_classified && v.output(*tree.root(), *dp) != dp->_classification)
+				const auto dp = datapoint_ptrs[row];
+				if (dp->_is_classified && flat_decision_tree::bit(outputs, row) != dp->_classification)
 				{
 					return false;
 				}
@@ -168,15 +223,31 @@ namespace horn_verification
 			
 			
 			//
-			// Check Horn constraints
+			// Check Horn constraints (looking up the outputs of their data points by row)
 			//
+			std::unordered_map<const datapoint<bool> *, std::size_t> row_of;
+			if (!horn_constraints.empty())
+			{
+				row_of.reserve(datapoint_ptrs.size());
+				for (std::size_t row = 0; row < datapoint_ptrs.size(); ++row)
+				{
+					row_of.emplace(datapoint_ptrs[row], row);
+				}
+			}
+			
+			auto output = [&](const datapoint<bool> * dp)
+			{
+				const auto it = row_of.find(dp);
+				return it != row_of.end() ? flat_decision_tree::bit(outputs, it->second) : flat_tree.output(*dp);
+			};
+			
 			for (const auto & hc : horn_constraints)
 			{
 				
 				bool lhs = true;
 				for (const auto & dp : hc._premises)
 				{
-					if (!v.output(*tree.root(), *dp))
+					if (!output(dp))
 					{
 						lhs = false;
 						break;
@@ -184,7 +255,7 @@ namespace horn_verification
 				}
 				
 				// premisses are satisfied
-				if (lhs && (hc._conclusion == nullptr || !v.output(*tree.root(), *hc._conclusion)))
+				if (lhs && (hc._conclusion == nullptr || !output(hc._conclusion)))
 				{
 					return false;
 				}
@@ -6,8 +6,11 @@
 #define __SIMPLE_JOB_MANAGER_H__
 
 // C++ includes
+#include <algorithm>
 #include <list>
 #include <memory>
+#include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <stdexcept>
 #include <vector>
@@ -18,10 +21,11 @@
 #include <math.h>
 
 // Project includes
+#include "columnar_sample.h"
 #include "datapoint.h"
 #include "error.h"
 #include "horn_constraint.h"
-#include "horn_solver.h"
+#include "incremental_horn_solver.h"
 #include "job.h"
 #include "slice.h"
 
@@ -77,10 +81,9 @@ namespace horn_verification
 	 *      This method adds a new \ref slice to the job manager.</li>
 	 *  <li>next_job(): This method returns the job the manager wants to have
 	 *      performed next. A job can be to splt a node (i.e., either a
-	 *      \ref categorical_split_job or an \ref int_split_job, depending on
-	 *      which type of attribute the learner should split on) or to create a
-	 *      leaf node (i.e., a \ref leaf_creation_job). In order to facilitate
-	 *      polymorphism and be exception safe, the manager returns a \p unique_ptr.</li>
+	 *      categorical or an integer split, depending on which type of attribute
+	 *      the learner should split on) or to create a leaf node. The manager
+	 *      returns the job by value as a \ref node_job.</li>
 	 *  <li>has_jobs(): This method returns whether there are jobts that the
 	 *      learner needs to process.</li>
 	 * </ul>
@@ -104,6 +107,12 @@ namespace horn_verification
 		/// The slices that need to be processed
 		std::list<slice> _slices;
 	
+		/// The slices that carry a node of a previously learned tree and are processed first
+		std::list<slice> _replay_slices;
+	
+		/// The number of nodes that have been reused from a previously learned tree
+		std::size_t _reused_nodes = 0;
+	
 		/// A reference to the set of (pointers to) data points
 		std::vector<datapoint<bool> *> & _datapoint_ptrs;
 	
@@ -111,7 +120,7 @@ namespace horn_verification
 		const std::vector<horn_constraint<bool>> & _horn_constraints;
 	
 		/// The solver for Horn clauses
-		horn_solver<bool> & _horn_solver;
+		incremental_horn_solver<bool> & _horn_solver;
 	
 
 		/// Threshold which bounds the numerical cuts considered while constructing the tree 
@@ -119,7 +128,81 @@ namespace horn_verification
 		bool _are_numerical_cuts_thresholded;
 
 		bool _is_first_split = true;
+
+		/// Whether the data points of every slice are kept sorted according to every integer attribute (see set_presorted())
+		bool _are_attributes_presorted = false;
+
+		/**
+		 * An entry of a presorted attribute list, which carries the value of the attribute so that
+		 * sweeping over and partitioning the list does not need to look at the data point itself.
+		 */
+		struct presorted_entry
+		{
+			/// The value of the attribute
+			int value;
+
+			/// The index of the data point in _presorted_points
+			unsigned int index;
+		};
+
+		/// The data points referred to by the presorted entries
+		std::vector<datapoint<bool> *> _presorted_points;
+
+		/// Columnar copy of the data points referred to by the presorted entries (with the same rows), whose labels are refreshed before a slice is scored
+		columnar_sample _columns;
+
+		/// For every integer attribute, the entries of all data points sorted according to this attribute. Every slice occupies the same range in these lists as in _datapoint_ptrs.
+		std::vector<std::vector<presorted_entry>> _presorted_entries;
+
+		/// For every data point (by index in _presorted_points), the part of the slice being split that it belongs to
+		std::vector<unsigned int> _partition_keys;
+
+		/// For every category of the (first) categorical attribute, the closed interval of the integer attributes that belong to it (empty if the attributes are not known to be grouped this way)
+		std::vector<std::pair<unsigned, unsigned>> _attribute_intervals;
+
 		
+		/**
+		 * Counts of the data points in a contiguous set of data points. The split search maintains
+		 * these counts while sweeping over the candidate thresholds of an attribute instead of
+		 * rescanning the data points for every threshold.
+		 */
+		struct point_counts
+		{
+			/// The number of positively classified data points
+			unsigned int positive = 0;
+
+			/// The number of negatively classified data points
+			unsigned int negative = 0;
+
+			/// The number of unclassified data points
+			unsigned int unclassified = 0;
+
+			/// The sum of the fractional values of the data points (only used with HORN_ASSIGNMENTS)
+			double mass = 0.0;
+		};
+
+		/**
+		 * The best split of an integer attribute, which the split search computes for every attribute
+		 * before choosing the best split across the attributes.
+		 */
+		struct int_split_candidate
+		{
+			/// Whether a split of the attribute is possible
+			bool split_possible = false;
+
+			/// The information gain of the split (including the cost of its threshold)
+			double info_gain = 0.0;
+
+			/// The intrinsic value of the split
+			double intrinsic_value = 0.0;
+
+			/// The threshold of the split
+			int threshold = 0;
+		};
+
+		/// The minimum number of data points of a slice for which the integer attributes are processed in parallel
+		static const std::size_t parallel_split_search_threshold = 512;
+
 	public:
 	
 		/**
@@ -129,7 +212,7 @@ namespace horn_verification
 		 * @param horn_constraints A reference to the horn constraints over which to work
 		 * @param solver A reference to the Horn solver to use
 		 */
-		simple_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, horn_solver<bool> & solver)
+		simple_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver)
 			: _datapoint_ptrs(datapoint_ptrs), _horn_constraints(horn_constraints), _horn_solver(solver)
 		{
 			_are_numerical_cuts_thresholded = false;
@@ -143,12 +226,71 @@ namespace horn_verification
 		 * @param solver A reference to the Horn solver to use
 		 * @param threshold An unsigned int which serves as the threshold to cuts considered while splitting nodes wrt numerical attributes 
 		 */
-		simple_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, horn_solver<bool> & solver, \
+		simple_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, \
 																			unsigned int threshold)
 			: _datapoint_ptrs(datapoint_ptrs), _horn_constraints(horn_constraints), _horn_solver(solver), _threshold(threshold)
 		{
 			_are_numerical_cuts_thresholded = true;
 		}
+
+
+		/**
+		 * Sets whether the data points of every slice are kept sorted according to every integer
+		 * attribute. In this mode, the data points are sorted once per attribute when learning starts
+		 * and the sorted vectors are partitioned stably whenever a slice is split, so that neither the
+		 * split search nor the split jobs need to sort the data points (at the cost of one vector of
+		 * pointers per integer attribute).
+		 *
+		 * @param presorted Whether to keep the data points presorted
+		 */
+		inline void set_presorted(bool presorted)
+		{
+			_are_attributes_presorted = presorted;
+		}
+
+
+		/**
+		 * Checks whether a data point has the value 0 for all integer attributes outside of the interval
+		 * of its category (see set_attribute_intervals()). As the attributes of a data point do not
+		 * change, callers can check every data point once, when it is added to the sample.
+		 *
+		 * @param dp The data point
+		 * @param intervals For every category, the closed interval of its integer attributes
+		 *
+		 * @return whether the data point fits the intervals
+		 */
+		static bool fits_attribute_intervals(const datapoint<bool> & dp, const std::vector<std::pair<unsigned, unsigned>> & intervals)
+		{
+			if (dp._categorical_data.empty() || dp._categorical_data[0] >= intervals.size())
+			{
+				return false;
+			}
+			const auto & interval = intervals[dp._categorical_data[0]];
+			for (std::size_t attribute = 0; attribute < dp._int_data.size(); ++attribute)
+			{
+				if ((attribute < interval.first || attribute > interval.second) && dp._int_data[attribute] != 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+
+		/**
+		 * Sets the intervals of the integer attributes that belong to the categories of the (first)
+		 * categorical attribute, as for the relations of a CHC problem or the functions of a Boogie
+		 * program. Once the first split has separated the categories, only the integer attributes of
+		 * the category of a slice are searched for splits (and, if the data points are presorted,
+		 * kept sorted). The intervals must only be set if every data point fits them (see
+		 * fits_attribute_intervals()), as otherwise restricting the search might change the tree.
+		 *
+		 * @param intervals For every category, the closed interval of its integer attributes
+		 */
+		void set_attribute_intervals(const std::vector<std::pair<unsigned, unsigned>> & intervals)
+		{
+			_attribute_intervals = intervals;
+		}
 	
 
 		/**
@@ -158,7 +300,14 @@ namespace horn_verification
 		 */
 		void add_slice(const slice & sl)
 		{
-			_slices.push_back(sl);
+			if (sl._previous_node)
+			{
+				_replay_slices.push_back(sl);
+			}
+			else
+			{
+				_slices.push_back(sl);
+			}
 		}
 
 		
@@ -169,7 +318,14 @@ namespace horn_verification
 		 */
 		void add_slice(slice && sl)
 		{
-			_slices.push_back(std::move(sl));
+			if (sl._previous_node)
+			{
+				_replay_slices.push_back(std::move(sl));
+			}
+			else
+			{
+				_slices.push_back(std::move(sl));
+			}
 		}
 		
 		
@@ -180,7 +336,18 @@ namespace horn_verification
 		 */
 		inline bool has_jobs() const
 		{
-			return !_slices.empty();
+			return !_slices.empty() || !_replay_slices.empty();
+		}
+		
+		
+		/**
+		 * Returns the number of nodes that have been reused from a previously learned tree.
+		 *
+		 * @returns the number of reused nodes
+		 */
+		inline std::size_t reused_nodes() const
+		{
+			return _reused_nodes;
 		}
 		
 		
@@ -191,11 +358,33 @@ namespace horn_verification
 		 * This implementation is simplistic in that it retrieves slices in a breadth-first order
 		 * and uses a simple entropy measure to split slices.
 		 *
-		 * @returns a unique pointer to the next job
+		 * @returns the next job
+		 */
+		node_job next_job()
+		{
+			return update_presorted(select_next_job());
+		}
+
+	protected:
+
+		/**
+		 * Selects the next job (see next_job()).
+		 *
+		 * @returns the next job
 		 */
-		std::unique_ptr<abstract_job> next_job()
+		node_job select_next_job()
 		{
 		
+			//
+			// Rebuild the previously learned tree first (as long as it is consistent)
+			//
+			auto replayed_job = next_replay_job();
+			if (replayed_job)
+			{
+				return replayed_job;
+			}
+		
+		
 			//
 			// Get next slice
 			//
@@ -217,7 +406,7 @@ namespace horn_verification
 				}
 				
 				_is_first_split = false;
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, 0) };
+				return node_job::categorical_split(sl, 0);
 				
 			}
 		
@@ -233,7 +422,7 @@ namespace horn_verification
 			// Slice can be turned into a leaf node
 			if (can_be_turned_into_leaf)
 			{
-				return std::unique_ptr<abstract_job> {std::make_unique<leaf_creation_job>(sl, label, std::move(positive_ptrs), std::move(negative_ptrs))};
+				return node_job::leaf_creation(sl, label, std::move(positive_ptrs), std::move(negative_ptrs));
 			}
 			// Slice needs to be split
 			else
@@ -243,7 +432,162 @@ namespace horn_verification
 		
 		}
 		
-	protected:
+	
+		/**
+		 * Returns a job that reproduces the node of a previously learned tree that is
+		 * attached to the next slice carrying such a node. An integer split is reproduced
+		 * if it is still a proper split of the slice that reduces the weighted entropy of
+		 * the classified data points (and respects the bound on numerical cuts), unless the
+		 * slice can be turned into a leaf, in which case the leaf is created right away. A
+		 * leaf is reproduced if its label is still consistent with the data points and Horn
+		 * constraints. Otherwise, the slice is handed over to the regular job selection,
+		 * which regrows the subtree from scratch.
+		 *
+		 * @returns the job reproducing the previous node (or replacing it by a leaf) or an
+		 *          empty job if there is no such job
+		 */
+		node_job next_replay_job()
+		{
+		
+			if (_replay_slices.empty())
+			{
+				return node_job();
+			}
+			
+			auto sl = _replay_slices.front();
+			_replay_slices.pop_front();
+			
+			
+			//
+			// Categorical split (the first split needs to be on the unique categorical attribute)
+			//
+			auto previous_categorical_node = dynamic_cast<categorical_node *>(sl._previous_node);
+			if (previous_categorical_node && (!_is_first_split || previous_categorical_node->attribute() == 0))
+			{
+				
+				++_reused_nodes;
+				_is_first_split = false;
+				return node_job::categorical_split(sl, previous_categorical_node->attribute());
+				
+			}
+			
+			
+			//
+			// Integer split (the threshold needs to separate the slice and respect the bound)
+			//
+			auto previous_int_node = dynamic_cast<int_node *>(sl._previous_node);
+			if (previous_int_node && !_is_first_split)
+			{
+				
+				auto attribute = previous_int_node->attribute();
+				auto threshold = previous_int_node->threshold();
+				
+				point_counts left_counts;
+				point_counts right_counts;
+				for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+				{
+					simple_job_manager::add_point(_datapoint_ptrs[i]->_int_data[attribute] <= threshold ? left_counts : right_counts, _datapoint_ptrs[i]);
+				}
+				
+				// The split is only reproduced if it still reduces the (weighted) entropy of the classified data points
+				// (which also requires both sides to be non-empty) and the slice cannot be turned into a leaf instead (as
+				// the learner would do when learning from scratch). Otherwise, splits that no longer separate anything
+				// would be kept forever and the tree would only grow.
+				point_counts counts = left_counts;
+				counts.positive += right_counts.positive;
+				counts.negative += right_counts.negative;
+				auto reduces_entropy = simple_job_manager::weighted_entropy(left_counts) + simple_job_manager::weighted_entropy(right_counts) < simple_job_manager::weighted_entropy(counts);
+				
+				if (reduces_entropy && (!_are_numerical_cuts_thresholded || (-1 * _threshold <= threshold && threshold <= _threshold)))
+				{
+					auto label = false;
+					auto positive_ptrs = std::unordered_set<datapoint<bool> *>();
+					auto negative_ptrs = std::unordered_set<datapoint<bool> *>();
+					if (is_leaf(sl, label, positive_ptrs, negative_ptrs))
+					{
+						return node_job::leaf_creation(sl, label, std::move(positive_ptrs), std::move(negative_ptrs));
+					}
+
+					++_reused_nodes;
+					return node_job::int_split(sl, attribute, threshold);
+				}
+				
+			}
+			
+			
+			//
+			// Leaf
+			//
+			auto previous_leaf_node = dynamic_cast<leaf_node *>(sl._previous_node);
+			if (previous_leaf_node && !_is_first_split)
+			{
+				
+				auto positive_ptrs = std::unordered_set<datapoint<bool> *>();
+				auto negative_ptrs = std::unordered_set<datapoint<bool> *>();
+				if (is_leaf_with_label(sl, previous_leaf_node->output(), positive_ptrs, negative_ptrs))
+				{
+					++_reused_nodes;
+					return node_job::leaf_creation(sl, previous_leaf_node->output(), std::move(positive_ptrs), std::move(negative_ptrs));
+				}
+				
+			}
+			
+			
+			//
+			// Previous node cannot be reused, thus regrow subtree
+			//
+			sl._previous_node = nullptr;
+			_slices.push_back(std::move(sl));
+			
+			return node_job();
+			
+		}
+	
+	
+		/**
+		 * Checks whether a slice can be turned into a leaf node with a given label. If so,
+		 * this method also determines which unlabeled data points need to be labeled
+		 * positively and negatively, respectively, in order to satisfy the horn constraints.
+		 *
+		 * @param sl The slice to check
+		 * @param label The label of the leaf node
+		 * @param positive_ptrs If the slice can be turned into a leaf, this paramater is used to return
+		 *                      a set of (pointers to) unlabaled data points which have to be labeled positively
+		 * @param negative_ptrs If the slice can be turned into a leaf, this paramater is used to return
+		 *                      a set of (pointers to) unlabaled data points which have to be labeled negatively
+		 *
+		 * @return whether this slice can be turned into a leaf node with the given label
+		 */
+		bool is_leaf_with_label(const slice & sl, bool label, std::unordered_set<datapoint<bool> *> & positive_ptrs, std::unordered_set<datapoint<bool> *> & negative_ptrs)
+		{
+		
+			assert (sl._left_index <= sl._right_index && sl._right_index < _datapoint_ptrs.size());
+			assert (positive_ptrs.empty());
+			assert (negative_ptrs.empty());
+			
+			auto & unlabeled_ptrs = label ? positive_ptrs : negative_ptrs;
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				
+				if (_datapoint_ptrs[i]->_is_classified)
+				{
+					if (_datapoint_ptrs[i]->_classification != label)
+					{
+						return false;
+					}
+				}
+				else
+				{
+					unlabeled_ptrs.insert(_datapoint_ptrs[i]);
+				}
+				
+			}
+			
+			// Run Horn solver if unlabeled data points need to be labeled
+			return unlabeled_ptrs.empty() || _horn_solver.solve(_datapoint_ptrs, _horn_constraints, positive_ptrs, negative_ptrs);
+		
+		}
+	
 	
 		/**
 		 * Checks whether a slice can be turned into a leaf node. If so, this method also
@@ -525,9 +869,9 @@ namespace horn_verification
 		 *
 		 * @param sl The slice of data points to be split
 		 *
-		 * @returns a unique pointer to the job created
+		 * @returns the job created
 		 */
-		std::unique_ptr<abstract_job> find_best_split(const slice & sl)
+		node_job find_best_split(const slice & sl)
 		{
 			
 			assert (sl._left_index <= sl._right_index && sl._right_index < _datapoint_ptrs.size());
@@ -542,6 +886,11 @@ namespace horn_verification
 			double best_cat_gain_ratio = 0;
 			std::size_t best_cat_attribute = 0;
 
+			// The counts of the whole slice do not depend on the order of the data points
+			const auto slice_counts = count_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+			const auto slice_classified_points = num_classified_points(slice_counts);
+			const auto slice_entropy = entropy(slice_counts);
+
 			
 			//
 			// Process categorical attributes
@@ -554,7 +903,7 @@ namespace horn_verification
 				std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
 				
 				
-				// 2) sum all weighted entropies
+				// 2) sum all weighted entropies (counting the points of each category while scanning it)
 				double total_weighted_entropy = 0;
 				double total_intrinsic_value = 0;
 				bool split_possible = true;
@@ -565,10 +914,13 @@ namespace horn_verification
 				{
 				
 					auto cur_category = _datapoint_ptrs[cur_left]->_categorical_data[attribute];
+					point_counts category_counts;
+					add_point(category_counts, _datapoint_ptrs[cur_right]);
 
 					while (cur_right + 1 <= sl._right_index && cur_category == _datapoint_ptrs[cur_right + 1]->_categorical_data[attribute])
 					{
 						++cur_right;
+						add_point(category_counts, _datapoint_ptrs[cur_right]);
 					}
 			
 			
@@ -580,10 +932,10 @@ namespace horn_verification
 					}
 					else
 					{
-						total_weighted_entropy += weighted_entropy(_datapoint_ptrs, cur_left, cur_right);
+						total_weighted_entropy += weighted_entropy(category_counts);
 
-						double n1 = 1.0 * num_classified_points(_datapoint_ptrs, cur_left, cur_right);
-						double n = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+						double n1 = 1.0 * num_classified_points(category_counts);
+						double n = 1.0 * slice_classified_points;
 						total_intrinsic_value += (n1 == 0) ? 0.0 : -1.0 * (n1/n) * log2(n1/n);
 
 						cur_left = cur_right + 1;
@@ -593,14 +945,13 @@ namespace horn_verification
 				if (split_possible)
 				{
 					double info_gain;
-                                        if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0)
+                                        if (slice_classified_points == 0)
                                         {
-                                                info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index);
+                                                info_gain = slice_entropy;
                                         }
                                         else
                                         {
-                                                info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
-                                                                total_weighted_entropy / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+                                                info_gain = slice_entropy - total_weighted_entropy / slice_classified_points;
 
                                         }
 
@@ -621,110 +972,32 @@ namespace horn_verification
 			//
 			// Process integer attributes
 			//
-			for (std::size_t attribute = 0; attribute < _datapoint_ptrs[sl._left_index]->_int_data.size(); ++attribute)
+			// Every attribute is scored on its own sorted copy of the slice (in parallel if OpenMP is enabled). The best
+			// split is then chosen in the order of the attributes, so that ties are broken as if they were processed one
+			// after another.
+			std::vector<int_split_candidate> candidates(_datapoint_ptrs[sl._left_index]->_int_data.size());
+			for_each_sorted_int_attribute(sl, [&](const auto & sorted_ptrs, std::size_t left_index, std::size_t right_index, std::size_t attribute)
 			{
-				int tries = 0;
-				double best_int_entropy_for_given_attribute = 1000000;
-				bool int_split_possible_for_given_attribute = false;
-				int best_int_split_index_for_given_attribute = 0;
-				double best_intrinsic_value_for_given_attribute = 0;
-
-
-				// 1) Sort according to int attribute
-				auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[attribute] < b->_int_data[attribute]; };
-				std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
-				
-				
-				// 2) Try all thresholds of current attribute
-				auto cur = sl._left_index;
-				while (cur < sl._right_index)
-				{
-				
-					// Skip to riight most entry with the same value
-					while (cur + 1 <= sl._right_index && _datapoint_ptrs[cur + 1]->_int_data[attribute] == _datapoint_ptrs[cur]->_int_data[attribute])
-					{
-						++cur;
-					}
-
-					// Split is possible
-					if (cur < sl._right_index)
-					{
-						tries++;
+				candidates[attribute] = score_int_attribute(sorted_ptrs, left_index, right_index, attribute, slice_counts);
+			});
 
-
-						// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
-						if (! _are_numerical_cuts_thresholded || \
-							       	((-1 * _threshold <= _datapoint_ptrs[cur]->_int_data[attribute]) && \
-										       (_datapoint_ptrs[cur]->_int_data[attribute] <= _threshold)))
-						{
-
-							//std::cout << "considering attribute: " << attribute << " sl._left_index: " << cur << " cut: " << _datapoint_ptrs[cur]->_int_data[attribute] << std::endl;
-							// weighted_entropy_left = H(left_node) * num_classified_points(left_node)
-							auto weighted_entropy_left = weighted_entropy(_datapoint_ptrs, sl._left_index, cur);
-							// weighted_entropy_right = H(right_node) * num_classified_points(right_node)
-							auto weighted_entropy_right = weighted_entropy(_datapoint_ptrs, cur + 1, sl._right_index);
-							auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
-						
-							if (!int_split_possible_for_given_attribute || total_weighted_entropy < best_int_entropy_for_given_attribute)
-							{
-								//std::cout << "updated the entropy; split is now definitely possible" << std::endl;	
-								int_split_possible_for_given_attribute = true;
-							
-								best_int_entropy_for_given_attribute = total_weighted_entropy;
-								best_int_split_index_for_given_attribute = cur;
-
-								// computation of the intrinsic value of the attribute
-								double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
-								double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
-								double n = n1 + n2;
-								best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
-                                                               		                                          (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
-									
-							}
-						
-						}
-							
-						++cur;			
-					}
-					
-				}
-				if (int_split_possible_for_given_attribute)
+			for (std::size_t attribute = 0; attribute < candidates.size(); ++attribute)
+			{
+				const auto & candidate = candidates[attribute];
+				if (candidate.split_possible)
 				{
-					// We have found the best split threshold for the given attribute
-					// Now compute the information gain to optimize across different attributes
-					double best_info_gain_for_attribute;					                                        
-					if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0.0)
-                                        {      
-                                                best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) ;
-                                        }
-                                        else
-                                        {
-                                                best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
-                                                        best_int_entropy_for_given_attribute / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);               
-                                        }
-
-					double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
-							       (_datapoint_ptrs[best_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
-							                  _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]);
-
-					assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
-					double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
-						                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
-
-					best_info_gain_for_attribute -= threshCost;
-					assert (best_intrinsic_value_for_given_attribute > 0.0);
-					double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_intrinsic_value_for_given_attribute;
+					assert (candidate.intrinsic_value > 0.0);
+					double best_gain_ratio_for_given_attribute = candidate.info_gain / candidate.intrinsic_value;
 
 					if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio) || \
-					    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && \
-					      std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold)))	
+					    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && std::abs(candidate.threshold) < std::abs(best_int_threshold)))	
 					{
 						// if this is the first attribute for which a split is possible then
 						// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
 						int_split_possible = true;
 						best_int_gain_ratio = best_gain_ratio_for_given_attribute;
 						best_int_attribute = attribute;
-						best_int_threshold = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
+						best_int_threshold = candidate.threshold;
 					}
 
 				}
@@ -743,23 +1016,23 @@ namespace horn_verification
 			
 			else if (int_split_possible && !cat_split_possible)
 			{
-				return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+				return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 			}
 			
 			else if (!int_split_possible && cat_split_possible)
 			{
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+				return node_job::categorical_split(sl, best_cat_attribute);
 			}
 			
 			else
 			{
 				if (best_int_gain_ratio <= best_cat_gain_ratio)
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+					return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 				}
 				else
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+					return node_job::categorical_split(sl, best_cat_attribute);
 				}
 
 			}
@@ -778,25 +1051,24 @@ namespace horn_verification
 		 * @return the entropy of the given set of data points
 		 */
 		double entropy(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			return entropy(count_points(datapoint_ptrs, left_index, right_index));
+		}
+
+
+		/**
+		 * Computes the entropy (with respect to the logarithm of 2) of a set of data points given
+		 * by its counts.
+		 *
+		 * @param counts The counts of the set of data points
+		 *
+		 * @return the entropy of the given set of data points
+		 */
+		double entropy(const point_counts & counts)
 		{
 			
-			unsigned int count_f = 0;
-			unsigned int count_t = 0;
-			
-			for (std::size_t i = left_index; i <= right_index; ++i)
-			{
-				if (datapoint_ptrs[i]->_is_classified)
-				{
-					if (datapoint_ptrs[i]->_classification)
-					{
-						++count_t;
-					}
-					else
-					{
-						++count_f;
-					}
-				}
-			}
+			unsigned int count_f = counts.negative;
+			unsigned int count_t = counts.positive;
 			
 			double sum = count_t + count_f;
 			//std::cout << "sum=" << sum << std::endl;
@@ -827,6 +1099,19 @@ namespace horn_verification
 			return entropy(datapoint_ptrs, left_index, right_index) * num_classified_points(_datapoint_ptrs, left_index, right_index); 
 		}
 
+		/**
+		 * Computes the entropy (with respect to the logarithm of 2) of a set of data points given
+		 * by its counts, weighted by the number of points classified in the set.
+		 *
+		 * @param counts The counts of the set of data points
+		 *
+		 * @return the weighted entropy of the given set of data points
+		 */
+		double weighted_entropy(const point_counts & counts)
+		{
+			return entropy(counts) * num_classified_points(counts);
+		}
+
 		/**
 		 * Computes the number of classified points in a contiguous set of data points.
 		 *
@@ -851,22 +1136,527 @@ namespace horn_verification
 			return count;
 		}
 
-			
 		/**
-		 * Returns if an unclassified point is present in a contiguous set of data points.
+		 * Computes the number of classified points in a set of data points given by its counts.
 		 *
-		 * @param datapoint_ptrs Pointer to the data points
-		 * @param left_index The left bound of the set of data points
-		 * @param right_index The right bound of the set of data points
+		 * @param counts The counts of the set of data points
 		 *
-		 * @return If an unclassified point is present in the contiguous set of data points.
-		 */				                                                
-		bool unclassified_points_present(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		 * @return the number of classified points in the set of data points.
+		 */
+		unsigned int num_classified_points(const point_counts & counts)
 		{
-			for (std::size_t i = left_index; i <= right_index; ++i)
-			{
-				if (! datapoint_ptrs[i]->_is_classified)
-				{
+			return counts.positive + counts.negative;
+		}
+
+		/**
+		 * Returns the data point of an element of a vector of data points.
+		 *
+		 * @param dp The element
+		 *
+		 * @return the data point
+		 */
+		static datapoint<bool> * point_of(datapoint<bool> * dp)
+		{
+			return dp;
+		}
+
+		/**
+		 * Returns the data point of an entry of a presorted list.
+		 *
+		 * @param entry The entry
+		 *
+		 * @return the data point
+		 */
+		datapoint<bool> * point_of(const presorted_entry & entry) const
+		{
+			return _presorted_points[entry.index];
+		}
+
+		/**
+		 * Returns the row of an entry of a presorted list in the columnar copy of the data points.
+		 *
+		 * @param entry The entry
+		 *
+		 * @return the row
+		 */
+		static std::size_t row_of(const presorted_entry & entry)
+		{
+			return entry.index;
+		}
+
+		/**
+		 * Returns the value of an integer attribute of an element of a vector of data points.
+		 *
+		 * @param dp The element
+		 * @param attribute The integer attribute
+		 *
+		 * @return the value of the attribute
+		 */
+		static int value_of(const datapoint<bool> * dp, std::size_t attribute)
+		{
+			return dp->_int_data[attribute];
+		}
+
+		/**
+		 * Returns the value of an integer attribute of an entry of a presorted list (of this attribute).
+		 *
+		 * @param entry The entry
+		 * @param attribute The integer attribute
+		 *
+		 * @return the value of the attribute
+		 */
+		static int value_of(const presorted_entry & entry, std::size_t attribute)
+		{
+			return entry.value;
+		}
+
+		/**
+		 * Adds a data point to the counts of a set of data points.
+		 *
+		 * @param counts The counts to update
+		 * @param dp The data point to add
+		 */
+		void add_point(point_counts & counts, datapoint<bool> * dp)
+		{
+			if (! dp->_is_classified)
+			{
+				++counts.unclassified;
+			}
+			else if (dp->_classification)
+			{
+				++counts.positive;
+			}
+			else
+			{
+				++counts.negative;
+			}
+		}
+
+		/**
+		 * Adds the data point of an entry of a presorted list to the counts of a set of data points,
+		 * reading its label from the columnar copy of the data points.
+		 *
+		 * @param counts The counts to update
+		 * @param entry The entry of the data point to add
+		 */
+		void add_point(point_counts & counts, const presorted_entry & entry)
+		{
+			const auto row = row_of(entry);
+			if (! _columns.is_classified(row))
+			{
+				++counts.unclassified;
+			}
+			else if (_columns.classification(row))
+			{
+				++counts.positive;
+			}
+			else
+			{
+				++counts.negative;
+			}
+		}
+
+		/**
+		 * Counts the data points of a contiguous set of data points.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points (or a presorted list)
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 *
+		 * @return the counts of the given set of data points
+		 */
+		template <class Element>
+		point_counts count_points(const std::vector<Element> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			point_counts counts;
+			for (std::size_t i = left_index; i <= right_index; ++i)
+			{
+				add_point(counts, datapoint_ptrs[i]);
+			}
+			return counts;
+		}
+
+		/**
+		 * Computes the counts of the data points of a set that are not contained in a subset of it
+		 * (e.g., the data points right of a threshold). The fractional mass is not derived, as the
+		 * difference of two sums of fractions is not exact.
+		 *
+		 * @param total The counts of the set of data points
+		 * @param part The counts of the subset
+		 *
+		 * @return the counts of the remaining data points
+		 */
+		point_counts remaining_points(const point_counts & total, const point_counts & part)
+		{
+			point_counts counts;
+			counts.positive = total.positive - part.positive;
+			counts.negative = total.negative - part.negative;
+			counts.unclassified = total.unclassified - part.unclassified;
+			return counts;
+		}
+
+
+		/**
+		 * Sorts a contiguous set of data points according to an integer attribute.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 * @param attribute The integer attribute
+		 */
+		static void sort_by_int_attribute(std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index, std::size_t attribute)
+		{
+			auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[attribute] < b->_int_data[attribute]; };
+			std::sort(datapoint_ptrs.begin() + left_index, datapoint_ptrs.begin() + right_index + 1, comparer);
+		}
+
+
+		/**
+		 * Calls a function for every integer attribute with a copy of the data points of a slice that
+		 * is sorted according to this attribute. Each thread sorts into its own copy, which leaves the
+		 * order of the slice unchanged and allows to process the attributes in parallel if OpenMP is
+		 * enabled. Hence, the function may be called concurrently and in any order of the attributes.
+		 * If the data points are presorted, the function is called with the presorted list of the attribute instead.
+		 *
+		 * @param sl The slice of data points
+		 * @param score_attribute The function to call with the sorted data points, their left and right bound and the attribute
+		 */
+		template <class Function>
+		void for_each_sorted_int_attribute(const slice & sl, Function score_attribute)
+		{
+			const auto attributes = int_attribute_range(sl);
+			const std::size_t number_of_points = sl._right_index - sl._left_index + 1;
+			const bool is_presorted = _are_attributes_presorted && !_presorted_entries.empty();
+			if (attributes.first == attributes.second)
+			{
+				return;
+			}
+			if (is_presorted)
+			{
+				// Data points may have been classified since the slice was created
+				refresh_labels(sl, attributes.first);
+			}
+
+			#pragma omp parallel if (attributes.second - attributes.first > 1 && number_of_points >= parallel_split_search_threshold)
+			{
+				std::vector<datapoint<bool> *> sorted_ptrs;
+
+				#pragma omp for schedule(dynamic)
+				for (std::size_t attribute = attributes.first; attribute < attributes.second; ++attribute)
+				{
+					if (is_presorted)
+					{
+						score_attribute(_presorted_entries[attribute], sl._left_index, sl._right_index, attribute);
+						continue;
+					}
+
+					sorted_ptrs.assign(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1);
+					sort_by_int_attribute(sorted_ptrs, 0, number_of_points - 1, attribute);
+					score_attribute(sorted_ptrs, 0, number_of_points - 1, attribute);
+				}
+			}
+		}
+
+
+		/**
+		 * Returns the integer attributes that can split a slice. Once the first split has separated
+		 * the categories of the data points, these are the attributes of the category of the slice if
+		 * intervals of attributes are set (see set_attribute_intervals()), as all other attributes are
+		 * 0 for every data point of the slice. Otherwise, these are all integer attributes.
+		 *
+		 * @param sl The slice
+		 *
+		 * @return the attributes as a half-open interval [first, second)
+		 */
+		std::pair<std::size_t, std::size_t> int_attribute_range(const slice & sl) const
+		{
+			const auto dp = _datapoint_ptrs[sl._left_index];
+			if (_attribute_intervals.empty() || _is_first_split)
+			{
+				return std::make_pair<std::size_t, std::size_t>(0, dp->_int_data.size());
+			}
+
+			const auto & interval = _attribute_intervals[dp->_categorical_data[0]];
+			return std::make_pair<std::size_t, std::size_t>(interval.first, interval.second + 1);
+		}
+
+
+		/**
+		 * Keeps the presorted lists in step with a job before the learner runs it. The lists are built
+		 * for the first job that processes all data points (as the job of the initial slice does). If the job
+		 * splits its slice, every data point of the slice is marked with the part it belongs to, and the
+		 * range of the slice is partitioned stably in every list according to these marks, so that the
+		 * parts occupy the ranges of the new slices and remain sorted. The data points of the slice are
+		 * then handed to the job already sorted.
+		 *
+		 * @param job The job to be run next
+		 *
+		 * @returns the given job
+		 */
+		node_job update_presorted(node_job job)
+		{
+			if (!_are_attributes_presorted)
+			{
+				return job;
+			}
+
+			const auto & sl = job.job_slice();
+			if (_presorted_entries.empty() && sl._left_index == 0 && sl._right_index + 1 == _datapoint_ptrs.size())
+			{
+				presort();
+			}
+			if (_presorted_entries.empty())
+			{
+				return job;
+			}
+
+			std::size_t number_of_parts = 0;
+			std::size_t sorted_attribute = 0;
+			const auto is_int_split = job.kind() == node_job::INT_SPLIT;
+			if (is_int_split)
+			{
+				// The left part (0) contains the data points up to the threshold
+				number_of_parts = 2;
+				sorted_attribute = job.attribute();
+				const auto & entries = _presorted_entries[sorted_attribute];
+				for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+				{
+					_partition_keys[entries[i].index] = entries[i].value <= job.threshold() ? 0 : 1;
+				}
+			}
+			else if (job.kind() == node_job::CATEGORICAL_SPLIT)
+			{
+				// The parts are ordered by category (as the categorical split job does)
+				const auto & entries = _presorted_entries[sorted_attribute];
+				for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+				{
+					const auto category = _columns.categorical_column(job.attribute())[row_of(entries[i])];
+					_partition_keys[entries[i].index] = category;
+					number_of_parts = std::max<std::size_t>(number_of_parts, category + 1);
+				}
+			}
+			else
+			{
+				return job;
+			}
+
+			// Below a split on an integer attribute, only the lists of the attributes that can split the slice are used
+			const auto attributes = is_int_split ? int_attribute_range(sl) : std::make_pair<std::size_t, std::size_t>(0, _presorted_entries.size());
+
+			#pragma omp parallel for schedule(dynamic) if (sl._right_index - sl._left_index + 1 >= parallel_split_search_threshold)
+			for (std::size_t attribute = attributes.first; attribute < attributes.second; ++attribute)
+			{
+				partition_stably(_presorted_entries[attribute], sl, number_of_parts);
+			}
+
+			const auto & entries = _presorted_entries[sorted_attribute];
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				_datapoint_ptrs[i] = _presorted_points[entries[i].index];
+			}
+			job.set_sorted();
+
+			return job;
+		}
+
+
+		/**
+		 * Builds the columnar copy of all data points and the presorted list of every integer attribute from it.
+		 */
+		void presort()
+		{
+			_presorted_points = _datapoint_ptrs;
+			_columns = columnar_sample(_presorted_points);
+			_partition_keys.assign(_presorted_points.size(), 0);
+			_presorted_entries.resize(_presorted_points.front()->_int_data.size());
+
+			#pragma omp parallel for schedule(dynamic)
+			for (std::size_t attribute = 0; attribute < _presorted_entries.size(); ++attribute)
+			{
+				const auto & column = _columns.int_column(attribute);
+				auto & entries = _presorted_entries[attribute];
+				entries.resize(column.size());
+				for (std::size_t i = 0; i < column.size(); ++i)
+				{
+					entries[i].value = column[i];
+					entries[i].index = i;
+				}
+				std::sort(entries.begin(), entries.end(), [](const presorted_entry & a, const presorted_entry & b) { return a.value < b.value; });
+			}
+		}
+
+
+		/**
+		 * Copies the labels of the data points of a slice into the columnar copy of the data points.
+		 *
+		 * @param sl The slice
+		 * @param attribute An integer attribute whose presorted list is kept in step with the slice
+		 */
+		void refresh_labels(const slice & sl, std::size_t attribute)
+		{
+			const auto & entries = _presorted_entries[attribute];
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				_columns.set_label(row_of(entries[i]), *point_of(entries[i]));
+			}
+		}
+
+
+		/**
+		 * Partitions the range of a slice in a presorted list stably according to the parts marked in
+		 * _partition_keys (by counting sort), so that the parts follow each other in increasing order.
+		 *
+		 * @param entries The presorted list
+		 * @param sl The slice to partition
+		 * @param number_of_parts The number of parts
+		 */
+		void partition_stably(std::vector<presorted_entry> & entries, const slice & sl, std::size_t number_of_parts)
+		{
+			// The buffers are private to the calling thread, as the lists are partitioned in parallel
+			thread_local std::vector<presorted_entry> buffer;
+			thread_local std::vector<std::size_t> offsets;
+
+			offsets.assign(number_of_parts + 1, 0);
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				++offsets[_partition_keys[entries[i].index] + 1];
+			}
+			for (std::size_t part = 1; part < offsets.size(); ++part)
+			{
+				offsets[part] += offsets[part - 1];
+			}
+			buffer.resize(sl._right_index - sl._left_index + 1);
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				buffer[offsets[_partition_keys[entries[i].index]]++] = entries[i];
+			}
+			std::copy(buffer.begin(), buffer.end(), entries.begin() + sl._left_index);
+		}
+
+
+		/**
+		 * Computes the best threshold of an integer attribute for splitting a contiguous set of data
+		 * points that is sorted according to this attribute.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points (or the presorted list of the attribute)
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 * @param attribute The integer attribute
+		 * @param slice_counts The counts of the set of data points
+		 *
+		 * @return the best split of the given attribute
+		 */
+		template <class Element>
+		int_split_candidate score_int_attribute(const std::vector<Element> & datapoint_ptrs, std::size_t left_index, std::size_t right_index, std::size_t attribute, const point_counts & slice_counts)
+		{
+			const auto slice_classified_points = num_classified_points(slice_counts);
+			const auto slice_entropy = entropy(slice_counts);
+
+			int tries = 0;
+			double best_int_entropy_for_given_attribute = 1000000;
+			bool int_split_possible_for_given_attribute = false;
+			int best_int_split_index_for_given_attribute = 0;
+			double best_intrinsic_value_for_given_attribute = 0;
+
+			// Try all thresholds of the attribute (counting the points left of the threshold while sweeping)
+			point_counts left_counts;
+			auto cur = left_index;
+			while (cur < right_index)
+			{
+
+				// Skip to riight most entry with the same value
+				add_point(left_counts, datapoint_ptrs[cur]);
+				while (cur + 1 <= right_index && value_of(datapoint_ptrs[cur + 1], attribute) == value_of(datapoint_ptrs[cur], attribute))
+				{
+					++cur;
+					add_point(left_counts, datapoint_ptrs[cur]);
+				}
+
+				// Split is possible
+				if (cur < right_index)
+				{
+					tries++;
+
+					// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
+					if (! _are_numerical_cuts_thresholded || \
+					    ((-1 * _threshold <= value_of(datapoint_ptrs[cur], attribute)) && (value_of(datapoint_ptrs[cur], attribute) <= _threshold)))
+					{
+						auto right_counts = remaining_points(slice_counts, left_counts);
+						// weighted_entropy_left = H(left_node) * num_classified_points(left_node)
+						auto weighted_entropy_left = weighted_entropy(left_counts);
+						// weighted_entropy_right = H(right_node) * num_classified_points(right_node)
+						auto weighted_entropy_right = weighted_entropy(right_counts);
+						auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
+
+						if (!int_split_possible_for_given_attribute || total_weighted_entropy < best_int_entropy_for_given_attribute)
+						{
+							int_split_possible_for_given_attribute = true;
+
+							best_int_entropy_for_given_attribute = total_weighted_entropy;
+							best_int_split_index_for_given_attribute = cur;
+
+							// computation of the intrinsic value of the attribute
+							double n1 = 1.0 * num_classified_points(left_counts);
+							double n2 = 1.0 * num_classified_points(right_counts);
+							double n = n1 + n2;
+							best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+							                                           (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+						}
+
+					}
+
+					++cur;
+				}
+
+			}
+
+			int_split_candidate candidate;
+			if (int_split_possible_for_given_attribute)
+			{
+				// We have found the best split threshold for the given attribute
+				// Now compute the information gain to optimize across different attributes
+				double best_info_gain_for_attribute;
+				if (slice_classified_points == 0.0)
+				{
+					best_info_gain_for_attribute = slice_entropy;
+				}
+				else
+				{
+					best_info_gain_for_attribute = slice_entropy - best_int_entropy_for_given_attribute / slice_classified_points;
+				}
+
+				double interval = (value_of(datapoint_ptrs[right_index], attribute) - value_of(datapoint_ptrs[left_index], attribute)) / \
+				                  (value_of(datapoint_ptrs[best_int_split_index_for_given_attribute+1], attribute) - \
+				                   value_of(datapoint_ptrs[best_int_split_index_for_given_attribute], attribute));
+
+				assert (slice_classified_points > 0);
+				double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / slice_classified_points;
+
+				candidate.split_possible = true;
+				candidate.info_gain = best_info_gain_for_attribute - threshCost;
+				candidate.intrinsic_value = best_intrinsic_value_for_given_attribute;
+				candidate.threshold = value_of(datapoint_ptrs[best_int_split_index_for_given_attribute], attribute);
+			}
+
+			return candidate;
+		}
+
+			
+		/**
+		 * Returns if an unclassified point is present in a contiguous set of data points.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 *
+		 * @return If an unclassified point is present in the contiguous set of data points.
+		 */				                                                
+		bool unclassified_points_present(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			for (std::size_t i = left_index; i <= right_index; ++i)
+			{
+				if (! datapoint_ptrs[i]->_is_classified)
+				{
 					return true;
 				}
 			}
@@ -965,6 +1755,81 @@ namespace horn_verification
 		// of the Horn assignment. Only used when _entropy_computation_criterion == HORN_ASSIGNMENTS.
 		std::map<datapoint<bool> *,double> _datapoint_ptrs_to_frac;
 
+		// Position of the conclusion of a horn constraint relative to the threshold of a split. Only used when _entropy_computation_criterion == PENALTY.
+		enum Position : char {LEFT, RIGHT};
+
+		// Horn constraints by the data points occurring in them as premise (once for every occurrence) and as conclusion.
+		// Only used when _entropy_computation_criterion == PENALTY, like the following members.
+		std::unordered_map<datapoint<bool> *, std::vector<std::size_t>> _constraints_with_premise;
+		std::unordered_map<datapoint<bool> *, std::vector<std::size_t>> _constraints_with_conclusion;
+		bool _are_horn_constraints_indexed = false;
+
+		// The same horn constraints by the rows of the columnar copy of the presorted data points (the constraints of row r are
+		// those from offsets[r] to offsets[r + 1]). Only used if the data points are presorted.
+		std::vector<std::size_t> _row_premise_offsets;
+		std::vector<std::size_t> _row_premise_constraints;
+		std::vector<std::size_t> _row_conclusion_offsets;
+		std::vector<std::size_t> _row_conclusion_constraints;
+
+		// The horn constraints whose conclusion is an unclassified data point of the slice being split, and the position of
+		// every horn constraint in this list (-1 if it is not in scope, indexed by constraint).
+		std::vector<std::size_t> _constraints_in_scope;
+		std::vector<int> _scope_indexes;
+
+		// For every horn constraint in scope: the number of occurrences of unclassified data points of the slice among its premises
+		// (indexed by the position in _constraints_in_scope).
+		std::vector<int> _num_premises_in_slice;
+
+		// The state of a sweep over the thresholds of an attribute. Every attribute is swept with its own state, so that the
+		// attributes can be processed concurrently.
+		struct penalty_sweep
+		{
+			// For every horn constraint in scope: the position of its conclusion and how many of the unclassified data points of
+			// the slice among its premises are left of the threshold (indexed by the position in _constraints_in_scope).
+			std::vector<Position> conclusion_positions;
+			std::vector<int> num_premises_left;
+
+			// The number of implications from the left to the right part and from the right to the left part
+			int left2right = 0;
+			int right2left = 0;
+		};
+
+		// The pending slices ordered by their (weighted) entropy, which is cached. Only used if the nodes are selected by their
+		// (weighted) entropy and _entropy_computation_criterion != HORN_ASSIGNMENTS (Horn assignments are sampled anew for every
+		// node, which changes the entropy of every slice). The super class adds new slices to _slices, which are moved into the
+		// queue when the next job is selected. The score of a queued slice is only recomputed when the Horn solver labels one of
+		// its data points; the outdated entries of the queue are skipped.
+		struct queued_slice
+		{
+			slice sl;
+			std::size_t version;
+			bool is_pending;
+			bool is_stale;
+		};
+
+		struct queue_entry
+		{
+			// The score of the slice (negated if the slice with the minimum score is selected)
+			double key;
+			// The number of the slice (slices are numbered in the order they are added, ties go to the first one)
+			std::size_t id;
+			// The version of the slice when the score was computed
+			std::size_t version;
+
+			bool operator<(const queue_entry & other) const
+			{
+				return key < other.key || (key == other.key && id > other.id);
+			}
+		};
+
+		std::vector<queued_slice> _queued_slices;
+		std::priority_queue<queue_entry> _slice_queue;
+		std::size_t _number_of_queued_slices = 0;
+
+		// The (number of the) queued slice every data point belonged to last and the slices whose score needs to be recomputed
+		std::unordered_map<datapoint<bool> *, std::size_t> _queued_slice_of;
+		std::vector<std::size_t> _stale_slices;
+
 
 	public:
 	        /**
@@ -976,7 +1841,7 @@ namespace horn_verification
 		 * @param node_selection_criterion Node selection heuristic to be used while building the tree
 		 * @param entropy_computation_criterion Criterion for scoring a node/slice a la entropy
                  */
-                complex_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, horn_solver<bool> & solver, \
+                complex_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, \
 						NodeSelection node_selection_criterion, EntropyComputation entropy_computation_criterion, ConjunctiveSetting conjunctive_setting)
                         : simple_job_manager(datapoint_ptrs, horn_constraints, solver)
                 {
@@ -996,7 +1861,7 @@ namespace horn_verification
                  * @param node_selection_criterion Node selection heuristic to be used while building the tree
                  * @param entropy_computation_criterion Criterion for scoring a node/slice a la entropy
                  */
-                complex_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, horn_solver<bool> & solver, \
+                complex_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, \
                            unsigned int threshold, NodeSelection node_selection_criterion, EntropyComputation entropy_computation_criterion, ConjunctiveSetting conjunctive_setting)
                         : simple_job_manager(datapoint_ptrs, horn_constraints, solver, threshold)
                 {
@@ -1168,11 +2033,55 @@ namespace horn_verification
 		 * Returns the next job. 
 		 * If _node_selection_criterion is DEFAULT, calls the next_job() function of the super class
 		 *
-		 * @returns a unique pointer to the next job
+		 * @returns the next job
+		 */
+		node_job next_job()
+		{
+			auto job = update_presorted(select_next_job());
+
+			// The data points labeled by a leaf creation job change the score of their slices
+			if (is_slice_queue_used())
+			{
+				if (job.kind() == node_job::LEAF_CREATION)
+				{
+					mark_stale_slices(job.positive_ptrs());
+					mark_stale_slices(job.negative_ptrs());
+				}
+			}
+
+			return job;
+		}
+
+
+		/**
+		 * Returns whether there are jobs left (i.e., slices that need to be processed), including the
+		 * slices in the queue of scored slices.
+		 *
+		 * @returns whether there are jobs left
+		 */
+		inline bool has_jobs() const
+		{
+			return simple_job_manager::has_jobs() || _number_of_queued_slices > 0;
+		}
+
+
+		/**
+		 * Selects the next job (see next_job()).
+		 *
+		 * @returns the next job
 		 */
-		std::unique_ptr<abstract_job> next_job()
+		node_job select_next_job()
 		{
 
+			//
+			// Rebuild the previously learned tree first (as long as it is consistent)
+			//
+			auto replayed_job = next_replay_job();
+			if (replayed_job)
+			{
+				return replayed_job;
+			}
+
 			if (_is_first_split)
 			{
 				srand(time(NULL));
@@ -1186,7 +2095,7 @@ namespace horn_verification
 				}
 				_is_first_split = false;
 
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, 0) };
+				return node_job::categorical_split(sl, 0);
 			}	
 			else
 			{
@@ -1222,8 +2131,8 @@ namespace horn_verification
 					// Slice can be turned into a leaf node
 					if (can_be_turned_into_leaf)
 					{
-						return std::unique_ptr<abstract_job> {std::make_unique<leaf_creation_job>(sl, label, \
-												std::move(positive_ptrs), std::move(negative_ptrs))};
+						return node_job::leaf_creation(sl, label, \
+												std::move(positive_ptrs), std::move(negative_ptrs));
 					}
 					// Slice needs to be split
 					else
@@ -1282,6 +2191,12 @@ namespace horn_verification
 				else if (_node_selection_criterion == MAX_ENTROPY || _node_selection_criterion == MAX_WEIGHTED_ENTROPY)
 				{
 
+					// Select the slice with the best cached score
+					if (is_slice_queue_used())
+					{
+						return leaf_or_split_job(pop_queued_slice());
+					}
+
 					if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
 					{
 						_datapoint_ptrs_to_frac.clear();
@@ -1290,7 +2205,8 @@ namespace horn_verification
 					}
 
 					
-					float max_entropy = 0.0;
+					// (compared as double, such that ties go to the first slice as in the queue of scored slices)
+					double max_entropy = 0.0;
 					unsigned int max_entropy_slice_index = 0;
 					unsigned int cur_index = 0;
 					for (auto it = _slices.begin(); it != _slices.end(); it++)
@@ -1316,28 +2232,19 @@ namespace horn_verification
 					//
 					// Determine what needs to be done (split or create leaf)
 					//
-					auto label = false; // label is unimportant (if is_leaf() returns false)
-					auto positive_ptrs = std::unordered_set<datapoint<bool> *>();
-					auto negative_ptrs = std::unordered_set<datapoint<bool> *>();
-					auto can_be_turned_into_leaf = is_leaf(sl, label, positive_ptrs, negative_ptrs);
-
-					// Slice can be turned into a leaf node
-					if (can_be_turned_into_leaf)
-					{
-						return std::unique_ptr<abstract_job> {std::make_unique<leaf_creation_job>(sl, label, \
-														       std::move(positive_ptrs), std::move(negative_ptrs))};
-					}
-					// Slice needs to be split
-					else
-					{
-						return find_best_split(sl);
-					}					
+					return leaf_or_split_job(sl);
 
 
 				}
 				else if (_node_selection_criterion == MIN_ENTROPY || _node_selection_criterion == MIN_WEIGHTED_ENTROPY)
 				{
 
+					// Select the slice with the best cached score
+					if (is_slice_queue_used())
+					{
+						return leaf_or_split_job(pop_queued_slice());
+					}
+
 					if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
 					{
 						_datapoint_ptrs_to_frac.clear();
@@ -1345,7 +2252,8 @@ namespace horn_verification
 						update_datapoint_ptrs_to_frac_with_complete_horn_assignments();
 					}
 
-					float min_entropy = _node_selection_criterion == MIN_ENTROPY ? 1.0 : 100000.0 ;
+					// (compared as double, such that ties go to the first slice as in the queue of scored slices)
+					double min_entropy = _node_selection_criterion == MIN_ENTROPY ? 1.0 : 100000.0 ;
 					unsigned int min_entropy_slice_index = 0;
 					unsigned int cur_index = 0;
 					for (auto it = _slices.begin(); it != _slices.end(); it++)
@@ -1371,22 +2279,7 @@ namespace horn_verification
 					//
 					// Determine what needs to be done (split or create leaf)
 					//
-					auto label = false; // label is unimportant (if is_leaf() returns false)
-					auto positive_ptrs = std::unordered_set<datapoint<bool> *>();
-					auto negative_ptrs = std::unordered_set<datapoint<bool> *>();
-					auto can_be_turned_into_leaf = is_leaf(sl, label, positive_ptrs, negative_ptrs);
-
-					// Slice can be turned into a leaf node
-					if (can_be_turned_into_leaf)
-					{
-						return std::unique_ptr<abstract_job> {std::make_unique<leaf_creation_job>(sl, label, \
-														       std::move(positive_ptrs), std::move(negative_ptrs))};
-					}
-					// Slice needs to be split
-					else
-					{
-						return find_best_split(sl);
-					}					
+					return leaf_or_split_job(sl);
 
 				}
 				else
@@ -1397,6 +2290,142 @@ namespace horn_verification
 			}
 		}
 
+
+		/**
+		 * Determines whether a slice is turned into a leaf or split and returns the corresponding job.
+		 *
+		 * @param sl The slice to process
+		 *
+		 * @returns the job
+		 */
+		node_job leaf_or_split_job(const slice & sl)
+		{
+			auto label = false; // label is unimportant (if is_leaf() returns false)
+			auto positive_ptrs = std::unordered_set<datapoint<bool> *>();
+			auto negative_ptrs = std::unordered_set<datapoint<bool> *>();
+			auto can_be_turned_into_leaf = is_leaf(sl, label, positive_ptrs, negative_ptrs);
+
+			// Slice can be turned into a leaf node
+			if (can_be_turned_into_leaf)
+			{
+				return node_job::leaf_creation(sl, label, std::move(positive_ptrs), std::move(negative_ptrs));
+			}
+			// Slice needs to be split
+			else
+			{
+				return find_best_split(sl);
+			}
+		}
+
+
+		/**
+		 * Returns whether the pending slices are kept in a queue ordered by their cached score (see
+		 * _slice_queue).
+		 *
+		 * @returns whether the queue of scored slices is used
+		 */
+		bool is_slice_queue_used() const
+		{
+			return _entropy_computation_criterion != HORN_ASSIGNMENTS && (_node_selection_criterion == MAX_ENTROPY || _node_selection_criterion == MAX_WEIGHTED_ENTROPY ||
+				_node_selection_criterion == MIN_ENTROPY || _node_selection_criterion == MIN_WEIGHTED_ENTROPY);
+		}
+
+
+		/**
+		 * Computes the score of a queued slice and adds it to the queue with the current version of
+		 * the slice.
+		 *
+		 * @param id The number of the slice
+		 */
+		void push_queued_slice(std::size_t id)
+		{
+			const auto & qs = _queued_slices[id];
+			const auto score = _node_selection_criterion == MAX_ENTROPY || _node_selection_criterion == MIN_ENTROPY ? entropy(_datapoint_ptrs, qs.sl._left_index, qs.sl._right_index) :
+				weighted_entropy(_datapoint_ptrs, qs.sl._left_index, qs.sl._right_index);
+			const auto is_max = _node_selection_criterion == MAX_ENTROPY || _node_selection_criterion == MAX_WEIGHTED_ENTROPY;
+			_slice_queue.push(queue_entry { is_max ? score : -score, id, qs.version });
+		}
+
+
+		/**
+		 * Moves the new slices into the queue, recomputes the outdated scores and removes the slice
+		 * with the best score from the queue (the slice with the maximum or minimum score, depending
+		 * on _node_selection_criterion, and the first one of several such slices).
+		 *
+		 * @returns the slice with the best score
+		 */
+		slice pop_queued_slice()
+		{
+
+			// Add new slices
+			for (auto & sl : _slices)
+			{
+				const auto id = _queued_slices.size();
+				for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+				{
+					_queued_slice_of[_datapoint_ptrs[i]] = id;
+				}
+				_queued_slices.push_back(queued_slice { std::move(sl), 0, true, false });
+				push_queued_slice(id);
+				++_number_of_queued_slices;
+			}
+			_slices.clear();
+
+			// Rescore slices whose data points have been labeled
+			for (auto id : _stale_slices)
+			{
+				auto & qs = _queued_slices[id];
+				qs.is_stale = false;
+				if (qs.is_pending)
+				{
+					++qs.version;
+					push_queued_slice(id);
+				}
+			}
+			_stale_slices.clear();
+
+			// Skip outdated entries
+			while (true)
+			{
+				assert (!_slice_queue.empty());
+				const auto entry = _slice_queue.top();
+				_slice_queue.pop();
+
+				auto & qs = _queued_slices[entry.id];
+				if (qs.is_pending && qs.version == entry.version)
+				{
+					qs.is_pending = false;
+					--_number_of_queued_slices;
+					return qs.sl;
+				}
+			}
+
+		}
+
+
+		/**
+		 * Marks the queued slices that contain (one of) the given data points, whose labels are about
+		 * to change, such that their score is recomputed before the next slice is selected.
+		 *
+		 * @param datapoint_ptrs The data points
+		 */
+		void mark_stale_slices(const std::unordered_set<datapoint<bool> *> & datapoint_ptrs)
+		{
+			for (auto dp : datapoint_ptrs)
+			{
+				auto it = _queued_slice_of.find(dp);
+				if (it != _queued_slice_of.end())
+				{
+					auto & qs = _queued_slices[it->second];
+					if (qs.is_pending && !qs.is_stale)
+					{
+						qs.is_stale = true;
+						_stale_slices.push_back(it->second);
+					}
+				}
+			}
+		}
+
 		/**
 		 * Computes the entropy (with respect to the logarithm of 2) of a contiguous set of data
 		 * points.
@@ -1408,21 +2437,27 @@ namespace horn_verification
 		 * @return the entropy of the given set of data points
 		 */
 		double entropy(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			return entropy(count_points(datapoint_ptrs, left_index, right_index));
+		}
+
+
+		/**
+		 * Computes the entropy (with respect to the logarithm of 2) of a set of data points given
+		 * by its counts.
+		 *
+		 * @param counts The counts of the set of data points
+		 *
+		 * @return the entropy of the given set of data points
+		 */
+		double entropy(const point_counts & counts)
 		{
 			if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
 			{
 				double count_f = 0.0;
-				double count_t = 0.0;
-			
-				for (std::size_t i = left_index; i <= right_index; ++i)
-				{
-					// assert that datapoint_ptrs[i] is present in the map _datapoint_ptrs_to_frac
-					auto it = _datapoint_ptrs_to_frac.find(datapoint_ptrs[i]);
-					assert (it != _datapoint_ptrs_to_frac.end());
-					count_t += it->second;
-				}
+				double count_t = counts.mass;
 			
-				double sum = right_index - left_index + 1;
+				double sum = counts.positive + counts.negative + counts.unclassified;
 				count_f = sum - count_t;
 
 				//std::cout << "sum=" << sum << std::endl;
@@ -1440,23 +2475,8 @@ namespace horn_verification
 			else if (_entropy_computation_criterion == DEFAULT_ENTROPY || _entropy_computation_criterion == PENALTY)
 			{
 
-				unsigned int count_f = 0;
-				unsigned int count_t = 0;
-			
-				for (std::size_t i = left_index; i <= right_index; ++i)
-				{
-					if (datapoint_ptrs[i]->_is_classified)
-					{
-						if (datapoint_ptrs[i]->_classification)
-						{
-							++count_t;
-						}
-						else
-						{
-							++count_f;
-						}
-					}
-				}
+				unsigned int count_f = counts.negative;
+				unsigned int count_t = counts.positive;
 			
 				double sum = count_t + count_f;
 				//std::cout << "sum=" << sum << std::endl;
@@ -1503,37 +2523,340 @@ namespace horn_verification
 			}
 			else if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
 			{
-				return right_index - left_index + 1;
+				return right_index - left_index + 1;
+			}
+			assert (false);
+			return 0;
+		}
+
+	
+		/**
+		 * Computes the entropy (with respect to the logarithm of 2) of a contiguous set of data
+		 * points, weighted by the number of points classified in the set.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 *
+		 * @return the entropy of the given set of data points
+		 */
+		double weighted_entropy(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
+			{
+				return entropy(datapoint_ptrs, left_index, right_index) * (right_index - left_index + 1);
+			}
+			else if (_entropy_computation_criterion == DEFAULT_ENTROPY || _entropy_computation_criterion == PENALTY)
+			{
+				return entropy(datapoint_ptrs, left_index, right_index) * num_classified_points(_datapoint_ptrs, left_index, right_index); 
+			}
+			// _entropy_computation_criterion should be one of the two implemented criterions
+			// Control should never reach here!
+			assert (false);
+			return 0.0;
+		}
+
+
+		/**
+		 * Computes the number of classified points in a set of data points given by its counts.
+		 *
+		 * @param counts The counts of the set of data points
+		 *
+		 * @return the number of classified points in the set of data points.
+		 */
+		unsigned int num_classified_points(const point_counts & counts)
+		{
+			if (_entropy_computation_criterion == DEFAULT_ENTROPY || _entropy_computation_criterion == PENALTY)
+			{
+				return counts.positive + counts.negative;
+			}
+			else if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
+			{
+				return counts.positive + counts.negative + counts.unclassified;
+			}
+			assert (false);
+			return 0;
+		}
+
+
+		/**
+		 * Computes the entropy (with respect to the logarithm of 2) of a set of data points given
+		 * by its counts, weighted by the number of points classified in the set.
+		 *
+		 * @param counts The counts of the set of data points
+		 *
+		 * @return the weighted entropy of the given set of data points
+		 */
+		double weighted_entropy(const point_counts & counts)
+		{
+			return entropy(counts) * num_classified_points(counts);
+		}
+
+
+		/**
+		 * Adds a data point to the counts of a set of data points, including its fractional value
+		 * if the entropy is computed with respect to Horn assignments.
+		 *
+		 * @param counts The counts to update
+		 * @param dp The data point to add
+		 */
+		void add_point(point_counts & counts, datapoint<bool> * dp)
+		{
+			simple_job_manager::add_point(counts, dp);
+			if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
+			{
+				// assert that dp is present in the map _datapoint_ptrs_to_frac
+				auto it = _datapoint_ptrs_to_frac.find(dp);
+				assert (it != _datapoint_ptrs_to_frac.end());
+				counts.mass += it->second;
+			}
+		}
+
+
+		/**
+		 * Adds the data point of an entry of a presorted list to the counts of a set of data points,
+		 * including its fractional value if the entropy is computed with respect to Horn assignments.
+		 *
+		 * @param counts The counts to update
+		 * @param entry The entry of the data point to add
+		 */
+		void add_point(point_counts & counts, const presorted_entry & entry)
+		{
+			simple_job_manager::add_point(counts, entry);
+			if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
+			{
+				auto it = _datapoint_ptrs_to_frac.find(point_of(entry));
+				assert (it != _datapoint_ptrs_to_frac.end());
+				counts.mass += it->second;
 			}
-			assert (false);
-			return 0;
 		}
 
-	
+
 		/**
-		 * Computes the entropy (with respect to the logarithm of 2) of a contiguous set of data
-		 * points, weighted by the number of points classified in the set.
+		 * Counts the data points of a contiguous set of data points. The fractional values are
+		 * summed from left to right.
 		 *
-		 * @param datapoint_ptrs Pointer to the data points
+		 * @param datapoint_ptrs Pointer to the data points (or a presorted list)
 		 * @param left_index The left bound of the set of data points
 		 * @param right_index The right bound of the set of data points
 		 *
-		 * @return the entropy of the given set of data points
+		 * @return the counts of the given set of data points
 		 */
-		double weighted_entropy(const std::vector<datapoint<bool> *> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		template <class Element>
+		point_counts count_points(const std::vector<Element> & datapoint_ptrs, std::size_t left_index, std::size_t right_index)
+		{
+			point_counts counts;
+			for (std::size_t i = left_index; i <= right_index; ++i)
+			{
+				add_point(counts, datapoint_ptrs[i]);
+			}
+			return counts;
+		}
+
+
+		/**
+		 * Computes the best threshold of an integer attribute for splitting a contiguous set of data
+		 * points that is sorted according to this attribute, as well as the best threshold for a
+		 * conjunctive split (if conjunctive splits are preferred). Only reads the state of the job
+		 * manager, so that several attributes can be scored concurrently.
+		 *
+		 * @param datapoint_ptrs Pointer to the data points (or the presorted list of the attribute)
+		 * @param left_index The left bound of the set of data points
+		 * @param right_index The right bound of the set of data points
+		 * @param attribute The integer attribute
+		 * @param candidate The best split of the given attribute (output)
+		 * @param conj_candidate The best conjunctive split of the given attribute (output)
+		 */
+		template <class Element>
+		void score_int_attribute(const std::vector<Element> & datapoint_ptrs, std::size_t left_index, std::size_t right_index, std::size_t attribute, \
+						int_split_candidate & candidate, int_split_candidate & conj_candidate)
 		{
+			int tries = 0;
+			double best_int_entropy_for_given_attribute = 1000000;
+			bool int_split_possible_for_given_attribute = false;
+			int best_int_split_index_for_given_attribute = 0;
+			double best_intrinsic_value_for_given_attribute = 0;
+
+			double best_conj_int_entropy_for_given_attribute = 1000000;
+			bool conj_int_split_possible_for_given_attribute = false;
+			int best_conj_int_split_index_for_given_attribute = 0;
+			double best_conj_intrinsic_value_for_given_attribute = 0;
+
+			// Try all thresholds of the attribute (counting the points left of the threshold while sweeping)
+			const auto slice_counts = count_points(datapoint_ptrs, left_index, right_index);
+			const auto slice_classified_points = num_classified_points(slice_counts);
+			const auto slice_entropy = entropy(slice_counts);
+			point_counts left_counts;
+
+			// The fractional mass of the points right of every index (summed once from right to left, such that the sweep
+			// takes linear time; like a sum from left to right, a partial sum never exceeds its number of points)
+			std::vector<double> right_masses;
 			if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
 			{
-				return entropy(datapoint_ptrs, left_index, right_index) * (right_index - left_index + 1);
+				right_masses.assign(right_index - left_index + 2, 0.0);
+				for (auto i = right_index + 1; i-- > left_index; )
+				{
+					point_counts counts;
+					add_point(counts, datapoint_ptrs[i]);
+					right_masses[i - left_index] = counts.mass + right_masses[i - left_index + 1];
+				}
 			}
-			else if (_entropy_computation_criterion == DEFAULT_ENTROPY || _entropy_computation_criterion == PENALTY)
+
+			// number of implications in the horn constraints cut by the current split (maintained while sweeping).
+			penalty_sweep sweep;
+			if (_entropy_computation_criterion == PENALTY)
 			{
-				return entropy(datapoint_ptrs, left_index, right_index) * num_classified_points(_datapoint_ptrs, left_index, right_index); 
+				start_penalty_sweep(sweep);
+			}
+
+			auto cur = left_index;
+			while (cur < right_index)
+			{
+
+				// Skip to riight most entry with the same value
+				add_point(left_counts, datapoint_ptrs[cur]);
+				if (_entropy_computation_criterion == PENALTY)
+				{
+					move_penalty_point(sweep, datapoint_ptrs[cur]);
+				}
+				while (cur + 1 <= right_index && value_of(datapoint_ptrs[cur + 1], attribute) == value_of(datapoint_ptrs[cur], attribute))
+				{
+					++cur;
+					add_point(left_counts, datapoint_ptrs[cur]);
+					if (_entropy_computation_criterion == PENALTY)
+					{
+						move_penalty_point(sweep, datapoint_ptrs[cur]);
+					}
+				}
+
+				// Split is possible
+				if (cur < right_index)
+				{
+					tries++;
+
+					// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
+					if (! _are_numerical_cuts_thresholded || \
+					    ((-1 * _threshold <= value_of(datapoint_ptrs[cur], attribute)) && (value_of(datapoint_ptrs[cur], attribute) <= _threshold)))
+					{
+						auto right_counts = remaining_points(slice_counts, left_counts);
+						if (_entropy_computation_criterion == HORN_ASSIGNMENTS)
+						{
+							right_counts.mass = right_masses[cur + 1 - left_index];
+						}
+						auto weighted_entropy_left = weighted_entropy(left_counts);
+						auto weighted_entropy_right = weighted_entropy(right_counts);
+						auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
+						double total_entropy;
+						if (slice_classified_points == 0.0)
+						{
+							total_entropy = 0.0;
+						}
+						else
+						{
+							total_entropy = total_weighted_entropy / (double)slice_classified_points;
+						}
+
+
+						// Add a penalty based on the number of implications in the horn constraints that are cut by the current split.
+						if (_entropy_computation_criterion == PENALTY)
+						{
+							double nleft = left_counts.negative;
+							double pleft = left_counts.positive;
+							double nright = right_counts.negative;
+							double pright = right_counts.positive;
+							double total_classified_points = nleft + pleft + nright + pright;
+
+							nleft = nleft == 0 ? 0 : nleft / (nleft + pleft);
+							pleft = pleft == 0 ? 0 : pleft / (nleft + pleft);
+							nright = nright == 0 ? 0 : nright / (nright + pright);
+							pright = pright == 0 ? 0 : pright / (nright + pright);
+
+							double penaltyVal = (1 - nleft * pright) * sweep.left2right + (1 - nright * pleft) * sweep.right2left;
+							penaltyVal = 2 * penaltyVal / (2 * (sweep.left2right + sweep.right2left) + total_classified_points);
+							total_entropy += penaltyVal;
+						}
+
+
+						// If the learner prefers conjunctive splits
+						if (_conjunctive_setting == PREFERENCEFORCONJUNCTS)
+						{
+							// Check if a conjunctive split is possible
+							if (left_counts.positive == 0 || right_counts.positive == 0)
+							{
+								// One of the sub node consists purely of negative or unclassified points.
+								// Consider this as a prospective candidate for a conjunctive split
+
+								if (! conj_int_split_possible_for_given_attribute || \
+								    total_entropy < best_conj_int_entropy_for_given_attribute)
+								{
+									conj_int_split_possible_for_given_attribute = true;
+
+									best_conj_int_entropy_for_given_attribute = total_entropy;
+									best_conj_int_split_index_for_given_attribute = cur;
+
+									// computation of the intrinsic value of the attribute
+									double n1 = 1.0 * num_classified_points(left_counts);
+									double n2 = 1.0 * num_classified_points(right_counts);
+									double n = n1 + n2;
+									best_conj_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+									                                                (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+								}
+							}
+						}
+
+						if (!int_split_possible_for_given_attribute || total_entropy < best_int_entropy_for_given_attribute)
+						{
+							int_split_possible_for_given_attribute = true;
+
+							best_int_entropy_for_given_attribute = total_entropy;
+							best_int_split_index_for_given_attribute = cur;
+
+							// computation of the intrinsic value of the attribute
+							double n1 = 1.0 * num_classified_points(left_counts);
+							double n2 = 1.0 * num_classified_points(right_counts);
+							double n = n1 + n2;
+							best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+							                                           (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+						}
+
+					}
+
+					++cur;
+				}
+
+			}
+
+			// We have found the best split thresholds for the given attribute
+			// Now compute the information gains to optimize across different attributes
+			if (_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_int_split_possible_for_given_attribute)
+			{
+				double interval = (value_of(datapoint_ptrs[right_index], attribute) - value_of(datapoint_ptrs[left_index], attribute)) / \
+				                  (value_of(datapoint_ptrs[best_conj_int_split_index_for_given_attribute+1], attribute) - \
+				                   value_of(datapoint_ptrs[best_conj_int_split_index_for_given_attribute], attribute));
+
+				assert (slice_classified_points > 0);
+				double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / slice_classified_points;
+
+				conj_candidate.split_possible = true;
+				conj_candidate.info_gain = slice_entropy - best_conj_int_entropy_for_given_attribute - threshCost;
+				conj_candidate.intrinsic_value = best_conj_intrinsic_value_for_given_attribute;
+				conj_candidate.threshold = value_of(datapoint_ptrs[best_conj_int_split_index_for_given_attribute], attribute);
+			}
+
+			if (int_split_possible_for_given_attribute)
+			{
+				double interval = (value_of(datapoint_ptrs[right_index], attribute) - value_of(datapoint_ptrs[left_index], attribute)) / \
+				                  (value_of(datapoint_ptrs[best_int_split_index_for_given_attribute+1], attribute) - \
+				                   value_of(datapoint_ptrs[best_int_split_index_for_given_attribute], attribute));
+
+				assert (slice_classified_points > 0);
+				double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / slice_classified_points;
+
+				candidate.split_possible = true;
+				candidate.info_gain = slice_entropy - best_int_entropy_for_given_attribute - threshCost;
+				candidate.intrinsic_value = best_intrinsic_value_for_given_attribute;
+				candidate.threshold = value_of(datapoint_ptrs[best_int_split_index_for_given_attribute], attribute);
 			}
-			// _entropy_computation_criterion should be one of the two implemented criterions
-			// Control should never reach here!
-			assert (false);
-			return 0.0;
 		}
 
 
@@ -1545,9 +2868,9 @@ namespace horn_verification
 		 *
 		 * @param sl The slice of data points to be split
 		 *
-		 * @returns a unique pointer to the job created
+		 * @returns the job created
 		 */
-		std::unique_ptr<abstract_job> find_best_split(const slice & sl)
+		node_job find_best_split(const slice & sl)
 		{
 			
 			assert (sl._left_index <= sl._right_index && sl._right_index < _datapoint_ptrs.size());
@@ -1588,7 +2911,9 @@ namespace horn_verification
 				std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
 				
 				
-				// 2) sum all weighted entropies
+				// 2) sum all weighted entropies (counting the points of each category while scanning it)
+				const auto slice_counts = count_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+				const auto slice_classified_points = num_classified_points(slice_counts);
 				double total_weighted_entropy = 0;
 				double total_intrinsic_value = 0;
 				bool split_possible = true;
@@ -1599,10 +2924,13 @@ namespace horn_verification
 				{
 				
 					auto cur_category = _datapoint_ptrs[cur_left]->_categorical_data[attribute];
+					point_counts category_counts;
+					add_point(category_counts, _datapoint_ptrs[cur_right]);
 
 					while (cur_right + 1 <= sl._right_index && cur_category == _datapoint_ptrs[cur_right + 1]->_categorical_data[attribute])
 					{
 						++cur_right;
+						add_point(category_counts, _datapoint_ptrs[cur_right]);
 					}
 			
 			
@@ -1614,10 +2942,10 @@ namespace horn_verification
 					}
 					else
 					{
-						total_weighted_entropy += weighted_entropy(_datapoint_ptrs, cur_left, cur_right);
+						total_weighted_entropy += weighted_entropy(category_counts);
 
-                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, cur_left, cur_right);
-                                                double n = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+                                                double n1 = 1.0 * num_classified_points(category_counts);
+                                                double n = 1.0 * slice_classified_points;
                                                 total_intrinsic_value += (n1 == 0) ? 0.0 : -1.0 * (n1/n) * log2(n1/n);
 
 						cur_left = cur_right + 1;
@@ -1628,14 +2956,13 @@ namespace horn_verification
                                 if (split_possible)
                                 {
 					double info_gain;
-					if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0)
+					if (slice_classified_points == 0)
 					{
-						info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index);
+						info_gain = entropy(slice_counts);
 					}
 					else
 					{
-						info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
-							    	total_weighted_entropy / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+						info_gain = entropy(slice_counts) - total_weighted_entropy / slice_classified_points;
 
 					}
 					assert (total_intrinsic_value > 0.0);
@@ -1655,250 +2982,115 @@ namespace horn_verification
 			//
 			// Process integer attributes
 			//
-			for (std::size_t attribute = 0; attribute < _datapoint_ptrs[sl._left_index]->_int_data.size(); ++attribute)
+			std::vector<int_split_candidate> candidates(_datapoint_ptrs[sl._left_index]->_int_data.size());
+			std::vector<int_split_candidate> conj_candidates(candidates.size());
+			if (_entropy_computation_criterion == PENALTY)
 			{
-				int tries = 0;
-                                double best_int_entropy_for_given_attribute = 1000000;
-                                bool int_split_possible_for_given_attribute = false;
-                                int best_int_split_index_for_given_attribute = 0;
-                                double best_intrinsic_value_for_given_attribute = 0;
-
-				double best_conj_int_entropy_for_given_attribute = 1000000;
-                                bool conj_int_split_possible_for_given_attribute = false;
-                                int best_conj_int_split_index_for_given_attribute = 0;
-                                double best_conj_intrinsic_value_for_given_attribute = 0;
-
-	
-				// 1) Sort according to int attribute
-				auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[attribute] < b->_int_data[attribute]; };
-				std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
-				
-				
-				// 2) Try all thresholds of current attribute
-				auto cur = sl._left_index;
-				while (cur < sl._right_index)
+				prepare_penalty(sl);
+				index_horn_constraints_by_row();
+			}
+			if (_entropy_computation_criterion == HORN_ASSIGNMENTS && !_are_attributes_presorted)
+			{
+				// Sums of fractions depend on the order of summation, i.e., on the order in which sorting the slice according to
+				// the previous attributes has left the data points. Hence, the attributes are sorted in place one after another
+				// (unless the data points are presorted, whose order then determines the sums).
+				const auto attributes = int_attribute_range(sl);
+				for (std::size_t attribute = attributes.first; attribute < attributes.second; ++attribute)
 				{
-				
-					// Skip to riight most entry with the same value
-					while (cur + 1 <= sl._right_index && _datapoint_ptrs[cur + 1]->_int_data[attribute] == _datapoint_ptrs[cur]->_int_data[attribute])
-					{
-						++cur;
-					}
+					sort_by_int_attribute(_datapoint_ptrs, sl._left_index, sl._right_index, attribute);
+					score_int_attribute(_datapoint_ptrs, sl._left_index, sl._right_index, attribute, candidates[attribute], conj_candidates[attribute]);
+				}
+			}
+			else
+			{
+				// Every attribute is scored on its own sorted copy of the slice (in parallel if OpenMP is enabled)
+				for_each_sorted_int_attribute(sl, [&](const auto & sorted_ptrs, std::size_t left_index, std::size_t right_index, std::size_t attribute)
+				{
+					score_int_attribute(sorted_ptrs, left_index, right_index, attribute, candidates[attribute], conj_candidates[attribute]);
+				});
+			}
 
-					// Split is possible
-					if (cur < sl._right_index)
+			// The best split is chosen in the order of the attributes, so that ties are broken as if they were processed one after another
+			for (std::size_t attribute = 0; attribute < candidates.size(); ++attribute)
+			{
+				const auto & conj_candidate = conj_candidates[attribute];
+				if (_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_candidate.split_possible)
+				{
+					if (conj_candidate.intrinsic_value > 0.0)
 					{
-                                                tries++;
+						conj_non_zero_intrinsic_value_possible = true;
+						double best_gain_ratio_for_given_attribute = conj_candidate.info_gain / conj_candidate.intrinsic_value;
 
-						// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
-						if (! _are_numerical_cuts_thresholded || \
-							       	((-1 * _threshold <= _datapoint_ptrs[cur]->_int_data[attribute]) && \
-										       (_datapoint_ptrs[cur]->_int_data[attribute] <= _threshold)))
+						if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio) || \
+						    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio && std::abs(conj_candidate.threshold) < std::abs(best_conj_int_threshold)))
 						{
-							//std::cout << "considering attribute: " << attribute << " sl._left_index: " << cur << " cut: " << _datapoint_ptrs[cur]->_int_data[attribute] << std::endl;
-							auto weighted_entropy_left = weighted_entropy(_datapoint_ptrs, sl._left_index, cur);
-							auto weighted_entropy_right = weighted_entropy(_datapoint_ptrs, cur + 1, sl._right_index);
-							auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
-							double total_entropy; 
-							if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0.0)
-							{
-								total_entropy = 0.0;
-							}
-							else
-							{
-								total_entropy = total_weighted_entropy / \
-										     (double)num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
-							}
-
-
-							// Add a penalty based on the number of implications in the horn constraints that are cut by the current split.
-							if (_entropy_computation_criterion == PENALTY)
-							{
-								// number of implications in the horn constraints cut by the current split.
-								int left2right = 0;
-								int right2left = 0;
-								penalty(sl, sl._left_index, cur, sl._right_index, &left2right, &right2left);		
-								double nleft = num_points_with_classification(_datapoint_ptrs, sl._left_index, cur, false);
-								double pleft = num_points_with_classification(_datapoint_ptrs, sl._left_index, cur, true);
-								double nright = num_points_with_classification(_datapoint_ptrs, cur+1, sl._right_index, false);
-								double pright = num_points_with_classification(_datapoint_ptrs, cur+1, sl._right_index, true);
-								double total_classified_points = nleft + pleft + nright + pright;
-
-								nleft = nleft == 0 ? 0 : nleft / (nleft + pleft);
-								pleft = pleft == 0 ? 0 : pleft / (nleft + pleft);
-								nright = nright == 0 ? 0 : nright / (nright + pright);
-								pright = pright == 0 ? 0 : pright / (nright + pright);
-
-								double penaltyVal = (1 - nleft * pright) * left2right + (1 - nright * pleft) * right2left;
-								penaltyVal = 2 * penaltyVal / (2 * (left2right + right2left) + total_classified_points);
-								total_entropy += penaltyVal;
-							}
-
-
-							// If the learner prefers conjunctive splits
-							if (_conjunctive_setting == PREFERENCEFORCONJUNCTS)
-							{
-								// Check if a conjunctive split is possible
-								if (! positive_points_present(_datapoint_ptrs, sl._left_index, cur) || \
-										! positive_points_present(_datapoint_ptrs, cur + 1, sl._right_index))
-								{
-									// One of the sub node consists purely of negative or unclassified points.
-									// Consider this as a prospective candidate for a conjunctive split
-			
-									if (! conj_int_split_possible_for_given_attribute || \
-											total_entropy < best_conj_int_entropy_for_given_attribute)
-									{
-										//std::cout << "updated the entropy; split is now definitely possible" << std::endl;	
-										conj_int_split_possible_for_given_attribute = true;
-							
-										best_conj_int_entropy_for_given_attribute = total_entropy;
-										best_conj_int_split_index_for_given_attribute = cur;
-
-										// computation of the intrinsic value of the attribute
-                		                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
-                                		                                double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
-                                                		                double n = n1 + n2;
-                                                                		best_conj_intrinsic_value_for_given_attribute = \
-														(n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
-													        (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
-
-									}
-								}
-							}
-	
-							if (!int_split_possible_for_given_attribute || total_entropy < best_int_entropy_for_given_attribute)
-                                                        {
-                                                                //std::cout << "updated the entropy; split is now definitely possible" << std::endl;    
-                                                                int_split_possible_for_given_attribute = true;
-
-                                                                best_int_entropy_for_given_attribute = total_entropy;
-                                                                best_int_split_index_for_given_attribute = cur;
-
-                                                                // computation of the intrinsic value of the attribute
-                                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
-                                                                double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
-                                                                double n = n1 + n2;
-                                                                best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
-													       (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
-
-                                                        }
-
+							// if this is the first attribute for which a split is possible then
+							// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+							conj_int_split_possible = true;
+							best_conj_int_gain_ratio = best_gain_ratio_for_given_attribute;
+							best_conj_int_attribute = attribute;
+							best_conj_int_threshold = conj_candidate.threshold;
 						}
-							
-						++cur;			
-					}
-					
-				}
-
-				if (_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_int_split_possible_for_given_attribute)
-                                {
-                                        // We have found the best split threshold for the given attribute
-                                        // Now compute the information gain to optimize across different attributes
-                                        double best_info_gain_for_attribute;
-					best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - best_conj_int_entropy_for_given_attribute;
-
-                                        double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
-                                                               (_datapoint_ptrs[best_conj_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
-                                                                          _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]);
-
-					assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
-                                        double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
-                                                                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
-
-                                        best_info_gain_for_attribute -= threshCost;
-					if (best_conj_intrinsic_value_for_given_attribute > 0.0)
-					{
-						conj_non_zero_intrinsic_value_possible = true;
-	                                        double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_conj_intrinsic_value_for_given_attribute;
-
-                                        	if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio) || \
-        	                                    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio && \
-                	                              std::abs(_datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_conj_int_threshold)))
-                        	                {
-                                	                // if this is the first attribute for which a split is possible then
-                                        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
-                                                	conj_int_split_possible = true;
-	                                                best_conj_int_gain_ratio = best_gain_ratio_for_given_attribute;
-        	                                        best_conj_int_attribute = attribute;
-                	                                best_conj_int_threshold = _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute];
-                        	                }
 					}
 					else
 					{
 						if (! conj_non_zero_intrinsic_value_possible)
 						{
-		                                        double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute;
-
-               	                         		if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio_4_zero_iv) || \
-	        	                                    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio_4_zero_iv && \
-        	        	                              std::abs(_datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_conj_int_threshold_4_zero_iv)))
-                	        	                {
-                        	        	                // if this is the first attribute for which a split is possible then
-                                	        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
-                                        	        	conj_int_split_possible = true;
-	                                        	        best_conj_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
-        	                                        	best_conj_int_attribute_4_zero_iv = attribute;
-	                	                                best_conj_int_threshold_4_zero_iv = _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute];
-        	                	                }
-							
+							double best_gain_ratio_for_given_attribute = conj_candidate.info_gain;
+
+							if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio_4_zero_iv) || \
+							    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio_4_zero_iv && std::abs(conj_candidate.threshold) < std::abs(best_conj_int_threshold_4_zero_iv)))
+							{
+								// if this is the first attribute for which a split is possible then
+								// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+								conj_int_split_possible = true;
+								best_conj_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
+								best_conj_int_attribute_4_zero_iv = attribute;
+								best_conj_int_threshold_4_zero_iv = conj_candidate.threshold;
+							}
 						}
 					}
-                                }
+				}
 
 
-                                if (int_split_possible_for_given_attribute)
-                                {
-                                        // We have found the best split threshold for the given attribute
-                                        // Now compute the information gain to optimize across different attributes
-                                        double best_info_gain_for_attribute;
-					best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - best_int_entropy_for_given_attribute;
-                                        
-					double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
-                                                               (_datapoint_ptrs[best_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
-                                                                          _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]);
-
-					assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
-                                        double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
-                                                                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
-
-                                        best_info_gain_for_attribute -= threshCost;
-					if (best_intrinsic_value_for_given_attribute > 0.0)
+				const auto & candidate = candidates[attribute];
+				if (candidate.split_possible)
+				{
+					if (candidate.intrinsic_value > 0.0)
 					{
 						non_zero_intrinsic_value_possible = true;
-						double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_intrinsic_value_for_given_attribute;
-
-	                                        if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio) || \
-        	                                    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && \
-                	                              std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold)))
-                        	                {
-                                	                // if this is the first attribute for which a split is possible then
-                                        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
-                                                	int_split_possible = true;
-	                                                best_int_gain_ratio = best_gain_ratio_for_given_attribute;
-        	                                        best_int_attribute = attribute;
-                	                                best_int_threshold = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
-                        	                }
+						double best_gain_ratio_for_given_attribute = candidate.info_gain / candidate.intrinsic_value;
+
+						if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio) || \
+						    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && std::abs(candidate.threshold) < std::abs(best_int_threshold)))
+						{
+							// if this is the first attribute for which a split is possible then
+							// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+							int_split_possible = true;
+							best_int_gain_ratio = best_gain_ratio_for_given_attribute;
+							best_int_attribute = attribute;
+							best_int_threshold = candidate.threshold;
+						}
 					}
 					else
 					{
 						if (! non_zero_intrinsic_value_possible)
 						{
-							double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute;
-								
-                                        		if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio_4_zero_iv) || \
-		                                          (best_gain_ratio_for_given_attribute == best_int_gain_ratio_4_zero_iv && \
-                		                          std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold_4_zero_iv)))
-                                        		{
-		                                                // if this is the first attribute for which a split is possible then
-                		                                // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
-                                		                int_split_possible = true;
-                                                		best_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
-		                                                best_int_attribute_4_zero_iv = attribute;
-                		                                best_int_threshold_4_zero_iv = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
-                                		        }
+							double best_gain_ratio_for_given_attribute = candidate.info_gain;
+
+							if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio_4_zero_iv) || \
+							    (best_gain_ratio_for_given_attribute == best_int_gain_ratio_4_zero_iv && std::abs(candidate.threshold) < std::abs(best_int_threshold_4_zero_iv)))
+							{
+								// if this is the first attribute for which a split is possible then
+								// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+								int_split_possible = true;
+								best_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
+								best_int_attribute_4_zero_iv = attribute;
+								best_int_threshold_4_zero_iv = candidate.threshold;
+							}
 						}
 					}
-                                }
+				}
 
 			
 			}
@@ -1924,7 +3116,7 @@ namespace horn_verification
 						best_conj_int_attribute = best_conj_int_attribute_4_zero_iv;
 						best_conj_int_threshold = best_conj_int_threshold_4_zero_iv;
 					}
-					return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_conj_int_attribute, best_conj_int_threshold) };
+					return node_job::int_split(sl, best_conj_int_attribute, best_conj_int_threshold);
 				}
 				else
 				{
@@ -1934,14 +3126,14 @@ namespace horn_verification
 						best_int_attribute = best_int_attribute_4_zero_iv;
 						best_int_threshold = best_int_threshold_4_zero_iv;
 					}
-					return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+					return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 				}
 			}
 			
 			else if (!int_split_possible && cat_split_possible)
 			{
 				assert (!conj_int_split_possible);
-				return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+				return node_job::categorical_split(sl, best_cat_attribute);
 			}
 			
 			else
@@ -1973,11 +3165,11 @@ namespace horn_verification
 				}
 				if (best_int_gain_ratio <= best_cat_gain_ratio)
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<int_split_job>(sl, best_int_attribute, best_int_threshold) };
+					return node_job::int_split(sl, best_int_attribute, best_int_threshold);
 				}
 				else
 				{
-					return std::unique_ptr<abstract_job> { std::make_unique<categorical_split_job>(sl, best_cat_attribute) };
+					return node_job::categorical_split(sl, best_cat_attribute);
 				}
 
 			}
@@ -1985,64 +3177,231 @@ namespace horn_verification
 		}
 		
 
-	void penalty(const slice & sl, std::size_t left_index, std::size_t cur_index, std::size_t right_index, int* left2right, int* right2left)
-	{
-		int _left2right = 0;
-		int _right2left = 0;
-		for (const auto & horn_clause : _horn_constraints)
-                {
-			enum Position {out_of_scope, left, right};
-			Position conclusion = out_of_scope;
-			int num_premise_left = 0;
-			int num_premise_right = 0;
+		/**
+		 * Indexes the horn constraints by the data points occurring in them (unless this has been
+		 * done before). The data points and horn constraints do not change while learning.
+		 */
+		void index_horn_constraints()
+		{
+			if (_are_horn_constraints_indexed)
+			{
+				return;
+			}
 
-			// for i ranging from left_index to cur, loop over premises and conclusion
-                        for (std::size_t i = left_index; i <= cur_index; ++i)
-                        {
-				for (const auto dp : horn_clause._premises)
+			for (std::size_t i = 0; i < _horn_constraints.size(); ++i)
+			{
+				for (const auto dp : _horn_constraints[i]._premises)
 				{
-					if (dp == _datapoint_ptrs[i] && !_datapoint_ptrs[i]->_is_classified)
-					{
-						num_premise_left++;	
-					}
+					_constraints_with_premise[dp].push_back(i);
 				}
-				if (_datapoint_ptrs[i] == horn_clause._conclusion && !_datapoint_ptrs[i]->_is_classified)
+				if (_horn_constraints[i]._conclusion)
+				{
+					_constraints_with_conclusion[_horn_constraints[i]._conclusion].push_back(i);
+				}
+			}
+			_scope_indexes.assign(_horn_constraints.size(), -1);
+			_are_horn_constraints_indexed = true;
+		}
+
+
+		/**
+		 * Indexes the horn constraints by the rows of the columnar copy of the presorted data points
+		 * (unless the data points are not presorted yet or this has been done before), so that the
+		 * penalty of a split can be computed from the presorted lists without looking up data points.
+		 */
+		void index_horn_constraints_by_row()
+		{
+			if (_presorted_points.empty() || !_row_premise_offsets.empty())
+			{
+				return;
+			}
+
+			auto index_rows = [this](const std::unordered_map<datapoint<bool> *, std::vector<std::size_t>> & constraints_with, std::vector<std::size_t> & offsets, std::vector<std::size_t> & constraints)
+			{
+				offsets.assign(1, 0);
+				constraints.clear();
+				for (const auto dp : _presorted_points)
 				{
-					conclusion = left;
+					auto it = constraints_with.find(dp);
+					if (it != constraints_with.end())
+					{
+						constraints.insert(constraints.end(), it->second.begin(), it->second.end());
+					}
+					offsets.push_back(constraints.size());
 				}
+			};
+			index_rows(_constraints_with_premise, _row_premise_offsets, _row_premise_constraints);
+			index_rows(_constraints_with_conclusion, _row_conclusion_offsets, _row_conclusion_constraints);
+		}
+
+
+		/**
+		 * Determines the horn constraints that contribute to the penalty of splits of a slice, namely
+		 * those whose conclusion is an unclassified data point of the slice, and counts the
+		 * occurrences of unclassified data points of the slice among their premises.
+		 *
+		 * @param sl The slice to be split
+		 */
+		void prepare_penalty(const slice & sl)
+		{
+			index_horn_constraints();
+
+			for (const auto i : _constraints_in_scope)
+			{
+				_scope_indexes[i] = -1;
 			}
+			_constraints_in_scope.clear();
 
-			// for i ranging from cur+1 to right_index, loop over premises and conclusion
-                        for (std::size_t i = cur_index+1; i <= right_index; ++i)
-                        {
-				for (const auto dp : horn_clause._premises)
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				if (! _datapoint_ptrs[i]->_is_classified)
 				{
-					if (dp == _datapoint_ptrs[i] && !_datapoint_ptrs[i]->_is_classified)
+					auto it = _constraints_with_conclusion.find(_datapoint_ptrs[i]);
+					if (it != _constraints_with_conclusion.end())
 					{
-						num_premise_right++;	
+						for (const auto constraint : it->second)
+						{
+							_scope_indexes[constraint] = _constraints_in_scope.size();
+							_constraints_in_scope.push_back(constraint);
+						}
 					}
 				}
-				if (_datapoint_ptrs[i] == horn_clause._conclusion && !_datapoint_ptrs[i]->_is_classified)
+			}
+
+			_num_premises_in_slice.assign(_constraints_in_scope.size(), 0);
+			for (std::size_t i = sl._left_index; i <= sl._right_index; ++i)
+			{
+				if (! _datapoint_ptrs[i]->_is_classified)
 				{
-					conclusion = right;
+					auto it = _constraints_with_premise.find(_datapoint_ptrs[i]);
+					if (it != _constraints_with_premise.end())
+					{
+						for (const auto constraint : it->second)
+						{
+							if (_scope_indexes[constraint] >= 0)
+							{
+								_num_premises_in_slice[_scope_indexes[constraint]]++;
+							}
+						}
+					}
 				}
 			}
-			if (conclusion == left)
+		}
+
+
+		/**
+		 * Starts a sweep over the thresholds of an attribute, i.e., all data points of the slice are
+		 * right of the threshold and no implication of a horn constraint is cut.
+		 *
+		 * @param sweep The state of the sweep
+		 */
+		void start_penalty_sweep(penalty_sweep & sweep) const
+		{
+			sweep.conclusion_positions.assign(_constraints_in_scope.size(), RIGHT);
+			sweep.num_premises_left.assign(_constraints_in_scope.size(), 0);
+			sweep.left2right = 0;
+			sweep.right2left = 0;
+		}
+
+
+		/**
+		 * Moves a data point from the right to the left part of a split and updates the number of
+		 * implications in the horn constraints that are cut by the split. The implications counted
+		 * are those from an unclassified premise to the unclassified conclusion of a horn constraint
+		 * (once for every occurrence of the premise).
+		 *
+		 * @param sweep The state of the sweep
+		 * @param dp The data point to move
+		 */
+		void move_penalty_point(penalty_sweep & sweep, datapoint<bool> * dp) const
+		{
+			if (dp->_is_classified)
+			{
+				return;
+			}
+
+			auto premise_it = _constraints_with_premise.find(dp);
+			if (premise_it != _constraints_with_premise.end())
+			{
+				move_penalty_premises(sweep, premise_it->second.data(), premise_it->second.data() + premise_it->second.size());
+			}
+
+			auto conclusion_it = _constraints_with_conclusion.find(dp);
+			if (conclusion_it != _constraints_with_conclusion.end())
 			{
-				_right2left += num_premise_right;
+				move_penalty_conclusions(sweep, conclusion_it->second.data(), conclusion_it->second.data() + conclusion_it->second.size());
 			}
-			if (conclusion == right)
+		}
+
+
+		/**
+		 * Moves the data point of an entry of a presorted list from the right to the left part of a
+		 * split (see above), reading its label and horn constraints by its row.
+		 *
+		 * @param sweep The state of the sweep
+		 * @param entry The entry of the data point to move
+		 */
+		void move_penalty_point(penalty_sweep & sweep, const presorted_entry & entry) const
+		{
+			const auto row = row_of(entry);
+			if (_columns.is_classified(row))
 			{
-				_left2right += num_premise_left;
+				return;
 			}
 
+			move_penalty_premises(sweep, _row_premise_constraints.data() + _row_premise_offsets[row], _row_premise_constraints.data() + _row_premise_offsets[row + 1]);
+			move_penalty_conclusions(sweep, _row_conclusion_constraints.data() + _row_conclusion_offsets[row], _row_conclusion_constraints.data() + _row_conclusion_offsets[row + 1]);
+		}
+
+
+		/**
+		 * Updates a sweep for an unclassified data point that moves to the left part of a split, as
+		 * far as the horn constraints are concerned in which it occurs as a premise.
+		 *
+		 * @param sweep The state of the sweep
+		 * @param begin The first of these horn constraints
+		 * @param end The end of these horn constraints
+		 */
+		void move_penalty_premises(penalty_sweep & sweep, const std::size_t * begin, const std::size_t * end) const
+		{
+			for (auto constraint = begin; constraint != end; ++constraint)
+			{
+				const auto index = _scope_indexes[*constraint];
+				if (index < 0)
+				{
+					continue;
+				}
+				if (sweep.conclusion_positions[index] == RIGHT)
+				{
+					sweep.left2right++;
+				}
+				else
+				{
+					sweep.right2left--;
+				}
+				sweep.num_premises_left[index]++;
+			}
 		}
-		*right2left = _right2left;
-		*left2right = _left2right;
-		return;
-	}
 
 
+		/**
+		 * Updates a sweep for an unclassified data point that moves to the left part of a split, as
+		 * far as the horn constraints are concerned of which it is the conclusion.
+		 *
+		 * @param sweep The state of the sweep
+		 * @param begin The first of these horn constraints
+		 * @param end The end of these horn constraints
+		 */
+		void move_penalty_conclusions(penalty_sweep & sweep, const std::size_t * begin, const std::size_t * end) const
+		{
+			for (auto constraint = begin; constraint != end; ++constraint)
+			{
+				const auto index = _scope_indexes[*constraint];
+				sweep.conclusion_positions[index] = LEFT;
+				sweep.left2right -= sweep.num_premises_left[index];
+				sweep.right2left += _num_premises_in_slice[index] - sweep.num_premises_left[index];
+			}
+		}
 
 
 	};
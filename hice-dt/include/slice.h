@@ -25,6 +25,11 @@ namespace horn_verification
 	 * a memory address at which a node of the decision tree corresponding
 	 * to the set of data points needs to be created.
 	 *
+	 * When a decision tree is relearned incrementally, a slice can also carry
+	 * a pointer to the node of a previously learned tree that corresponds to
+	 * the same position in the tree. The job manager uses this node as a hint
+	 * to rebuild the previous tree wherever it is still consistent.
+	 *
 	 * @author Daniel Neider
 	 *
 	 * @version 1.0
@@ -41,6 +46,9 @@ namespace horn_verification
 		/// The address at which to create a new node
 		base_node ** _node_ptr;
 		
+		/// The corresponding node of a previously learned tree (or \c nullptr if none exists)
+		base_node * _previous_node;
+		
 		
 		/**
 		 * Creates a new slice.
@@ -48,9 +56,10 @@ namespace horn_verification
 		 * @param left_index The left bound of the range of data points
 		 * @param right_index The right bound of the range of data points
 		 * @param node_ptr The address at which to create a new node
+		 * @param previous_node The corresponding node of a previously learned tree (or \c nullptr if none exists)
 		 */
-		slice(std::size_t left_index, std::size_t right_index, base_node ** node_ptr)
-			: _left_index(left_index), _right_index(right_index), _node_ptr(node_ptr)
+		slice(std::size_t left_index, std::size_t right_index, base_node ** node_ptr, base_node * previous_node = nullptr)
+			: _left_index(left_index), _right_index(right_index), _node_ptr(node_ptr), _previous_node(previous_node)
 		{
 			// Nothing
 		}
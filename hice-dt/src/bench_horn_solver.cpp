@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Micro-benchmark comparing horn_solver and incremental_horn_solver on a recorded sample (file_stem.attributes,
+ * file_stem.data and file_stem.horn; by default fixtures/nested_branches, a sample of 1761 datapoints and 1413 Horn
+ * constraints recorded by chc_verifier on benchmarks/sequentialPrograms/08.c.smt2). It replays the calls the learner makes when checking whether slices can be
+ * turned into leaves: random slices of unclassified datapoints are tentatively labeled positive and negative, and
+ * the result of a successful call is applied to the datapoints from time to time (as when creating a leaf).
+ * Both solvers are asked the same questions, and the benchmark fails if their answers differ.
+ */
+
+// C++ includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Project includes
+#include "boogie_io.h"
+#include "horn_solver.h"
+#include "incremental_horn_solver.h"
+
+using namespace horn_verification;
+
+int main(int argc, char* argv[]){
+
+	std::string file_stem = argc > 1 ? argv[1] : "fixtures/nested_branches";
+	unsigned number_of_calls = argc > 2 ? std::atoi(argv[2]) : 2000;
+	unsigned seed = argc > 3 ? std::atoi(argv[3]) : 0;
+
+	auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+	auto datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+	auto horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+	auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints);
+	std::vector<datapoint<bool> *> datapoint_ptrs;
+	for (auto & dp : datapoints) {
+		datapoint_ptrs.push_back(&dp);
+	}
+
+	horn_solver<bool> old_solver;
+	incremental_horn_solver<bool> new_solver;
+	std::chrono::duration<double> old_time(0);
+	std::chrono::duration<double> new_time(0);
+	unsigned mismatches = 0;
+	unsigned satisfiable_calls = 0;
+	std::mt19937 generator(seed);
+
+	/* Compare both solvers on one call, and return the result of the call */
+	auto compare = [&](const std::unordered_set<datapoint<bool> *> & positive, const std::unordered_set<datapoint<bool> *> & negative, std::unordered_set<datapoint<bool> *> & result_positive, std::unordered_set<datapoint<bool> *> & result_negative) {
+		auto old_positive = positive;
+		auto old_negative = negative;
+		auto start = std::chrono::steady_clock::now();
+		bool old_result = old_solver.solve(datapoint_ptrs, horn_constraints, old_positive, old_negative);
+		old_time += std::chrono::steady_clock::now() - start;
+
+		result_positive = positive;
+		result_negative = negative;
+		start = std::chrono::steady_clock::now();
+		bool new_result = new_solver.solve(datapoint_ptrs, horn_constraints, result_positive, result_negative);
+		new_time += std::chrono::steady_clock::now() - start;
+
+		if (old_result != new_result || (old_result && (old_positive != result_positive || old_negative != result_negative))) {
+			mismatches++;
+		}
+		return new_result;
+	};
+
+	/* Initial run, whose result is applied to the datapoints */
+	std::unordered_set<datapoint<bool> *> positive, negative;
+	if (!compare(std::unordered_set<datapoint<bool> *>(), std::unordered_set<datapoint<bool> *>(), positive, negative)) {
+		std::cout << "Horn constraints are contradictory" << std::endl;
+		return EXIT_FAILURE;
+	}
+	for (auto dp : positive) {
+		dp->set_classification(true);
+	}
+	for (auto dp : negative) {
+		dp->set_classification(false);
+	}
+
+	/* Tentative labelings of slices */
+	for (unsigned call = 0; call < number_of_calls; call++) {
+		std::vector<datapoint<bool> *> unclassified;
+		for (auto dp : datapoint_ptrs) {
+			if (!dp->_is_classified) {
+				unclassified.push_back(dp);
+			}
+		}
+		if (unclassified.empty()) {
+			break;
+		}
+		std::shuffle(unclassified.begin(), unclassified.end(), generator);
+		unclassified.resize(1 + generator() % std::min<std::size_t>(unclassified.size(), 16));
+
+		for (bool label : {true, false}) {
+			std::unordered_set<datapoint<bool> *> slice(unclassified.begin(), unclassified.end());
+			std::unordered_set<datapoint<bool> *> empty;
+			std::unordered_set<datapoint<bool> *> result_positive, result_negative;
+			bool ok = label ? compare(slice, empty, result_positive, result_negative) : compare(empty, slice, result_positive, result_negative);
+			if (ok) {
+				satisfiable_calls++;
+				if (generator() % 8 == 0) {  /* create leaf */
+					for (auto dp : result_positive) {
+						dp->set_classification(true);
+					}
+					for (auto dp : result_negative) {
+						dp->set_classification(false);
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	std::cout << "Calls: " << old_solver.invocation_count << " (" << satisfiable_calls << " satisfiable)" << std::endl;
+	std::cout << "horn_solver: " << old_time.count() << " s" << std::endl;
+	std::cout << "incremental_horn_solver: " << new_time.count() << " s" << std::endl;
+	std::cout << "Speed-up: " << old_time.count() / new_time.count() << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
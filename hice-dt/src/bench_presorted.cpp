@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Benchmark comparing the learner with and without presorted data points (see simple_job_manager::set_presorted) on a
+ * recorded sample (file_stem.attributes, file_stem.data and file_stem.horn, as written by Boogie for hice-dt). The learner
+ * is run with the configuration of hice-dt on a fresh copy of the sample in both modes, and the benchmark fails if the
+ * learned decision trees differ. It also reports the memory per data point of the sample as data points and as a columnar
+ * sample (which the learner uses in presorted mode).
+ */
+
+// C++ includes
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Project includes
+#include "boogie_io.h"
+#include "columnar_sample.h"
+#include "error.h"
+#include "incremental_horn_solver.h"
+#include "json_visitor.h"
+#include "learner.h"
+#include "simple_job_manager.h"
+
+using namespace horn_verification;
+
+/* Learn a decision tree for a copy of the sample and return its JSON representation together with the time of the learner */
+std::string learn(const attributes_metadata & metadata, std::vector<datapoint<bool> > datapoints, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned> > > & horn_indexes, bool presorted, std::chrono::duration<double> & time) {
+	auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints);
+	std::vector<datapoint<bool> *> datapoint_ptrs;
+	for (auto & dp : datapoints) {
+		datapoint_ptrs.push_back(&dp);
+	}
+
+	incremental_horn_solver<bool> solver;
+	std::unordered_set<datapoint<bool> *> positive_ptrs, negative_ptrs;
+	if (!solver.solve(datapoint_ptrs, horn_constraints, positive_ptrs, negative_ptrs)) {
+		throw sample_error("No consistent decision tree exists (Horn clauses are contradictory)");
+	}
+	for (auto dp : positive_ptrs) {
+		dp->set_classification(true);
+	}
+	for (auto dp : negative_ptrs) {
+		dp->set_classification(false);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	complex_job_manager manager(datapoint_ptrs, horn_constraints, solver, NodeSelection::BFS, EntropyComputation::PENALTY, ConjunctiveSetting::NOPREFERENCEFORCONJUNCTS);
+	manager.set_presorted(presorted);
+	learner<complex_job_manager> l(manager);
+	auto tree = l.learn(metadata, datapoint_ptrs, horn_constraints);
+	time += std::chrono::steady_clock::now() - start;
+
+	std::ostringstream out;
+	json_visitor visitor(metadata, out);
+	tree.accept(visitor);
+	return out.str();
+}
+
+int main(int argc, char* argv[]){
+
+	if (argc < 2) {
+		std::cout << "Usage: " << argv[0] << " file_stem [number_of_runs]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::string file_stem = argv[1];
+	unsigned number_of_runs = argc > 2 ? std::atoi(argv[2]) : 5;
+
+	auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+	auto datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+	auto horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+
+	std::chrono::duration<double> sorting_time(0);
+	std::chrono::duration<double> presorted_time(0);
+	unsigned mismatches = 0;
+	try {
+		for (unsigned run = 0; run < number_of_runs; run++) {
+			if (learn(metadata, datapoints, horn_indexes, false, sorting_time) != learn(metadata, datapoints, horn_indexes, true, presorted_time)) {
+				mismatches++;
+			}
+		}
+	} catch (const std::exception & ex) {
+		std::cout << "Error: " << ex.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<datapoint<bool> *> datapoint_ptrs;
+	std::size_t datapoint_bytes = 0;
+	for (auto & dp : datapoints) {
+		datapoint_ptrs.push_back(&dp);
+		datapoint_bytes += columnar_sample::bytes_of(dp);
+	}
+
+	std::cout << "Data points: " << datapoints.size() << " (" << metadata.int_names().size() << " integer attributes)" << std::endl;
+	std::cout << "Bytes per data point: " << static_cast<double>(datapoint_bytes) / datapoints.size() << " (data points), " << columnar_sample(datapoint_ptrs).bytes_per_point() << " (columnar)" << std::endl;
+	std::cout << "Sorting at every split: " << sorting_time.count() / number_of_runs << " s" << std::endl;
+	std::cout << "Presorted: " << presorted_time.count() / number_of_runs << " s" << std::endl;
+	std::cout << "Speed-up: " << sorting_time.count() / presorted_time.count() << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
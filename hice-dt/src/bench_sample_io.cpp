@@ -0,0 +1,163 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Benchmark comparing the time to load a sample from the text files (file_stem.data and file_stem.horn) and from the
+ * binary sample files (file_stem.data.bin and file_stem.horn.bin, see binary_sample.h). For 10^4, 10^5 and 10^6 data points
+ * (up to the given maximum), a random sample with one categorical and ten integer attributes and a Horn constraint for every
+ * fourth data point is written in both formats, which are then loaded. The benchmark also measures how long a reader that
+ * is kept across rounds takes to read one percent of new data points. It fails if the loaded samples differ.
+ */
+
+// C++ includes
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project includes
+#include "binary_sample.h"
+#include "boogie_io.h"
+
+using namespace horn_verification;
+
+typedef std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_indexes_t;
+
+/* Create a random sample */
+void create_sample(std::size_t number_of_datapoints, std::size_t number_of_categories, std::size_t number_of_ints, std::vector<datapoint<bool>> & datapoints, horn_indexes_t & horn_indexes) {
+	std::mt19937 gen(number_of_datapoints);
+	std::uniform_int_distribution<int> value(-1000, 1000);
+	std::uniform_int_distribution<unsigned> label(0, 2);
+
+	datapoints.clear();
+	for (std::size_t i = 0; i < number_of_datapoints; ++i) {
+		auto l = label(gen);
+		datapoint<bool> dp(l == 1, l != 0);
+		dp._identifier = i;
+		dp._categorical_data.push_back(i % number_of_categories);
+		for (std::size_t j = 0; j < number_of_ints; ++j) {
+			dp._int_data.push_back(value(gen));
+		}
+		datapoints.push_back(std::move(dp));
+	}
+
+	horn_indexes.clear();
+	std::uniform_int_distribution<unsigned> index(0, number_of_datapoints - 1);
+	for (std::size_t i = 0; i < number_of_datapoints / 4; ++i) {
+		std::set<unsigned> premises { index(gen), index(gen) };
+		std::set<unsigned> consequence;
+		if (i % 3 != 0) {
+			consequence.insert(index(gen));
+		}
+		horn_indexes.push_back(std::make_pair(std::move(premises), std::move(consequence)));
+	}
+}
+
+/* Write a sample to the text files read by hice-dt */
+void write_text_sample(const std::string & file_stem, std::size_t number_of_categories, std::size_t number_of_ints, const std::vector<datapoint<bool>> & datapoints, const horn_indexes_t & horn_indexes) {
+	std::ofstream attributes(file_stem + ".attributes");
+	attributes << "cat,$func," << number_of_categories << "\n";
+	for (std::size_t j = 0; j < number_of_ints; ++j) {
+		attributes << "int,x" << j << "\n";
+	}
+
+	std::ofstream data(file_stem + ".data");
+	for (const auto & dp : datapoints) {
+		data << dp._categorical_data[0];
+		for (auto v : dp._int_data) {
+			data << "," << v;
+		}
+		data << "," << (!dp._is_classified ? "?" : (dp._classification ? "true" : "false")) << "\n";
+	}
+
+	std::ofstream horn(file_stem + ".horn");
+	for (const auto & h : horn_indexes) {
+		for (auto i : h.first) {
+			horn << i << ",";
+		}
+		horn << (h.second.empty() ? std::string("_") : std::to_string(*h.second.begin())) << "\n";
+	}
+}
+
+/* Check whether two samples are equal */
+bool equal(const std::vector<datapoint<bool>> & d1, const horn_indexes_t & h1, const std::vector<datapoint<bool>> & d2, const horn_indexes_t & h2) {
+	if (d1.size() != d2.size() || h1 != h2) {
+		return false;
+	}
+	for (std::size_t i = 0; i < d1.size(); ++i) {
+		if (d1[i]._categorical_data != d2[i]._categorical_data || d1[i]._int_data != d2[i]._int_data || d1[i]._is_classified != d2[i]._is_classified || (d1[i]._is_classified && d1[i]._classification != d2[i]._classification) || d1[i]._identifier != d2[i]._identifier) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]){
+
+	std::string file_stem = argc > 1 ? argv[1] : "bench_sample_io";
+	std::size_t max_datapoints = argc > 2 ? std::atol(argv[2]) : 1000000;
+	const std::size_t number_of_categories = 8;
+	const std::size_t number_of_ints = 10;
+
+	bool ok = true;
+	for (std::size_t n = 10000; n <= max_datapoints; n *= 10) {
+
+		// Create sample, the sample with one percent new data points, and write both formats
+		std::vector<datapoint<bool>> datapoints, grown_datapoints;
+		horn_indexes_t horn_indexes, grown_horn_indexes;
+		create_sample(n, number_of_categories, number_of_ints, datapoints, horn_indexes);
+		create_sample(n + n / 100, number_of_categories, number_of_ints, grown_datapoints, grown_horn_indexes);
+		grown_datapoints.erase(grown_datapoints.begin(), grown_datapoints.begin() + n);
+		for (auto & dp : grown_datapoints) {
+			datapoints.push_back(dp);
+		}
+		grown_datapoints.assign(datapoints.begin(), datapoints.end());
+		datapoints.resize(n);
+
+		write_text_sample(file_stem, number_of_categories, number_of_ints, datapoints, horn_indexes);
+		boogie_io::write_binary_data_file(file_stem + ".data.bin", datapoints, boogie_io::read_attributes_file(file_stem + ".attributes"));
+		boogie_io::write_binary_horn_file(file_stem + ".horn.bin", horn_indexes);
+
+		// Load text files
+		auto start = std::chrono::steady_clock::now();
+		auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+		auto text_datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+		auto text_horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+		std::chrono::duration<double> text_time = std::chrono::steady_clock::now() - start;
+
+		// Load binary files
+		start = std::chrono::steady_clock::now();
+		std::vector<datapoint<bool>> binary_datapoints;
+		horn_indexes_t binary_horn_indexes;
+		binary_sample_reader reader(file_stem + ".data.bin", file_stem + ".horn.bin", metadata);
+		reader.read_datapoints(binary_datapoints);
+		reader.read_horn_constraints(binary_horn_indexes);
+		std::chrono::duration<double> binary_time = std::chrono::steady_clock::now() - start;
+
+		// Append one percent new data points and read them with the same reader
+		boogie_io::write_binary_data_file(file_stem + ".data.bin", grown_datapoints, metadata);
+		start = std::chrono::steady_clock::now();
+		reader.read_datapoints(binary_datapoints);
+		reader.read_horn_constraints(binary_horn_indexes);
+		std::chrono::duration<double> update_time = std::chrono::steady_clock::now() - start;
+
+		bool same = equal(text_datapoints, text_horn_indexes, std::vector<datapoint<bool>>(binary_datapoints.begin(), binary_datapoints.begin() + n), binary_horn_indexes) && equal(grown_datapoints, horn_indexes, binary_datapoints, binary_horn_indexes);
+		ok = ok && same;
+
+		std::cout << n << " data points: text " << text_time.count() * 1000 << " ms, binary " << binary_time.count() * 1000 << " ms (speed-up " << text_time.count() / binary_time.count() << "), ";
+		std::cout << "reading " << n / 100 << " new data points " << update_time.count() * 1000 << " ms" << (same ? "" : " MISMATCH") << std::endl;
+
+	}
+
+	for (auto suffix : { ".attributes", ".data", ".horn", ".data.bin", ".horn.bin" }) {
+		std::remove((file_stem + suffix).c_str());
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
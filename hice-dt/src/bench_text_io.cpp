@@ -0,0 +1,188 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Benchmark comparing the text readers of boogie_io (read_data_file and read_horn_file), which parse the mapped file in
+ * place, with a reference reader that uses std::getline, boogie_io::split and a string stream per field (as the readers
+ * did before). A random data file with the given number of data points (default 10^6), one categorical and ten integer
+ * attributes and a Horn file with a Horn constraint for every fourth data point are written and read by both readers.
+ * The benchmark fails if the results differ.
+ */
+
+// C++ includes
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project includes
+#include "boogie_io.h"
+
+using namespace horn_verification;
+
+typedef std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_indexes_t;
+
+/* Split a line like boogie_io::split */
+std::vector<std::string> split(const std::string & str, char delim) {
+	std::vector<std::string> splitted;
+	std::stringstream ss(str);
+	std::string item;
+	while (std::getline(ss, item, delim)) {
+		splitted.push_back(std::move(item));
+	}
+	return splitted;
+}
+
+/* Reference reader for data files (without error checks) */
+std::vector<datapoint<bool>> reference_read_data_file(const std::string & filename, const attributes_metadata & metadata) {
+	std::ifstream infile(filename);
+	std::vector<datapoint<bool>> datapoints;
+	std::string line;
+	while (std::getline(infile, line)) {
+		if (line.empty() || line.compare(0, 1, "#") == 0) {
+			continue;
+		}
+		auto split_line = split(line, ',');
+		const auto & last = split_line.back();
+		datapoint<bool> dp(last == "true", last != "?");
+		std::stringstream ss;
+		auto it = split_line.begin();
+		for (std::size_t i = 0; i < metadata.categorical_names().size(); ++i, ++it) {
+			ss.str(*it);
+			ss.clear();
+			unsigned int value;
+			ss >> value;
+			dp._categorical_data.push_back(value);
+		}
+		for (std::size_t i = 0; i < metadata.int_names().size(); ++i, ++it) {
+			ss.str(*it);
+			ss.clear();
+			int value;
+			ss >> value;
+			dp._int_data.push_back(value);
+		}
+		dp._identifier = datapoints.size();
+		datapoints.push_back(std::move(dp));
+	}
+	return datapoints;
+}
+
+/* Reference reader for Horn files (without error checks) */
+horn_indexes_t reference_read_horn_file(const std::string & filename) {
+	std::ifstream infile(filename);
+	horn_indexes_t horn_constraints;
+	std::string line;
+	while (std::getline(infile, line)) {
+		if (line.empty() || line.compare(0, 1, "#") == 0) {
+			continue;
+		}
+		auto split_line = split(line, ',');
+		std::set<unsigned> premises, consequence;
+		std::stringstream ss;
+		for (std::size_t i = 0; i < split_line.size() - 1; ++i) {
+			ss.str(split_line[i]);
+			ss.clear();
+			std::size_t index;
+			ss >> index;
+			premises.insert(index);
+		}
+		if (split_line.back() != "_") {
+			ss.str(split_line.back());
+			ss.clear();
+			std::size_t index;
+			ss >> index;
+			consequence.insert(index);
+		}
+		horn_constraints.push_back(std::make_pair(premises, consequence));
+	}
+	return horn_constraints;
+}
+
+/* Write a random sample (with some comments and empty lines) */
+void write_sample(const std::string & file_stem, std::size_t number_of_datapoints, std::size_t number_of_categories, std::size_t number_of_ints) {
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> value(-100000, 100000);
+	std::uniform_int_distribution<unsigned> label(0, 2);
+	std::uniform_int_distribution<unsigned> index(0, number_of_datapoints - 1);
+
+	std::ofstream attributes(file_stem + ".attributes");
+	attributes << "cat,$func," << number_of_categories << "\n";
+	for (std::size_t j = 0; j < number_of_ints; ++j) {
+		attributes << "int,x" << j << "\n";
+	}
+
+	std::ofstream data(file_stem + ".data");
+	data << "# Benchmark data\n";
+	for (std::size_t i = 0; i < number_of_datapoints; ++i) {
+		data << i % number_of_categories;
+		for (std::size_t j = 0; j < number_of_ints; ++j) {
+			data << "," << value(gen);
+		}
+		auto l = label(gen);
+		data << "," << (l == 0 ? "?" : (l == 1 ? "true" : "false")) << "\n";
+		if (i % 1000 == 999) {
+			data << "\n";
+		}
+	}
+
+	std::ofstream horn(file_stem + ".horn");
+	for (std::size_t i = 0; i < number_of_datapoints / 4; ++i) {
+		horn << index(gen) << "," << index(gen) << ",";
+		if (i % 3 == 0) {
+			horn << "_\n";
+		} else {
+			horn << index(gen) << "\n";
+		}
+	}
+}
+
+int main(int argc, char* argv[]){
+
+	std::string file_stem = argc > 1 ? argv[1] : "bench_text_io";
+	std::size_t number_of_datapoints = argc > 2 ? std::atol(argv[2]) : 1000000;
+
+	write_sample(file_stem, number_of_datapoints, 8, 10);
+	auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+
+	// boogie_io (first, such that both readers allocate fresh memory)
+	auto start = std::chrono::steady_clock::now();
+	auto datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+	std::chrono::duration<double> data_time = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	auto horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+	std::chrono::duration<double> horn_time = std::chrono::steady_clock::now() - start;
+
+	// Reference reader
+	start = std::chrono::steady_clock::now();
+	auto reference_datapoints = reference_read_data_file(file_stem + ".data", metadata);
+	std::chrono::duration<double> reference_data_time = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	auto reference_horn_indexes = reference_read_horn_file(file_stem + ".horn");
+	std::chrono::duration<double> reference_horn_time = std::chrono::steady_clock::now() - start;
+
+	// Compare
+	bool same = datapoints.size() == reference_datapoints.size() && horn_indexes == reference_horn_indexes;
+	for (std::size_t i = 0; same && i < datapoints.size(); ++i) {
+		const auto & dp = datapoints[i];
+		const auto & ref = reference_datapoints[i];
+		same = dp._categorical_data == ref._categorical_data && dp._int_data == ref._int_data && dp._is_classified == ref._is_classified && dp._classification == ref._classification && dp._identifier == ref._identifier;
+	}
+
+	std::cout << "Data file (" << datapoints.size() << " data points): reference " << reference_data_time.count() * 1000 << " ms, boogie_io " << data_time.count() * 1000 << " ms (speed-up " << reference_data_time.count() / data_time.count() << ")" << std::endl;
+	std::cout << "Horn file (" << horn_indexes.size() << " constraints): reference " << reference_horn_time.count() * 1000 << " ms, boogie_io " << horn_time.count() * 1000 << " ms (speed-up " << reference_horn_time.count() / horn_time.count() << ")" << std::endl;
+	std::cout << (same ? "Results are identical" : "MISMATCH") << std::endl;
+
+	for (auto suffix : { ".attributes", ".data", ".horn" }) {
+		std::remove((file_stem + suffix).c_str());
+	}
+
+	return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
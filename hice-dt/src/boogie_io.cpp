@@ -3,10 +3,19 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 // C++ includes
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
 #include <utility>
 
 // Project includes
+#include "binary_sample.h"
 #include "boogie_io.h"
 #include "error.h"
 
@@ -168,110 +177,290 @@ namespace horn_verification
 	}
 	
 
-	std::vector<datapoint<bool>> boogie_io::read_data_file(const std::string & filename, const attributes_metadata & metadata)
+	/**
+	 * Splits the line [\p begin, \p end) at commas and stores the beginning and end of each field in
+	 * \p fields, which is cleared first. Like boogie_io::split(), an empty field at the end of the line
+	 * is dropped. No memory is allocated once \p fields has grown large enough.
+	 *
+	 * @param begin The beginning of the line
+	 * @param end The end of the line
+	 * @param fields The vector to store the fields in
+	 */
+	static void split_fields(const char * begin, const char * end, std::vector<std::pair<const char *, const char *>> & fields)
 	{
-	
-		// Open file for read operations
-		std::ifstream infile(filename);
 
-		// Check opening the file failed
-		if (infile.fail())
+		fields.clear();
+
+		auto field_begin = begin;
+		for (auto it = begin; it != end; ++it)
 		{
-			throw boogie_io_error("Error opening " + filename);
+			if (*it == ',')
+			{
+				fields.emplace_back(field_begin, it);
+				field_begin = it + 1;
+			}
+		}
+
+		if (field_begin != end)
+		{
+			fields.emplace_back(field_begin, end);
+		}
+
+	}
+
+
+	/**
+	 * Parses a decimal integer in the closed interval [\p min, \p max] that starts at \p it and
+	 * ends at the next comma or at \p end (whichever comes first), and advances \p it to that
+	 * position. Like reading the field with <code>operator&gt;&gt;</code> of a string stream, leading
+	 * white spaces and a sign are accepted, but no trailing characters.
+	 *
+	 * @param it The beginning of the field (is advanced to its end if the field is a valid integer)
+	 * @param end The end of the line
+	 * @param min The smallest valid value
+	 * @param max The largest valid value
+	 * @param value The parsed value
+	 *
+	 * @return whether the field is a valid integer
+	 */
+	static inline bool parse_integer(const char * & it, const char * end, long long min, long long max, long long & value)
+	{
+
+		while (it != end && (*it == ' ' || (*it >= '\t' && *it <= '\r')))
+		{
+			++it;
+		}
+
+		bool negative = false;
+		if (it != end && (*it == '-' || *it == '+'))
+		{
+			negative = *it == '-';
+			++it;
+		}
+
+		if (it == end || *it == ',')
+		{
+			return false;
+		}
+
+		long long result = 0;
+		for (; it != end && *it != ','; ++it)
+		{
+
+			if (*it < '0' || *it > '9')
+			{
+				return false;
+			}
+
+			result = result * 10 + (*it - '0');
+
+			// Stop early to avoid an overflow (all valid values fit into 32 bit)
+			if (result > (1LL << 32))
+			{
+				return false;
+			}
+
+		}
+
+		value = negative ? -result : result;
+		return value >= min && value <= max;
+
+	}
+
+
+	/**
+	 * Parses a field (which does not contain a comma) as decimal integer in the closed interval
+	 * [\p min, \p max].
+	 *
+	 * @param field The beginning and end of the field
+	 * @param min The smallest valid value
+	 * @param max The largest valid value
+	 * @param value The parsed value
+	 *
+	 * @return whether the field is a valid integer
+	 */
+	static bool parse_integer(const std::pair<const char *, const char *> & field, long long min, long long max, long long & value)
+	{
+		auto it = field.first;
+		return parse_integer(it, field.second, min, max, value);
+	}
+
+
+	/**
+	 * Returns whether a field equals a string literal.
+	 *
+	 * @param field The beginning and end of the field
+	 * @param str The string literal
+	 *
+	 * @return whether the field equals \p str
+	 */
+	template <std::size_t N>
+	static bool field_equals(const std::pair<const char *, const char *> & field, const char (&str)[N])
+	{
+		return static_cast<std::size_t>(field.second - field.first) == N - 1 && std::memcmp(field.first, str, N - 1) == 0;
+	}
+
+
+	/**
+	 * Reads the content of an input stream into a string, stopping at the end of the stream or at
+	 * the first line that equals \p terminator (which is consumed).
+	 *
+	 * @param in The input stream to read from
+	 * @param terminator The line that ends the input (an empty terminator never matches)
+	 *
+	 * @return the content read
+	 */
+	static std::string read_until(std::istream & in, const std::string & terminator)
+	{
+
+		if (terminator.empty())
+		{
+			return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+		std::string content;
+		std::string line;
+		while (std::getline(in, line) && line != terminator)
+		{
+			content += line;
+			content += '\n';
+		}
+
+		return content;
+
+	}
+
+
+	/**
+	 * Throws the error that describes why a line of a data file is not a valid data point. The line
+	 * is checked in the same order as it used to be parsed (number of fields, classification,
+	 * categorical attributes, integer attributes), such that the first problem is reported.
+	 *
+	 * @param begin The beginning of the line
+	 * @param end The end of the line
+	 * @param line_nr The number of the line
+	 * @param filename The name of the input used in error messages
+	 * @param metadata Meta data of the attributes
+	 */
+	static void throw_datapoint_error(const char * begin, const char * end, unsigned int line_nr, const std::string & filename, const attributes_metadata & metadata)
+	{
+
+		std::vector<std::pair<const char *, const char *>> fields;
+		split_fields(begin, end, fields);
+
+		// Check format of line
+		if (fields.size() != metadata.categorical_names().size() + metadata.int_names().size() + 1)
+		{
+			throw boogie_io_error("Invalid format of datapoint in line " + std::to_string(line_nr) + " of " + filename);
+		}
+
+		// Check classification
+		const auto & last = fields.back();
+		if (!field_equals(last, "true") && !field_equals(last, "false") && !field_equals(last, "?"))
+		{
+			throw boogie_io_error("Invalid classification of datapoint in line " + std::to_string(line_nr) + " of " + filename);
+		}
+
+		// Check categorical attributes (negative values are invalid categories rather than parse errors)
+		auto it = fields.begin();
+		long long value;
+		for (std::size_t i = 0; i < metadata.categorical_names().size(); ++i, ++it)
+		{
+
+			if (!parse_integer(*it, -static_cast<long long>(std::numeric_limits<unsigned>::max()), std::numeric_limits<unsigned>::max(), value))
+			{
+				throw boogie_io_error("Unable to parse categorical data in line " + std::to_string(line_nr) + " of " + filename);
+			}
+			else if (value < 0 || static_cast<std::size_t>(value) >= metadata.number_of_categories()[i])
+			{
+				throw boogie_io_error("Invalid category value in line " + std::to_string(line_nr) + " of " + filename);
+			}
+
 		}
+
+		// Check integer attributes (there has to be an error, hence, report the line as invalid if none is found)
+		for (std::size_t i = 0; i < metadata.int_names().size(); ++i, ++it)
+		{
+
+			if (!parse_integer(*it, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), value))
+			{
+				break;
+			}
+
+		}
+
+		throw boogie_io_error("Unable to parse integer data in line " + std::to_string(line_nr) + " of " + filename);
+
+	}
+
+
+	/**
+	 * Parses data points in the format of boogie_io::read_data_file from the characters
+	 * [\p begin, \p end) and appends them to \p datapoints.
+	 *
+	 * The text is parsed in place and in a single pass over every line: apart from the data points
+	 * themselves, no memory is allocated per line. Only if a line is not a valid data point, it is
+	 * split into fields and checked again to report the error (see throw_datapoint_error).
+	 *
+	 * @param begin The beginning of the text
+	 * @param end The end of the text
+	 * @param filename The name of the input used in error messages
+	 * @param metadata Meta data of the attributes
+	 * @param datapoints The vector to which the data points are added
+	 */
+	static void parse_data(const char * begin, const char * end, const std::string & filename, const attributes_metadata & metadata, std::vector<datapoint<bool>> & datapoints)
+	{
 		
+		// Data points are numbered consecutively
+		unsigned number_of_datapoints = datapoints.size();
 		
-		// Some variables
-		std::vector<datapoint<bool>> datapoints;
-		unsigned number_of_datapoints = 0;
+		// Reserve space for one data point per line
+		datapoints.reserve(datapoints.size() + std::count(begin, end, '\n') + 1);
 		
 		
 		//
-		// Read file line by line
+		// Parse text line by line
 		//
-		std::string line;
 		unsigned int line_nr = 0;
-		while (std::getline(infile, line))
+		for (const char * line_begin = begin, * line_end = begin; line_begin != end; line_begin = line_end == end ? end : line_end + 1)
 		{
 			
-			++line_nr;
-			
-			// Skip empty lines and comments
-			if (line.empty() || line.compare(0, 1, "#") == 0)
+			line_end = static_cast<const char *>(std::memchr(line_begin, '\n', end - line_begin));
+			if (line_end == nullptr)
 			{
-				continue;
-			}
-
-			// Split line
-			auto split_line = split(line, ',');
-			
-			// Check format of line
-			if (split_line.size() != metadata.categorical_names().size() + metadata.int_names().size() + 1)
-			{
-				throw boogie_io_error("Invalid format of datapoint in line " + std::to_string(line_nr) + " of " + filename);
+				line_end = end;
 			}
 			
+			++line_nr;
 			
-			//
-			// Get classification
-			//
-			bool is_labeled;
-			bool label;
-			const auto & last = split_line.back();
-			
-			if (last == "true")
-			{
-				is_labeled = true;
-				label = true;
-			}
-			else if (last == "false")
-			{
-				is_labeled = true;
-				label = false;
-			}
-			else if (last == "?")
-			{
-				is_labeled = false;
-				label = false; // Unimportant
-			}
-			else
+			// Skip empty lines and comments
+			if (line_begin == line_end || *line_begin == '#')
 			{
-				throw boogie_io_error("Invalid classification of datapoint in line " + std::to_string(line_nr) + " of " + filename);
+				continue;
 			}
 			
 			
 			//
-			// Parse datapoint
+			// Parse datapoint (every attribute has to be followed by a comma)
 			//
-			datapoint<bool> dp(label, is_labeled);
-			std::stringstream ss;
-			auto it = split_line.begin();
+			datapoint<bool> dp;
+			auto it = line_begin;
+			long long value;
+			bool is_valid = true;
 			
 			
 			// Categorical arguments
 			dp._categorical_data.reserve(metadata.categorical_names().size());
-			for (std::size_t i = 0; i < metadata.categorical_names().size(); ++i)
+			for (std::size_t i = 0; is_valid && i < metadata.categorical_names().size(); ++i)
 			{
 				
-				// Parse categorical data
-				ss.str(*it);
-				ss.clear();
-				unsigned int value;
-				ss >> value;
-				
-				if (ss.fail() || !ss.eof())
-				{
-					throw boogie_io_error("Unable to parse categorical data in line " + std::to_string(line_nr) + " of " + filename);
-				}
-				else if (value >= metadata.number_of_categories()[i])
+				if (!parse_integer(it, line_end, 0, static_cast<long long>(metadata.number_of_categories()[i]) - 1, value) || it == line_end)
 				{
-					throw boogie_io_error("Invalid category value in line " + std::to_string(line_nr) + " of " + filename);
+					is_valid = false;
+					break;
 				}
 				
-				// Add data
 				dp._categorical_data.push_back(value);
-				
-				// Advance iterator
 				++it;
 				
 			}
@@ -279,37 +468,55 @@ namespace horn_verification
 			
 			// Integer attributes
 			dp._int_data.reserve(metadata.int_names().size());
-			for (std::size_t i = 0; i < metadata.int_names().size(); ++i)
+			for (std::size_t i = 0; is_valid && i < metadata.int_names().size(); ++i)
 			{
 				
-				// Parse categorical data
-				ss.str(*it);
-				ss.clear();
-				int value;
-				ss >> value;
-				
-				if (ss.fail() || !ss.eof())
+				if (!parse_integer(it, line_end, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), value) || it == line_end)
 				{
-					throw boogie_io_error("Unable to parse integer data in line " + std::to_string(line_nr) + " of " + filename);
+					is_valid = false;
+					break;
 				}
 				
-				// Add data
 				dp._int_data.push_back(value);
-				
-				// Advance iterator
 				++it;
 				
 			}
 			
 			
-			// Check data point
-			if (dp._categorical_data.size() != metadata.categorical_names().size())
+			//
+			// Get classification (the last field, which may be followed by a comma like every field;
+			// no valid classification contains a comma)
+			//
+			if (is_valid)
 			{
-				throw boogie_io_error("Data point has incorrect number of categorical attributes in line " + std::to_string(line_nr) + " of " + filename);
+				
+				const auto last = std::make_pair(it, *(line_end - 1) == ',' ? line_end - 1 : line_end);
+				
+				if (field_equals(last, "true"))
+				{
+					dp._is_classified = true;
+					dp._classification = true;
+				}
+				else if (field_equals(last, "false"))
+				{
+					dp._is_classified = true;
+					dp._classification = false;
+				}
+				else if (field_equals(last, "?"))
+				{
+					dp._is_classified = false;
+					dp._classification = false; // Unimportant
+				}
+				else
+				{
+					is_valid = false;
+				}
+				
 			}
-			if (dp._int_data.size() != metadata.int_names().size())
+			
+			if (!is_valid)
 			{
-				throw boogie_io_error("Data point has incorrect number of integer attributes in line " + std::to_string(line_nr) + " of " + filename);
+				throw_datapoint_error(line_begin, line_end, line_nr, filename, metadata);
 			}
 		
 		
@@ -319,15 +526,34 @@ namespace horn_verification
 			
 		}
 	
+	}
+	
+	
+	std::vector<datapoint<bool>> boogie_io::read_data_file(const std::string & filename, const attributes_metadata & metadata)
+	{
+	
+		// Map file into memory (or read it into a buffer on Windows; throws if opening the file failed)
+		mapped_file infile(filename);
+		auto begin = reinterpret_cast<const char *>(infile.data());
 		
-		// Close input file
-		infile.close();
+		// Parse data points
+		std::vector<datapoint<bool>> datapoints;
+		parse_data(begin, begin + infile.size(), filename, metadata, datapoints);
 	
 		return datapoints;
 	
 	}
 	
 	
+	void boogie_io::read_data(std::istream & in, const std::string & filename, const attributes_metadata & metadata, std::vector<datapoint<bool>> & datapoints, const std::string & terminator)
+	{
+		
+		auto content = read_until(in, terminator);
+		parse_data(content.data(), content.data() + content.size(), filename, metadata, datapoints);
+		
+	}
+	
+	
 	std::vector<horn_constraint<bool>> boogie_io::indexes2horn_constraints(const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints_as_indexes, std::vector<datapoint<bool>> & datapoints)
 	{
 		
@@ -389,48 +615,52 @@ namespace horn_verification
 	}
 	
 	
-	std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> boogie_io::read_horn_file(const std::string & filename)
+	/**
+	 * Parses Horn constraints in the format of boogie_io::read_horn_file from the characters
+	 * [\p begin, \p end) and appends them (as pairs of sets of indexes) to \p horn_constraints.
+	 *
+	 * @param begin The beginning of the text
+	 * @param end The end of the text
+	 * @param filename The name of the input used in error messages
+	 * @param horn_constraints The vector to which the Horn constraints are added
+	 */
+	static void parse_horn_constraints(const char * begin, const char * end, const std::string & filename, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints)
 	{
 	
-		// Define symbol for empty head
-		auto empty_head = "_";
+		// Fields of the current line (reused for every line)
+		std::vector<std::pair<const char *, const char *>> fields;
 		
-		// Open file for read operations
-		std::ifstream infile(filename);
-
-		// Check opening the file failed
-		if (infile.fail())
-		{
-			throw boogie_io_error("Error opening " + filename);
-		}
+		// Reserve space for one Horn constraint per line
+		horn_constraints.reserve(horn_constraints.size() + std::count(begin, end, '\n') + 1);
 		
 		
-		// Some variables
-		std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_constraints; // Horn constraints as indexes (as occurring in the data file)
-
-		
 		//
-		// Read file line by line
+		// Parse text line by line
 		//
-		std::string line;
 		unsigned int line_nr = 0;
-		while (std::getline(infile, line))
+		for (const char * line_begin = begin, * line_end = begin; line_begin != end; line_begin = line_end == end ? end : line_end + 1)
 		{
 			
+			line_end = static_cast<const char *>(std::memchr(line_begin, '\n', end - line_begin));
+			if (line_end == nullptr)
+			{
+				line_end = end;
+			}
+			
 			++line_nr;
 			
 			// Skip empty lines and comments
-			if (line.empty() || line.compare(0, 1, "#") == 0)
+			if (line_begin == line_end || *line_begin == '#')
 			{
 				continue;
 			}
 		
 		
 			// Split line
-			auto split_line = split(line, ',');
+			split_fields(line_begin, line_end, fields);
 
 			// Check format of line
-			if (split_line.size() < 2)
+			if (fields.size() < 2)
 			{
 				throw boogie_io_error("Invalid format of horn constraint in line " + std::to_string(line_nr) + " of " + filename);
 			}
@@ -438,62 +668,164 @@ namespace horn_verification
 		
 			// Parse premises
 			std::set<unsigned> premises;
-			std::stringstream ss;
-			for (std::size_t i = 0; i < split_line.size() - 1; ++i)
+			long long index;
+			for (std::size_t i = 0; i < fields.size() - 1; ++i)
 			{
 				
-				ss.str(split_line[i]);
-				ss.clear();
-				std::size_t index;
-				ss >> index;
-				
-				if (ss.fail() || !ss.eof())
+				if (!parse_integer(fields[i], 0, std::numeric_limits<unsigned>::max(), index))
 				{
 					throw boogie_io_error("Unable to parse horn constraint in line " + std::to_string(line_nr) + " of " + filename);
 				}
 				
-				//std::cout << index << " ";
-				
 				premises.insert(index);
 				
 			}
 		
-			// Parse consequence
-			//std::cout << " => ";
+			// Parse consequence (_ denotes an empty head)
 			std::set<unsigned> consequence;
-			if (split_line.back() != empty_head)
+			if (!field_equals(fields.back(), "_"))
 			{
 				
-				ss.str(split_line.back());
-				ss.clear();
-				std::size_t index;
-				ss >> index;
-				
-				if (ss.fail() || !ss.eof())
+				if (!parse_integer(fields.back(), 0, std::numeric_limits<unsigned>::max(), index))
 				{
 					throw boogie_io_error("Unable to parse horn constraint in line " + std::to_string(line_nr) + " of " + filename);
 				}
 				
-				//std::cout << index;
-				
 				consequence.insert(index);
 				
 			}
 		
-			horn_constraints.push_back(std::make_pair(premises, consequence));
-			//std::cout << std::endl;
+			horn_constraints.push_back(std::make_pair(std::move(premises), std::move(consequence)));
 		
 		}
 		
+	}
+	
+	
+	std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> boogie_io::read_horn_file(const std::string & filename)
+	{
+	
+		// Map file into memory (or read it into a buffer on Windows; throws if opening the file failed)
+		mapped_file infile(filename);
+		auto begin = reinterpret_cast<const char *>(infile.data());
 		
-		// Close input file
-		infile.close();
+		// Parse Horn constraints as indexes (as occurring in the data file)
+		std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_constraints;
+		parse_horn_constraints(begin, begin + infile.size(), filename, horn_constraints);
 	
 		return horn_constraints;
 		
 	}
 	
 	
+	void boogie_io::read_horn_constraints(std::istream & in, const std::string & filename, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints, const std::string & terminator)
+	{
+	
+		auto content = read_until(in, terminator);
+		parse_horn_constraints(content.data(), content.data() + content.size(), filename, horn_constraints);
+		
+	}
+	
+	
+	void boogie_io::read_binary_sample(const std::string & file_stem, const attributes_metadata & metadata, std::vector<datapoint<bool>> & datapoints, std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints)
+	{
+		
+		binary_sample_reader reader(file_stem + ".data.bin", file_stem + ".horn.bin", metadata);
+		reader.read_datapoints(datapoints);
+		reader.read_horn_constraints(horn_constraints);
+		
+	}
+
+
+	/**
+	 * Writes a 32 bit integer in little-endian byte order to an output stream.
+	 *
+	 * @param out The output stream
+	 * @param value The integer
+	 */
+	static void write_uint32(std::ostream & out, std::uint32_t value)
+	{
+		const char bytes[4] = { static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+		out.write(bytes, sizeof(bytes));
+	}
+
+
+	void boogie_io::write_binary_data_file(const std::string & filename, const std::vector<datapoint<bool>> & datapoints, const attributes_metadata & metadata)
+	{
+		
+		// Open file
+		std::ofstream outfile(filename, std::ofstream::out | std::ofstream::binary);
+		
+		// Check opening the file failed
+		if (outfile.fail())
+		{
+			throw boogie_io_error("Error opening " + filename);
+		}
+		
+		// Header
+		outfile.write(binary_sample::data_magic, sizeof(binary_sample::data_magic));
+		write_uint32(outfile, metadata.categorical_names().size());
+		write_uint32(outfile, metadata.int_names().size());
+		
+		// Data points
+		for (const auto & dp : datapoints)
+		{
+			
+			write_uint32(outfile, !dp._is_classified ? binary_sample::unlabeled : (dp._classification ? binary_sample::positive : binary_sample::negative));
+			
+			for (const auto & value : dp._categorical_data)
+			{
+				write_uint32(outfile, value);
+			}
+			
+			for (const auto & value : dp._int_data)
+			{
+				write_uint32(outfile, static_cast<std::uint32_t>(value));
+			}
+			
+		}
+		
+		// Close file
+		outfile.close();
+		
+	}
+
+
+	void boogie_io::write_binary_horn_file(const std::string & filename, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_constraints)
+	{
+		
+		// Open file
+		std::ofstream outfile(filename, std::ofstream::out | std::ofstream::binary);
+		
+		// Check opening the file failed
+		if (outfile.fail())
+		{
+			throw boogie_io_error("Error opening " + filename);
+		}
+		
+		// Header
+		outfile.write(binary_sample::horn_magic, sizeof(binary_sample::horn_magic));
+		
+		// Horn constraints
+		for (const auto & horn_pair : horn_constraints)
+		{
+			
+			write_uint32(outfile, horn_pair.second.empty() ? binary_sample::no_head : *horn_pair.second.begin());
+			write_uint32(outfile, horn_pair.first.size());
+			
+			for (const auto index : horn_pair.first)
+			{
+				write_uint32(outfile, index);
+			}
+			
+		}
+		
+		// Close file
+		outfile.close();
+		
+	}
+	
+	
 	void boogie_io::write_json_file(const std::string & filename, decision_tree & tree, const attributes_metadata & metadata)
 	{
 		
@@ -507,45 +839,104 @@ namespace horn_verification
 			throw boogie_io_error("Error opening " + filename);
 		}
 		
-		// Create visitor and write output
-		json_visitor visitor(metadata, outfile);
-		tree.accept(visitor);
+		// Write output
+		write_json(outfile, tree, metadata);
 		
 		// Close file
 		outfile.close();
 		
 	}
+	
+	
+	void boogie_io::write_json(std::ostream & out, decision_tree & tree, const attributes_metadata & metadata)
+	{
+		
+		// Create visitor and write output
+		json_visitor visitor(metadata, out);
+		tree.accept(visitor);
+		
+	}
 
 	std::vector<horn_constraint<bool>> boogie_io::get_indistinguishable_datapoints(std::vector<datapoint<bool>> & datapoints, unsigned int threshold)
 	{
 
-                std::vector<horn_constraint<bool>> horn_constraints;
-		auto dpts_size = datapoints.size();
+		//
+		// Two data points are indistinguishable if and only if they agree on all categorical
+		// attributes and on all integer attributes clamped to [-threshold, threshold + 1]: values
+		// below -threshold (above threshold) cannot be separated by a cut of modulus at most
+		// threshold. Hence, indistinguishability is an equivalence relation, whose classes are
+		// found by hashing the clamped data points.
+		//
+		const long long lower = -static_cast<long long>(threshold);
+		const long long upper = static_cast<long long>(threshold) + 1;
+		auto clamp = [lower, upper](int value) { return std::min(std::max(static_cast<long long>(value), lower), upper); };
 
-		for(unsigned int i = 0; i < dpts_size; i++)
+		auto hash = [&datapoints, &clamp](unsigned i)
 		{
-			for (unsigned int j = i+1; j < dpts_size; j++)
+			std::size_t h = 0;
+			for (auto value : datapoints[i]._categorical_data)
 			{
-				if (! datapoints[i].is_distinguishable(datapoints[j], threshold))
-				{				        
-					//std::cout << "Cannot distinguish points: " << i << " and " << j << std::endl; 
+				h = h * 31 + std::hash<unsigned>()(value);
+			}
+			for (auto value : datapoints[i]._int_data)
+			{
+				h = h * 31 + std::hash<long long>()(clamp(value));
+			}
+			return h;
+		};
 
-					std::vector <datapoint<bool> *> premises1;
-                        		datapoint<bool> * consequence1 = nullptr;
+		auto indistinguishable = [&datapoints, &clamp](unsigned i, unsigned j)
+		{
+			if (datapoints[i]._categorical_data != datapoints[j]._categorical_data)
+			{
+				return false;
+			}
+			for (std::size_t k = 0; k < datapoints[i]._int_data.size(); ++k)
+			{
+				if (clamp(datapoints[i]._int_data[k]) != clamp(datapoints[j]._int_data[k]))
+				{
+					return false;
+				}
+			}
+			return true;
+		};
 
-                                	premises1.push_back(&datapoints[i]);
-                                	consequence1 = &datapoints[j];
-                        		horn_constraints.push_back(horn_constraint<bool>(premises1, consequence1));
 
-					std::vector <datapoint<bool> *> premises2;
-					datapoint<bool> * consequence2 = nullptr;
+		//
+		// Chain the data points of each equivalence class in the order of the data points and close
+		// the chain to a cycle, which forces all of them to the same label with one Horn constraint
+		// per data point (instead of two per pair of data points)
+		//
+		std::unordered_map<unsigned, unsigned, decltype(hash), decltype(indistinguishable)> class_of(datapoints.size(), hash, indistinguishable);
+		std::vector<std::pair<unsigned, unsigned>> first_and_last; // Of each class
 
-                                	premises2.push_back(&datapoints[j]);
-                                	consequence2 = &datapoints[i];
-                        		horn_constraints.push_back(horn_constraint<bool>(premises2, consequence2));
-				}
+		std::vector<horn_constraint<bool>> horn_constraints;
+		
+		for (unsigned i = 0; i < datapoints.size(); ++i)
+		{
+
+			auto result = class_of.emplace(i, first_and_last.size());
+			if (result.second)
+			{
+				first_and_last.push_back(std::make_pair(i, i));
+			}
+			else
+			{
+				auto & last = first_and_last[result.first->second].second;
+				horn_constraints.push_back(horn_constraint<bool>(std::vector<datapoint<bool> *>(1, &datapoints[last]), &datapoints[i]));
+				last = i;
 			}
+
 		}
+
+		for (const auto & pair : first_and_last)
+		{
+			if (pair.first != pair.second)
+			{
+				horn_constraints.push_back(horn_constraint<bool>(std::vector<datapoint<bool> *>(1, &datapoints[pair.second]), &datapoints[pair.first]));
+			}
+		}
+
 		return horn_constraints;
 
 	}
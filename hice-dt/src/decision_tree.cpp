@@ -4,6 +4,8 @@
 
 // C++ includes
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 // Project includes
 #include "decision_tree.h"
@@ -139,4 +141,63 @@ namespace horn_verification
 	}
 
 	
+	//
+	// Decision tree
+	//
+	
+	/**
+	 * This visitor collects the children of the nodes it visits.
+	 */
+	class children_collector : public base_visitor
+	{
+		
+		/// The nodes collected so far
+		std::vector<base_node *> & _nodes;
+		
+	public:
+		
+		children_collector(std::vector<base_node *> & nodes)
+			: _nodes(nodes)
+		{
+			// Nothing
+		}
+		
+		void visit(categorical_node & n) override
+		{
+			std::copy_if(n.children().begin(), n.children().end(), std::back_inserter(_nodes), [](base_node * child) { return child != nullptr; });
+		}
+		
+		void visit(int_node & n) override
+		{
+			std::copy_if(n.children().begin(), n.children().end(), std::back_inserter(_nodes), [](base_node * child) { return child != nullptr; });
+		}
+		
+		void visit(leaf_node & n) override
+		{
+			// Nothing
+		}
+		
+	};
+	
+	
+	void decision_tree::delete_nodes(base_node * root)
+	{
+		
+		std::vector<base_node *> nodes;
+		children_collector collector(nodes);
+		
+		nodes.push_back(root);
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			nodes[i]->accept(collector);
+		}
+		
+		for (auto node : nodes)
+		{
+			delete node;
+		}
+		
+	}
+
+	
 }; // End namespace horn_verification
\ No newline at end of file
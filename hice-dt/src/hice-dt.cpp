@@ -4,22 +4,28 @@
 
 // C++ includes
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <istream>
+#include <memory>
 #include <unordered_set>
 #include <stdexcept>
 #include <string>
 #include <sstream>
 
 // C includes
+#include <getopt.h>
 #include <unistd.h>
 
 // Project includes
+#include "binary_sample.h"
 #include "boogie_io.h"
 #include "bound.h"
+#include "bounded_sample.h"
 #include "simple_job_manager.h"
 #include "debug_job_manager.h"
 #include "horndini.h"
-#include "horn_solver.h"
+#include "incremental_horn_solver.h"
 #include "learner.h"
 #include "pretty_print_visitor.h" // DEBUG
 
@@ -31,10 +37,9 @@ using namespace horn_verification;
  *
  * 1) It generates derived predicates for each integer attribute of the form
  *    x <= c, x >= c, and x = c, where c is a constant given by the user
- * 2) It generates a new set of data points based on the derived attributes
- * 3) It generates a new set of Horn constraints based on these data points
- * 4) It runs Houdini on the data points and Horn constraints
- * 5) If a consistent conjunction exists, it constructs an equivalent decision
+ * 2) It evaluates the derived predicates on the data points (packed as bitsets)
+ * 3) It runs Houdini on these values and the Horn constraints
+ * 4) If a consistent conjunction exists, it constructs an equivalent decision
  *    tree and returns
  *
  * Throws an <code>no_conjunction_exists_exception</code> if no conjunction exists.
@@ -55,8 +60,7 @@ decision_tree horndini_prephase(const attributes_metadata & metadata, const std:
 	//
 	auto derived_predicates_and_intervals = horndini::generate_derived_predicates_and_intervals(intervals, c);
 
-	auto derived_datapoints = horndini::generate_derived_datapoints(datapoints, derived_predicates_and_intervals.first);
-	auto derived_horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, derived_datapoints);
+	derived_values values(datapoints, derived_predicates_and_intervals.first, derived_predicates_and_intervals.second);
 	assert (metadata.number_of_categories().size() == 1 && metadata.number_of_categories()[0] == derived_predicates_and_intervals.second.size());
 
 
@@ -77,7 +81,7 @@ decision_tree horndini_prephase(const attributes_metadata & metadata, const std:
 	// Run Horndini
 	//
 
-	horndini::learn(derived_datapoints, derived_horn_constraints, conjunctions);
+	horndini::learn(datapoints, values, horn_indexes, conjunctions);
 	auto horndini_tree = horndini::conjunctions2tree(metadata, derived_predicates_and_intervals.first, conjunctions);
 			
 	// Debug checks			
@@ -97,6 +101,526 @@ decision_tree horndini_prephase(const attributes_metadata & metadata, const std:
 }
 
 
+/**
+ * Checks whether the attributes and intervals read from file fit together.
+ *
+ * @param metadata The meta data
+ * @param intervals The intervals describing where individual annotations begin and end in a data point
+ */
+void check_input(const attributes_metadata & metadata, const std::vector<std::pair<unsigned, unsigned>> & intervals)
+{
+
+	if (metadata.int_names().size() + metadata.categorical_names().size() == 0)
+	{
+		throw std::runtime_error("No attributes defined");
+	}
+	if (metadata.number_of_categories().size() < 0)
+	{
+		throw std::runtime_error("At least one categorical attribute (the ID of the annotation) is required");
+	}
+	if (metadata.number_of_categories()[0] != intervals.size())
+	{
+		throw std::runtime_error("Intervals file does not match number of annotations to synthesize");
+	}
+
+}
+
+
+/**
+ * Learns a decision tree that is consistent with a sample, first running the Horndini pre-phase
+ * if desired. If bounds are used, the bound is increased until a consistent decision tree is
+ * found, and \p cur_bound holds the final bound afterwards. If the Horndini pre-phase succeeds,
+ * \p cur_bound is reset to 1 (the bound the Horndini pre-phase has always reported).
+ *
+ * The data points are copied, hence the sample is not modified and can be reused in later rounds.
+ *
+ * @param metadata The meta data
+ * @param datapoints The data points
+ * @param horn_indexes The Horn constraints, modeled as indexes into the <code>datapoints</code> vector
+ * @param intervals The intervals describing where individual annotations begin and end in a data point
+ * @param use_attribute_intervals Whether every data point fits the intervals, such that the split search can be
+ *        restricted to them (see simple_job_manager::fits_attribute_intervals())
+ * @param cur_bound The bound to start with
+ * @param do_horndini_prephase Whether to run the Horndini pre-phase
+ * @param presort Whether to presort the data points once per attribute
+ * @param bound_times The vector to which the bound (or 0 if no bound is used) and the time in seconds of every run of the
+ *        decision tree learner are added
+ *
+ * @return a decision tree that is consistent with the sample
+ */
+decision_tree learn_decision_tree(const attributes_metadata & metadata, const std::vector<datapoint<bool>> & datapoints, const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_indexes, const std::vector<std::pair<unsigned, unsigned>> & intervals, bool use_attribute_intervals, bound<> & cur_bound, bool do_horndini_prephase, bool presort, std::vector<std::pair<int, double>> & bound_times)
+{
+
+	/************************************************************************************
+	 *
+	 * Do Horndini prephase if desired
+	 *
+	 ************************************************************************************/
+	if (do_horndini_prephase)
+	{
+
+		//
+		// Create copy of data points and pointers thereof
+		//
+		std::vector<datapoint<bool>> datapoints_copy;
+		datapoints_copy.reserve(datapoints.size());
+		for (unsigned i = 0; i < datapoints.size(); ++i)
+		{
+			datapoints_copy.push_back(datapoints[i]);
+		}
+		
+		std::vector<datapoint<bool> *> datapoint_ptrs;
+		datapoint_ptrs.reserve(datapoints.size());
+		for (unsigned i = 0; i < datapoints_copy.size(); ++i)
+		{
+			datapoint_ptrs.push_back(&datapoints_copy[i]);
+		}
+
+		//
+		// Create Horn constraints
+		//
+		auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints_copy);
+
+
+		//
+		// Run Horndini
+		//
+		try // There might not be a conjunctive invariant
+		{
+			
+			auto horndini_tree = horndini_prephase(metadata, datapoints_copy, horn_indexes, intervals);
+
+
+			//
+			// Return if consistent
+			//
+			auto horndini_consistent = learner<complex_job_manager>::is_consistent(horndini_tree, datapoint_ptrs, horn_constraints);
+			if (horndini_consistent)
+			{
+				cur_bound.set_bound(1);
+				return horndini_tree;
+			}
+		}
+		
+		// Catch exception that no consistent conjunction exists 
+		catch (const no_conjunction_exists_exception & ex)
+		{
+			// Do nothing, just proceed to decision tree learning phase
+		}
+		
+		
+	}
+
+
+
+	/************************************************************************************
+	 *
+	 * Run decision tree learner
+	 *
+	 ************************************************************************************/
+
+
+	//
+	// Create copy of data points, pointers thereof and Horn constraints, and label the data points
+	// derived from the Horn constraints (once for all bounds)
+	//
+	bounded_sample sample(datapoints, horn_indexes);
+
+
+	//
+	// Loop over increasing bounds (depending on the implementation of the bounds object, at some point no bound is used)
+	//
+	while (true)
+	{
+
+		auto start = std::chrono::steady_clock::now();
+		auto level = cur_bound.use_bound() ? cur_bound.get_bound() : 0;
+
+
+		//
+		// Try-catch block is used to handle situations where bounds are too small and need to be increased
+		//
+		try
+		{
+
+
+			//
+			// Add bound constraints if necessary and perform initial run of the Horn solver
+			//
+			sample.prepare(cur_bound);
+
+			auto & datapoint_ptrs = sample.datapoint_ptrs();
+			auto & horn_constraints = sample.horn_constraints();
+			auto & solver = sample.solver();
+
+
+			//
+			// Run decision tree learner
+			//
+			// You can configure different heuristics for the learner by passing, at the end, arguments
+			//   NodeSelection enum type with values BFS, DFS, RANDOM, MAX_ENTROPY, MAX_WEIGHTED_ENTROPY, MIN_ENTROPY, MIN_WEIGHTED_ENTROPY
+			//   EntropyComputation enum type with values DEFAULT_ENTROPY, HORN_ASSIGNMENTS
+			//   ConjunctiveSetting enum type with values NOPREFERENCEFORCONJUNCTS, PREFERENCEFORCONJUNCTS
+			auto ns = NodeSelection::BFS;
+			auto ec = EntropyComputation::PENALTY;
+			auto cs = ConjunctiveSetting::NOPREFERENCEFORCONJUNCTS;
+			auto manager = cur_bound.use_bound() ? complex_job_manager(datapoint_ptrs, horn_constraints, solver, cur_bound.get_bound(), ns, ec, cs) : complex_job_manager(datapoint_ptrs, horn_constraints, solver, ns, ec, cs);
+			manager.set_presorted(presort);
+			if (use_attribute_intervals)
+			{
+				manager.set_attribute_intervals(intervals);
+			}
+			learner<complex_job_manager> l(manager);
+			auto decision_tree = l.learn(metadata, datapoint_ptrs, horn_constraints);
+
+
+			//
+			// Debug
+			//
+			assert (l.is_consistent(decision_tree, datapoint_ptrs, horn_constraints));
+
+			bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+
+			return decision_tree;
+
+		}
+
+		// Sample is inconsistent
+		catch (const sample_error & ex)
+		{
+
+			bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+
+			// Increase bounds or declare inconsistent sample if no bounds ought to be used
+			if(cur_bound.use_bound())
+			{
+				cur_bound.increase_bound();
+			}
+			else
+			{
+				throw;
+			}
+			
+		}
+		
+		// No split possible
+		// Sample is inconsistent
+		catch (const split_not_possible_error & ex)
+		{
+		
+			bound_times.push_back(std::make_pair(level, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+
+			// Increase bounds or declare inconsistent sample if no bounds ought to be used
+			if(cur_bound.use_bound())
+			{
+				cur_bound.increase_bound();
+			}
+			else
+			{
+				throw;
+			}
+			
+		}
+
+
+	} // Loops over increasing bounds, should terminate at some point
+
+}
+
+
+/**
+ * Prints the time of every run of the decision tree learner during the learning of one tree.
+ *
+ * @param out The output stream to write to
+ * @param bound_times The bound (or 0 if no bound is used) and the time in seconds of every run
+ */
+void print_bound_times(std::ostream & out, const std::vector<std::pair<int, double>> & bound_times)
+{
+
+	for (std::size_t i = 0; i < bound_times.size(); ++i)
+	{
+
+		if (bound_times[i].first > 0)
+		{
+			out << "Bound " << bound_times[i].first;
+		}
+		else
+		{
+			out << "No bound";
+		}
+
+		out << ": " << bound_times[i].second * 1000 << " ms" << (i + 1 < bound_times.size() ? " (failed)" : "") << std::endl;
+
+	}
+
+}
+
+
+/**
+ * Checks that Horn constraints only refer to known data points.
+ *
+ * Throws a <code>boogie_io_error</code> if a Horn constraint refers to an unknown data point.
+ *
+ * @param horn_indexes The Horn constraints, modeled as indexes into a vector of data points
+ * @param number_of_datapoints The number of data points
+ */
+void check_horn_indexes(const std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> & horn_indexes, std::size_t number_of_datapoints)
+{
+
+	for (const auto & horn_pair : horn_indexes)
+	{
+		if ((!horn_pair.first.empty() && *horn_pair.first.rbegin() >= number_of_datapoints) || (!horn_pair.second.empty() && *horn_pair.second.rbegin() >= number_of_datapoints))
+		{
+			throw boogie_io_error("Horn constraint refers to unknown data point");
+		}
+	}
+
+}
+
+
+/**
+ * Reads the lines of a message up to (and excluding) the line <code>end</code> into a string stream.
+ *
+ * @param in The input stream to read from
+ * @param block The string stream to write the lines to
+ *
+ * @return whether the line <code>end</code> was found
+ */
+bool read_message_block(std::istream & in, std::stringstream & block)
+{
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+
+		boogie_io::trim(line);
+		if (line == "end")
+		{
+			return true;
+		}
+
+		block << line << '\n';
+
+	}
+
+	return false;
+
+}
+
+
+/**
+ * Runs the learner as a server that keeps the sample (and the bound) in memory across rounds.
+ *
+ * The attributes and intervals are read once from <code>file_stem.attributes</code> and
+ * <code>file_stem.intervals</code>. Afterwards, the server reads messages from \p in, each of
+ * which is answered with exactly one line on \p out:
+ * <ul>
+ *   <li><code>data</code>, followed by data points in the format of the data file and a line
+ *       <code>end</code>: adds the data points to the sample and answers <code>ok</code>.</li>
+ *   <li><code>horn</code>, followed by Horn constraints in the format of the Horn file and a line
+ *       <code>end</code>: adds the Horn constraints (whose indexes refer to all data points added so
+ *       far) to the sample and answers <code>ok</code>.</li>
+ *   <li><code>binary</code>: adds the data points and Horn constraints that have been appended to
+ *       <code>file_stem.data.bin</code> and <code>file_stem.horn.bin</code> (see \ref binary_sample)
+ *       since the previous <code>binary</code> message, updates the labels of the data points read
+ *       before and answers <code>ok</code>. The reader of these files is kept across messages, so
+ *       that every message only converts the new records. A server that receives
+ *       <code>binary</code> messages cannot also receive <code>data</code> messages.</li>
+ *   <li><code>learn</code>: learns a decision tree consistent with the sample and answers its JSON
+ *       serialization.</li>
+ *   <li><code>reset</code>: removes all data points and Horn constraints, resets the bound and
+ *       answers <code>ok</code>. The next <code>binary</code> message reads the binary files from
+ *       their beginning.</li>
+ *   <li><code>quit</code>: stops the server (without answer).</li>
+ * </ul>
+ * If a message fails, the sample is left unchanged and the answer is <code>error</code> followed
+ * by a description of the error. The only exception are <code>binary</code> messages, whose
+ * updates of labels are kept, as are their new data points if only their Horn constraints are
+ * invalid (the reader does not read records twice).
+ *
+ * @param file_stem The file stem of the attributes, intervals and binary sample files
+ * @param do_horndini_prephase Whether to run the Horndini pre-phase
+ * @param use_bounds Whether to bound the learner
+ * @param presort Whether to presort the data points once per attribute
+ * @param report_times Whether to print the time of every run of the decision tree learner to <code>std::cerr</code>
+ * @param in The input stream to read messages from
+ * @param out The output stream to write answers to
+ *
+ * @return 0 if successful, otherwise an error code defined by POSIX
+ */
+int run_server(const std::string & file_stem, bool do_horndini_prephase, bool use_bounds, bool presort, bool report_times, std::istream & in, std::ostream & out)
+{
+
+	//
+	// Read input that is fixed across rounds
+	//
+	const auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+	const auto intervals = boogie_io::read_intervals_file(file_stem + ".intervals");
+	check_input(metadata, intervals);
+
+
+	//
+	// The sample and the bound kept across rounds
+	//
+	std::vector<datapoint<bool>> datapoints;
+	std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_indexes;
+	bound<> cur_bound (1, use_bounds);
+	std::unique_ptr<binary_sample_reader> reader; // Created by the first binary message
+
+	// Every data point is checked once against the intervals, before the first round that learns with it
+	std::size_t checked_datapoints = 0;
+	bool datapoints_fit_intervals = true;
+
+
+	//
+	// Process messages
+	//
+	std::string line;
+	while (std::getline(in, line))
+	{
+
+		boogie_io::trim(line);
+		if (line.empty())
+		{
+			continue;
+		}
+
+		try
+		{
+
+			if (line == "data" || line == "horn")
+			{
+
+				// Read the whole block first such that no line of it is taken as message if it is invalid
+				std::stringstream block;
+				if (!read_message_block(in, block))
+				{
+					throw boogie_io_error("Message " + line + " not terminated by end");
+				}
+
+				if (line == "data")
+				{
+
+					auto number_of_datapoints = datapoints.size();
+
+					try
+					{
+						boogie_io::read_data(block, "data message", metadata, datapoints);
+					}
+					catch (...)
+					{
+						datapoints.erase(datapoints.begin() + number_of_datapoints, datapoints.end());
+						throw;
+					}
+
+				}
+				else
+				{
+
+					std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> new_horn_indexes;
+					boogie_io::read_horn_constraints(block, "horn message", new_horn_indexes);
+
+					check_horn_indexes(new_horn_indexes, datapoints.size());
+					horn_indexes.insert(horn_indexes.end(), new_horn_indexes.begin(), new_horn_indexes.end());
+
+				}
+
+				out << "ok" << std::endl;
+
+			}
+			else if (line == "binary")
+			{
+
+				if (!reader)
+				{
+					reader.reset(new binary_sample_reader(file_stem + ".data.bin", file_stem + ".horn.bin", metadata));
+				}
+
+				// The reader only advances if all new data points are valid
+				auto number_of_datapoints = datapoints.size();
+
+				try
+				{
+					reader->read_datapoints(datapoints);
+				}
+				catch (...)
+				{
+					datapoints.erase(datapoints.begin() + number_of_datapoints, datapoints.end());
+					throw;
+				}
+
+				// The reader has already advanced past invalid Horn constraints, which are dropped
+				std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> new_horn_indexes;
+				reader->read_horn_constraints(new_horn_indexes);
+
+				check_horn_indexes(new_horn_indexes, datapoints.size());
+				horn_indexes.insert(horn_indexes.end(), new_horn_indexes.begin(), new_horn_indexes.end());
+
+				out << "ok" << std::endl;
+
+			}
+			else if (line == "learn")
+			{
+
+				for (; checked_datapoints < datapoints.size(); ++checked_datapoints)
+				{
+					datapoints_fit_intervals = datapoints_fit_intervals && simple_job_manager::fits_attribute_intervals(datapoints[checked_datapoints], intervals);
+				}
+
+				// Learn with a copy of the bound such that a failed round does not change it
+				auto round_bound = cur_bound;
+				std::vector<std::pair<int, double>> bound_times;
+				auto tree = learn_decision_tree(metadata, datapoints, horn_indexes, intervals, datapoints_fit_intervals, round_bound, do_horndini_prephase, presort, bound_times);
+				cur_bound = round_bound;
+
+				if (report_times)
+				{
+					print_bound_times(std::cerr, bound_times);
+				}
+
+				boogie_io::write_json(out, tree, metadata);
+				out << std::endl;
+
+			}
+			else if (line == "reset")
+			{
+
+				datapoints.clear();
+				horn_indexes.clear();
+				cur_bound = bound<>(1, use_bounds);
+				reader.reset();
+				checked_datapoints = 0;
+				datapoints_fit_intervals = true;
+
+				out << "ok" << std::endl;
+
+			}
+			else if (line == "quit")
+			{
+				return EXIT_SUCCESS;
+			}
+			else
+			{
+				throw boogie_io_error("Unknown message " + line);
+			}
+
+		}
+
+		//
+		// Report errors and keep serving
+		//
+		catch (const std::exception & ex)
+		{
+			out << "error " << ex.what() << std::endl;
+		}
+
+	}
+
+	return EXIT_SUCCESS;
+
+}
+
+
 /**
  * Prints a help message to an output stream.
  *
@@ -109,7 +633,11 @@ void print_help(std::ostream & out, const char * name)
 	out << "Usage: " << name << " [options] file_stem" << std::endl;
 	out << "Options are:" << std::endl;
 	out << "  -b\t\tBound the learner" << std::endl;
+	out << "  --binary\tRead the sample from file_stem.data.bin and file_stem.horn.bin (see binary_sample.h) instead of the text files" << std::endl;
 	out << "  -h\t\tRun Horndini pre-phase" << std::endl;
+	out << "  -p\t\tPresort the data points once per attribute instead of sorting them at every split" << std::endl;
+	out << "  -s, --server\tRun as server that reads the sample from stdin and answers with decision trees on stdout" << std::endl;
+	out << "  -t\t\tPrint the time of every run of the learner (per bound) to stderr" << std::endl;
 
 }
 
@@ -129,9 +657,22 @@ int main(int argc, char * argv[]) {
 	//
 	bool do_horndini_prephase = false;
 	bool use_bounds = false;
+	bool presort = false;
+	bool server = false;
+	bool report_times = false;
+	bool binary = false;
+
+	// --binary has no short form (its value is not a valid option character)
+	static const int binary_option = 256;
+	static const struct option long_options[] =
+	{
+		{"server", no_argument, nullptr, 's'},
+		{"binary", no_argument, nullptr, binary_option},
+		{nullptr, 0, nullptr, 0}
+	};
 
 	int c;
-	while ((c = getopt (argc, argv, "bh")) != -1)
+	while ((c = getopt_long (argc, argv, "bhpst", long_options, nullptr)) != -1)
 	{
 
 		switch (c)
@@ -142,6 +683,18 @@ int main(int argc, char * argv[]) {
 			case 'h':
 				do_horndini_prephase = true;
 				break;
+			case 'p':
+				presort = true;
+				break;
+			case 's':
+				server = true;
+				break;
+			case 't':
+				report_times = true;
+				break;
+			case binary_option:
+				binary = true;
+				break;
 			default:
 				print_help(std::cout, argv[0]);
 				return EXIT_FAILURE;
@@ -166,6 +719,14 @@ int main(int argc, char * argv[]) {
 	try 
 	{
 
+		//
+		// Run as server if desired
+		//
+		if (server)
+		{
+			return run_server(file_stem, do_horndini_prephase, use_bounds, presort, report_times, std::cin, std::cout);
+		}
+
 
 		//
 		// Read input from files
@@ -174,11 +735,18 @@ int main(int argc, char * argv[]) {
 		// Read attribute meta data
 		const auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
 		
-		// Read data points
-		const auto datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
-
-		// Read horn constraints
-		const auto horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+		// Read data points and horn constraints (from the binary sample files if asked for, otherwise from the text files)
+		std::vector<datapoint<bool>> datapoints;
+		std::vector<std::pair<std::set<unsigned>, std::set<unsigned>>> horn_indexes;
+		if (binary)
+		{
+			boogie_io::read_binary_sample(file_stem, metadata, datapoints, horn_indexes);
+		}
+		else
+		{
+			datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+			horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+		}
 
 		// Read intervals
 		const auto intervals = boogie_io::read_intervals_file(file_stem + ".intervals");
@@ -187,18 +755,7 @@ int main(int argc, char * argv[]) {
 		//
 		// Check input
 		//
-		if (metadata.int_names().size() + metadata.categorical_names().size() == 0)
-		{
-			throw std::runtime_error("No attributes defined");
-		}
-		if (metadata.number_of_categories().size() < 0)
-		{
-			throw std::runtime_error("At least one categorical attribute (the ID of the annotation) is required");
-		}
-		if (metadata.number_of_categories()[0] != intervals.size())
-		{
-			throw std::runtime_error("Intervals file does not match number of annotations to synthesize");
-		}
+		check_input(metadata, intervals);
 
 
 		//
@@ -206,83 +763,6 @@ int main(int argc, char * argv[]) {
 		//
 		bound<> cur_bound (1, use_bounds);
 
-		
-		/************************************************************************************
-		 *
-		 * Do Horndini prephase if desired
-		 *
-		 ************************************************************************************/
-		if (do_horndini_prephase)
-		{
-
-			//
-			// Create copy of data points and pointers thereof
-			//
-			std::vector<datapoint<bool>> datapoints_copy;
-			datapoints_copy.reserve(datapoints.size());
-			for (unsigned i = 0; i < datapoints.size(); ++i)
-			{
-				datapoints_copy.push_back(datapoints[i]);
-			}
-			
-			std::vector<datapoint<bool> *> datapoint_ptrs;
-			datapoint_ptrs.reserve(datapoints.size());
-			for (unsigned i = 0; i < datapoints_copy.size(); ++i)
-			{
-				datapoint_ptrs.push_back(&datapoints_copy[i]);
-			}
-
-			//
-			// Create Horn constraints
-			//
-			auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints_copy);
-
-
-			//
-			// Run Horndini
-			//
-			try // There might not be a conjunctive invariant
-			{
-				
-				auto horndini_tree = horndini_prephase(metadata, datapoints_copy, horn_indexes, intervals);
-
-
-				//
-				// Output and exit if consistent
-				//
-				auto horndini_consistent = learner<complex_job_manager>::is_consistent(horndini_tree, datapoint_ptrs, horn_constraints);
-				if (horndini_consistent)
-				{
-
-					boogie_io::write_json_file(file_stem + ".json", horndini_tree, metadata);
-
-					if (cur_bound.use_bound())
-					{
-						cur_bound.write_bound_file(file_stem + ".bound", cur_bound);
-					}
-
-					return EXIT_SUCCESS;
-
-				}
-			}
-			
-			// Catch exception that no consistent conjunction exists 
-			catch (const no_conjunction_exists_exception & ex)
-			{
-				// Do nothing, just proceed to decision tree learning phase
-			}
-			
-			
-		}
-
-
-
-		/************************************************************************************
-		 *
-		 * Run decision tree learner
-		 *
-		 ************************************************************************************/
-
 
 		//
 		// Read round number (and bounds) from file if bounds are to be used
@@ -303,164 +783,27 @@ int main(int argc, char * argv[]) {
 
 
 		//
-		// Loop over increasing bounds (depending on the implementation of the bounds object, at some point no bound is used)
+		// Learn decision tree
 		//
-		bool terminate;
-		do
-		{
-
-			terminate = !cur_bound.use_bound();
-
-
-			//
-			// Try-catch block is used to handle situations where bounds are too small and need to be increased
-			//
-			try
-			{
-
-
-				//
-				// Create copy of data points and pointers thereof
-				//
-				std::vector<datapoint<bool>> datapoints_copy;
-				datapoints_copy.reserve(datapoints.size());
-				for (unsigned i = 0; i < datapoints.size(); ++i)
-				{
-					datapoints_copy.push_back(datapoints[i]);
-				}
-				
-				std::vector<datapoint<bool> *> datapoint_ptrs;
-				datapoint_ptrs.reserve(datapoints.size());
-				for (unsigned i = 0; i < datapoints_copy.size(); ++i)
-				{
-					datapoint_ptrs.push_back(&datapoints_copy[i]);
-				}
-
+		auto datapoints_fit_intervals = std::all_of(datapoints.cbegin(), datapoints.cend(), [&intervals](const datapoint<bool> & dp) { return simple_job_manager::fits_attribute_intervals(dp, intervals); });
+		std::vector<std::pair<int, double>> bound_times;
+		auto decision_tree = learn_decision_tree(metadata, datapoints, horn_indexes, intervals, datapoints_fit_intervals, cur_bound, do_horndini_prephase, presort, bound_times);
 
-				//
-				// Generate Horn constraints
-				//
-				auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints_copy);
-
-				//
-				// Create bound constraints if necessary
-				//
-				if (cur_bound.use_bound())
-				{
-					
-					std::vector<horn_constraint<bool>> indistinguishability_horn_constraints;
-					
-					// Infer horn constraints which arise due to indistinguishability of data points
-					indistinguishability_horn_constraints = boogie_io::get_indistinguishable_datapoints(datapoints_copy, cur_bound.get_bound());
-
-					// Push these indistinguishability_horn_constraints to horn_constraints
-					horn_constraints.insert(horn_constraints.end(), std::make_move_iterator(indistinguishability_horn_constraints.begin()), std::make_move_iterator(indistinguishability_horn_constraints.end()));
-					
-				}
-
-
-				//
-				// Instantiate Horn solver and perform initial run to label data points if necessary
-				//
-				horn_solver<bool> solver;
-				std::unordered_set<datapoint<bool> *> positive_ptrs;
-				std::unordered_set<datapoint<bool> *> negative_ptrs;
-
-				// Initial run
-				auto ok = solver.solve(datapoint_ptrs, horn_constraints, positive_ptrs, negative_ptrs);
-				
-				if (ok)
-				{
-					
-					for (auto & dp : positive_ptrs)
-					{
-						dp->_is_classified = true;
-						dp->_classification = true;	
-					}
-
-					for (auto & dp : negative_ptrs)
-					{
-						dp->_is_classified = true;
-						dp->_classification = false;	
-					}
-					
-				}
-				else
-				{
-					throw sample_error("No consistent decision tree exists (Horn clauses are contradictory)");
-				}
-
-
-				//
-				// Run decision tree learner
-				//
-				// You can configure different heuristics for the learner by passing, at the end, arguments
-				//   NodeSelection enum type with values BFS, DFS, RANDOM, MAX_ENTROPY, MAX_WEIGHTED_ENTROPY, MIN_ENTROPY, MIN_WEIGHTED_ENTROPY
-				//   EntropyComputation enum type with values DEFAULT_ENTROPY, HORN_ASSIGNMENTS
-				//   ConjunctiveSetting enum type with values NOPREFERENCEFORCONJUNCTS, PREFERENCEFORCONJUNCTS
-				auto ns = NodeSelection::BFS;
-				auto ec = EntropyComputation::PENALTY;
-				auto cs = ConjunctiveSetting::NOPREFERENCEFORCONJUNCTS;
-				auto manager = cur_bound.use_bound() ? complex_job_manager(datapoint_ptrs, horn_constraints, solver, cur_bound.get_bound(), ns, ec, cs) : complex_job_manager(datapoint_ptrs, horn_constraints, solver, ns, ec, cs);
-				learner<complex_job_manager> l(manager);
-				auto decision_tree = l.learn(metadata, datapoint_ptrs, horn_constraints);
-
-
-				//
-				// Debug
-				//
-				assert (l.is_consistent(decision_tree, datapoint_ptrs, horn_constraints));
-
-				//
-				// Output
-				//
-				boogie_io::write_json_file(file_stem + ".json", decision_tree, metadata);
-
-				if (cur_bound.use_bound())
-				{
-					cur_bound.write_bound_file(file_stem + ".bound", cur_bound);
-				}
-				
-
-				terminate = true;
-
-			}
-
-			// Sample is inconsistent
-			catch (const sample_error & ex)
-			{
+		if (report_times)
+		{
+			print_bound_times(std::cerr, bound_times);
+		}
 
-				// Increase bounds or declare inconsistent sample if no bounds ought to be used
-				if(cur_bound.use_bound())
-				{
-					cur_bound.increase_bound();
-				}
-				else
-				{
-					throw;
-				}
-				
-			}
-			
-			// No split possible
-			// Sample is inconsistent
-			catch (const split_not_possible_error & ex)
-			{
-			
-				// Increase bounds or declare inconsistent sample if no bounds ought to be used
-				if(cur_bound.use_bound())
-				{
-					cur_bound.increase_bound();
-				}
-				else
-				{
-					throw;
-				}
-				
-			}
 
+		//
+		// Output
+		//
+		boogie_io::write_json_file(file_stem + ".json", decision_tree, metadata);
 
-		} while (!terminate); // Loops over increasing bounds, should terminate at some point
+		if (cur_bound.use_bound())
+		{
+			cur_bound.write_bound_file(file_stem + ".bound", cur_bound);
+		}
 
 
 		return EXIT_SUCCESS;
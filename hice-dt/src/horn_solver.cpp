@@ -38,7 +38,8 @@ namespace horn_verification
 				compute_current_marking();
 				_compute_current_marking = false;
 			}
-			for(auto current_marking_itrator = current_variable_addr->_list_of_marking.begin(); current_marking_itrator != current_variable_addr->_list_of_marking.end(); current_marking_itrator++) {
+			const auto & current_markings = _markings[current_variable_addr];
+			for(auto current_marking_itrator = current_markings.begin(); current_marking_itrator != current_markings.end(); current_marking_itrator++) {
 				if ((*current_marking_itrator) != current_variable_addr) {
 					if((!(*current_marking_itrator)->_is_classified)||(*current_marking_itrator)->_classification) {
 						horn_constraints_satisfiability = (*current_marking_itrator)->set_classification(false);
@@ -55,6 +56,20 @@ namespace horn_verification
 		return true;
 	}
 
+	template <class T>
+	void horn_solver<T>::remove_satisfied_horn_clauses(std::unordered_set <horn_constraint<T> *> &horn_constraints) const {
+		for(auto horn_constraint_itrator = horn_constraints.begin(); horn_constraint_itrator != horn_constraints.end(); horn_constraint_itrator++) {
+			if((*horn_constraint_itrator)->_satisfiable == true) {
+				horn_constraints.erase(horn_constraint_itrator);
+				if (!horn_constraints.empty()) {
+					horn_constraint_itrator = horn_constraints.begin();
+				} else {
+					break;
+				}
+			}
+		}
+	}
+
 	template <class T>
 	void horn_solver<T>::remove_from_vector (std::vector <datapoint<T> *> &vector_of_objects, datapoint<T> *object_to_romove) const {
 		for( unsigned i =0; i < vector_of_objects.size();) {
@@ -92,7 +107,7 @@ namespace horn_verification
 	void horn_solver<T>::compute_current_marking () const{
 		for(unsigned i = 0; i <_copy_of_horn_constraints.size(); i++) {
 			if (!_copy_of_horn_constraints.at(i)._satisfiable) {
-				_copy_of_horn_constraints.at(i).compute_marking();
+				_copy_of_horn_constraints.at(i).compute_marking(_markings, _horn_constraints_of);
 			}
 		}
 	}
@@ -124,21 +139,21 @@ namespace horn_verification
 		for(unsigned i = 0; i < datapoints.size();i++){
 			datapoints.at(i)->_classification = _copy_of_datapoints.at(i)._classification;
 			datapoints.at(i)->_is_classified = _copy_of_datapoints.at(i)._is_classified;
-			datapoints.at(i)->_list_of_marking.clear();
-			datapoints.at(i)->_list_of_horn_constraints.clear();
 		}
+		_markings.clear();
+		_horn_constraints_of.clear();
 	}
 
 	template <class T>
 	void horn_solver<T>::populate_meta_data (const std::vector<datapoint<T> *> &datapoints, std::vector<horn_constraint<T> > &horn_constraints) const {
 		for(unsigned i = 0; i < datapoints.size();i++){ /* assign defualt marking */
-			datapoints.at(i)->_list_of_marking.insert(datapoints.at(i));
+			_markings[datapoints.at(i)].insert(datapoints.at(i));
 		}
 		for(unsigned i = 0; i < horn_constraints.size();i++){ /* setting list_of_horn_constraints */
 			if (horn_constraints.at(i)._satisfiable == false) {
-				horn_constraints.at(i)._conclusion->_list_of_horn_constraints.insert(&horn_constraints.at(i));
+				_horn_constraints_of[horn_constraints.at(i)._conclusion].insert(&horn_constraints.at(i));
 				for(unsigned j = 0; j < horn_constraints.at(i)._premises.size(); j++) {
-					horn_constraints.at(i)._premises.at(j)->_list_of_horn_constraints.insert(&horn_constraints.at(i));
+					_horn_constraints_of[horn_constraints.at(i)._premises.at(j)].insert(&horn_constraints.at(i));
 				}
 			}
 		}
@@ -150,11 +165,11 @@ namespace horn_verification
 		_copy_of_negative.clear();
 		_copy_of_datapoints.clear();
 		_copy_of_horn_constraints.clear();
-		_false_datapoint._list_of_marking.clear();
+		_markings.erase(&_false_datapoint);
 		_false_datapoint.set_classification(false);
-		_false_datapoint._list_of_horn_constraints.clear();
-		assert(_false_datapoint._list_of_marking.size() == 0);
-		assert(_false_datapoint._list_of_horn_constraints.size() == 0);
+		_horn_constraints_of.erase(&_false_datapoint);
+		assert(_markings.count(&_false_datapoint) == 0);
+		assert(_horn_constraints_of.count(&_false_datapoint) == 0);
 		if(!positive.empty()){
 			_copy_of_positive.reserve(positive.size());
 		}
@@ -228,7 +243,7 @@ namespace horn_verification
 			if(copy_of_horn_constraint._satisfiable == false){
 				_copy_of_horn_constraints.push_back(copy_of_horn_constraint);
 				if(horn_constraints.at(i)._conclusion == NULL) {
-					_false_datapoint._list_of_horn_constraints.insert(&_copy_of_horn_constraints.at(_copy_of_horn_constraints.size() - 1));
+					_horn_constraints_of[&_false_datapoint].insert(&_copy_of_horn_constraints.at(_copy_of_horn_constraints.size() - 1));
 				}
 			}
 		}
@@ -327,8 +342,8 @@ namespace horn_verification
 			_copy_of_negative.clear();
 			_copy_of_datapoints.clear();
 			_copy_of_horn_constraints.clear();
-			_false_datapoint._list_of_marking.clear();
-			_false_datapoint._list_of_horn_constraints.clear();
+			_markings.erase(&_false_datapoint);
+			_horn_constraints_of.erase(&_false_datapoint);
 			/*gettimeofday(&end_time, NULL);
 			elapsed_time.tv_sec = elapsed_time.tv_sec + end_time.tv_sec - start_time.tv_sec;
 			elapsed_time.tv_usec = elapsed_time.tv_usec + end_time.tv_usec - start_time.tv_usec;*/
@@ -349,8 +364,8 @@ namespace horn_verification
 		_copy_of_negative.clear();
 		_copy_of_datapoints.clear();
 		_copy_of_horn_constraints.clear();
-		_false_datapoint._list_of_marking.clear();
-		_false_datapoint._list_of_horn_constraints.clear();
+		_markings.erase(&_false_datapoint);
+		_horn_constraints_of.erase(&_false_datapoint);
 		/*gettimeofday(&end_time, NULL);
 		elapsed_time.tv_sec = elapsed_time.tv_sec + end_time.tv_sec - start_time.tv_sec;
 		elapsed_time.tv_usec = elapsed_time.tv_usec + end_time.tv_usec - start_time.tv_usec;*/
@@ -367,10 +382,11 @@ namespace horn_verification
 		while (!worklist.empty()) {
 			datapoint<T>  *current_variable_addr = worklist.top();
 			worklist.pop();
-			if (!current_variable_addr->_list_of_horn_constraints.empty()) {
-				current_variable_addr->remove_satisfied_horn_clauses();
+			auto current_horn_constraints = _horn_constraints_of.find(current_variable_addr);
+			if (current_horn_constraints != _horn_constraints_of.end() && !current_horn_constraints->second.empty()) {
+				remove_satisfied_horn_clauses(current_horn_constraints->second);
 				if (current_variable_addr->_classification == true) {  /* propagate truth _classification */
-					for(auto horn_constraint_itrator = current_variable_addr->_list_of_horn_constraints.begin(); horn_constraint_itrator != current_variable_addr->_list_of_horn_constraints.end(); ++horn_constraint_itrator) {
+					for(auto horn_constraint_itrator = current_horn_constraints->second.begin(); horn_constraint_itrator != current_horn_constraints->second.end(); ++horn_constraint_itrator) {
 						if ((*horn_constraint_itrator)->_satisfiable ==false) {
 							if(propagate_true_classification ((*horn_constraint_itrator), current_variable_addr, positive) == false){
 								return false;
@@ -378,7 +394,7 @@ namespace horn_verification
 						}
 					}
 				} else {  /* propagation of false _classification */
-					for(auto horn_constraint_itrator = current_variable_addr->_list_of_horn_constraints.begin(); horn_constraint_itrator != current_variable_addr->_list_of_horn_constraints.end(); ++horn_constraint_itrator) {
+					for(auto horn_constraint_itrator = current_horn_constraints->second.begin(); horn_constraint_itrator != current_horn_constraints->second.end(); ++horn_constraint_itrator) {
 						if ((*horn_constraint_itrator)->_satisfiable ==false) {
 							if(propagate_false_classification ((*horn_constraint_itrator), current_variable_addr, negative) == false) {
 								return false;
@@ -0,0 +1,450 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// C++ includes
+#include <algorithm>
+#include <cassert>
+
+// Project includes
+#include "incremental_horn_solver.h"
+
+namespace horn_verification
+{
+	template <class T>
+	incremental_horn_solver<T>::~incremental_horn_solver() {}
+
+	template <class T>
+	void incremental_horn_solver<T>::next_generation() {
+		_generation++;
+	}
+
+	template <class T>
+	unsigned long incremental_horn_solver<T>::generation() const {
+		return _generation;
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::checkpoint() {
+		assert (_trail_limits.empty() && !_base_conflict);
+		_checkpoint_generation = _built_generation == _generation ? _generation : 0;
+		_checkpoint_trail = _trail.size();
+		_checkpoint_clauses = _clauses.size();
+		_checkpoint_base_derived = _base_derived.size();
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::rollback() {
+		if (_checkpoint_generation != _generation || _built_generation != _generation) {  /* rebuilt at the next call anyway */
+			return;
+		}
+		backtrack(0);
+		while (_trail.size() > _checkpoint_trail) {
+			_values[_trail.back()] = UNASSIGNED;
+			_trail.pop_back();
+		}
+		_propagation_head = _trail.size();
+
+		/* Remove the clauses added since (the lists of clauses of a variable are ordered by clause) */
+		while (_clauses.size() > _checkpoint_clauses) {
+			unsigned clause = _clauses.size() - 1;
+			const auto &literals = _clauses.back();
+			for (std::size_t k = 0; k < 2; k++) {
+				auto &watch_list = _watches[literals[k]];
+				watch_list.erase(std::find(watch_list.begin(), watch_list.end(), clause));
+			}
+			for (std::size_t k = 0; k < literals.size(); k++) {
+				if (literals[k] & 1) {
+					_clauses_with_premise[literals[k] >> 1].pop_back();
+				}
+			}
+			_clauses_with_conclusion[_conclusions.back()].pop_back();
+			_clauses.pop_back();
+			_conclusions.pop_back();
+		}
+
+		_base_conflict = false;
+		_base_derived.resize(_checkpoint_base_derived);
+		_pending.clear();
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::extend(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints) {
+		if (_built_generation != _generation) {  /* built at the next call anyway */
+			return;
+		}
+		assert (_trail_limits.empty());
+		std::size_t trail_start = _trail.size();
+		std::size_t first_clause = _clauses.size();
+
+		for (const auto datapoint_addr : datapoints) {
+			auto index_itrator = _point_index.find(datapoint_addr);
+			if (index_itrator == _point_index.end()) {
+				index_of(datapoint_addr);
+			} else if (datapoint_addr->_is_classified && !enqueue(index_itrator->second, datapoint_addr->_classification)) {
+				_base_conflict = true;
+			}
+		}
+		for (const auto &constraint : horn_constraints) {
+			add_clause(constraint);
+		}
+
+		if (_base_conflict) {
+			return;
+		}
+		_base_conflict = !propagate() || !assign_implied_negatives(trail_start, first_clause);
+		for (std::size_t i = trail_start; i < _trail.size(); i++) {
+			if (!_points[_trail[i]]->_is_classified) {
+				_base_derived.push_back(_trail[i]);
+			}
+		}
+	}
+
+	template <class T>
+	unsigned incremental_horn_solver<T>::index_of(datapoint<T> *datapoint_addr) {
+		auto index_itrator = _point_index.find(datapoint_addr);
+		if (index_itrator != _point_index.end()) {
+			return index_itrator->second;
+		}
+		unsigned variable = _points.size();
+		_points.push_back(datapoint_addr);
+		_point_index.emplace(datapoint_addr, variable);
+		_values.push_back(UNASSIGNED);
+		_is_candidate.push_back(false);
+		_clauses_with_premise.emplace_back();
+		_clauses_with_conclusion.emplace_back();
+		_watches.emplace_back();
+		_watches.emplace_back();
+		if (datapoint_addr != nullptr && datapoint_addr->_is_classified) {
+			enqueue(variable, datapoint_addr->_classification);
+		}
+		if (!_trail_limits.empty()) {  /* datapoint not contained in the vector of datapoints, level 0 is incomplete (rebuild at the next call) */
+			_built_generation = 0;
+		}
+		return variable;
+	}
+
+	template <class T>
+	char incremental_horn_solver<T>::value_of_literal(unsigned literal) const {
+		char value = _values[literal >> 1];
+		if (value == UNASSIGNED || (literal & 1) == 0) {
+			return value;
+		}
+		return value == ASSIGNED_TRUE ? ASSIGNED_FALSE : ASSIGNED_TRUE;
+	}
+
+	template <class T>
+	bool incremental_horn_solver<T>::is_satisfied(unsigned clause) const {
+		for (const auto literal : _clauses[clause]) {
+			if (value_of_literal(literal) == ASSIGNED_TRUE) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <class T>
+	bool incremental_horn_solver<T>::enqueue(unsigned variable, bool classification) {
+		char value = classification ? ASSIGNED_TRUE : ASSIGNED_FALSE;
+		if (_values[variable] != UNASSIGNED) {
+			return _values[variable] == value;
+		}
+		_values[variable] = value;
+		_trail.push_back(variable);
+		return true;
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::new_level() {
+		_trail_limits.push_back(_trail.size());
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::backtrack(std::size_t level) {
+		if (_trail_limits.size() <= level) {
+			return;
+		}
+		std::size_t limit = _trail_limits[level];
+		while (_trail.size() > limit) {
+			_values[_trail.back()] = UNASSIGNED;
+			_trail.pop_back();
+		}
+		_trail_limits.resize(level);
+		_propagation_head = _trail.size();
+	}
+
+	template <class T>
+	bool incremental_horn_solver<T>::propagate() {
+		while (_propagation_head < _trail.size()) {
+			unsigned variable = _trail[_propagation_head++];
+			unsigned false_literal = 2 * variable + (_values[variable] == ASSIGNED_TRUE ? 1 : 0);
+			auto &watch_list = _watches[false_literal];
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < watch_list.size(); i++) {
+				unsigned clause = watch_list[i];
+				auto &literals = _clauses[clause];
+				if (literals[0] == false_literal) {
+					std::swap(literals[0], literals[1]);
+				}
+				if (value_of_literal(literals[0]) == ASSIGNED_TRUE) {
+					watch_list[kept++] = clause;
+					continue;
+				}
+				bool found_new_watch = false;
+				for (std::size_t k = 2; k < literals.size(); k++) {
+					if (value_of_literal(literals[k]) != ASSIGNED_FALSE) {
+						std::swap(literals[1], literals[k]);
+						_watches[literals[1]].push_back(clause);
+						found_new_watch = true;
+						break;
+					}
+				}
+				if (found_new_watch) {
+					continue;
+				}
+				watch_list[kept++] = clause;
+				if (value_of_literal(literals[0]) == ASSIGNED_FALSE) {  /* all literals false, horn constraint violated */
+					for (i++; i < watch_list.size(); i++) {
+						watch_list[kept++] = watch_list[i];
+					}
+					watch_list.resize(kept);
+					_propagation_head = _trail.size();
+					return false;
+				}
+				enqueue(literals[0] >> 1, (literals[0] & 1) == 0);  /* unit clause */
+			}
+			watch_list.resize(kept);
+		}
+		return true;
+	}
+
+	template <class T>
+	bool incremental_horn_solver<T>::assign_implied_negatives(std::size_t trail_start, std::size_t first_clause) {
+		/* A datapoint becomes implied to be false only if it implies (together with the true datapoints) a false datapoint.
+		 * If it did not do so before the assignments starting at trail_start and the clauses starting at first_clause, it
+		 * implies either a datapoint that has been assigned false since or the conclusion of a horn constraint that has a
+		 * premise which has been assigned true since or that has been added since. Hence, only unassigned datapoints from
+		 * which one of these is reachable backwards need to be probed. */
+		std::vector<unsigned> worklist;
+		std::vector<unsigned> candidates;
+		auto add_seed = [&](unsigned variable) {
+			worklist.push_back(variable);
+		};
+		for (std::size_t clause = first_clause; clause < _clauses.size(); clause++) {
+			if (!is_satisfied(clause)) {
+				add_seed(_conclusions[clause]);
+			}
+		}
+		for (std::size_t i = trail_start; i < _trail.size(); i++) {
+			unsigned variable = _trail[i];
+			if (_values[variable] == ASSIGNED_FALSE) {
+				add_seed(variable);
+			} else {
+				for (const auto clause : _clauses_with_premise[variable]) {
+					if (!is_satisfied(clause)) {
+						add_seed(_conclusions[clause]);
+					}
+				}
+			}
+		}
+		while (!worklist.empty()) {
+			unsigned variable = worklist.back();
+			worklist.pop_back();
+			for (const auto clause : _clauses_with_conclusion[variable]) {
+				if (is_satisfied(clause)) {
+					continue;
+				}
+				for (const auto literal : _clauses[clause]) {
+					unsigned premise = literal >> 1;
+					if ((literal & 1) && _values[premise] == UNASSIGNED && !_is_candidate[premise]) {
+						_is_candidate[premise] = true;
+						candidates.push_back(premise);
+						worklist.push_back(premise);
+					}
+				}
+			}
+		}
+
+		/* Probe candidates */
+		std::vector<unsigned> implied_negatives;
+		std::size_t level = _trail_limits.size();
+		for (const auto candidate : candidates) {
+			_is_candidate[candidate] = false;
+			new_level();
+			enqueue(candidate, true);
+			bool consistent = propagate();
+			backtrack(level);
+			if (!consistent) {
+				implied_negatives.push_back(candidate);
+			}
+		}
+		for (const auto variable : implied_negatives) {
+			if (!enqueue(variable, false)) {
+				return false;
+			}
+		}
+		return propagate();
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::add_clause(const horn_constraint<T> &constraint) {
+		unsigned conclusion = constraint._conclusion == NULL ? _false_point : index_of(constraint._conclusion);
+		std::vector<unsigned> premises;
+		premises.reserve(constraint._premises.size());
+		for (unsigned j = 0; j < constraint._premises.size(); j++) {
+			premises.push_back(index_of(constraint._premises[j]));
+		}
+		std::sort(premises.begin(), premises.end());
+		premises.erase(std::unique(premises.begin(), premises.end()), premises.end());
+		if (std::binary_search(premises.begin(), premises.end(), conclusion)) {  /* trivially satisfied */
+			return;
+		}
+		if (premises.empty()) {  /* fact */
+			_base_conflict = _base_conflict || !enqueue(conclusion, true);
+			return;
+		}
+		unsigned clause = _clauses.size();
+		std::vector<unsigned> literals;
+		literals.reserve(premises.size() + 1);
+		literals.push_back(2 * conclusion);
+		for (const auto premise : premises) {
+			literals.push_back(2 * premise + 1);
+			_clauses_with_premise[premise].push_back(clause);
+		}
+		_clauses_with_conclusion[conclusion].push_back(clause);
+
+		/* Watch true literals first and false literals last, since the clause may be added after level 0 has been propagated */
+		auto rank = [this](unsigned literal) {
+			char value = value_of_literal(literal);
+			return value == ASSIGNED_TRUE ? 0 : value == UNASSIGNED ? 1 : 2;
+		};
+		std::stable_sort(literals.begin(), literals.end(), [&rank](unsigned first, unsigned second) { return rank(first) < rank(second); });
+		if (value_of_literal(literals[0]) == ASSIGNED_FALSE) {  /* all literals false, horn constraint violated */
+			_base_conflict = true;
+		} else if (value_of_literal(literals[0]) == UNASSIGNED && value_of_literal(literals[1]) == ASSIGNED_FALSE) {  /* unit clause */
+			enqueue(literals[0] >> 1, (literals[0] & 1) == 0);
+		}
+		_watches[literals[0]].push_back(clause);
+		_watches[literals[1]].push_back(clause);
+		_clauses.push_back(std::move(literals));
+		_conclusions.push_back(conclusion);
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::build(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints) {
+		_built_generation = _generation;
+		_checkpoint_generation = 0;
+		_points.clear();
+		_point_index.clear();
+		_clauses.clear();
+		_conclusions.clear();
+		_watches.clear();
+		_clauses_with_premise.clear();
+		_clauses_with_conclusion.clear();
+		_values.clear();
+		_trail.clear();
+		_trail_limits.clear();
+		_propagation_head = 0;
+		_base_conflict = false;
+		_base_derived.clear();
+		_pending.clear();
+		_is_candidate.clear();
+
+		/* Variables (level 0 assignment is the current classification) */
+		_point_index.reserve(datapoints.size());
+		for (unsigned i = 0; i < datapoints.size(); i++) {
+			index_of(datapoints[i]);
+		}
+		_false_point = index_of(nullptr);
+		enqueue(_false_point, false);
+
+		/* Clauses */
+		_clauses.reserve(horn_constraints.size());
+		_conclusions.reserve(horn_constraints.size());
+		for (unsigned i = 0; i < horn_constraints.size(); i++) {
+			add_clause(horn_constraints[i]);
+		}
+
+		/* Propagate level 0 */
+		_base_conflict = _base_conflict || !propagate() || !assign_implied_negatives(0, _clauses.size());
+		for (const auto variable : _trail) {
+			if (_points[variable] != nullptr && !_points[variable]->_is_classified) {
+				_base_derived.push_back(variable);
+			}
+		}
+	}
+
+	template <class T>
+	void incremental_horn_solver<T>::synchronize() {
+		std::size_t trail_start = _trail.size();
+		for (const auto variable : _pending) {
+			datapoint<T> *datapoint_addr = _points[variable];
+			if (datapoint_addr->_is_classified && !enqueue(variable, datapoint_addr->_classification)) {
+				_base_conflict = true;
+			}
+		}
+		_pending.clear();
+		if (trail_start == _trail.size() || _base_conflict) {
+			return;
+		}
+		_base_conflict = !propagate() || !assign_implied_negatives(trail_start, _clauses.size());
+		for (std::size_t i = trail_start; i < _trail.size(); i++) {
+			if (!_points[_trail[i]]->_is_classified) {
+				_base_derived.push_back(_trail[i]);
+			}
+		}
+	}
+
+	template <class T>
+	bool incremental_horn_solver<T>::solve(const std::vector<datapoint<T> *> &datapoints, const std::vector<horn_constraint<T> > &horn_constraints, std::unordered_set <datapoint<T> *> &positive, std::unordered_set <datapoint<T> *> &negative) {
+		clock_t begin_clock = clock();
+		invocation_count++;
+
+		if (_built_generation != _generation) {
+			build(datapoints, horn_constraints);
+		} else {
+			synchronize();
+		}
+
+		bool satisfiable = !_base_conflict;
+		if (satisfiable) {
+			new_level();
+			std::size_t trail_start = _trail.size();
+			for (auto negative_itrator = negative.begin(); satisfiable && negative_itrator != negative.end(); negative_itrator++) {
+				satisfiable = enqueue(index_of(*negative_itrator), false);
+			}
+			for (auto positive_itrator = positive.begin(); satisfiable && positive_itrator != positive.end(); positive_itrator++) {
+				satisfiable = enqueue(index_of(*positive_itrator), true);
+			}
+			satisfiable = satisfiable && propagate() && assign_implied_negatives(trail_start, _clauses.size());
+
+			if (satisfiable) {
+				for (std::size_t i = trail_start; i < _trail.size(); i++) {
+					unsigned variable = _trail[i];
+					if (_values[variable] == ASSIGNED_TRUE) {
+						positive.insert(_points[variable]);
+					} else {
+						negative.insert(_points[variable]);
+					}
+					_pending.push_back(variable);
+				}
+				for (const auto variable : _base_derived) {
+					if (!_points[variable]->_is_classified) {
+						if (_values[variable] == ASSIGNED_TRUE) {
+							positive.insert(_points[variable]);
+						} else {
+							negative.insert(_points[variable]);
+						}
+					}
+				}
+			}
+			backtrack(0);
+		}
+
+		clock_t end_clock = clock();
+		elapsed_time = elapsed_time + end_clock - begin_clock;
+		return satisfiable;
+	}
+
+	template class incremental_horn_solver<bool>;
+};
@@ -15,7 +15,33 @@
 namespace horn_verification
 {
 
-	std::vector<slice> categorical_split_job::run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata)
+	void node_job::run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata, node_arena & arena, std::vector<slice> & new_slices)
+	{
+		
+		switch (_kind)
+		{
+			
+			case CATEGORICAL_SPLIT:
+				run_categorical_split(datapoint_ptrs, metadata, arena, new_slices);
+				break;
+			
+			case INT_SPLIT:
+				run_int_split(datapoint_ptrs, arena, new_slices);
+				break;
+			
+			case LEAF_CREATION:
+				run_leaf_creation(arena);
+				break;
+			
+			default:
+				assert (false);
+			
+		}
+		
+	}
+
+
+	void node_job::run_categorical_split(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata, node_arena & arena, std::vector<slice> & new_slices)
 	{
 
 		// 0) Check parameters
@@ -23,16 +49,23 @@ namespace horn_verification
 		//assert (_slice._left_index < _slice._right_index); 
 		
 		// 1) Sort datapoints 
-		auto comparer = [this](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_categorical_data[this->_attribute] < b->_categorical_data[this->_attribute]; };
-		std::sort(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, comparer);
+		if (!_is_sorted)
+		{
+			auto comparer = [this](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_categorical_data[this->_attribute] < b->_categorical_data[this->_attribute]; };
+			std::sort(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, comparer);
+		}
 		//for_each(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, [](const datapoint<bool> * dp) { std::cout << *dp << std::endl; });
 	
 		// 2) Create new categorical node
-		auto new_node = new categorical_node(_attribute, metadata.number_of_categories()[_attribute]);
+		auto new_node = arena.new_categorical_node(_attribute, metadata.number_of_categories()[_attribute]);
 		*(_slice._node_ptr) = new_node;
 	
-		// 3) Create new tasks 
-		auto new_slices = std::vector<slice>();
+		// 3) Create new tasks (and pass on the corresponding children of a previously learned tree, if it made the same split)
+		auto previous_node = dynamic_cast<categorical_node *>(_slice._previous_node);
+		if (previous_node && previous_node->attribute() != _attribute)
+		{
+			previous_node = nullptr;
+		}
 		
 		auto cur_left = _slice._left_index;
 		auto cur_right = cur_left;
@@ -47,26 +80,27 @@ namespace horn_verification
 				++cur_right;
 			}
 			
-			new_slices.push_back(slice(cur_left, cur_right, new_node->children().data() + cur_category));
+			new_slices.push_back(slice(cur_left, cur_right, new_node->children().data() + cur_category, previous_node ? previous_node->children()[cur_category] : nullptr));
 			
 			cur_left = cur_right + 1;
 			cur_right = cur_left;
 			
 		}
-		
-		return new_slices;
 	
 	}
 
-	std::vector<slice> int_split_job::run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata)
+	void node_job::run_int_split(std::vector<datapoint<bool> *> & datapoint_ptrs, node_arena & arena, std::vector<slice> & new_slices)
 	{
 	
 		// 0) Check parameters
 		assert (_slice._left_index < _slice._right_index);
 	
 		// 1) Sort datapoints 
-		auto comparer = [this](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[this->_attribute] < b->_int_data[this->_attribute]; };
-		std::sort(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, comparer);
+		if (!_is_sorted)
+		{
+			auto comparer = [this](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[this->_attribute] < b->_int_data[this->_attribute]; };
+			std::sort(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, comparer);
+		}
 		//auto pos = _slice._left_index;
 		//for_each(datapoint_ptrs.begin() + _slice._left_index, datapoint_ptrs.begin() + _slice._right_index + 1, [&pos](const datapoint<bool> * dp) { std::cout << (pos++) << ": " << *dp << std::endl; });
 	
@@ -80,28 +114,30 @@ namespace horn_verification
 		}
 	
 		// 3) Create new int node
-		auto new_node = new int_node(_attribute, _threshold);
+		auto new_node = arena.new_int_node(_attribute, _threshold);
 		*(_slice._node_ptr) = new_node;
 			
-		// 4) Return new slices
-		auto new_slices = std::vector<slice>();
-		//new_slices.reserve(2);
-		new_slices.push_back(slice(_slice._left_index, split_at_index, new_node->children().data()));
-		new_slices.push_back(slice(split_at_index + 1, _slice._right_index, new_node->children().data() + 1));
+		// 4) Add new slices (and pass on the corresponding children of a previously learned tree, if it made the same split)
+		auto previous_node = dynamic_cast<int_node *>(_slice._previous_node);
+		if (previous_node && (previous_node->attribute() != _attribute || previous_node->threshold() != _threshold))
+		{
+			previous_node = nullptr;
+		}
 		
-		return new_slices;
+		new_slices.push_back(slice(_slice._left_index, split_at_index, new_node->children().data(), previous_node ? previous_node->children()[0] : nullptr));
+		new_slices.push_back(slice(split_at_index + 1, _slice._right_index, new_node->children().data() + 1, previous_node ? previous_node->children()[1] : nullptr));
 	
 	}
 
 	
-	std::vector<slice> leaf_creation_job::run(std::vector<datapoint<bool> *> & datapoint_ptrs, const attributes_metadata & metadata)
+	void node_job::run_leaf_creation(node_arena & arena)
 	{
 		
 		// 0) Check parameters
 		assert (_slice._left_index <= _slice._right_index);
 		
 		// 1) Create new leaf node
-		*(_slice._node_ptr) = new leaf_node(_label);
+		*(_slice._node_ptr) = arena.new_leaf_node(_label);
 		
 		// 2) Apply positive and negative labels of data points
 		for (auto & dp : _positive_ptrs)
@@ -115,8 +151,6 @@ namespace horn_verification
 			dp->_classification = false;
 		}
 		
-		return std::vector<slice>();
-		
 	}
 
 }; // End namespace horn_verification
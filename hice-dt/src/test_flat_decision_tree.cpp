@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Regression test for the compiled form of decision trees. The test builds random decision trees of various depths
+ * (with integer and categorical nodes) and random data points, and checks that the flat decision tree classifies
+ * every data point as the output visitor does, both from a vector of data points and from a columnar sample.
+ */
+
+// C++ includes
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Project includes
+#include "columnar_sample.h"
+#include "datapoint.h"
+#include "decision_tree.h"
+#include "flat_decision_tree.h"
+#include "output_visitor.h"
+
+using namespace horn_verification;
+
+const std::size_t number_of_int_attributes = 4;
+const std::size_t number_of_categories = 3;
+
+/* Build a random tree of at most the given depth */
+base_node * random_tree(std::mt19937 & generator, unsigned depth) {
+	std::uniform_int_distribution<int> kind(0, 3);
+	auto k = depth == 0 ? 0 : kind(generator);
+	if (k == 0) {
+		return new leaf_node(generator() % 2 == 0);
+	} else if (k == 1) {
+		auto node = new categorical_node(0, number_of_categories);
+		for (auto & child : node->children()) {
+			child = random_tree(generator, depth - 1);
+		}
+		return node;
+	} else {
+		auto node = new int_node(generator() % number_of_int_attributes, std::uniform_int_distribution<int>(-5, 5)(generator));
+		for (auto & child : node->children()) {
+			child = random_tree(generator, depth - 1);
+		}
+		return node;
+	}
+}
+
+int main(int argc, char* argv[]) {
+
+	unsigned number_of_trees = argc > 1 ? std::atoi(argv[1]) : 200;
+	unsigned compared_points = 0;
+	unsigned mismatches = 0;
+
+	for (unsigned seed = 0; seed < number_of_trees; seed++) {
+		std::mt19937 generator(seed);
+		decision_tree tree(random_tree(generator, seed % 12));
+
+		/* a number of points that is not a multiple of the block size */
+		std::vector<datapoint<bool>> datapoints(1 + generator() % 300);
+		std::vector<datapoint<bool> *> datapoint_ptrs;
+		std::uniform_int_distribution<int> value(-8, 8);
+		for (auto & dp : datapoints) {
+			dp._categorical_data.assign(1, generator() % number_of_categories);
+			for (std::size_t i = 0; i < number_of_int_attributes; ++i) {
+				dp._int_data.push_back(value(generator));
+			}
+			datapoint_ptrs.push_back(&dp);
+		}
+
+		flat_decision_tree flat_tree(*tree.root());
+		auto outputs = flat_tree.classify(datapoint_ptrs);
+		auto columnar_outputs = flat_tree.classify(columnar_sample(datapoint_ptrs));
+
+		output_visitor v;
+		for (std::size_t row = 0; row < datapoints.size(); ++row) {
+			bool expected = v.output(*tree.root(), datapoints[row]);
+			if (flat_decision_tree::bit(outputs, row) != expected || flat_decision_tree::bit(columnar_outputs, row) != expected || flat_tree.output(datapoints[row]) != expected) {
+				mismatches++;
+			}
+			compared_points++;
+		}
+	}
+
+	std::cout << "Compared points: " << compared_points << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+
+	return compared_points > 0 && mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,227 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Regression test for the incremental Horn solver on a recorded sample (by default on fixtures/counter, a small sample of
+ * a counter loop, and on fixtures/nested_branches, a sample of 1761 datapoints and 1413 Horn constraints recorded by
+ * chc_verifier on benchmarks/sequentialPrograms/08.c.smt2). The test replays the calls the learner makes, as bench_horn_solver does, and checks that horn_solver and
+ * incremental_horn_solver give the same answers. Between rounds of calls, the sample is changed in place (a Horn
+ * constraint is replaced by another one and the classifications are restored), which keeps the address and the size of
+ * both vectors. After next_generation(), the incremental solver has to answer as horn_solver does on the changed sample.
+ * Finally, the sample is grown from half of its Horn constraints as the learner's sample grows across rounds: after every
+ * round, the incremental solver is rolled back to its checkpoint and extended by new Horn constraints and classifications.
+ */
+
+// C++ includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Project includes
+#include "boogie_io.h"
+#include "horn_solver.h"
+#include "incremental_horn_solver.h"
+
+using namespace horn_verification;
+
+/* Number of calls compared and number of calls whose answers differ */
+unsigned compared_calls = 0;
+unsigned mismatches = 0;
+
+/* Ask both solvers the same question and return the answer of the incremental solver */
+bool compare(horn_solver<bool> & old_solver, incremental_horn_solver<bool> & new_solver, std::vector<datapoint<bool> *> & datapoint_ptrs, std::vector<horn_constraint<bool> > & horn_constraints,
+		const std::unordered_set<datapoint<bool> *> & positive, const std::unordered_set<datapoint<bool> *> & negative, std::unordered_set<datapoint<bool> *> & result_positive, std::unordered_set<datapoint<bool> *> & result_negative) {
+	auto old_positive = positive;
+	auto old_negative = negative;
+	bool old_result = old_solver.solve(datapoint_ptrs, horn_constraints, old_positive, old_negative);
+
+	result_positive = positive;
+	result_negative = negative;
+	bool new_result = new_solver.solve(datapoint_ptrs, horn_constraints, result_positive, result_negative);
+
+	compared_calls++;
+	if (old_result != new_result || (old_result && (old_positive != result_positive || old_negative != result_negative))) {
+		mismatches++;
+	}
+	return new_result;
+}
+
+/* Label the given datapoints */
+void apply(const std::unordered_set<datapoint<bool> *> & positive, const std::unordered_set<datapoint<bool> *> & negative) {
+	for (auto dp : positive) {
+		dp->set_classification(true);
+	}
+	for (auto dp : negative) {
+		dp->set_classification(false);
+	}
+}
+
+/* Tentative labelings of slices, whose result is applied from time to time (as when creating a leaf) */
+void label_slices(horn_solver<bool> & old_solver, incremental_horn_solver<bool> & new_solver, std::vector<datapoint<bool> *> & datapoint_ptrs, std::vector<horn_constraint<bool> > & horn_constraints, std::mt19937 & generator) {
+	for (unsigned call = 0; call < 20; call++) {
+		std::vector<datapoint<bool> *> unclassified;
+		for (auto dp : datapoint_ptrs) {
+			if (!dp->_is_classified) {
+				unclassified.push_back(dp);
+			}
+		}
+		if (unclassified.empty()) {
+			break;
+		}
+		std::shuffle(unclassified.begin(), unclassified.end(), generator);
+		unclassified.resize(1 + generator() % std::min<std::size_t>(unclassified.size(), 4));
+
+		for (bool label : {true, false}) {
+			std::unordered_set<datapoint<bool> *> slice(unclassified.begin(), unclassified.end());
+			std::unordered_set<datapoint<bool> *> empty;
+			std::unordered_set<datapoint<bool> *> result_positive, result_negative;
+			bool ok = label ? compare(old_solver, new_solver, datapoint_ptrs, horn_constraints, slice, empty, result_positive, result_negative) :
+				compare(old_solver, new_solver, datapoint_ptrs, horn_constraints, empty, slice, result_positive, result_negative);
+			if (ok) {
+				if (generator() % 4 == 0) {
+					apply(result_positive, result_negative);
+				}
+				break;
+			}
+		}
+	}
+}
+
+/* Run the test on one recorded sample and return whether it passed */
+bool run_test(const std::string & file_stem, unsigned number_of_rounds) {
+
+	auto calls_before = compared_calls;
+	auto mismatches_before = mismatches;
+	auto metadata = boogie_io::read_attributes_file(file_stem + ".attributes");
+	auto datapoints = boogie_io::read_data_file(file_stem + ".data", metadata);
+	auto horn_indexes = boogie_io::read_horn_file(file_stem + ".horn");
+	auto horn_constraints = boogie_io::indexes2horn_constraints(horn_indexes, datapoints);
+	std::vector<datapoint<bool> *> datapoint_ptrs;
+	for (auto & dp : datapoints) {
+		datapoint_ptrs.push_back(&dp);
+	}
+	const auto original_datapoints = datapoints;
+	const auto original_horn_constraints = horn_constraints;
+
+	horn_solver<bool> old_solver;
+	incremental_horn_solver<bool> new_solver;
+	unsigned generations = 0;
+	std::mt19937 generator(0);
+
+	for (unsigned round = 0; round < number_of_rounds; round++) {
+
+		/* Change the sample in place (except in the first round): restore the classifications and replace a Horn constraint
+		 * by one between random datapoints, which may also make the Horn constraints contradictory */
+		if (round > 0) {
+			for (std::size_t i = 0; i < datapoints.size(); i++) {
+				datapoints[i]._is_classified = original_datapoints[i]._is_classified;
+				datapoints[i]._classification = original_datapoints[i]._classification;
+			}
+			std::copy(original_horn_constraints.begin(), original_horn_constraints.end(), horn_constraints.begin());
+			auto & constraint = horn_constraints[generator() % horn_constraints.size()];
+			constraint._premises.assign(1, datapoint_ptrs[generator() % datapoint_ptrs.size()]);
+			constraint._size_of_premises = 1;
+			constraint._conclusion = generator() % 4 == 0 ? nullptr : datapoint_ptrs[generator() % datapoint_ptrs.size()];
+
+			auto generation = new_solver.generation();
+			new_solver.next_generation();
+			generations += new_solver.generation() > generation ? 1 : 0;
+		}
+
+		/* Initial run, whose result is applied to the datapoints */
+		std::unordered_set<datapoint<bool> *> positive, negative;
+		if (!compare(old_solver, new_solver, datapoint_ptrs, horn_constraints, std::unordered_set<datapoint<bool> *>(), std::unordered_set<datapoint<bool> *>(), positive, negative)) {
+			continue;
+		}
+		apply(positive, negative);
+
+		label_slices(old_solver, new_solver, datapoint_ptrs, horn_constraints, generator);
+	}
+
+	/* Grow the sample: start with half of the Horn constraints and, in every round, roll back to the state after the initial
+	 * run, then add further Horn constraints and classify a datapoint as it is classified in the original sample. From time to
+	 * time, a Horn constraint without conclusion over the datapoints of another one is added, whose premises are then implied
+	 * to be false (which may also make the Horn constraints contradictory) */
+	for (std::size_t i = 0; i < datapoints.size(); i++) {
+		datapoints[i]._is_classified = false;
+	}
+	std::vector<horn_constraint<bool> > grown_constraints(original_horn_constraints.begin(), original_horn_constraints.begin() + original_horn_constraints.size() / 2);
+	auto next_constraint = grown_constraints.size();
+	std::vector<std::pair<bool, bool> > labels(datapoints.size());
+	incremental_horn_solver<bool> grown_solver;
+	unsigned extensions = 0;
+
+	for (unsigned round = 0; round < number_of_rounds; round++) {
+
+		if (round > 0) {
+			for (std::size_t i = 0; i < datapoints.size(); i++) {
+				datapoints[i]._is_classified = labels[i].first;
+				datapoints[i]._classification = labels[i].second;
+			}
+			grown_solver.rollback();
+
+			std::vector<datapoint<bool> *> classified;
+			auto i = generator() % datapoints.size();
+			if (original_datapoints[i]._is_classified && !datapoints[i]._is_classified) {
+				datapoints[i].set_classification(original_datapoints[i]._classification);
+				classified.push_back(&datapoints[i]);
+			}
+			auto end = std::min(original_horn_constraints.size(), next_constraint + 1 + generator() % 3);
+			std::vector<horn_constraint<bool> > new_constraints(original_horn_constraints.begin() + next_constraint, original_horn_constraints.begin() + end);
+			next_constraint = end;
+			const auto & constraint = original_horn_constraints[generator() % original_horn_constraints.size()];
+			if (generator() % 4 == 0 && constraint._conclusion != nullptr) {
+				auto premises = constraint._premises;
+				premises.push_back(constraint._conclusion);
+				new_constraints.emplace_back(premises, nullptr);
+			}
+			grown_constraints.insert(grown_constraints.end(), new_constraints.begin(), new_constraints.end());
+
+			grown_solver.extend(classified, new_constraints);
+			extensions++;
+		}
+
+		/* Initial run, whose result is applied to the datapoints and saved */
+		std::unordered_set<datapoint<bool> *> positive, negative;
+		if (!compare(old_solver, grown_solver, datapoint_ptrs, grown_constraints, std::unordered_set<datapoint<bool> *>(), std::unordered_set<datapoint<bool> *>(), positive, negative)) {
+			break;
+		}
+		apply(positive, negative);
+		for (std::size_t i = 0; i < datapoints.size(); i++) {
+			labels[i] = std::make_pair(datapoints[i]._is_classified, datapoints[i]._classification);
+		}
+		grown_solver.checkpoint();
+
+		label_slices(old_solver, grown_solver, datapoint_ptrs, grown_constraints, generator);
+	}
+
+	std::cout << file_stem << std::endl;
+	std::cout << "Compared calls: " << compared_calls - calls_before << std::endl;
+	std::cout << "Generations: " << generations << std::endl;
+	std::cout << "Extensions: " << extensions << std::endl;
+	std::cout << "Mismatches: " << mismatches - mismatches_before << std::endl;
+
+	return compared_calls > calls_before && generations + 1 == number_of_rounds && extensions > 0 && mismatches == mismatches_before;
+}
+
+int main(int argc, char* argv[]) {
+
+	unsigned number_of_rounds = argc > 2 ? std::atoi(argv[2]) : 50;
+	std::vector<std::string> file_stems;
+	if (argc > 1) {
+		file_stems.push_back(argv[1]);
+	} else {
+		file_stems = { "fixtures/counter", "fixtures/nested_branches" };
+	}
+
+	bool passed = true;
+	for (const auto & file_stem : file_stems) {
+		passed = run_test(file_stem, number_of_rounds) && passed;
+	}
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,1118 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * Regression test for the split search of the job managers, which sweeps over the thresholds of an attribute while
+ * maintaining running counts of the data points on either side. The test learns decision trees for random samples
+ * with every entropy computation and checks every split the learner makes against the split search that rescans the
+ * data points on either side of each threshold (the implementation preceding the sweep, reproduced below as
+ * reference_split()). As all splits are the same, so are the learned trees.
+ *
+ * The test also checks the selection of slices by their (weighted) entropy, which keeps the pending slices in a priority
+ * queue that only rescores the slices whose data points a leaf creation labels, against the scan over all pending slices
+ * that the queue replaces (reproduced below in scan_checked_job_manager). Samples with few classified data points, whose
+ * Horn constraints label many points, and small slices make both rescoring and ties among the scores frequent.
+ */
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Project includes
+#include "attributes_metadata.h"
+#include "error.h"
+#include "incremental_horn_solver.h"
+#include "learner.h"
+#include "simple_job_manager.h"
+
+using namespace horn_verification;
+
+/* A split chosen by the split search */
+struct split_choice {
+	bool is_int_split;
+	std::size_t attribute;
+	int threshold;
+
+	bool operator==(const split_choice & other) const {
+		return is_int_split == other.is_int_split && attribute == other.attribute && (!is_int_split || threshold == other.threshold);
+	}
+};
+
+/* Number of splits compared and number of splits that differ */
+unsigned compared_splits = 0;
+unsigned mismatches = 0;
+
+/* Return whether a job is a split and, if so, the split it performs */
+bool split_of(const node_job & job, split_choice & split) {
+	if (job.kind() == node_job::INT_SPLIT) {
+		split = split_choice { true, job.attribute(), job.threshold() };
+		return true;
+	}
+	if (job.kind() == node_job::CATEGORICAL_SPLIT) {
+		split = split_choice { false, job.attribute(), 0 };
+		return true;
+	}
+	return false;
+}
+
+/* Simple job manager that provides the split search preceding the sweep */
+class reference_simple_job_manager : public simple_job_manager {
+public:
+	reference_simple_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, int threshold)
+		: simple_job_manager(datapoint_ptrs, horn_constraints, solver) {
+		if (threshold >= 0) {
+			_threshold = threshold;
+			_are_numerical_cuts_thresholded = true;
+		}
+	}
+
+	split_choice reference_split(const slice & sl)
+	{
+		
+		assert (sl._left_index <= sl._right_index && sl._right_index < _datapoint_ptrs.size());
+
+		// 0) Initialize variables
+		bool int_split_possible = false;
+		double best_int_gain_ratio = 0;
+		std::size_t best_int_attribute = 0;
+		int best_int_threshold = 0;
+
+		bool cat_split_possible = false;
+		double best_cat_gain_ratio = 0;
+		std::size_t best_cat_attribute = 0;
+
+		
+		//
+		// Process categorical attributes
+		//
+		for (std::size_t attribute = 0; attribute < _datapoint_ptrs[sl._left_index]->_categorical_data.size(); ++attribute)
+		{
+		
+			// 1) Sort according to categorical attribute
+			auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_categorical_data[attribute] < b->_categorical_data[attribute]; };
+			std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
+			
+			
+			// 2) sum all weighted entropies
+			double total_weighted_entropy = 0;
+			double total_intrinsic_value = 0;
+			bool split_possible = true;
+			auto cur_left = sl._left_index;
+			auto cur_right = cur_left;
+
+			while (cur_right <= sl._right_index)
+			{
+			
+				auto cur_category = _datapoint_ptrs[cur_left]->_categorical_data[attribute];
+
+				while (cur_right + 1 <= sl._right_index && cur_category == _datapoint_ptrs[cur_right + 1]->_categorical_data[attribute])
+				{
+					++cur_right;
+				}
+		
+		
+				// If only one category, skip attribute
+				if (cur_left == sl._left_index && cur_right == sl._right_index)
+				{
+					split_possible = false;
+					break;
+				}
+				else
+				{
+					total_weighted_entropy += weighted_entropy(_datapoint_ptrs, cur_left, cur_right);
+
+					double n1 = 1.0 * num_classified_points(_datapoint_ptrs, cur_left, cur_right);
+					double n = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+					total_intrinsic_value += (n1 == 0) ? 0.0 : -1.0 * (n1/n) * log2(n1/n);
+
+					cur_left = cur_right + 1;
+					cur_right = cur_left;
+				}
+			}
+			if (split_possible)
+			{
+				double info_gain;
+                                        if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0)
+                                        {
+                                                info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index);
+                                        }
+                                        else
+                                        {
+                                                info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
+                                                                total_weighted_entropy / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+
+                                        }
+
+				assert (total_intrinsic_value > 0.0);
+				double gain_ratio = info_gain / total_intrinsic_value;
+				// split is possible on the current "attribute"
+				if (! cat_split_possible || gain_ratio > best_cat_gain_ratio)
+				{
+					cat_split_possible = true;
+					best_cat_gain_ratio = gain_ratio;
+					best_cat_attribute = attribute;
+				}
+			}
+			
+		}
+		
+		//std::cout << "Now processing integer splits" << std::endl;
+		//
+		// Process integer attributes
+		//
+		for (std::size_t attribute = 0; attribute < _datapoint_ptrs[sl._left_index]->_int_data.size(); ++attribute)
+		{
+			int tries = 0;
+			double best_int_entropy_for_given_attribute = 1000000;
+			bool int_split_possible_for_given_attribute = false;
+			int best_int_split_index_for_given_attribute = 0;
+			double best_intrinsic_value_for_given_attribute = 0;
+
+
+			// 1) Sort according to int attribute
+			auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[attribute] < b->_int_data[attribute]; };
+			std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
+			
+			
+			// 2) Try all thresholds of current attribute
+			auto cur = sl._left_index;
+			while (cur < sl._right_index)
+			{
+			
+				// Skip to riight most entry with the same value
+				while (cur + 1 <= sl._right_index && _datapoint_ptrs[cur + 1]->_int_data[attribute] == _datapoint_ptrs[cur]->_int_data[attribute])
+				{
+					++cur;
+				}
+
+				// Split is possible
+				if (cur < sl._right_index)
+				{
+					tries++;
+
+
+					// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
+					if (! _are_numerical_cuts_thresholded || \
+						       	((-1 * _threshold <= _datapoint_ptrs[cur]->_int_data[attribute]) && \
+									       (_datapoint_ptrs[cur]->_int_data[attribute] <= _threshold)))
+					{
+
+						//std::cout << "considering attribute: " << attribute << " sl._left_index: " << cur << " cut: " << _datapoint_ptrs[cur]->_int_data[attribute] << std::endl;
+						// weighted_entropy_left = H(left_node) * num_classified_points(left_node)
+						auto weighted_entropy_left = weighted_entropy(_datapoint_ptrs, sl._left_index, cur);
+						// weighted_entropy_right = H(right_node) * num_classified_points(right_node)
+						auto weighted_entropy_right = weighted_entropy(_datapoint_ptrs, cur + 1, sl._right_index);
+						auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
+					
+						if (!int_split_possible_for_given_attribute || total_weighted_entropy < best_int_entropy_for_given_attribute)
+						{
+							//std::cout << "updated the entropy; split is now definitely possible" << std::endl;	
+							int_split_possible_for_given_attribute = true;
+						
+							best_int_entropy_for_given_attribute = total_weighted_entropy;
+							best_int_split_index_for_given_attribute = cur;
+
+							// computation of the intrinsic value of the attribute
+							double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
+							double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
+							double n = n1 + n2;
+							best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+                                                               		                                          (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+								
+						}
+					
+					}
+						
+					++cur;			
+				}
+				
+			}
+			if (int_split_possible_for_given_attribute)
+			{
+				// We have found the best split threshold for the given attribute
+				// Now compute the information gain to optimize across different attributes
+				double best_info_gain_for_attribute;					                                        
+				if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0.0)
+                                        {      
+                                                best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) ;
+                                        }
+                                        else
+                                        {
+                                                best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
+                                                        best_int_entropy_for_given_attribute / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);               
+                                        }
+
+				double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
+						       (_datapoint_ptrs[best_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
+						                  _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]);
+
+				assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
+				double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
+					                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+
+				best_info_gain_for_attribute -= threshCost;
+				assert (best_intrinsic_value_for_given_attribute > 0.0);
+				double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_intrinsic_value_for_given_attribute;
+
+				if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio) || \
+				    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && \
+				      std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold)))	
+				{
+					// if this is the first attribute for which a split is possible then
+					// initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+					int_split_possible = true;
+					best_int_gain_ratio = best_gain_ratio_for_given_attribute;
+					best_int_attribute = attribute;
+					best_int_threshold = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
+				}
+
+			}
+		
+		}
+
+		
+		//
+		// Return best split
+		//
+		
+		if (!int_split_possible && !cat_split_possible)
+		{
+			throw split_not_possible_error("No split possible!");
+		}
+		
+		else if (int_split_possible && !cat_split_possible)
+		{
+			return split_choice { true, best_int_attribute, best_int_threshold };
+		}
+		
+		else if (!int_split_possible && cat_split_possible)
+		{
+			return split_choice { false, best_cat_attribute, 0 };
+		}
+		
+		else
+		{
+			if (best_int_gain_ratio <= best_cat_gain_ratio)
+			{
+				return split_choice { true, best_int_attribute, best_int_threshold };
+			}
+			else
+			{
+				return split_choice { false, best_cat_attribute, 0 };
+			}
+
+		}
+	}
+};
+
+/* Complex job manager that provides the split search preceding the sweep */
+class reference_complex_job_manager : public complex_job_manager {
+	EntropyComputation _reference_entropy_computation;
+	ConjunctiveSetting _reference_conjunctive_setting;
+
+public:
+	reference_complex_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, int threshold, EntropyComputation entropy_computation, ConjunctiveSetting conjunctive_setting)
+		: complex_job_manager(datapoint_ptrs, horn_constraints, solver, BFS, entropy_computation, conjunctive_setting), _reference_entropy_computation(entropy_computation), _reference_conjunctive_setting(conjunctive_setting) {
+		if (threshold >= 0) {
+			_threshold = threshold;
+			_are_numerical_cuts_thresholded = true;
+		}
+	}
+
+	/* Weighted entropy of the data points right of a threshold (the sweep sums their fractional values from right to left) */
+	double right_weighted_entropy(std::size_t left_index, std::size_t right_index) {
+		if (_reference_entropy_computation != HORN_ASSIGNMENTS) {
+			return weighted_entropy(_datapoint_ptrs, left_index, right_index);
+		}
+		point_counts counts;
+		for (auto i = right_index + 1; i-- > left_index; ) {
+			add_point(counts, _datapoint_ptrs[i]);
+		}
+		return weighted_entropy(counts);
+	}
+
+	split_choice reference_split(const slice & sl)
+	{
+		
+		assert (sl._left_index <= sl._right_index && sl._right_index < _datapoint_ptrs.size());
+
+                        // 0) Initialize variables
+                        bool int_split_possible = false;
+		bool non_zero_intrinsic_value_possible = false;
+                        double best_int_gain_ratio = -1000000;
+                        std::size_t best_int_attribute = 0;
+                        int best_int_threshold = 0;
+                        double best_int_gain_ratio_4_zero_iv = -1000000;
+                        std::size_t best_int_attribute_4_zero_iv = 0;
+                        int best_int_threshold_4_zero_iv = 0;
+
+		// Variables to track the split if conjunctive splits are preferred	
+		bool conj_int_split_possible = false;
+		bool conj_non_zero_intrinsic_value_possible = false;
+                        double best_conj_int_gain_ratio = -1000000;
+                        std::size_t best_conj_int_attribute = 0;
+                        int best_conj_int_threshold = 0;
+                        double best_conj_int_gain_ratio_4_zero_iv = -1000000;
+                        std::size_t best_conj_int_attribute_4_zero_iv = 0;
+                        int best_conj_int_threshold_4_zero_iv = 0;
+
+                        bool cat_split_possible = false;
+                        double best_cat_gain_ratio = -1000000;
+                        std::size_t best_cat_attribute = 0;
+
+
+		//
+		// Process categorical attributes
+		//
+		for (std::size_t attribute = 0; attribute < _datapoint_ptrs[sl._left_index]->_categorical_data.size(); ++attribute)
+		{
+		
+			// 1) Sort according to categorical attribute
+			auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_categorical_data[attribute] < b->_categorical_data[attribute]; };
+			std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
+			
+			
+			// 2) sum all weighted entropies
+			double total_weighted_entropy = 0;
+			double total_intrinsic_value = 0;
+			bool split_possible = true;
+			auto cur_left = sl._left_index;
+			auto cur_right = cur_left;
+
+			while (cur_right <= sl._right_index)
+			{
+			
+				auto cur_category = _datapoint_ptrs[cur_left]->_categorical_data[attribute];
+
+				while (cur_right + 1 <= sl._right_index && cur_category == _datapoint_ptrs[cur_right + 1]->_categorical_data[attribute])
+				{
+					++cur_right;
+				}
+		
+		
+				// If only one category, skip attribute
+				if (cur_left == sl._left_index && cur_right == sl._right_index)
+				{
+					split_possible = false;
+					break;
+				}
+				else
+				{
+					total_weighted_entropy += weighted_entropy(_datapoint_ptrs, cur_left, cur_right);
+
+                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, cur_left, cur_right);
+                                                double n = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+                                                total_intrinsic_value += (n1 == 0) ? 0.0 : -1.0 * (n1/n) * log2(n1/n);
+
+					cur_left = cur_right + 1;
+					cur_right = cur_left;
+				}
+			}
+		
+                                if (split_possible)
+                                {
+				double info_gain;
+				if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0)
+				{
+					info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index);
+				}
+				else
+				{
+					info_gain = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - \
+						    	total_weighted_entropy / num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+
+				}
+				assert (total_intrinsic_value > 0.0);
+                                        double gain_ratio = info_gain / total_intrinsic_value;
+                                        // split is possible on the current "attribute"
+                                        if (! cat_split_possible || gain_ratio > best_cat_gain_ratio)
+                                        {
+                                                cat_split_possible = true;
+                                                best_cat_gain_ratio = gain_ratio;
+                                                best_cat_attribute = attribute;
+                                        }
+                                }
+
+		}
+		
+		//std::cout << "Now processing integer splits" << std::endl;
+		//
+		// Process integer attributes
+		//
+		// (only the attributes of the slice's relation: the others are constant on the slice, but sorting according to them would
+		// permute the data points and, thus, change the order in which fractional values are summed)
+		const auto attributes = int_attribute_range(sl);
+		for (std::size_t attribute = attributes.first; attribute < attributes.second; ++attribute)
+		{
+			int tries = 0;
+                                double best_int_entropy_for_given_attribute = 1000000;
+                                bool int_split_possible_for_given_attribute = false;
+                                int best_int_split_index_for_given_attribute = 0;
+                                double best_intrinsic_value_for_given_attribute = 0;
+
+			double best_conj_int_entropy_for_given_attribute = 1000000;
+                                bool conj_int_split_possible_for_given_attribute = false;
+                                int best_conj_int_split_index_for_given_attribute = 0;
+                                double best_conj_intrinsic_value_for_given_attribute = 0;
+
+
+			// 1) Sort according to int attribute
+			auto comparer = [attribute](const datapoint<bool> * const a, const datapoint<bool> * const b) { return a->_int_data[attribute] < b->_int_data[attribute]; };
+			std::sort(_datapoint_ptrs.begin() + sl._left_index, _datapoint_ptrs.begin() + sl._right_index + 1, comparer);
+			
+			
+			// 2) Try all thresholds of current attribute
+			auto cur = sl._left_index;
+			while (cur < sl._right_index)
+			{
+			
+				// Skip to riight most entry with the same value
+				while (cur + 1 <= sl._right_index && _datapoint_ptrs[cur + 1]->_int_data[attribute] == _datapoint_ptrs[cur]->_int_data[attribute])
+				{
+					++cur;
+				}
+
+				// Split is possible
+				if (cur < sl._right_index)
+				{
+                                                tries++;
+
+					// if cuts have been thresholded, check that a split at the current value of the numerical attribute is allowed
+					if (! _are_numerical_cuts_thresholded || \
+						       	((-1 * _threshold <= _datapoint_ptrs[cur]->_int_data[attribute]) && \
+									       (_datapoint_ptrs[cur]->_int_data[attribute] <= _threshold)))
+					{
+						//std::cout << "considering attribute: " << attribute << " sl._left_index: " << cur << " cut: " << _datapoint_ptrs[cur]->_int_data[attribute] << std::endl;
+						auto weighted_entropy_left = weighted_entropy(_datapoint_ptrs, sl._left_index, cur);
+						auto weighted_entropy_right = right_weighted_entropy(cur + 1, sl._right_index);
+						auto total_weighted_entropy = weighted_entropy_left + weighted_entropy_right;
+						double total_entropy; 
+						if (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) == 0.0)
+						{
+							total_entropy = 0.0;
+						}
+						else
+						{
+							total_entropy = total_weighted_entropy / \
+									     (double)num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+						}
+
+
+						// Add a penalty based on the number of implications in the horn constraints that are cut by the current split.
+						if (_reference_entropy_computation == PENALTY)
+						{
+							// number of implications in the horn constraints cut by the current split.
+							int left2right = 0;
+							int right2left = 0;
+							penalty(sl, sl._left_index, cur, sl._right_index, &left2right, &right2left);		
+							double nleft = num_points_with_classification(_datapoint_ptrs, sl._left_index, cur, false);
+							double pleft = num_points_with_classification(_datapoint_ptrs, sl._left_index, cur, true);
+							double nright = num_points_with_classification(_datapoint_ptrs, cur+1, sl._right_index, false);
+							double pright = num_points_with_classification(_datapoint_ptrs, cur+1, sl._right_index, true);
+							double total_classified_points = nleft + pleft + nright + pright;
+
+							nleft = nleft == 0 ? 0 : nleft / (nleft + pleft);
+							pleft = pleft == 0 ? 0 : pleft / (nleft + pleft);
+							nright = nright == 0 ? 0 : nright / (nright + pright);
+							pright = pright == 0 ? 0 : pright / (nright + pright);
+
+							double penaltyVal = (1 - nleft * pright) * left2right + (1 - nright * pleft) * right2left;
+							penaltyVal = 2 * penaltyVal / (2 * (left2right + right2left) + total_classified_points);
+							total_entropy += penaltyVal;
+						}
+
+
+						// If the learner prefers conjunctive splits
+						if (_reference_conjunctive_setting == PREFERENCEFORCONJUNCTS)
+						{
+							// Check if a conjunctive split is possible
+							if (! positive_points_present(_datapoint_ptrs, sl._left_index, cur) || \
+									! positive_points_present(_datapoint_ptrs, cur + 1, sl._right_index))
+							{
+								// One of the sub node consists purely of negative or unclassified points.
+								// Consider this as a prospective candidate for a conjunctive split
+		
+								if (! conj_int_split_possible_for_given_attribute || \
+										total_entropy < best_conj_int_entropy_for_given_attribute)
+								{
+									//std::cout << "updated the entropy; split is now definitely possible" << std::endl;	
+									conj_int_split_possible_for_given_attribute = true;
+						
+									best_conj_int_entropy_for_given_attribute = total_entropy;
+									best_conj_int_split_index_for_given_attribute = cur;
+
+									// computation of the intrinsic value of the attribute
+                		                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
+                                		                                double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
+                                                		                double n = n1 + n2;
+                                                                		best_conj_intrinsic_value_for_given_attribute = \
+													(n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+												        (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+
+								}
+							}
+						}
+
+						if (!int_split_possible_for_given_attribute || total_entropy < best_int_entropy_for_given_attribute)
+                                                        {
+                                                                //std::cout << "updated the entropy; split is now definitely possible" << std::endl;    
+                                                                int_split_possible_for_given_attribute = true;
+
+                                                                best_int_entropy_for_given_attribute = total_entropy;
+                                                                best_int_split_index_for_given_attribute = cur;
+
+                                                                // computation of the intrinsic value of the attribute
+                                                                double n1 = 1.0 * num_classified_points(_datapoint_ptrs, sl._left_index, cur);
+                                                                double n2 = 1.0 * num_classified_points(_datapoint_ptrs, cur + 1, sl._right_index);
+                                                                double n = n1 + n2;
+                                                                best_intrinsic_value_for_given_attribute = (n1 == 0.0 ? 0.0 : -1.0 * (n1/n) * log2(n1/n)) + \
+												       (n2 == 0.0 ? 0.0 : - 1.0 * (n2/n) * log2(n2/n));
+
+                                                        }
+
+					}
+						
+					++cur;			
+				}
+				
+			}
+
+			if (_reference_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_int_split_possible_for_given_attribute)
+                                {
+                                        // We have found the best split threshold for the given attribute
+                                        // Now compute the information gain to optimize across different attributes
+                                        double best_info_gain_for_attribute;
+				best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - best_conj_int_entropy_for_given_attribute;
+
+                                        double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
+                                                               (_datapoint_ptrs[best_conj_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
+                                                                          _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]);
+
+				assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
+                                        double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
+                                                                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+
+                                        best_info_gain_for_attribute -= threshCost;
+				if (best_conj_intrinsic_value_for_given_attribute > 0.0)
+				{
+					conj_non_zero_intrinsic_value_possible = true;
+                                        double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_conj_intrinsic_value_for_given_attribute;
+
+                                        	if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio) || \
+        	                                    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio && \
+                	                              std::abs(_datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_conj_int_threshold)))
+                        	                {
+                                	                // if this is the first attribute for which a split is possible then
+                                        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+                                                	conj_int_split_possible = true;
+                                                best_conj_int_gain_ratio = best_gain_ratio_for_given_attribute;
+        	                                        best_conj_int_attribute = attribute;
+                	                                best_conj_int_threshold = _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute];
+                        	                }
+				}
+				else
+				{
+					if (! conj_non_zero_intrinsic_value_possible)
+					{
+	                                        double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute;
+
+               	                         		if (! conj_int_split_possible || (best_gain_ratio_for_given_attribute > best_conj_int_gain_ratio_4_zero_iv) || \
+        	                                    (best_gain_ratio_for_given_attribute == best_conj_int_gain_ratio_4_zero_iv && \
+        	        	                              std::abs(_datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_conj_int_threshold_4_zero_iv)))
+                	        	                {
+                        	        	                // if this is the first attribute for which a split is possible then
+                                	        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+                                        	        	conj_int_split_possible = true;
+                                        	        best_conj_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
+        	                                        	best_conj_int_attribute_4_zero_iv = attribute;
+                	                                best_conj_int_threshold_4_zero_iv = _datapoint_ptrs[best_conj_int_split_index_for_given_attribute]->_int_data[attribute];
+        	                	                }
+						
+					}
+				}
+                                }
+
+
+                                if (int_split_possible_for_given_attribute)
+                                {
+                                        // We have found the best split threshold for the given attribute
+                                        // Now compute the information gain to optimize across different attributes
+                                        double best_info_gain_for_attribute;
+				best_info_gain_for_attribute = entropy(_datapoint_ptrs, sl._left_index, sl._right_index) - best_int_entropy_for_given_attribute;
+                                        
+				double interval = (_datapoint_ptrs[sl._right_index]->_int_data[attribute] - _datapoint_ptrs[sl._left_index]->_int_data[attribute]) / \
+                                                               (_datapoint_ptrs[best_int_split_index_for_given_attribute+1]->_int_data[attribute] - \
+                                                                          _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]);
+
+				assert (num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index) > 0);
+                                        double threshCost = ( interval < (double)tries ? log2(interval) : log2(tries) ) / \
+                                                                 num_classified_points(_datapoint_ptrs, sl._left_index, sl._right_index);
+
+                                        best_info_gain_for_attribute -= threshCost;
+				if (best_intrinsic_value_for_given_attribute > 0.0)
+				{
+					non_zero_intrinsic_value_possible = true;
+					double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute / best_intrinsic_value_for_given_attribute;
+
+                                        if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio) || \
+        	                                    (best_gain_ratio_for_given_attribute == best_int_gain_ratio && \
+                	                              std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold)))
+                        	                {
+                                	                // if this is the first attribute for which a split is possible then
+                                        	        // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+                                                	int_split_possible = true;
+                                                best_int_gain_ratio = best_gain_ratio_for_given_attribute;
+        	                                        best_int_attribute = attribute;
+                	                                best_int_threshold = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
+                        	                }
+				}
+				else
+				{
+					if (! non_zero_intrinsic_value_possible)
+					{
+						double best_gain_ratio_for_given_attribute = best_info_gain_for_attribute;
+							
+                                        		if (! int_split_possible || (best_gain_ratio_for_given_attribute > best_int_gain_ratio_4_zero_iv) || \
+	                                          (best_gain_ratio_for_given_attribute == best_int_gain_ratio_4_zero_iv && \
+                		                          std::abs(_datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute]) < std::abs(best_int_threshold_4_zero_iv)))
+                                        		{
+	                                                // if this is the first attribute for which a split is possible then
+                		                                // initialize all variables: best_int_gain_ratio, best_int_attribute, best_int_threshold
+                                		                int_split_possible = true;
+                                                		best_int_gain_ratio_4_zero_iv = best_gain_ratio_for_given_attribute;
+	                                                best_int_attribute_4_zero_iv = attribute;
+                		                                best_int_threshold_4_zero_iv = _datapoint_ptrs[best_int_split_index_for_given_attribute]->_int_data[attribute];
+                                		        }
+					}
+				}
+                                }
+
+		
+		}
+
+		
+		//
+		// Return best split
+		//
+		
+		if (!int_split_possible && !cat_split_possible)
+		{
+			assert (!conj_int_split_possible);
+			throw split_not_possible_error("No split possible!");
+		}
+		
+		else if (int_split_possible && !cat_split_possible)
+		{
+			if (_reference_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_int_split_possible)
+			{
+				if (! conj_non_zero_intrinsic_value_possible)
+				{
+					best_conj_int_gain_ratio = best_conj_int_gain_ratio_4_zero_iv;
+					best_conj_int_attribute = best_conj_int_attribute_4_zero_iv;
+					best_conj_int_threshold = best_conj_int_threshold_4_zero_iv;
+				}
+				return split_choice { true, best_conj_int_attribute, best_conj_int_threshold };
+			}
+			else
+			{
+				if (! non_zero_intrinsic_value_possible)
+				{
+                                        	best_int_gain_ratio = best_int_gain_ratio_4_zero_iv;				                  
+					best_int_attribute = best_int_attribute_4_zero_iv;
+					best_int_threshold = best_int_threshold_4_zero_iv;
+				}
+				return split_choice { true, best_int_attribute, best_int_threshold };
+			}
+		}
+		
+		else if (!int_split_possible && cat_split_possible)
+		{
+			assert (!conj_int_split_possible);
+			return split_choice { false, best_cat_attribute, 0 };
+		}
+		
+		else
+		{
+			// If conjunctive splits are preferred, overwrite the best int split variabls with those corresponding to conjunctive splits.
+			if (_reference_conjunctive_setting == PREFERENCEFORCONJUNCTS && conj_int_split_possible)
+			{
+				if (! conj_non_zero_intrinsic_value_possible)
+				{
+					best_int_gain_ratio = best_conj_int_gain_ratio_4_zero_iv;
+					best_int_attribute = best_conj_int_attribute_4_zero_iv;
+					best_int_threshold = best_conj_int_threshold_4_zero_iv;
+				}
+				else
+				{
+					best_int_gain_ratio = best_conj_int_gain_ratio;
+					best_int_attribute = best_conj_int_attribute;
+					best_int_threshold = best_conj_int_threshold;
+				}
+			}
+			else
+			{
+				if (! non_zero_intrinsic_value_possible)
+				{
+                                	       	best_int_gain_ratio = best_int_gain_ratio_4_zero_iv;				                  
+					best_int_attribute = best_int_attribute_4_zero_iv;
+					best_int_threshold = best_int_threshold_4_zero_iv;
+				}
+			}
+			if (best_int_gain_ratio <= best_cat_gain_ratio)
+			{
+				return split_choice { true, best_int_attribute, best_int_threshold };
+			}
+			else
+			{
+				return split_choice { false, best_cat_attribute, 0 };
+			}
+
+		}
+	}
+
+	void penalty(const slice & sl, std::size_t left_index, std::size_t cur_index, std::size_t right_index, int* left2right, int* right2left)
+	{
+		int _left2right = 0;
+		int _right2left = 0;
+		for (const auto & horn_clause : _horn_constraints)
+                {
+			enum Position {out_of_scope, left, right};
+			Position conclusion = out_of_scope;
+			int num_premise_left = 0;
+			int num_premise_right = 0;
+
+			// for i ranging from left_index to cur, loop over premises and conclusion
+                        for (std::size_t i = left_index; i <= cur_index; ++i)
+                        {
+				for (const auto dp : horn_clause._premises)
+				{
+					if (dp == _datapoint_ptrs[i] && !_datapoint_ptrs[i]->_is_classified)
+					{
+						num_premise_left++;	
+					}
+				}
+				if (_datapoint_ptrs[i] == horn_clause._conclusion && !_datapoint_ptrs[i]->_is_classified)
+				{
+					conclusion = left;
+				}
+			}
+
+			// for i ranging from cur+1 to right_index, loop over premises and conclusion
+                        for (std::size_t i = cur_index+1; i <= right_index; ++i)
+                        {
+				for (const auto dp : horn_clause._premises)
+				{
+					if (dp == _datapoint_ptrs[i] && !_datapoint_ptrs[i]->_is_classified)
+					{
+						num_premise_right++;	
+					}
+				}
+				if (_datapoint_ptrs[i] == horn_clause._conclusion && !_datapoint_ptrs[i]->_is_classified)
+				{
+					conclusion = right;
+				}
+			}
+			if (conclusion == left)
+			{
+				_right2left += num_premise_right;
+			}
+			if (conclusion == right)
+			{
+				_left2right += num_premise_left;
+			}
+
+		}
+		*right2left = _right2left;
+		*left2right = _left2right;
+		return;
+	}
+};
+
+/*
+ * Job manager that compares the split chosen for every slice with the reference split search. Slices are processed in
+ * breadth-first order, so the slice of the next job is the first one (after the initial split on the categorical attribute).
+ */
+template <class ReferenceJobManager> class checked_job_manager : public ReferenceJobManager {
+public:
+	template <class... Args> checked_job_manager(Args &&... args) : ReferenceJobManager(std::forward<Args>(args)...) {}
+
+	node_job next_job() {
+		auto & datapoint_ptrs = this->_datapoint_ptrs;
+		bool check = !this->_is_first_split && this->_replay_slices.empty();
+		slice sl = check ? this->_slices.front() : slice(0, 0, nullptr);
+		std::vector<datapoint<bool> *> original_order(datapoint_ptrs.begin() + sl._left_index, datapoint_ptrs.begin() + sl._right_index + 1);
+
+		node_job job;
+		split_choice chosen { false, 0, 0 };
+		bool is_split = false;
+		bool split_failed = false;
+		try {
+			job = ReferenceJobManager::next_job();
+			is_split = split_of(job, chosen);
+		} catch (const split_not_possible_error &) {
+			split_failed = true;
+		}
+
+		if (check && (is_split || split_failed)) {
+			/* Run the reference on the same order of data points and restore the order the learner continues with */
+			std::vector<datapoint<bool> *> chosen_order(datapoint_ptrs.begin() + sl._left_index, datapoint_ptrs.begin() + sl._right_index + 1);
+			std::copy(original_order.begin(), original_order.end(), datapoint_ptrs.begin() + sl._left_index);
+			split_choice expected { false, 0, 0 };
+			bool reference_failed = false;
+			try {
+				expected = this->reference_split(sl);
+			} catch (const split_not_possible_error &) {
+				reference_failed = true;
+			}
+			std::copy(chosen_order.begin(), chosen_order.end(), datapoint_ptrs.begin() + sl._left_index);
+
+			compared_splits++;
+			if (split_failed != reference_failed || (!split_failed && !(chosen == expected))) {
+				mismatches++;
+			}
+		}
+		if (split_failed) {
+			throw split_not_possible_error("No split possible!");
+		}
+		return job;
+	}
+};
+
+/* Number of slice selections compared, selections among slices with the same best score, selections after a rescoring and
+ * selections that differ */
+unsigned compared_selections = 0;
+unsigned tied_selections = 0;
+unsigned rescored_selections = 0;
+unsigned selection_mismatches = 0;
+
+/*
+ * Job manager that compares the slice selected by the queue of scored slices with the slice the scan over all pending slices
+ * selects. The manager keeps its own list of the pending slices in the order the scan visits them (the order of their addition).
+ */
+class scan_checked_job_manager : public complex_job_manager {
+	NodeSelection _reference_node_selection;
+	std::vector<slice> _pending;
+	std::vector<double> _scores_when_added;
+
+	double score(const slice & sl) {
+		return _reference_node_selection == MAX_ENTROPY || _reference_node_selection == MIN_ENTROPY ? entropy(_datapoint_ptrs, sl._left_index, sl._right_index) :
+			weighted_entropy(_datapoint_ptrs, sl._left_index, sl._right_index);
+	}
+
+	/* The scan preceding the queue, which selects the first slice with the best score (the scan used to keep the best score
+	 * as float, which made the last of several tied slices win whenever the score was rounded down) */
+	std::size_t scan() {
+		const bool is_max = _reference_node_selection == MAX_ENTROPY || _reference_node_selection == MAX_WEIGHTED_ENTROPY;
+		double best = is_max ? 0.0 : (_reference_node_selection == MIN_ENTROPY ? 1.0 : 100000.0);
+		std::size_t best_index = 0;
+		for (std::size_t i = 0; i < _pending.size(); i++) {
+			auto value = score(_pending[i]);
+			if (is_max ? value > best : value < best) {
+				best = value;
+				best_index = i;
+			}
+		}
+		return best_index;
+	}
+
+public:
+	scan_checked_job_manager(std::vector<datapoint<bool> *> & datapoint_ptrs, const std::vector<horn_constraint<bool>> & horn_constraints, incremental_horn_solver<bool> & solver, NodeSelection node_selection, EntropyComputation entropy_computation)
+		: complex_job_manager(datapoint_ptrs, horn_constraints, solver, node_selection, entropy_computation, NOPREFERENCEFORCONJUNCTS), _reference_node_selection(node_selection) {}
+
+	void add_slice(const slice & sl) {
+		_pending.push_back(sl);
+		_scores_when_added.push_back(score(sl));
+		complex_job_manager::add_slice(sl);
+	}
+
+	node_job next_job() {
+		bool check = !_is_first_split && _replay_slices.empty() && !_pending.empty();
+		std::size_t expected = check ? scan() : 0;
+
+		auto job = complex_job_manager::next_job();
+
+		std::size_t chosen = 0;
+		while (chosen < _pending.size() && (_pending[chosen]._left_index != job.job_slice()._left_index || _pending[chosen]._right_index != job.job_slice()._right_index)) {
+			chosen++;
+		}
+		if (chosen == _pending.size()) {
+			selection_mismatches++;
+			return job;
+		}
+
+		if (check) {
+			compared_selections++;
+			const auto best = score(_pending[expected]);
+			unsigned ties = 0;
+			bool rescored = false;
+			for (std::size_t i = 0; i < _pending.size(); i++) {
+				const auto value = score(_pending[i]);
+				ties += value == best ? 1 : 0;
+				rescored = rescored || value != _scores_when_added[i];
+			}
+			tied_selections += ties > 1 ? 1 : 0;
+			rescored_selections += rescored ? 1 : 0;
+			if (chosen != expected) {
+				selection_mismatches++;
+			}
+		}
+
+		_pending.erase(_pending.begin() + chosen);
+		_scores_when_added.erase(_scores_when_added.begin() + chosen);
+		return job;
+	}
+};
+
+/* Random sample whose classifications and horn constraints agree with a random linear classifier per category. If the
+ * attributes are grouped, every category has integer attributes of its own (as the relations of a CHC problem), which are 0
+ * for the data points of all other categories. */
+struct sample {
+	attributes_metadata metadata;
+	std::vector<datapoint<bool> > datapoints;
+	std::vector<datapoint<bool> *> datapoint_ptrs;
+	std::vector<horn_constraint<bool> > horn_constraints;
+	std::vector<std::pair<unsigned, unsigned> > intervals;
+
+	sample(unsigned seed, bool fully_classified, bool grouped = false) {
+		std::mt19937 generator(seed);
+		auto random = [&generator](int low, int high) { return std::uniform_int_distribution<int>(low, high)(generator); };
+		const unsigned categories = random(1, 3);
+		const unsigned int_attributes = random(1, 4);
+		const unsigned number_of_points = random(20, 150);
+
+		metadata.add_categorical_attribute("$func", categories);
+		for (unsigned i = 0; i < (grouped ? categories : 1) * int_attributes; i++) {
+			metadata.add_int_attribute("x" + std::to_string(i));
+		}
+		for (unsigned category = 0; category < categories; category++) {
+			intervals.push_back(grouped ? std::make_pair(category * int_attributes, (category + 1) * int_attributes - 1) : std::make_pair(0u, int_attributes - 1));
+		}
+		std::vector<std::vector<int> > weights(categories, std::vector<int>(int_attributes + 1));
+		for (auto & category_weights : weights) {
+			for (auto & weight : category_weights) {
+				weight = random(-2, 2);
+			}
+		}
+
+		std::vector<bool> truth;
+		datapoints.reserve(number_of_points);
+		for (unsigned i = 0; i < number_of_points; i++) {
+			datapoint<bool> dp(i);
+			dp._categorical_data.push_back(random(0, categories - 1));
+			int value = weights[dp._categorical_data[0]][int_attributes];
+			const auto offset = intervals[dp._categorical_data[0]].first;
+			dp._int_data.assign(metadata.int_names().size(), 0);
+			for (unsigned j = 0; j < int_attributes; j++) {
+				dp._int_data[offset + j] = random(-5, 5);
+				value += weights[dp._categorical_data[0]][j] * dp._int_data[offset + j];
+			}
+			truth.push_back(value >= 0);
+			if (fully_classified || random(0, 9) < 3) {
+				dp._is_classified = true;
+				dp._classification = truth.back();
+			}
+			datapoints.push_back(dp);
+		}
+		for (auto & dp : datapoints) {
+			datapoint_ptrs.push_back(&dp);
+		}
+
+		const unsigned number_of_constraints = random(0, number_of_points);
+		for (unsigned i = 0; i < number_of_constraints; i++) {
+			std::vector<datapoint<bool> *> premises;
+			bool premises_true = true;
+			for (int j = random(1, 3); j > 0; j--) {
+				auto premise = random(0, number_of_points - 1);
+				premises.push_back(datapoint_ptrs[premise]);
+				premises_true = premises_true && truth[premise];
+			}
+			auto conclusion = random(0, number_of_points - 1);
+			if (!premises_true && random(0, 2) == 0) {
+				horn_constraints.push_back(horn_constraint<bool>(premises, nullptr));
+			} else if (!premises_true || truth[conclusion]) {
+				horn_constraints.push_back(horn_constraint<bool>(premises, datapoint_ptrs[conclusion]));
+			}
+		}
+	}
+};
+
+/* Learn a decision tree for a sample using a checked job manager */
+template <class JobManager> void learn(sample & s, JobManager & manager, incremental_horn_solver<bool> & solver) {
+	std::unordered_set<datapoint<bool> *> positive_ptrs, negative_ptrs;
+	if (!solver.solve(s.datapoint_ptrs, s.horn_constraints, positive_ptrs, negative_ptrs)) {
+		return;
+	}
+	for (auto dp : positive_ptrs) {
+		dp->set_classification(true);
+	}
+	for (auto dp : negative_ptrs) {
+		dp->set_classification(false);
+	}
+	learner<JobManager> l(manager);
+	try {
+		l.learn(s.metadata, s.datapoint_ptrs, s.horn_constraints);
+	} catch (const split_not_possible_error &) {
+		/* the leaves learned so far do not allow to separate the remaining data points */
+	}
+}
+
+int main(int argc, char* argv[]) {
+
+	unsigned number_of_samples = argc > 1 ? std::atoi(argv[1]) : 50;
+
+	for (unsigned seed = 0; seed < number_of_samples; seed++) {
+		for (int threshold : {-1, 2}) {
+			for (bool presorted : {false, true}) {
+				for (bool grouped : {false, true}) {
+					sample s(seed, true, grouped);
+					incremental_horn_solver<bool> solver;
+					checked_job_manager<reference_simple_job_manager> manager(s.datapoint_ptrs, s.horn_constraints, solver, threshold);
+					manager.set_presorted(presorted);
+					manager.set_attribute_intervals(s.intervals);
+					learn(s, manager, solver);
+				}
+				for (auto entropy_computation : {DEFAULT_ENTROPY, PENALTY, HORN_ASSIGNMENTS}) {
+					if (presorted && entropy_computation == HORN_ASSIGNMENTS) {
+						continue;  /* sums of fractions follow the presorted order, which the reference does not reproduce */
+					}
+					for (auto conjunctive_setting : {NOPREFERENCEFORCONJUNCTS, PREFERENCEFORCONJUNCTS}) {
+						for (bool grouped : {false, true}) {
+							sample s(seed, false, grouped);
+							incremental_horn_solver<bool> solver;
+							checked_job_manager<reference_complex_job_manager> manager(s.datapoint_ptrs, s.horn_constraints, solver, threshold, entropy_computation, conjunctive_setting);
+							manager.set_presorted(presorted);
+							manager.set_attribute_intervals(s.intervals);
+							learn(s, manager, solver);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (unsigned seed = 0; seed < number_of_samples; seed++) {
+		for (auto node_selection : {MAX_ENTROPY, MAX_WEIGHTED_ENTROPY, MIN_ENTROPY, MIN_WEIGHTED_ENTROPY}) {
+			for (auto entropy_computation : {DEFAULT_ENTROPY, PENALTY}) {
+				for (bool grouped : {false, true}) {
+					sample s(seed, false, grouped);
+					incremental_horn_solver<bool> solver;
+					scan_checked_job_manager manager(s.datapoint_ptrs, s.horn_constraints, solver, node_selection, entropy_computation);
+					manager.set_attribute_intervals(s.intervals);
+					learn(s, manager, solver);
+				}
+			}
+		}
+	}
+
+	std::cout << "Compared splits: " << compared_splits << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	std::cout << "Compared slice selections: " << compared_selections << " (" << tied_selections << " among tied scores, " << rescored_selections << " after rescoring)" << std::endl;
+	std::cout << "Selection mismatches: " << selection_mismatches << std::endl;
+
+	return compared_splits > 0 && mismatches == 0 && tied_selections > 0 && rescored_selections > 0 && selection_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,39 @@
+#! /bin/bash
+
+# Checks that relearning the decision tree incrementally (-i) does not need many more rounds than learning
+# it from scratch: every benchmark that is verified without -i needs to be verified with -i as well, in at
+# most twice the number of rounds (plus a few, as the rounds differ from run to run).
+
+path="$(dirname "$PWD")"/benchmarks/sequentialPrograms
+
+rounds() {
+
+	timeout 60 ../chc_verifier/src/chc_verifier ${@:2} $1 | grep -o "invoked learner [0-9]*" | grep -o "[0-9]*$"
+}
+
+run_the_test() {
+
+	failed=0
+
+	for name in 01 03 04 05 10 14 16 17 21 23; do
+
+		file_name=$path/$name.c.smt2
+		plain=$(rounds $file_name)
+		incremental=$(rounds $file_name -i)
+
+		echo "Verifying:" $(basename $file_name) "... rounds:" ${plain:-timeout} "(from scratch)," ${incremental:-timeout} "(incremental)"
+
+		if [ -n "$plain" ] && { [ -z "$incremental" ] || [ $incremental -gt $((2 * plain + 5)) ]; }; then
+			failed=1
+		fi
+	done
+
+	if [ $failed -ne 0 ]; then
+		echo "Incremental relearning needs too many rounds."
+		exit 1
+	fi
+
+	echo "Check of incremental relearning finished successfully."
+}
+
+run_the_test